@@ -53,6 +53,22 @@ endif
 
 endif
 
+ifeq ($(ATMOSPHERE_BOARD),generic-linux)
+
+ifeq ($(ATMOSPHERE_CPU),generic-x64)
+export ATMOSPHERE_ARCH_DIR   := x64
+export ATMOSPHERE_BOARD_DIR  := generic/linux
+export ATMOSPHERE_OS_DIR     := linux
+
+export ATMOSPHERE_ARCH_NAME  := x64
+export ATMOSPHERE_BOARD_NAME := generic_linux
+export ATMOSPHERE_OS_NAME    := linux
+
+export ATMOSPHERE_CPU_EXTENSIONS :=
+endif
+
+endif
+
 ifeq ($(ATMOSPHERE_CPU),arm-cortex-a57)
 export ATMOSPHERE_CPU_DIR    := cortex_a57
 export ATMOSPHERE_CPU_NAME   := arm_cortex_a57
@@ -63,6 +79,11 @@ export ATMOSPHERE_CPU_DIR    := arm7tdmi
 export ATMOSPHERE_CPU_NAME   := arm7tdmi
 endif
 
+ifeq ($(ATMOSPHERE_CPU),generic-x64)
+export ATMOSPHERE_CPU_DIR    := generic_x64
+export ATMOSPHERE_CPU_NAME   := generic_x64
+endif
+
 
 export ATMOSPHERE_ARCH_MAKE_DIR  := $(ATMOSPHERE_CONFIG_MAKE_DIR)/arch/$(ATMOSPHERE_ARCH_DIR)
 export ATMOSPHERE_BOARD_MAKE_DIR := $(ATMOSPHERE_CONFIG_MAKE_DIR)/board/$(ATMOSPHERE_BOARD_DIR)
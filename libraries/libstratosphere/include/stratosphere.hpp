@@ -22,6 +22,8 @@
 /* Libstratosphere definitions. */
 #include <stratosphere/ams/impl/ams_system_thread_definitions.hpp>
 
+#if defined(ATMOSPHERE_OS_HORIZON)
+
 /* Libstratosphere-only utility. */
 #include <stratosphere/util.hpp>
 
@@ -96,4 +98,12 @@
 #include <stratosphere/fssystem.hpp>
 
 /* External modules that we're including. */
-#include <stratosphere/rapidjson.hpp>
\ No newline at end of file
+#include <stratosphere/rapidjson.hpp>
+
+#else
+
+/* Host builds only provide the os module, and the utilities which need nothing more. */
+#include <stratosphere/os.hpp>
+#include <stratosphere/util/util_compression.hpp>
+
+#endif
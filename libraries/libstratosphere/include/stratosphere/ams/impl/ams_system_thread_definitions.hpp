@@ -34,6 +34,7 @@ namespace ams::impl {
 
     /* Loader. */
     AMS_DEFINE_SYSTEM_THREAD(21, ldr, Main);
+    AMS_DEFINE_SYSTEM_THREAD(21, ldr, LoadWorker);
 
     /* Process Manager. */
     AMS_DEFINE_SYSTEM_THREAD(21, pm, Main);
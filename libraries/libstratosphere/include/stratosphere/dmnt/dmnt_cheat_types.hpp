@@ -63,4 +63,83 @@ namespace ams::dmnt::cheat {
         FrozenAddressValue value;
     };
 
+    struct FrozenAddressWriteStatistics {
+        u32 entry_count;
+        u32 write_count;
+        s64 write_time_ns;
+        u64 tick_count;
+    };
+
+    static_assert(util::is_pod<FrozenAddressWriteStatistics>::value && sizeof(FrozenAddressWriteStatistics) == 0x18, "FrozenAddressWriteStatistics definition!");
+
+    enum CheatSearchValueType : u32 {
+        CheatSearchValueType_U8  = 0,
+        CheatSearchValueType_U16 = 1,
+        CheatSearchValueType_U32 = 2,
+        CheatSearchValueType_U64 = 3,
+        CheatSearchValueType_S8  = 4,
+        CheatSearchValueType_S16 = 5,
+        CheatSearchValueType_S32 = 6,
+        CheatSearchValueType_S64 = 7,
+        CheatSearchValueType_F32 = 8,
+        CheatSearchValueType_F64 = 9,
+    };
+
+    enum CheatSearchCondition : u32 {
+        CheatSearchCondition_Equal     = 0,
+        CheatSearchCondition_Range     = 1,
+        CheatSearchCondition_Changed   = 2,
+        CheatSearchCondition_Unchanged = 3,
+        CheatSearchCondition_Increased = 4,
+        CheatSearchCondition_Decreased = 5,
+    };
+
+    /* NOTE: Values are passed as the little-endian bit pattern of the searched type. */
+    struct CheatSearchParameters {
+        u32 value_type;
+        u32 condition;
+        u64 value;
+        u64 upper_value;
+    };
+
+    struct CheatSearchStatus {
+        u64 result_count;
+        u32 value_type;
+        u32 scan_count;
+        bool truncated;
+        u8 reserved[7];
+    };
+
+    struct CheatSearchResult {
+        u64 address;
+        u64 value;
+    };
+
+    struct CheatPointerSearchParameters {
+        u64 address;
+        u32 max_depth;
+        u32 max_offset;
+    };
+
+    constexpr inline size_t CheatPointerPathDepthMax = 4;
+
+    /* The target is reached by starting at main_nso_extents.base + base_offset, and for each offset reading a pointer and adding the offset. */
+    struct CheatPointerPath {
+        u64 base_offset;
+        u32 depth;
+        u32 reserved;
+        u64 offsets[CheatPointerPathDepthMax];
+    };
+
+    static_assert(util::is_pod<CheatSearchParameters>::value && sizeof(CheatSearchParameters) == 0x18, "CheatSearchParameters definition!");
+    static_assert(util::is_pod<CheatSearchStatus>::value && sizeof(CheatSearchStatus) == 0x18, "CheatSearchStatus definition!");
+    static_assert(util::is_pod<CheatSearchResult>::value && sizeof(CheatSearchResult) == 0x10, "CheatSearchResult definition!");
+    static_assert(util::is_pod<CheatPointerSearchParameters>::value && sizeof(CheatPointerSearchParameters) == 0x10, "CheatPointerSearchParameters definition!");
+    static_assert(util::is_pod<CheatPointerPath>::value && sizeof(CheatPointerPath) == 0x30, "CheatPointerPath definition!");
+
+    enum CheatVmScheduleMode : u32 {
+        CheatVmScheduleMode_Periodic          = 0,
+        CheatVmScheduleMode_FrameSynchronized = 1,
+    };
+
 }
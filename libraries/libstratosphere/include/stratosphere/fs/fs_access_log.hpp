@@ -28,6 +28,11 @@ namespace ams::fs {
     Result SetGlobalAccessLogMode(u32 mode);
 
     void SetLocalAccessLog(bool enabled);
+
+    /* When the sd card is the global access log target, write this process's accesses as binary records, off the calling thread. */
+    /* This is for programs which log enough accesses that formatting them slows them down; utilities/fs_access_log.py decodes the records. */
+    void SetLocalBinaryAccessLog(bool enabled);
+
     void SetLocalSystemAccessLogForDebug(bool enabled);
 
 }
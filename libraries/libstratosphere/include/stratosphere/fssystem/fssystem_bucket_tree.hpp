@@ -16,6 +16,7 @@
 #pragma once
 #include <vapours.hpp>
 #include <stratosphere/fs/fs_substorage.hpp>
+#include <stratosphere/os.hpp>
 
 namespace ams::fssystem {
 
@@ -149,6 +150,58 @@ namespace ams::fssystem {
                         return this->allocator;
                     }
             };
+
+            /* Holds verified copies of recently used L2 nodes and entry sets, shared by all visitors of a tree. */
+            class NodeCache {
+                NON_COPYABLE(NodeCache);
+                NON_MOVEABLE(NodeCache);
+                public:
+                    static constexpr size_t CacheSizeMax = 128_KB;
+                    static constexpr s32    NodeCountMax = 8;
+
+                    enum NodeKind : u32 {
+                        NodeKind_Offset   = 0,
+                        NodeKind_EntrySet = 1,
+                    };
+                private:
+                    static constexpr s64 InvalidKey = -1;
+
+                    struct CachedNode {
+                        char *buffer;
+                        s64 key;
+                        u32 last_used;
+                    };
+
+                    static constexpr s64 MakeKey(NodeKind kind, s32 index) {
+                        return (static_cast<s64>(kind) << BITSIZEOF(u32)) | static_cast<u32>(index);
+                    }
+                private:
+                    mutable os::SdkMutex mutex;
+                    IAllocator *allocator;
+                    size_t node_size;
+                    s32 node_count;
+                    u32 use_counter;
+                    CachedNode nodes[NodeCountMax];
+                    s32 last_entry_set_index;
+                    s64 last_entry_set_start;
+                    s64 last_entry_set_end;
+                public:
+                    NodeCache() : mutex(), allocator(), node_size(), node_count(), use_counter(), nodes(), last_entry_set_index(-1), last_entry_set_start(), last_entry_set_end() { /* ... */ }
+                    ~NodeCache() { this->Finalize(); }
+
+                    void Initialize(IAllocator *allocator, size_t node_size);
+                    void Finalize();
+                    void Invalidate();
+
+                    template<typename F>
+                    bool Access(Result *out, NodeKind kind, s32 index, F f);
+                    void Store(NodeKind kind, s32 index, const char *buffer);
+
+                    bool FindLastEntrySet(s32 *out_index, s64 virtual_address) const;
+                    void SetLastEntrySet(s32 index, s64 start, s64 end);
+                private:
+                    CachedNode *FindNode(s64 key);
+            };
         private:
             static constexpr s32 GetEntryCount(size_t node_size, size_t entry_size) {
                 return static_cast<s32>((node_size - sizeof(NodeHeader)) / entry_size);
@@ -215,8 +268,9 @@ namespace ams::fssystem {
             s32 entry_set_count;
             s64 start_offset;
             s64 end_offset;
+            mutable NodeCache node_cache;
         public:
-            BucketTree() : node_storage(), entry_storage(), node_l1(), node_size(), entry_size(), entry_count(), offset_count(), entry_set_count(), start_offset(), end_offset() { /* ... */ }
+            BucketTree() : node_storage(), entry_storage(), node_l1(), node_size(), entry_size(), entry_count(), offset_count(), entry_set_count(), start_offset(), end_offset(), node_cache() { /* ... */ }
             ~BucketTree() { this->Finalize(); }
 
             Result Initialize(IAllocator *allocator, fs::SubStorage node_storage, fs::SubStorage entry_storage, size_t node_size, size_t entry_size, s32 entry_count);
@@ -321,10 +375,12 @@ namespace ams::fssystem {
             Result FindEntrySet(s32 *out_index, s64 virtual_address, s32 node_index);
             Result FindEntrySetWithBuffer(s32 *out_index, s64 virtual_address, s32 node_index, char *buffer);
             Result FindEntrySetWithoutBuffer(s32 *out_index, s64 virtual_address, s32 node_index);
+            Result FindEntrySetInBuffer(s32 *out_index, s64 virtual_address, const char *buffer);
 
             Result FindEntry(s64 virtual_address, s32 entry_set_index);
             Result FindEntryWithBuffer(s64 virtual_address, s32 entry_set_index, char *buffer);
             Result FindEntryWithoutBuffer(s64 virtual_address, s32 entry_set_index);
+            Result FindEntryInBuffer(s64 virtual_address, const char *buffer);
     };
 
 }
@@ -25,6 +25,8 @@ namespace ams::fssystem::save {
     class BufferedStorage : public ::ams::fs::IStorage {
         NON_COPYABLE(BufferedStorage);
         NON_MOVEABLE(BufferedStorage);
+        public:
+            static constexpr size_t ReadAheadSizeMax = 512_KB;
         private:
             class Cache;
             class UniqueCache;
@@ -40,6 +42,10 @@ namespace ams::fssystem::save {
             Cache *next_fetch_cache;
             os::Mutex mutex;
             bool bulk_read_enabled;
+            bool read_ahead_enabled;
+            s32 read_ahead_block_count;
+            s64 read_ahead_last_offset;
+            s64 read_ahead_next_offset;
         public:
             BufferedStorage();
             virtual ~BufferedStorage();
@@ -64,6 +70,9 @@ namespace ams::fssystem::save {
             IBufferManager *GetBufferManager() const { return this->buffer_manager; }
 
             void EnableBulkRead() { this->bulk_read_enabled = true; }
+
+            /* When enabled, sequential reads which miss the cache fill the caches ahead of them with one larger read. */
+            void SetReadAheadEnabled(bool en) { this->read_ahead_enabled = en; }
         private:
             Result PrepareAllocation();
             Result ControlDirtiness();
@@ -74,6 +83,10 @@ namespace ams::fssystem::save {
 
             Result BulkRead(s64 offset, void *buffer, size_t size, bool head_cache_needed, bool tail_cache_needed);
 
+            s32 UpdateReadAheadWindow(s64 offset, size_t size);
+            bool IsCached(s64 offset);
+            Result ReadAhead(s64 offset, s32 block_count);
+
             Result WriteCore(s64 offset, const void *buffer, size_t size);
     };
 
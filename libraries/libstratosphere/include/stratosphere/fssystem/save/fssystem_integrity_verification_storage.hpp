@@ -36,6 +36,14 @@ namespace ams::fssystem::save {
                 u8 hash[HashSize];
             };
             static_assert(util::is_pod<BlockHash>::value);
+
+            static constexpr size_t PipelineReadSize = 256_KB;
+        private:
+            struct VerificationContext {
+                IntegrityVerificationStorage *storage;
+                BlockHash *signatures;
+                s64 offset;
+            };
         private:
             fs::SubStorage hash_storage;
             fs::SubStorage data_storage;
@@ -80,6 +88,8 @@ namespace ams::fssystem::save {
             }
 
             Result IsCleared(bool *is_cleared, const BlockHash &hash);
+
+            static Result VerifyBlock(void *arg, s64 offset, u8 *block, size_t block_size);
         private:
             static void SetValidationBit(BlockHash *hash) {
                 AMS_ASSERT(hash != nullptr);
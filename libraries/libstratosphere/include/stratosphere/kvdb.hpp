@@ -19,6 +19,7 @@
 #include "kvdb/kvdb_auto_buffer.hpp"
 #include "kvdb/kvdb_bounded_string.hpp"
 #include "kvdb/kvdb_archive.hpp"
+#include "kvdb/kvdb_journal.hpp"
 #include "kvdb/kvdb_memory_key_value_store.hpp"
 #include "kvdb/kvdb_file_key_value_store.hpp"
 #include "kvdb/kvdb_file_key_value_cache.hpp"
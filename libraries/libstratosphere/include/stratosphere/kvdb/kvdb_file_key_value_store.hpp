@@ -30,6 +30,12 @@ namespace ams::kvdb {
             static constexpr size_t MaxKeySize = (MaxFileLength - FileExtensionLength) / 2;
             using Path = kvdb::BoundedString<fs::EntryNameLengthMax>;
             using FileName = kvdb::BoundedString<MaxFileLength>;
+
+            struct CacheStatistics {
+                u64 hit_count;
+                u64 miss_count;
+                u64 eviction_count;
+            };
         private:
             /* Subtypes. */
             struct Entry {
@@ -37,19 +43,67 @@ namespace ams::kvdb {
                 void *value;
                 size_t key_size;
                 size_t value_size;
+                Entry *hash_next;
+                Entry *lru_prev;
+                Entry *lru_next;
             };
             static_assert(util::is_pod<Entry>::value, "FileKeyValueStore::Entry definition!");
 
             class Cache {
+                private:
+                    struct FreeBlock {
+                        FreeBlock *next;
+                    };
+
+                    static constexpr size_t MinimumBlockSizeShift = 4;
+                    static constexpr size_t MinimumBlockSize      = 1ul << MinimumBlockSizeShift;
+                    static constexpr size_t BlockSizeClassCount   = BITSIZEOF(size_t) - MinimumBlockSizeShift;
+                    static_assert(MinimumBlockSize >= sizeof(FreeBlock));
                 private:
                     u8 *backing_buffer = nullptr;
                     size_t backing_buffer_size = 0;
                     size_t backing_buffer_free_offset = 0;
+                    size_t value_heap_offset = 0;
                     Entry *entries = nullptr;
+                    Entry **buckets = nullptr;
+                    size_t bucket_count = 0;
+                    Entry *free_entries = nullptr;
+                    Entry *lru_head = nullptr;
+                    Entry *lru_tail = nullptr;
+                    FreeBlock *free_blocks[BlockSizeClassCount] = {};
                     size_t count = 0;
                     size_t capacity = 0;
+                    CacheStatistics statistics = {};
                 private:
+                    size_t GetAlignedOffset(size_t offset) const;
                     void *Allocate(size_t size);
+                    void *AllocateValue(size_t size);
+                    void FreeValue(void *value, size_t size);
+
+                    void Reset();
+                    Entry *Find(const void *key, size_t key_size);
+                    void RemoveEntry(Entry *entry);
+                    void EvictLeastRecentlyUsed();
+                    void LinkToFront(Entry *entry);
+                    void Unlink(Entry *entry);
+
+                    Entry **GetBucket(const void *key, size_t key_size) {
+                        /* FNV-1a over the key bytes. */
+                        const u8 *key_bytes = static_cast<const u8 *>(key);
+                        size_t hash = 0xCBF29CE484222325;
+                        for (size_t i = 0; i < key_size; i++) {
+                            hash = (hash ^ key_bytes[i]) * 0x100000001B3;
+                        }
+                        return std::addressof(this->buckets[hash & (this->bucket_count - 1)]);
+                    }
+
+                    static size_t GetBlockSize(size_t size) {
+                        return util::CeilingPowerOfTwo(std::max(size, MinimumBlockSize));
+                    }
+
+                    static size_t GetBlockSizeClass(size_t size) {
+                        return util::CountTrailingZeros(GetBlockSize(size)) - MinimumBlockSizeShift;
+                    }
 
                     bool HasEntries() const {
                         return this->entries != nullptr && this->capacity != 0;
@@ -60,7 +114,16 @@ namespace ams::kvdb {
                     std::optional<size_t> TryGet(void *out_value, size_t max_out_size, const void *key, size_t key_size);
                     std::optional<size_t> TryGetSize(const void *key, size_t key_size);
                     void Set(const void *key, size_t key_size, const void *value, size_t value_size);
+                    void Remove(const void *key, size_t key_size);
                     bool Contains(const void *key, size_t key_size);
+
+                    void GetStatistics(CacheStatistics *out) const {
+                        *out = this->statistics;
+                    }
+
+                    void ResetStatistics() {
+                        this->statistics = {};
+                    }
             };
         private:
             os::Mutex lock;
@@ -80,6 +143,10 @@ namespace ams::kvdb {
             Result Set(const void *key, size_t key_size, const void *value, size_t value_size);
             Result Remove(const void *key, size_t key_size);
 
+            /* Cache statistics. */
+            void GetCacheStatistics(CacheStatistics *out);
+            void ResetCacheStatistics();
+
             /* Niceties. */
             template<typename Key>
             Result Get(size_t *out_size, void *out_value, size_t max_out_size, const Key &key) {
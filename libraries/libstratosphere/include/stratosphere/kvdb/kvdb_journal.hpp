@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere/kvdb/kvdb_auto_buffer.hpp>
+
+namespace ams::kvdb {
+
+    enum JournalRecordType : u8 {
+        JournalRecordType_Set    = 0,
+        JournalRecordType_Remove = 1,
+        JournalRecordType_Base   = 2, /* Begins a journal, identifying the archive it applies to. */
+    };
+
+    /* Functionality for parsing/generating a key value journal, a sequence of checksummed deltas applied on top of an archive. */
+    class JournalReader {
+        private:
+            const AutoBuffer &buffer;
+            size_t offset;
+        public:
+            JournalReader(const AutoBuffer &b) : buffer(b), offset(0) { /* ... */ }
+
+            bool IsEnd() const {
+                return this->offset >= this->buffer.GetSize();
+            }
+
+            size_t GetOffset() const {
+                return this->offset;
+            }
+        public:
+            /* Fails for truncated or corrupted records; pointers remain valid for the lifetime of the buffer. */
+            Result ReadRecord(JournalRecordType *out_type, const void **out_key, size_t *out_key_size, const void **out_value, size_t *out_value_size);
+    };
+
+    class JournalWriter {
+        private:
+            AutoBuffer &buffer;
+            size_t offset;
+        public:
+            JournalWriter(AutoBuffer &b) : buffer(b), offset(0) { /* ... */ }
+        private:
+            Result Write(const void *src, size_t size);
+        public:
+            void WriteRecord(JournalRecordType type, const void *key, size_t key_size, const void *value, size_t value_size);
+    };
+
+    class JournalSizeHelper {
+        private:
+            size_t size;
+        public:
+            JournalSizeHelper() : size(0) { /* ... */ }
+
+            void AddRecord(size_t key_size, size_t value_size);
+
+            size_t GetSize() const {
+                return this->size;
+            }
+    };
+
+}
@@ -20,6 +20,7 @@
 #include <stratosphere/fs/fs_filesystem.hpp>
 #include <stratosphere/kvdb/kvdb_auto_buffer.hpp>
 #include <stratosphere/kvdb/kvdb_archive.hpp>
+#include <stratosphere/kvdb/kvdb_journal.hpp>
 #include <stratosphere/kvdb/kvdb_bounded_string.hpp>
 
 namespace ams::kvdb {
@@ -158,6 +159,52 @@ namespace ams::kvdb {
                         return ResultSuccess();
                     }
 
+                    Result SortUnsafe() {
+                        /* Entries added with AddUnsafe are usually already in order, without duplicates. */
+                        const auto not_ordered = [](const Entry &lhs, const Entry &rhs) { return !(lhs.GetKey() < rhs.GetKey()); };
+                        if (std::adjacent_find(this->GetBegin(), this->GetEnd(), not_ordered) == this->GetEnd()) {
+                            return ResultSuccess();
+                        }
+
+                        /* Sort by key and then by the order entries were added in, using scratch space from our memory resource. */
+                        struct SortEntry {
+                            Entry entry;
+                            size_t order;
+                        };
+
+                        const size_t sort_entries_size = sizeof(SortEntry) * this->count;
+                        SortEntry *sort_entries = reinterpret_cast<SortEntry *>(this->memory_resource->Allocate(sort_entries_size));
+                        R_UNLESS(sort_entries != nullptr, ResultAllocationFailed());
+                        ON_SCOPE_EXIT { this->memory_resource->Deallocate(sort_entries, sort_entries_size); };
+
+                        for (size_t i = 0; i < this->count; ++i) {
+                            std::construct_at(sort_entries + i, SortEntry{ this->entries[i], i });
+                        }
+                        std::sort(sort_entries, sort_entries + this->count, [](const SortEntry &lhs, const SortEntry &rhs) {
+                            if (lhs.entry.GetKey() < rhs.entry.GetKey()) {
+                                return true;
+                            } else if (rhs.entry.GetKey() < lhs.entry.GetKey()) {
+                                return false;
+                            } else {
+                                return lhs.order < rhs.order;
+                            }
+                        });
+
+                        /* Keep the most recently added entry for any duplicated key. */
+                        size_t new_count = 0;
+                        for (size_t i = 0; i < this->count; ++i) {
+                            Entry &entry = sort_entries[i].entry;
+                            if (i + 1 < this->count && sort_entries[i + 1].entry.GetKey() == entry.GetKey()) {
+                                this->memory_resource->Deallocate(entry.GetValuePointer(), entry.GetValueSize());
+                                continue;
+                            }
+                            this->entries[new_count++] = entry;
+                        }
+                        this->count = new_count;
+
+                        return ResultSuccess();
+                    }
+
                     Result Remove(const Key &key) {
                         /* Find entry for key. */
                         Entry *it = this->find(key);
@@ -254,15 +301,34 @@ namespace ams::kvdb {
             };
         private:
             using Path = kvdb::BoundedString<fs::EntryNameLengthMax>;
+
+            /* Journaled stores rewrite the archive once the journal outgrows it (or this size, for small stores). */
+            static constexpr size_t MinimumJournalCompactionSize = 32_KB;
+            static constexpr size_t MinimumDirtyKeyCapacity      = 0x10;
         private:
             Index index;
             Path path;
             Path temp_path;
+            Path journal_path;
             MemoryResource *memory_resource;
+            Key *dirty_keys = nullptr;
+            size_t dirty_count = 0;
+            size_t dirty_capacity = 0;
+            size_t journal_size = 0;
+            u8 archive_hash[crypto::Sha256Generator::HashSize] = {};
+            bool is_journaled = false;
+            bool is_dirty_overflowed = false;
         public:
             MemoryKeyValueStore() { /* ... */ }
 
-            Result Initialize(const char *dir, size_t capacity, MemoryResource *mr) {
+            ~MemoryKeyValueStore() {
+                if (this->dirty_keys != nullptr) {
+                    this->memory_resource->Deallocate(this->dirty_keys, sizeof(Key) * this->dirty_capacity);
+                    this->dirty_keys = nullptr;
+                }
+            }
+
+            Result Initialize(const char *dir, size_t capacity, MemoryResource *mr, bool journaled = false) {
                 /* Ensure that the passed path is a directory. */
                 fs::DirectoryEntryType entry_type;
                 R_TRY(fs::GetEntryType(std::addressof(entry_type), dir));
@@ -271,11 +337,15 @@ namespace ams::kvdb {
                 /* Set paths. */
                 this->path.SetFormat("%s%s", dir, "/imkvdb.arc");
                 this->temp_path.SetFormat("%s%s", dir, "/imkvdb.tmp");
+                this->journal_path.SetFormat("%s%s", dir, "/imkvdb.jnl");
 
                 /* Initialize our index. */
                 R_TRY(this->index.Initialize(capacity, mr));
                 this->memory_resource = mr;
 
+                /* A journaled store appends changed entries on save, rather than rewriting the whole archive. */
+                this->is_journaled = journaled;
+
                 return ResultSuccess();
             }
 
@@ -284,6 +354,7 @@ namespace ams::kvdb {
                 /* A store initialized this way cannot have its contents loaded from or flushed to disk. */
                 this->path.Set("");
                 this->temp_path.Set("");
+                this->journal_path.Set("");
 
                 /* Initialize our index. */
                 R_TRY(this->index.Initialize(capacity, mr));
@@ -302,65 +373,33 @@ namespace ams::kvdb {
             Result Load() {
                 /* Reset any existing entries. */
                 this->index.ResetEntries();
+                this->ClearDirtyKeys();
+                this->journal_size = 0;
 
-                /* Try to read the archive -- note, path not found is a success condition. */
-                /* This is because no archive file = no entries, so we're in the right state. */
-                AutoBuffer buffer;
-                R_TRY_CATCH(this->ReadArchiveFile(&buffer)) {
-                    R_CONVERT(fs::ResultPathNotFound, ResultSuccess());
-                } R_END_TRY_CATCH;
-
-                /* Parse entries from the buffer. */
-                {
-                    ArchiveReader reader(buffer);
-
-                    size_t entry_count = 0;
-                    R_TRY(reader.ReadEntryCount(&entry_count));
+                /* Read the archive. */
+                R_TRY(this->LoadArchive());
+                R_TRY(this->index.SortUnsafe());
 
-                    for (size_t i = 0; i < entry_count; i++) {
-                        /* Get size of key/value. */
-                        size_t key_size = 0, value_size = 0;
-                        R_TRY(reader.GetEntrySize(&key_size, &value_size));
-
-                        /* Allocate memory for value. */
-                        void *new_value = this->memory_resource->Allocate(value_size);
-                        R_UNLESS(new_value != nullptr, ResultAllocationFailed());
-                        auto value_guard = SCOPE_GUARD { this->memory_resource->Deallocate(new_value, value_size); };
-
-                        /* Read key and value. */
-                        Key key;
-                        R_TRY(reader.ReadEntry(&key, sizeof(key), new_value, value_size));
-                        R_TRY(this->index.AddUnsafe(key, new_value, value_size));
-
-                        /* We succeeded, so cancel the value guard to prevent deallocation. */
-                        value_guard.Cancel();
-                    }
+                /* Apply any changes recorded in the journal since the archive was last written. */
+                if (this->is_journaled) {
+                    R_TRY(this->ReplayJournal());
                 }
 
                 return ResultSuccess();
             }
 
             Result Save(bool destructive = false) {
-                /* Create a buffer to hold the archive. */
-                AutoBuffer buffer;
-                R_TRY(buffer.Initialize(this->GetArchiveSize()));
-
-                /* Write the archive to the buffer. */
-                {
-                    ArchiveWriter writer(buffer);
-                    writer.WriteHeader(this->GetCount());
-                    for (const auto &it : this->index) {
-                        const auto &key = it.GetKey();
-                        writer.WriteEntry(&key, sizeof(Key), it.GetValuePointer(), it.GetValueSize());
-                    }
+                if (this->is_journaled) {
+                    return this->SaveJournal(destructive);
+                } else {
+                    return this->SaveArchive(destructive);
                 }
-
-                /* Save the buffer to disk. */
-                return this->Commit(buffer, destructive);
             }
 
             Result Set(const Key &key, const void *value, size_t value_size) {
-                return this->index.Set(key, value, value_size);
+                R_TRY(this->index.Set(key, value, value_size));
+                this->AddDirtyKey(key);
+                return ResultSuccess();
             }
 
             template<typename Value>
@@ -428,7 +467,9 @@ namespace ams::kvdb {
             }
 
             Result Remove(const Key &key) {
-                return this->index.Remove(key);
+                R_TRY(this->index.Remove(key));
+                this->AddDirtyKey(key);
+                return ResultSuccess();
             }
 
             Entry *begin() {
@@ -471,6 +512,88 @@ namespace ams::kvdb {
                 return this->index.find(key);
             }
         private:
+            Result LoadArchive() {
+                /* Try to read the archive -- note, path not found is a success condition. */
+                /* This is because no archive file = no entries, so we're in the right state. */
+                AutoBuffer buffer;
+                this->UpdateArchiveHash(buffer);
+                R_TRY_CATCH(this->ReadArchiveFile(&buffer)) {
+                    R_CONVERT(fs::ResultPathNotFound, ResultSuccess());
+                } R_END_TRY_CATCH;
+
+                /* Journals identify the archive they apply to by its hash. */
+                this->UpdateArchiveHash(buffer);
+
+                /* Parse entries from the buffer. */
+                {
+                    ArchiveReader reader(buffer);
+
+                    size_t entry_count = 0;
+                    R_TRY(reader.ReadEntryCount(&entry_count));
+
+                    for (size_t i = 0; i < entry_count; i++) {
+                        /* Get size of key/value. */
+                        size_t key_size = 0, value_size = 0;
+                        R_TRY(reader.GetEntrySize(&key_size, &value_size));
+
+                        /* Allocate memory for value. */
+                        void *new_value = this->memory_resource->Allocate(value_size);
+                        R_UNLESS(new_value != nullptr, ResultAllocationFailed());
+                        auto value_guard = SCOPE_GUARD { this->memory_resource->Deallocate(new_value, value_size); };
+
+                        /* Read key and value. */
+                        Key key;
+                        R_TRY(reader.ReadEntry(&key, sizeof(key), new_value, value_size));
+                        R_TRY(this->index.AddUnsafe(key, new_value, value_size));
+
+                        /* We succeeded, so cancel the value guard to prevent deallocation. */
+                        value_guard.Cancel();
+                    }
+                }
+
+                return ResultSuccess();
+            }
+
+            Result SaveArchive(bool destructive) {
+                /* Create a buffer to hold the archive. */
+                AutoBuffer buffer;
+                R_TRY(buffer.Initialize(this->GetArchiveSize()));
+
+                /* Write the archive to the buffer. */
+                {
+                    ArchiveWriter writer(buffer);
+                    writer.WriteHeader(this->GetCount());
+                    for (const auto &it : this->index) {
+                        const auto &key = it.GetKey();
+                        writer.WriteEntry(&key, sizeof(Key), it.GetValuePointer(), it.GetValueSize());
+                    }
+                }
+
+                /* A journal against an unchanged archive would still replay after the write, so discard it first. */
+                /* This is safe, as the archive on disk already holds our entries. */
+                if (this->is_journaled && this->IsArchiveHash(buffer)) {
+                    R_TRY(this->DeleteJournal());
+                }
+
+                /* Save the buffer to disk. */
+                R_TRY(this->Commit(buffer, destructive));
+
+                /* Any existing journal was written against the previous archive, and no longer applies. */
+                this->UpdateArchiveHash(buffer);
+                this->journal_size = 0;
+                return ResultSuccess();
+            }
+
+            void UpdateArchiveHash(const AutoBuffer &buffer) {
+                crypto::GenerateSha256Hash(this->archive_hash, sizeof(this->archive_hash), buffer.Get(), buffer.GetSize());
+            }
+
+            bool IsArchiveHash(const AutoBuffer &buffer) const {
+                u8 hash[crypto::Sha256Generator::HashSize];
+                crypto::GenerateSha256Hash(hash, sizeof(hash), buffer.Get(), buffer.GetSize());
+                return std::memcmp(hash, this->archive_hash, sizeof(hash)) == 0;
+            }
+
             Result SaveArchiveToFile(const char *path, const void *buf, size_t size) {
                 /* Try to delete the archive, but allow deletion failure. */
                 fs::DeleteFile(path);
@@ -518,21 +641,236 @@ namespace ams::kvdb {
             }
 
             Result ReadArchiveFile(AutoBuffer *dst) const {
+                return this->ReadFile(dst, this->path.Get());
+            }
+
+            Result ReadFile(AutoBuffer *dst, const char *path) const {
                 /* Open the file. */
                 fs::FileHandle file;
                 R_TRY(fs::OpenFile(std::addressof(file), path, fs::OpenMode_Read));
                 ON_SCOPE_EXIT { fs::CloseFile(file); };
 
-                /* Get the archive file size. */
-                s64 archive_size;
-                R_TRY(fs::GetFileSize(std::addressof(archive_size), file));
+                /* Get the file size. */
+                s64 file_size;
+                R_TRY(fs::GetFileSize(std::addressof(file_size), file));
 
                 /* Make a new buffer, read the file. */
-                R_TRY(dst->Initialize(static_cast<size_t>(archive_size)));
+                R_TRY(dst->Initialize(static_cast<size_t>(file_size)));
                 R_TRY(fs::ReadFile(file, 0, dst->Get(), dst->GetSize()));
 
                 return ResultSuccess();
             }
+
+            void AddDirtyKey(const Key &key) {
+                /* Only journaled stores need to track what changed since the last save. */
+                if (!this->is_journaled || this->is_dirty_overflowed) {
+                    return;
+                }
+
+                /* The dirty keys are kept sorted, so that repeated changes to the same key are only journaled once. */
+                Key *it = std::lower_bound(this->dirty_keys, this->dirty_keys + this->dirty_count, key);
+                if (it != this->dirty_keys + this->dirty_count && *it == key) {
+                    return;
+                }
+                const size_t insert_index = it - this->dirty_keys;
+
+                /* Grow the dirty key list, if we need to. */
+                if (this->dirty_count == this->dirty_capacity) {
+                    const size_t new_capacity = std::max(MinimumDirtyKeyCapacity, 2 * this->dirty_capacity);
+
+                    /* If we can't track the change, fall back to rewriting the archive on the next save. */
+                    Key *new_keys = reinterpret_cast<Key *>(this->memory_resource->Allocate(sizeof(Key) * new_capacity));
+                    if (new_keys == nullptr) {
+                        this->is_dirty_overflowed = true;
+                        return;
+                    }
+
+                    if (this->dirty_keys != nullptr) {
+                        std::memcpy(new_keys, this->dirty_keys, sizeof(Key) * this->dirty_count);
+                        this->memory_resource->Deallocate(this->dirty_keys, sizeof(Key) * this->dirty_capacity);
+                    }
+
+                    this->dirty_keys     = new_keys;
+                    this->dirty_capacity = new_capacity;
+                }
+
+                /* Move later keys forward, and insert the new key. */
+                std::memmove(this->dirty_keys + insert_index + 1, this->dirty_keys + insert_index, sizeof(Key) * (this->dirty_count - insert_index));
+                this->dirty_keys[insert_index] = key;
+                this->dirty_count++;
+            }
+
+            void ClearDirtyKeys() {
+                this->dirty_count         = 0;
+                this->is_dirty_overflowed = false;
+            }
+
+            Result SaveJournal(bool destructive) {
+                /* If nothing has changed, there's nothing to save. */
+                if (this->dirty_count == 0 && !this->is_dirty_overflowed) {
+                    return ResultSuccess();
+                }
+
+                /* Determine the size of the records for the changed keys. */
+                JournalSizeHelper size_helper;
+                for (size_t i = 0; i < this->dirty_count; ++i) {
+                    const auto it = this->find(this->dirty_keys[i]);
+                    size_helper.AddRecord(sizeof(Key), it != this->end() ? it->GetValueSize() : 0);
+                }
+
+                /* Compact into the archive once the journal would outgrow it. */
+                if (this->is_dirty_overflowed || this->journal_size + size_helper.GetSize() > std::max(this->GetArchiveSize(), MinimumJournalCompactionSize)) {
+                    return this->CompactJournal(destructive);
+                }
+
+                /* Write the records to a buffer. */
+                AutoBuffer buffer;
+                R_TRY(buffer.Initialize(size_helper.GetSize()));
+                {
+                    JournalWriter writer(buffer);
+                    for (size_t i = 0; i < this->dirty_count; ++i) {
+                        const Key &key = this->dirty_keys[i];
+                        if (const auto it = this->find(key); it != this->end()) {
+                            writer.WriteRecord(JournalRecordType_Set, std::addressof(key), sizeof(Key), it->GetValuePointer(), it->GetValueSize());
+                        } else {
+                            writer.WriteRecord(JournalRecordType_Remove, std::addressof(key), sizeof(Key), nullptr, 0);
+                        }
+                    }
+                }
+
+                /* Append the records to the journal. */
+                R_TRY(this->AppendToJournal(buffer));
+
+                this->ClearDirtyKeys();
+                return ResultSuccess();
+            }
+
+            Result CompactJournal(bool destructive) {
+                /* Write the full archive. */
+                /* This invalidates the journal, whose base record names the previous archive, so a crash before deletion can't replay it. */
+                R_TRY(this->SaveArchive(destructive));
+
+                /* Discard the stale journal. */
+                R_TRY(this->DeleteJournal());
+
+                this->ClearDirtyKeys();
+                return ResultSuccess();
+            }
+
+            Result DeleteJournal() {
+                R_TRY_CATCH(fs::DeleteFile(this->journal_path.Get())) {
+                    R_CATCH(fs::ResultPathNotFound) { /* There may be no journal to discard. */ }
+                } R_END_TRY_CATCH;
+
+                this->journal_size = 0;
+                return ResultSuccess();
+            }
+
+            Result AppendToJournal(const AutoBuffer &buffer) {
+                /* Start a new journal, if we don't have one. */
+                if (this->journal_size == 0) {
+                    R_TRY(this->StartJournal());
+                }
+
+                /* Append the records. */
+                {
+                    fs::FileHandle file;
+                    R_TRY(fs::OpenFile(std::addressof(file), this->journal_path.Get(), fs::OpenMode_Write | fs::OpenMode_AllowAppend));
+                    ON_SCOPE_EXIT { fs::CloseFile(file); };
+                    R_TRY(fs::WriteFile(file, this->journal_size, buffer.Get(), buffer.GetSize(), fs::WriteOption::Flush));
+                }
+
+                /* An interrupted append leaves a torn record past journal_size, which the next append overwrites. */
+                this->journal_size += buffer.GetSize();
+                return ResultSuccess();
+            }
+
+            Result StartJournal() {
+                /* Write a base record, identifying the archive the journal applies to. */
+                AutoBuffer buffer;
+                {
+                    JournalSizeHelper size_helper;
+                    size_helper.AddRecord(0, sizeof(this->archive_hash));
+                    R_TRY(buffer.Initialize(size_helper.GetSize()));
+
+                    JournalWriter writer(buffer);
+                    writer.WriteRecord(JournalRecordType_Base, nullptr, 0, this->archive_hash, sizeof(this->archive_hash));
+                }
+
+                /* Create the journal, replacing any stale one. */
+                R_TRY(this->DeleteJournal());
+                R_TRY(fs::CreateFile(this->journal_path.Get(), 0));
+
+                {
+                    fs::FileHandle file;
+                    R_TRY(fs::OpenFile(std::addressof(file), this->journal_path.Get(), fs::OpenMode_Write | fs::OpenMode_AllowAppend));
+                    ON_SCOPE_EXIT { fs::CloseFile(file); };
+                    R_TRY(fs::WriteFile(file, 0, buffer.Get(), buffer.GetSize(), fs::WriteOption::Flush));
+                }
+
+                this->journal_size = buffer.GetSize();
+                return ResultSuccess();
+            }
+
+            bool IsJournalOfArchive(JournalReader &reader) const {
+                JournalRecordType type;
+                const void *key, *value;
+                size_t key_size, value_size;
+                if (R_FAILED(reader.ReadRecord(std::addressof(type), std::addressof(key), std::addressof(key_size), std::addressof(value), std::addressof(value_size)))) {
+                    return false;
+                }
+
+                return type == JournalRecordType_Base && value_size == sizeof(this->archive_hash) && std::memcmp(value, this->archive_hash, sizeof(this->archive_hash)) == 0;
+            }
+
+            Result ReplayJournal() {
+                /* Try to read the journal -- no journal file means no changes since the archive was written. */
+                AutoBuffer buffer;
+                R_TRY_CATCH(this->ReadFile(std::addressof(buffer), this->journal_path.Get())) {
+                    R_CONVERT(fs::ResultPathNotFound, ResultSuccess());
+                } R_END_TRY_CATCH;
+
+                /* A journal for a different archive was absorbed by a compaction which crashed before deleting it. */
+                /* It must not be replayed, as its records may be older than the archive's entries. */
+                JournalReader reader(buffer);
+                if (!this->IsJournalOfArchive(reader)) {
+                    return this->DeleteJournal();
+                }
+
+                /* Apply records until we reach the end, or a record torn by an interrupted append. */
+                while (!reader.IsEnd()) {
+                    JournalRecordType type;
+                    const void *key, *value;
+                    size_t key_size, value_size;
+                    if (R_FAILED(reader.ReadRecord(std::addressof(type), std::addressof(key), std::addressof(key_size), std::addressof(value), std::addressof(value_size)))) {
+                        break;
+                    }
+                    R_UNLESS(type != JournalRecordType_Base, ResultInvalidKeyValue());
+                    R_UNLESS(key_size == sizeof(Key),        ResultInvalidKeyValue());
+
+                    Key record_key;
+                    std::memcpy(std::addressof(record_key), key, sizeof(Key));
+
+                    if (type == JournalRecordType_Set) {
+                        R_TRY(this->index.Set(record_key, value, value_size));
+                    } else {
+                        R_TRY_CATCH(this->index.Remove(record_key)) {
+                            R_CATCH(ResultKeyNotFound) { /* The archive may already reflect the removal. */ }
+                        } R_END_TRY_CATCH;
+                    }
+                }
+
+                /* Drop any torn tail, so that further appends follow the last intact record. */
+                this->journal_size = reader.GetOffset();
+                if (this->journal_size != buffer.GetSize()) {
+                    fs::FileHandle file;
+                    R_TRY(fs::OpenFile(std::addressof(file), this->journal_path.Get(), fs::OpenMode_Write));
+                    ON_SCOPE_EXIT { fs::CloseFile(file); };
+                    R_TRY(fs::SetFileSize(file, this->journal_size));
+                }
+
+                return ResultSuccess();
+            }
     };
 
 }
\ No newline at end of file
@@ -73,6 +73,21 @@ namespace ams::ldr {
     }
     static_assert(sizeof(PinId) == sizeof(u64) && util::is_pod<PinId>::value, "PinId definition!");
 
+    /* Atmosphere extension: time spent in each phase of creating a process. */
+    /* Segments are read, decompressed and hashed concurrently, so those phases are summed over all segments and may exceed load_nsos. */
+    struct LaunchPhaseTimes {
+        TimeSpanType load_meta;
+        TimeSpanType load_nso_headers;
+        TimeSpanType create_process;
+        TimeSpanType load_nsos;
+        TimeSpanType read_segments;
+        TimeSpanType decompress_segments;
+        TimeSpanType hash_segments;
+        TimeSpanType patch_nsos;
+        TimeSpanType total;
+    };
+    static_assert(sizeof(LaunchPhaseTimes) == 0x48 && util::is_pod<LaunchPhaseTimes>::value, "LaunchPhaseTimes definition!");
+
     /* Import ModuleInfo from libnx. */
     using ModuleInfo = ::LoaderModuleInfo;
 
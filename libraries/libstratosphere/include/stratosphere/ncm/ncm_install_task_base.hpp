@@ -37,6 +37,19 @@ namespace ams::ncm {
         TimeSpan elapsed_time;
     };
 
+    enum class InstallPipelineStage {
+        Read  = 0,
+        Write = 1,
+        Hash  = 2,
+    };
+
+    /* Throughput of each stage of a pipelined install; elapsed_time is the time the stage spent working. */
+    struct InstallPipelineThroughput {
+        InstallThroughput read;
+        InstallThroughput write;
+        InstallThroughput hash;
+    };
+
     struct InstallContentMetaInfo {
         ContentId content_id;
         s64 content_size;
@@ -78,9 +91,17 @@ namespace ams::ncm {
 
     static_assert(sizeof(InstallContentMetaInfo) == 0x50);
 
+    namespace impl {
+
+        class InstallPipeline;
+
+    }
+
     class InstallTaskBase {
         NON_COPYABLE(InstallTaskBase);
         NON_MOVEABLE(InstallTaskBase);
+        private:
+            friend class impl::InstallPipeline;
         private:
             crypto::Sha256Generator sha256_generator;
             StorageId install_storage;
@@ -94,6 +115,12 @@ namespace ams::ncm {
             TimeSpan throughput_start_time;
             os::Mutex throughput_mutex;
             FirmwareVariationId firmware_variation_id;
+            void *install_buffer;
+            size_t install_buffer_size;
+            bool pipelined_install_enabled;
+            s32 max_parallel_content_count;
+            impl::InstallPipeline *pipeline;
+            InstallPipelineThroughput pipeline_throughput;
         private:
             ALWAYS_INLINE Result SetLastResultOnFailure(Result result) {
                 if (R_FAILED(result)) {
@@ -102,7 +129,7 @@ namespace ams::ncm {
                 return result;
             }
         public:
-            InstallTaskBase() : data(), progress(), progress_mutex(false), cancel_mutex(false), cancel_requested(), throughput_mutex(false) { /* ... */ }
+            InstallTaskBase() : data(), progress(), progress_mutex(false), cancel_mutex(false), cancel_requested(), throughput_mutex(false), install_buffer(), install_buffer_size(), pipelined_install_enabled(), max_parallel_content_count(1), pipeline(), pipeline_throughput() { /* ... */ }
             virtual ~InstallTaskBase() { /* ... */ };
         public:
             virtual void Cancel();
@@ -123,6 +150,7 @@ namespace ams::ncm {
             void ResetLastResult();
             Result IncludesExFatDriver(bool *out);
             InstallThroughput GetThroughput();
+            InstallPipelineThroughput GetPipelineThroughput();
             Result CalculateContentsSize(s64 *out_size, const ContentMetaKey &key, StorageId storage_id);
             Result ListOccupiedSize(s32 *out_written, InstallTaskOccupiedSize *out_list, s32 out_list_size, s32 offset);
 
@@ -134,6 +162,8 @@ namespace ams::ncm {
             Result PrepareContentMeta(const InstallContentMetaInfo &meta_info, std::optional<ContentMetaKey> key, std::optional<u32> source_version);
             Result PrepareContentMeta(ContentId content_id, s64 size, ContentMetaType meta_type, AutoBuffer *buffer);
             Result WritePlaceHolderBuffer(InstallContentInfo *content_info, const void *data, size_t data_size);
+            Result AcquirePlaceHolderBuffer(void **out_buffer, size_t *out_buffer_size, InstallContentInfo *content_info);
+            void SetInstallBuffer(void *buffer, size_t buffer_size);
             void PrepareAgain();
 
             Result CountInstallContentMetaData(s32 *out_count);
@@ -169,6 +199,7 @@ namespace ams::ncm {
             virtual Result OnExecuteComplete() { return ResultSuccess(); }
 
             Result WritePlaceHolder(const ContentMetaKey &key, InstallContentInfo *content_info);
+            Result WritePlaceHolderData(InstallContentInfo *content_info, const void *data, size_t data_size);
             virtual Result OnWritePlaceHolder(const ContentMetaKey &key, InstallContentInfo *content_info) = 0;
 
             bool IsNecessaryInstallTicket(const fs::RightsId &rights_id);
@@ -186,6 +217,7 @@ namespace ams::ncm {
             void ResetThroughputMeasurement();
             void StartThroughputMeasurement();
             void UpdateThroughputMeasurement(s64 throughput);
+            void UpdatePipelineThroughputMeasurement(InstallPipelineStage stage, s64 throughput, TimeSpan elapsed_time);
 
             Result GetInstallContentMetaDataFromPath(AutoBuffer *out, const Path &path, const InstallContentInfo &content_info, std::optional<u32> source_version);
 
@@ -198,6 +230,11 @@ namespace ams::ncm {
 
             void SetFirmwareVariationId(FirmwareVariationId id) { this->firmware_variation_id = id; }
             Result ListRightsIds(s32 *out_count, Span<RightsId> out_span, const ContentMetaKey &key, s32 offset);
+
+            /* When enabled, Execute reads, writes and hashes content concurrently, installing up to the max parallel content count at once. */
+            /* This requires an install buffer; the task installs serially if it has none, or if the pipeline can't be set up. */
+            void SetPipelinedInstallEnabled(bool enabled) { this->pipelined_install_enabled = enabled; }
+            void SetMaxParallelContentCount(s32 count) { AMS_ASSERT(count > 0); this->max_parallel_content_count = count; }
     };
 
 }
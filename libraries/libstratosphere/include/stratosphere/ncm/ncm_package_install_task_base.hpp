@@ -24,8 +24,6 @@ namespace ams::ncm {
             using PackagePath = kvdb::BoundedString<256>;
         private:
             PackagePath package_root;
-            void *buffer;
-            size_t buffer_size;
         public:
             PackageInstallTaskBase() : package_root() { /* ... */ }
 
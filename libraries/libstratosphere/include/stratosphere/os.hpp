@@ -23,19 +23,25 @@
 #include <stratosphere/os/os_memory_permission.hpp>
 #include <stratosphere/os/os_memory_heap_api.hpp>
 #include <stratosphere/os/os_memory_virtual_address_api.hpp>
+#if defined(ATMOSPHERE_OS_HORIZON)
 #include <stratosphere/os/os_managed_handle.hpp>
 #include <stratosphere/os/os_process_handle.hpp>
+#endif
 #include <stratosphere/os/os_random.hpp>
 #include <stratosphere/os/os_mutex.hpp>
 #include <stratosphere/os/os_condition_variable.hpp>
 #include <stratosphere/os/os_sdk_mutex.hpp>
 #include <stratosphere/os/os_sdk_condition_variable.hpp>
 #include <stratosphere/os/os_rw_lock.hpp>
+#if defined(ATMOSPHERE_OS_HORIZON)
 #include <stratosphere/os/os_transfer_memory.hpp>
+#endif
 #include <stratosphere/os/os_semaphore.hpp>
 #include <stratosphere/os/os_event.hpp>
 #include <stratosphere/os/os_system_event.hpp>
+#if defined(ATMOSPHERE_OS_HORIZON)
 #include <stratosphere/os/os_interrupt_event.hpp>
+#endif
 #include <stratosphere/os/os_timer_event.hpp>
 #include <stratosphere/os/os_thread_local_storage.hpp>
 #include <stratosphere/os/os_sdk_thread_local_storage.hpp>
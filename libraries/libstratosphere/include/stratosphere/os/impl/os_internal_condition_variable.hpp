@@ -20,6 +20,8 @@
 
 #if defined(ATMOSPHERE_OS_HORIZON)
     #include <stratosphere/os/impl/os_internal_condition_variable_impl.os.horizon.hpp>
+#elif defined(ATMOSPHERE_OS_LINUX)
+    #include <stratosphere/os/impl/os_internal_condition_variable_impl.os.linux.hpp>
 #else
     #error "Unknown OS for ams::os::impl::InternalConditionVariableImpl"
 #endif
@@ -19,6 +19,8 @@
 
 #if defined(ATMOSPHERE_OS_HORIZON)
     #include <stratosphere/os/impl/os_internal_critical_section_impl.os.horizon.hpp>
+#elif defined(ATMOSPHERE_OS_LINUX)
+    #include <stratosphere/os/impl/os_internal_critical_section_impl.os.linux.hpp>
 #else
     #error "Unknown OS for ams::os::impl::InternalCriticalSectionImpl"
 #endif
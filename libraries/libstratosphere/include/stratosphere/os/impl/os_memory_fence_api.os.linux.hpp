@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <vapours.hpp>
+
+namespace ams::os::impl {
+
+    ALWAYS_INLINE void FenceMemoryStoreStore() { std::atomic_thread_fence(std::memory_order_release); }
+    ALWAYS_INLINE void FenceMemoryStoreLoad()  { std::atomic_thread_fence(std::memory_order_seq_cst); }
+    ALWAYS_INLINE void FenceMemoryStoreAny()   { std::atomic_thread_fence(std::memory_order_seq_cst); }
+
+    ALWAYS_INLINE void FenceMemoryLoadStore()  { std::atomic_thread_fence(std::memory_order_acquire); }
+    ALWAYS_INLINE void FenceMemoryLoadLoad()   { std::atomic_thread_fence(std::memory_order_acquire); }
+    ALWAYS_INLINE void FenceMemoryLoadAny()    { std::atomic_thread_fence(std::memory_order_acquire); }
+
+    ALWAYS_INLINE void FenceMemoryAnyStore()   { std::atomic_thread_fence(std::memory_order_seq_cst); }
+    ALWAYS_INLINE void FenceMemoryAnyLoad()    { std::atomic_thread_fence(std::memory_order_seq_cst); }
+    ALWAYS_INLINE void FenceMemoryAnyAny()     { std::atomic_thread_fence(std::memory_order_seq_cst); }
+
+}
@@ -44,6 +44,7 @@ namespace ams::os {
 
     inline constexpr const ProcessId InvalidProcessId = ProcessId::Invalid;
 
+    #if defined(ATMOSPHERE_OS_HORIZON)
     NX_INLINE Result TryGetProcessId(os::ProcessId *out, ::Handle process_handle) {
         return svcGetProcessId(&out->value, process_handle);
     }
@@ -53,6 +54,10 @@ namespace ams::os {
         R_ABORT_UNLESS(TryGetProcessId(&process_id, process_handle));
         return process_id;
     }
+    #else
+    /* Host builds have no libnx, so handles are those of the svc abi (file descriptors, on linux). */
+    using Handle = svc::Handle;
+    #endif
 
     inline constexpr bool operator==(const ProcessId &lhs, const ProcessId &rhs) {
         return lhs.value == rhs.value;
@@ -18,6 +18,8 @@
 
 #if defined(ATMOSPHERE_OS_HORIZON)
     #include <stratosphere/os/impl/os_memory_fence_api.os.horizon.hpp>
+#elif defined(ATMOSPHERE_OS_LINUX)
+    #include <stratosphere/os/impl/os_memory_fence_api.os.linux.hpp>
 #else
     #error "Unknown os for os::MemoryFence*"
 #endif
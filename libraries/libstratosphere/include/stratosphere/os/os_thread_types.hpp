@@ -22,6 +22,10 @@
 #include <stratosphere/os/impl/os_internal_critical_section.hpp>
 #include <stratosphere/os/impl/os_internal_condition_variable.hpp>
 
+#if defined(ATMOSPHERE_OS_LINUX)
+    #include <pthread.h>
+#endif
+
 namespace ams::os {
 
     namespace impl {
@@ -32,8 +36,24 @@ namespace ams::os {
 
     using ThreadId = u64;
 
-    /* TODO */
-    using ThreadImpl = ::Thread;
+    #if defined(ATMOSPHERE_OS_HORIZON)
+        /* TODO */
+        using ThreadImpl = ::Thread;
+    #elif defined(ATMOSPHERE_OS_LINUX)
+        struct ThreadImpl {
+            pthread_t pthread;
+            u32 handle;
+            s32 cancel_handle;
+            u32 started;
+            u32 exited;
+            u32 suspended;
+            s32 priority;
+            s32 ideal_core;
+            u64 affinity_mask;
+        };
+    #else
+        #error "Unknown OS for ams::os::ThreadImpl"
+    #endif
 
     struct ThreadType {
         enum State {
@@ -21,20 +21,29 @@ namespace ams::os {
 
     struct WaitableHolderType;
     struct WaitableManagerType;
+    struct WaitableManagerRelayType;
 
     void InitializeWaitableManager(WaitableManagerType *manager);
     void FinalizeWaitableManager(WaitableManagerType *manager);
 
+    /* Relays keep the manager's handles in persistent groups of up to svc::ArgumentHandleCountMax, and may be attached whenever the manager isn't being waited on. */
+    /* The first relay is waited on by the thread calling WaitAny, takes no stack, and takes over the handles already linked. Each later relay waits on its group from a thread created on the given stack. */
+    /* Once every relay is full, linking another handle fails with os::ResultOutOfResource. Relays are destroyed by FinalizeWaitableManager. */
+    Result AttachWaitableManagerRelay(WaitableManagerType *manager, WaitableManagerRelayType *relay, void *stack, size_t stack_size, s32 priority);
+
     WaitableHolderType *WaitAny(WaitableManagerType *manager);
     WaitableHolderType *TryWaitAny(WaitableManagerType *manager);
     WaitableHolderType *TimedWaitAny(WaitableManagerType *manager, TimeSpan timeout);
 
     void FinalizeWaitableHolder(WaitableHolderType *holder);
 
+    Result TryLinkWaitableHolder(WaitableManagerType *manager, WaitableHolderType *holder);
     void LinkWaitableHolder(WaitableManagerType *manager, WaitableHolderType *holder);
     void UnlinkWaitableHolder(WaitableHolderType *holder);
     void UnlinkAllWaitableHolder(WaitableManagerType *manager);
 
+    /* Holders are moved in link order; on failure, those that did not fit stay linked to src. */
+    Result TryMoveAllWaitableHolder(WaitableManagerType *dst, WaitableManagerType *src);
     void MoveAllWaitableHolder(WaitableManagerType *dst, WaitableManagerType *src);
 
     void SetWaitableHolderUserData(WaitableHolderType *holder, uintptr_t user_data);
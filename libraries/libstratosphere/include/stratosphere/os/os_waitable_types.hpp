@@ -15,13 +15,16 @@
  */
 #pragma once
 #include <vapours.hpp>
+#include <stratosphere/os/os_thread_types.hpp>
 #include <stratosphere/os/impl/os_internal_critical_section.hpp>
+#include <stratosphere/os/impl/os_internal_condition_variable.hpp>
 
 namespace ams::os {
 
     namespace impl {
 
         class WaitableManagerImpl;
+        class WaitableManagerRelay;
         struct WaitableHolderImpl;
 
     }
@@ -34,12 +37,17 @@ namespace ams::os {
 
         u8 state;
         bool is_waiting;
-        util::TypedStorage<impl::WaitableManagerImpl, sizeof(util::IntrusiveListNode) + sizeof(impl::InternalCriticalSection) + 2 * sizeof(void *) + sizeof(Handle), alignof(void *)> impl_storage;
+        util::TypedStorage<impl::WaitableManagerImpl, 2 * sizeof(util::IntrusiveListNode) + sizeof(impl::InternalCriticalSection) + 3 * sizeof(void *) + sizeof(Handle), alignof(void *)> impl_storage;
     };
     static_assert(std::is_trivial<WaitableManagerType>::value);
 
+    struct WaitableManagerRelayType {
+        util::TypedStorage<impl::WaitableManagerRelay, util::AlignUp(sizeof(ThreadType) + 2 * sizeof(void *) + util::AlignUp(svc::ArgumentHandleCountMax * (sizeof(void *) + sizeof(Handle)) + sizeof(s32), alignof(void *)) + sizeof(Handle) + sizeof(impl::InternalCriticalSection) + sizeof(impl::InternalConditionVariable) + 5 * sizeof(bool), alignof(ThreadType)), alignof(ThreadType)> impl_storage;
+    };
+    static_assert(std::is_trivial<WaitableManagerRelayType>::value);
+
     struct WaitableHolderType {
-        util::TypedStorage<impl::WaitableHolderImpl, 2 * sizeof(util::IntrusiveListNode) + 3 * sizeof(void *), alignof(void *)> impl_storage;
+        util::TypedStorage<impl::WaitableHolderImpl, 3 * sizeof(util::IntrusiveListNode) + 3 * sizeof(void *), alignof(void *)> impl_storage;
         uintptr_t user_data;
     };
     static_assert(std::is_trivial<WaitableHolderType>::value);
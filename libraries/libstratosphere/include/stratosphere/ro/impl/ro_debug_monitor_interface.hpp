@@ -19,7 +19,8 @@
 #include <stratosphere/ro/ro_types.hpp>
 #include <stratosphere/sf.hpp>
 
-#define AMS_RO_I_DEBUG_MONITOR_INTERFACE_INTERFACE_INFO(C, H)                                                                                                                                          \
-    AMS_SF_METHOD_INFO(C, H, 0, Result, GetProcessModuleInfo, (sf::Out<u32> out_count, const sf::OutArray<LoaderModuleInfo> &out_infos, os::ProcessId process_id), (out_count, out_infos, process_id))
+#define AMS_RO_I_DEBUG_MONITOR_INTERFACE_INTERFACE_INFO(C, H)                                                                                                                                                            \
+    AMS_SF_METHOD_INFO(C, H,     0, Result, GetProcessModuleInfo,           (sf::Out<u32> out_count, const sf::OutArray<LoaderModuleInfo> &out_infos, os::ProcessId process_id), (out_count, out_infos, process_id)) \
+    AMS_SF_METHOD_INFO(C, H, 65000, void,   AtmosphereInvalidatePatchIndex, (),                                                                                                  ())
 
 AMS_SF_DEFINE_INTERFACE(ams::ro::impl, IDebugMonitorInterface, AMS_RO_I_DEBUG_MONITOR_INTERFACE_INTERFACE_INFO)
@@ -63,12 +63,54 @@ namespace ams::sf::cmif {
     };
     static_assert(util::is_pod<ServiceCommandMeta>::value && sizeof(ServiceCommandMeta) == 0x18, "sizeof(ServiceCommandMeta)");
 
+    struct ServiceCommandIndexSlot {
+        u32 cmd_id;
+        u16 entry_start;
+        u16 entry_count;
+    };
+    static_assert(util::is_pod<ServiceCommandIndexSlot>::value && sizeof(ServiceCommandIndexSlot) == 0x8, "sizeof(ServiceCommandIndexSlot)");
+
     namespace impl {
 
+        class ServiceCommandIndex {
+            private:
+                const ServiceCommandMeta *entries;
+                const u16 *entry_indices;
+                const ServiceCommandIndexSlot *slots;
+                u32 slot_count;
+                u32 hash_multiplier;
+            public:
+                constexpr ServiceCommandIndex(const ServiceCommandMeta *e, const u16 *ei, const ServiceCommandIndexSlot *s, u32 sc, u32 hm) : entries(e), entry_indices(ei), slots(s), slot_count(sc), hash_multiplier(hm) { /* ... */ }
+
+                static constexpr ALWAYS_INLINE u32 Hash(u32 cmd_id, u32 multiplier, u32 slot_count) {
+                    /* Multiplicative hashing, using the high bits of the product to select a slot. */
+                    return static_cast<u32>((static_cast<u64>(static_cast<u32>(cmd_id * multiplier)) * slot_count) >> BITSIZEOF(u32));
+                }
+
+                constexpr ALWAYS_INLINE const ServiceCommandMeta *Find(u32 cmd_id, hos::Version hosver) const {
+                    /* Find the slot for the command id. Tables are at most half full, so probing always terminates. */
+                    const u32 slot_mask = this->slot_count - 1;
+                    for (u32 slot = Hash(cmd_id, this->hash_multiplier, this->slot_count); this->slots[slot].entry_count != 0; slot = (slot + 1) & slot_mask) {
+                        if (this->slots[slot].cmd_id == cmd_id) {
+                            /* Resolve the version range, preferring entries in declaration order. */
+                            const u16 *indices = this->entry_indices + this->slots[slot].entry_start;
+                            for (size_t i = 0; i < this->slots[slot].entry_count; ++i) {
+                                const ServiceCommandMeta &entry = this->entries[indices[i]];
+                                if (entry.Matches(cmd_id, hosver)) {
+                                    return std::addressof(entry);
+                                }
+                            }
+                            return nullptr;
+                        }
+                    }
+                    return nullptr;
+                }
+        };
+
         class ServiceDispatchTableBase {
             protected:
-                Result ProcessMessageImpl(ServiceDispatchContext &ctx, const cmif::PointerAndSize &in_raw_data, const ServiceCommandMeta *entries, const size_t entry_count) const;
-                Result ProcessMessageForMitmImpl(ServiceDispatchContext &ctx, const cmif::PointerAndSize &in_raw_data, const ServiceCommandMeta *entries, const size_t entry_count) const;
+                Result ProcessMessageImpl(ServiceDispatchContext &ctx, const cmif::PointerAndSize &in_raw_data, const ServiceCommandIndex &cmd_index) const;
+                Result ProcessMessageForMitmImpl(ServiceDispatchContext &ctx, const cmif::PointerAndSize &in_raw_data, const ServiceCommandIndex &cmd_index) const;
             public:
                 /* CRTP. */
                 template<typename T>
@@ -88,17 +130,94 @@ namespace ams::sf::cmif {
         class ServiceDispatchTableImpl : public ServiceDispatchTableBase {
             public:
                 static constexpr size_t NumEntries = N;
+                static constexpr size_t NumSlots   = std::bit_ceil(std::max<size_t>(2 * N, 1));
+                static_assert(N <= std::numeric_limits<u16>::max());
+            private:
+                static constexpr size_t HashMultiplierCandidateCount = 0x40;
+
+                static constexpr u32 GetHashMultiplierCandidate(size_t i) {
+                    return (0x9E3779B1u + static_cast<u32>(i) * 0x6A09E666u) | 1;
+                }
             private:
                 const std::array<ServiceCommandMeta, N> entries;
+                std::array<u16, N> entry_indices;
+                std::array<ServiceCommandIndexSlot, NumSlots> slots;
+                u32 hash_multiplier;
+            private:
+                constexpr void BuildCommandIndex() {
+                    /* Group entry indices by command id, preserving declaration order within each group. */
+                    std::array<ServiceCommandIndexSlot, N> groups{};
+                    size_t num_groups = 0, num_indices = 0;
+                    for (size_t i = 0; i < N; ++i) {
+                        const u32 cmd_id = this->entries[i].cmd_id;
+
+                        bool seen = false;
+                        for (size_t j = 0; j < num_groups; ++j) {
+                            if (groups[j].cmd_id == cmd_id) {
+                                seen = true;
+                                break;
+                            }
+                        }
+                        if (seen) {
+                            continue;
+                        }
+
+                        groups[num_groups].cmd_id      = cmd_id;
+                        groups[num_groups].entry_start = static_cast<u16>(num_indices);
+                        for (size_t j = i; j < N; ++j) {
+                            if (this->entries[j].cmd_id == cmd_id) {
+                                this->entry_indices[num_indices++] = static_cast<u16>(j);
+                            }
+                        }
+                        groups[num_groups].entry_count = static_cast<u16>(num_indices - groups[num_groups].entry_start);
+                        ++num_groups;
+                    }
+
+                    /* Select the multiplier which produces the fewest collisions, ideally a perfect hash. */
+                    size_t best_collisions = std::numeric_limits<size_t>::max();
+                    for (size_t i = 0; i < HashMultiplierCandidateCount && best_collisions != 0; ++i) {
+                        const u32 multiplier = GetHashMultiplierCandidate(i);
+
+                        std::array<bool, NumSlots> used{};
+                        size_t collisions = 0;
+                        for (size_t j = 0; j < num_groups; ++j) {
+                            const u32 slot = ServiceCommandIndex::Hash(groups[j].cmd_id, multiplier, NumSlots);
+                            if (used[slot]) {
+                                ++collisions;
+                            }
+                            used[slot] = true;
+                        }
+
+                        if (collisions < best_collisions) {
+                            best_collisions       = collisions;
+                            this->hash_multiplier = multiplier;
+                        }
+                    }
+
+                    /* Populate the slots, resolving any remaining collisions by linear probing. */
+                    for (size_t i = 0; i < num_groups; ++i) {
+                        u32 slot = ServiceCommandIndex::Hash(groups[i].cmd_id, this->hash_multiplier, NumSlots);
+                        while (this->slots[slot].entry_count != 0) {
+                            slot = (slot + 1) & (NumSlots - 1);
+                        }
+                        this->slots[slot] = groups[i];
+                    }
+                }
+
+                constexpr ServiceCommandIndex GetCommandIndex() const {
+                    return ServiceCommandIndex(this->entries.data(), this->entry_indices.data(), this->slots.data(), NumSlots, this->hash_multiplier);
+                }
             public:
-                explicit constexpr ServiceDispatchTableImpl(const std::array<ServiceCommandMeta, N> &e) : entries{e} { /* ... */ }
+                explicit constexpr ServiceDispatchTableImpl(const std::array<ServiceCommandMeta, N> &e) : entries{e}, entry_indices{}, slots{}, hash_multiplier(GetHashMultiplierCandidate(0)) {
+                    this->BuildCommandIndex();
+                }
 
                 Result ProcessMessage(ServiceDispatchContext &ctx, const cmif::PointerAndSize &in_raw_data) const {
-                    return this->ProcessMessageImpl(ctx, in_raw_data, this->entries.data(), this->entries.size());
+                    return this->ProcessMessageImpl(ctx, in_raw_data, this->GetCommandIndex());
                 }
 
                 Result ProcessMessageForMitm(ServiceDispatchContext &ctx, const cmif::PointerAndSize &in_raw_data) const {
-                    return this->ProcessMessageForMitmImpl(ctx, in_raw_data, this->entries.data(), this->entries.size());
+                    return this->ProcessMessageForMitmImpl(ctx, in_raw_data, this->GetCommandIndex());
                 }
 
                 constexpr const std::array<ServiceCommandMeta, N> &GetEntries() const {
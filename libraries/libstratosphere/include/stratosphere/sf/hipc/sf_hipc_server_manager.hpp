@@ -29,6 +29,9 @@ namespace ams::sf::hipc {
     static constexpr size_t ServerSessionCountMax = 0x40;
     static_assert(ServerSessionCountMax == 0x40, "ServerSessionCountMax isn't 0x40 somehow, this assert is a reminder that this will break lots of things");
 
+    /* Each group of ServerSessionCountMax handles is waited on by a waitable manager relay; every relay but the first needs a thread. */
+    static constexpr size_t WaitableManagerRelayThreadStackSize = os::MemoryPageSize;
+
     template<size_t, typename, size_t>
     class ServerManager;
 
@@ -84,11 +87,17 @@ namespace ams::sf::hipc {
 
             os::Mutex waitlist_mutex;
             os::WaitableManagerType waitlist;
+
+            os::WaitableManagerRelayType *relays;
+            u8 *relay_thread_stacks;
+            size_t num_relays;
+            bool attached_relays;
         private:
             virtual void RegisterSessionToWaitList(ServerSession *session) override final;
             void RegisterToWaitList(os::WaitableHolderType *holder);
             void ProcessWaitList();
 
+            void AttachWaitableManagerRelays();
             bool WaitAndProcessImpl();
 
             Result ProcessForServer(os::WaitableHolderType *holder);
@@ -108,7 +117,7 @@ namespace ams::sf::hipc {
                     os::SetWaitableHolderUserData(server, static_cast<uintptr_t>(UserDataTag::Server));
                 }
 
-                os::LinkWaitableHolder(std::addressof(this->waitable_manager), server);
+                this->RegisterToWaitList(server);
             }
 
             void RegisterServerImpl(int index, cmif::ServiceObjectHolder &&static_holder, Handle port_handle, bool is_mitm_server) {
@@ -189,10 +198,11 @@ namespace ams::sf::hipc {
                 return ServerSessionManager::AcceptMitmSession(server->port_handle, std::move(p), std::move(forward_service));
             }
         public:
-            ServerManagerBase(DomainEntryStorage *entry_storage, size_t entry_count) :
+            ServerManagerBase(DomainEntryStorage *entry_storage, size_t entry_count, os::WaitableManagerRelayType *relay_storage, u8 *relay_thread_stack_storage, size_t relay_count) :
                 ServerDomainSessionManager(entry_storage, entry_count),
                 request_stop_event(os::EventClearMode_ManualClear), notify_event(os::EventClearMode_ManualClear),
-                waitable_selection_mutex(false), waitlist_mutex(false)
+                waitable_selection_mutex(false), waitlist_mutex(false),
+                relays(relay_storage), relay_thread_stacks(relay_thread_stack_storage), num_relays(relay_count), attached_relays(false)
             {
                 /* Link waitables. */
                 os::InitializeWaitableManager(std::addressof(this->waitable_manager));
@@ -243,9 +253,10 @@ namespace ams::sf::hipc {
         NON_COPYABLE(ServerManager);
         NON_MOVEABLE(ServerManager);
         static_assert(MaxServers  <= ServerSessionCountMax, "MaxServers can never be larger than ServerSessionCountMax (0x40).");
-        static_assert(MaxSessions <= ServerSessionCountMax, "MaxSessions can never be larger than ServerSessionCountMax (0x40).");
-        static_assert(MaxServers + MaxSessions <= ServerSessionCountMax, "MaxServers + MaxSessions can never be larger than ServerSessionCountMax (0x40).");
         private:
+            /* Servers and sessions beyond the first ServerSessionCountMax are waited on by relay threads. */
+            static constexpr size_t RelayCount = std::max<size_t>(util::DivideUp(MaxServers + MaxSessions, ServerSessionCountMax), 1);
+
             static constexpr inline bool DomainCountsValid = [] {
                 if constexpr (ManagerOptions::MaxDomains > 0) {
                     return ManagerOptions::MaxDomainObjects > 0;
@@ -273,6 +284,10 @@ namespace ams::sf::hipc {
             DomainStorage domain_storages[ManagerOptions::MaxDomains];
             bool domain_allocated[ManagerOptions::MaxDomains];
             DomainEntryStorage domain_entry_storages[ManagerOptions::MaxDomainObjects];
+
+            /* Waitable manager relays. */
+            os::WaitableManagerRelayType relay_storages[RelayCount];
+            alignas(os::ThreadStackAlignment) u8 relay_thread_stack_storages[RelayCount - 1][WaitableManagerRelayThreadStackSize];
         private:
             constexpr inline size_t GetServerIndex(const Server *server) const {
                 const size_t i = server - GetPointer(this->server_storages[0]);
@@ -370,7 +385,7 @@ namespace ams::sf::hipc {
                 return this->GetObjectBySessionIndex(session, this->saved_messages_start, hipc::TlsMessageBufferSize);
             }
         public:
-            ServerManager() : ServerManagerBase(this->domain_entry_storages, ManagerOptions::MaxDomainObjects), resource_mutex(false) {
+            ServerManager() : ServerManagerBase(this->domain_entry_storages, ManagerOptions::MaxDomainObjects, this->relay_storages, reinterpret_cast<u8 *>(this->relay_thread_stack_storages), RelayCount), resource_mutex(false) {
                 /* Clear storages. */
                 #define SF_SM_MEMCLEAR(obj) if constexpr (sizeof(obj) > 0) { std::memset(obj, 0, sizeof(obj)); }
                 SF_SM_MEMCLEAR(this->server_storages);
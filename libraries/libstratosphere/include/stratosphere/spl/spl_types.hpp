@@ -177,6 +177,13 @@ namespace ams::spl {
     };
     static_assert(alignof(IvCtr) == alignof(u8), "IvCtr definition!");
 
+    struct ComputeCtrRegion {
+        u64 offset;
+        u64 size;
+        IvCtr iv_ctr;
+    };
+    static_assert(sizeof(ComputeCtrRegion) == 0x20, "ComputeCtrRegion definition!");
+
     struct Cmac {
         union {
             u8 data[AES_128_KEY_SIZE];
@@ -25,4 +25,28 @@ namespace ams::util {
     /* Decompression utilities. */
     int DecompressLZ4(void *dst, size_t dst_size, const void *src, size_t src_size);
 
+    /* Framed compression utilities. */
+    /* A frame splits data into blocks which are compressed independently, and begins with an index of the blocks. */
+    /* This lets blocks be compressed and decompressed on several threads at once, and any one block be decompressed alone. */
+    constexpr inline size_t LZ4FrameBlockSizeMin     = 4_KB;
+    constexpr inline size_t LZ4FrameBlockSizeMax     = 4_MB;
+    constexpr inline size_t LZ4FrameBlockSizeDefault = 64_KB;
+    constexpr inline s32    LZ4FrameThreadCountMax   = 4;
+
+    struct LZ4FrameInfo {
+        size_t uncompressed_size;
+        size_t block_size;
+        s32 block_count;
+    };
+
+    /* Returns the dst_size needed to be sure that compressing src_size bytes of data succeeds. */
+    size_t GetCompressLZ4FrameBound(size_t src_size, size_t block_size);
+
+    /* thread_count includes the calling thread; extra threads only run on cores other than the caller's. */
+    bool CompressLZ4Frame(size_t *out_size, void *dst, size_t dst_size, const void *src, size_t src_size, size_t block_size, s32 thread_count);
+
+    bool GetLZ4FrameInfo(LZ4FrameInfo *out, const void *src, size_t src_size);
+    bool DecompressLZ4Frame(size_t *out_size, void *dst, size_t dst_size, const void *src, size_t src_size, s32 thread_count);
+    bool DecompressLZ4FrameBlock(size_t *out_size, void *dst, size_t dst_size, const void *src, size_t src_size, s32 block_index);
+
 }
\ No newline at end of file
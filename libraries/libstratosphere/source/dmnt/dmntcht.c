@@ -74,6 +74,28 @@ Result dmntchtResumeCheatProcess(void) {
     return _dmntchtCmdVoid(&g_dmntchtSrv, 65005);
 }
 
+Result dmntchtGetCheatVmSchedule(u32 *out_executions_per_second, DmntCheatVmScheduleMode *out_mode) {
+    struct {
+        u32 executions_per_second;
+        u32 mode;
+    } out;
+
+    Result rc = serviceDispatchOut(&g_dmntchtSrv, 65006, out);
+    if (R_SUCCEEDED(rc)) {
+        if (out_executions_per_second) *out_executions_per_second = out.executions_per_second;
+        if (out_mode) *out_mode = (DmntCheatVmScheduleMode)out.mode;
+    }
+    return rc;
+}
+
+Result dmntchtSetCheatVmSchedule(u32 executions_per_second, DmntCheatVmScheduleMode mode) {
+    const struct {
+        u32 executions_per_second;
+        u32 mode;
+    } in = { executions_per_second, (u32)mode };
+    return serviceDispatchIn(&g_dmntchtSrv, 65007, in);
+}
+
 static Result _dmntchtGetCount(u64 *out_count, u32 cmd_id) {
     return serviceDispatchOut(&g_dmntchtSrv, cmd_id, *out_count);
 }
@@ -194,3 +216,35 @@ Result dmntchtEnableFrozenAddress(u64 address, u64 width, u64 *out_value) {
 Result dmntchtDisableFrozenAddress(u64 address) {
     return serviceDispatchIn(&g_dmntchtSrv, 65304, address);
 }
+
+Result dmntchtGetFrozenAddressWriteStatistics(DmntFrozenAddressWriteStatistics *out) {
+    return serviceDispatchOut(&g_dmntchtSrv, 65305, *out);
+}
+
+Result dmntchtStartCheatSearch(const DmntCheatSearchParameters *params, u64 *out_count) {
+    return serviceDispatchInOut(&g_dmntchtSrv, 65400, *params, *out_count);
+}
+
+Result dmntchtContinueCheatSearch(const DmntCheatSearchParameters *params, u64 *out_count) {
+    return serviceDispatchInOut(&g_dmntchtSrv, 65401, *params, *out_count);
+}
+
+Result dmntchtGetCheatSearchStatus(DmntCheatSearchStatus *out) {
+    return serviceDispatchOut(&g_dmntchtSrv, 65402, *out);
+}
+
+Result dmntchtGetCheatSearchResults(DmntCheatSearchResult *buffer, u64 max_count, u64 offset, u64 *out_count) {
+    return _dmntchtGetEntries(buffer, sizeof(*buffer) * max_count, offset, out_count, 65403);
+}
+
+Result dmntchtResetCheatSearch(void) {
+    return _dmntchtCmdVoid(&g_dmntchtSrv, 65404);
+}
+
+Result dmntchtStartCheatPointerSearch(const DmntCheatPointerSearchParameters *params, u64 *out_count) {
+    return serviceDispatchInOut(&g_dmntchtSrv, 65405, *params, *out_count);
+}
+
+Result dmntchtGetCheatPointerSearchResults(DmntCheatPointerPath *buffer, u64 max_count, u64 offset, u64 *out_count) {
+    return _dmntchtGetEntries(buffer, sizeof(*buffer) * max_count, offset, out_count, 65406);
+}
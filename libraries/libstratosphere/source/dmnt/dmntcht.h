@@ -58,6 +58,75 @@ typedef struct {
     DmntFrozenAddressValue value;
 } DmntFrozenAddressEntry;
 
+typedef enum {
+    DmntCheatSearchValueType_U8  = 0,
+    DmntCheatSearchValueType_U16 = 1,
+    DmntCheatSearchValueType_U32 = 2,
+    DmntCheatSearchValueType_U64 = 3,
+    DmntCheatSearchValueType_S8  = 4,
+    DmntCheatSearchValueType_S16 = 5,
+    DmntCheatSearchValueType_S32 = 6,
+    DmntCheatSearchValueType_S64 = 7,
+    DmntCheatSearchValueType_F32 = 8,
+    DmntCheatSearchValueType_F64 = 9,
+} DmntCheatSearchValueType;
+
+typedef enum {
+    DmntCheatSearchCondition_Equal     = 0,
+    DmntCheatSearchCondition_Range     = 1,
+    DmntCheatSearchCondition_Changed   = 2,
+    DmntCheatSearchCondition_Unchanged = 3,
+    DmntCheatSearchCondition_Increased = 4,
+    DmntCheatSearchCondition_Decreased = 5,
+} DmntCheatSearchCondition;
+
+typedef struct {
+    u32 value_type;   ///< \ref DmntCheatSearchValueType
+    u32 condition;    ///< \ref DmntCheatSearchCondition
+    u64 value;        ///< Little-endian bit pattern of the value (or lower bound, for ranges).
+    u64 upper_value;  ///< Little-endian bit pattern of the upper bound, for ranges.
+} DmntCheatSearchParameters;
+
+typedef struct {
+    u64 result_count;
+    u32 value_type;
+    u32 scan_count;
+    bool truncated;
+    u8 reserved[7];
+} DmntCheatSearchStatus;
+
+typedef struct {
+    u64 address;
+    u64 value;
+} DmntCheatSearchResult;
+
+typedef struct {
+    u64 address;
+    u32 max_depth;
+    u32 max_offset;
+} DmntCheatPointerSearchParameters;
+
+#define DMNT_CHEAT_POINTER_PATH_DEPTH_MAX 4
+
+typedef struct {
+    u64 base_offset;  ///< Offset of the first pointer from the main nso's base.
+    u32 depth;
+    u32 reserved;
+    u64 offsets[DMNT_CHEAT_POINTER_PATH_DEPTH_MAX];
+} DmntCheatPointerPath;
+
+typedef struct {
+    u32 entry_count;    ///< Number of frozen addresses.
+    u32 write_count;    ///< Number of writes issued on the last tick.
+    s64 write_time_ns;  ///< Time spent writing on the last tick.
+    u64 tick_count;     ///< Number of ticks frozen addresses have been written on.
+} DmntFrozenAddressWriteStatistics;
+
+typedef enum {
+    DmntCheatVmScheduleMode_Periodic          = 0,
+    DmntCheatVmScheduleMode_FrameSynchronized = 1,
+} DmntCheatVmScheduleMode;
+
 Result dmntchtInitialize(void);
 void dmntchtExit(void);
 Service* dmntchtGetServiceSession(void);
@@ -74,6 +143,8 @@ Result dmntchtWriteCheatProcessMemory(u64 address, const void *buffer, size_t si
 Result dmntchtQueryCheatProcessMemory(MemoryInfo *mem_info, u64 address);
 Result dmntchtPauseCheatProcess(void);
 Result dmntchtResumeCheatProcess(void);
+Result dmntchtGetCheatVmSchedule(u32 *out_executions_per_second, DmntCheatVmScheduleMode *out_mode);
+Result dmntchtSetCheatVmSchedule(u32 executions_per_second, DmntCheatVmScheduleMode mode);
 
 Result dmntchtGetCheatCount(u64 *out_count);
 Result dmntchtGetCheats(DmntCheatEntry *buffer, u64 max_count, u64 offset, u64 *out_count);
@@ -90,6 +161,15 @@ Result dmntchtGetFrozenAddresses(DmntFrozenAddressEntry *buffer, u64 max_count,
 Result dmntchtGetFrozenAddress(DmntFrozenAddressEntry *out, u64 address);
 Result dmntchtEnableFrozenAddress(u64 address, u64 width, u64 *out_value);
 Result dmntchtDisableFrozenAddress(u64 address);
+Result dmntchtGetFrozenAddressWriteStatistics(DmntFrozenAddressWriteStatistics *out);
+
+Result dmntchtStartCheatSearch(const DmntCheatSearchParameters *params, u64 *out_count);
+Result dmntchtContinueCheatSearch(const DmntCheatSearchParameters *params, u64 *out_count);
+Result dmntchtGetCheatSearchStatus(DmntCheatSearchStatus *out);
+Result dmntchtGetCheatSearchResults(DmntCheatSearchResult *buffer, u64 max_count, u64 offset, u64 *out_count);
+Result dmntchtResetCheatSearch(void);
+Result dmntchtStartCheatPointerSearch(const DmntCheatPointerSearchParameters *params, u64 *out_count);
+Result dmntchtGetCheatPointerSearchResults(DmntCheatPointerPath *buffer, u64 max_count, u64 offset, u64 *out_count);
 
 #ifdef __cplusplus
 }
@@ -18,6 +18,7 @@
 #include "fsa/fs_directory_accessor.hpp"
 #include "fsa/fs_file_accessor.hpp"
 #include "fsa/fs_filesystem_accessor.hpp"
+#include "fs_binary_access_log.hpp"
 
 #define AMS_FS_IMPL_ACCESS_LOG_AMS_API_VERSION "ams_version: " STRINGIZE(ATMOSPHERE_RELEASE_VERSION_MAJOR) "." STRINGIZE(ATMOSPHERE_RELEASE_VERSION_MINOR) "." STRINGIZE(ATMOSPHERE_RELEASE_VERSION_MICRO)
 
@@ -65,6 +66,10 @@ namespace ams::fs {
         SetLocalAccessLogImpl(enabled);
     }
 
+    void SetLocalBinaryAccessLog(bool enabled) {
+        fs::impl::SetBinaryAccessLogEnabled(enabled);
+    }
+
     void SetLocalSystemAccessLogForDebug(bool enabled) {
         #if defined(AMS_BUILD_FOR_DEBUGGING)
             if (enabled) {
@@ -191,10 +196,6 @@ namespace ams::fs::impl {
             return g_access_log_manager_printer_callback_manager;
         }
 
-        const char *GetPriorityRawName(fs::impl::IdString &id_string) {
-            return id_string.ToString(fs::GetPriorityRawOnCurrentThreadInternal());
-        }
-
         Result OutputAccessLogToSdCardImpl(const char *log, size_t size) {
             /* Use libnx bindings. */
             return ::fsOutputAccessLogToSdCard(log, size);
@@ -288,6 +289,25 @@ namespace ams::fs::impl {
             OutputAccessLogImpl(log_buffer.get(), log_buffer_size);
         }
 
+        bool ShouldOutputBinaryAccessLog() {
+            /* Binary logs are only supported for output to the sd card. */
+            return fs::impl::IsBinaryAccessLogEnabled() && (g_global_access_log_mode & AccessLogMode_Log) == 0 && (g_global_access_log_mode & AccessLogMode_SdCard) != 0;
+        }
+
+        template<typename PriorityType> requires (std::same_as<PriorityType, fs::Priority> || std::same_as<PriorityType, fs::PriorityRaw>)
+        void OutputAccessLogWithPriority(Result result, PriorityType priority, os::Tick start, os::Tick end, const char *name, const void *handle, const char *format, std::va_list vl) {
+            /* Prefer to defer formatting to the binary log decoder. */
+            if (ShouldOutputBinaryAccessLog()) {
+                constexpr auto PriorityTypeValue = std::same_as<PriorityType, fs::Priority> ? BinaryAccessLogPriorityType_Priority : BinaryAccessLogPriorityType_PriorityRaw;
+                if (OutputBinaryAccessLog(result, PriorityTypeValue, static_cast<u8>(priority), start, end, name, handle, format, vl)) {
+                    return;
+                }
+            }
+
+            fs::impl::IdString id_string;
+            OutputAccessLog(result, id_string.ToString(priority), start, end, name, handle, format, vl);
+        }
+
         void GetProgramIndexFortAccessLog(u32 *out_index, u32 *out_count) {
             if (hos::GetVersion() >= hos::Version_7_0_0) {
                 /* Use libnx bindings if available. */
@@ -399,46 +419,42 @@ namespace ams::fs::impl {
     void OutputAccessLog(Result result, fs::Priority priority, os::Tick start, os::Tick end, const char *name, const void *handle, const char *fmt, ...) {
         std::va_list vl;
         va_start(vl, fmt);
-        OutputAccessLog(result, fs::impl::IdString().ToString(priority), start, end, name, handle, fmt, vl);
+        OutputAccessLogWithPriority(result, priority, start, end, name, handle, fmt, vl);
         va_end(vl);
     }
 
     void OutputAccessLog(Result result, fs::PriorityRaw priority_raw, os::Tick start, os::Tick end, const char *name, const void *handle, const char *fmt, ...){
         std::va_list vl;
         va_start(vl, fmt);
-        OutputAccessLog(result, fs::impl::IdString().ToString(priority_raw), start, end, name, handle, fmt, vl);
+        OutputAccessLogWithPriority(result, priority_raw, start, end, name, handle, fmt, vl);
         va_end(vl);
     }
 
     void OutputAccessLog(Result result, os::Tick start, os::Tick end, const char *name, fs::FileHandle handle, const char *fmt, ...) {
         std::va_list vl;
         va_start(vl, fmt);
-        fs::impl::IdString id_string;
-        OutputAccessLog(result, GetPriorityRawName(id_string), start, end, name, handle.handle, fmt, vl);
+        OutputAccessLogWithPriority(result, fs::GetPriorityRawOnCurrentThreadInternal(), start, end, name, handle.handle, fmt, vl);
         va_end(vl);
     }
 
     void OutputAccessLog(Result result, os::Tick start, os::Tick end, const char *name, fs::DirectoryHandle handle, const char *fmt, ...) {
         std::va_list vl;
         va_start(vl, fmt);
-        fs::impl::IdString id_string;
-        OutputAccessLog(result, GetPriorityRawName(id_string), start, end, name, handle.handle, fmt, vl);
+        OutputAccessLogWithPriority(result, fs::GetPriorityRawOnCurrentThreadInternal(), start, end, name, handle.handle, fmt, vl);
         va_end(vl);
     }
 
     void OutputAccessLog(Result result, os::Tick start, os::Tick end, const char *name, fs::impl::IdentifyAccessLogHandle handle, const char *fmt, ...) {
         std::va_list vl;
         va_start(vl, fmt);
-        fs::impl::IdString id_string;
-        OutputAccessLog(result, GetPriorityRawName(id_string), start, end, name, handle.handle, fmt, vl);
+        OutputAccessLogWithPriority(result, fs::GetPriorityRawOnCurrentThreadInternal(), start, end, name, handle.handle, fmt, vl);
         va_end(vl);
     }
 
     void OutputAccessLog(Result result, os::Tick start, os::Tick end, const char *name, const void *handle, const char *fmt, ...) {
         std::va_list vl;
         va_start(vl, fmt);
-        fs::impl::IdString id_string;
-        OutputAccessLog(result, GetPriorityRawName(id_string), start, end, name, handle, fmt, vl);
+        OutputAccessLogWithPriority(result, fs::GetPriorityRawOnCurrentThreadInternal(), start, end, name, handle, fmt, vl);
         va_end(vl);
     }
 
@@ -453,8 +469,7 @@ namespace ams::fs::impl {
         if (R_FAILED(result)) {
             std::va_list vl;
             va_start(vl, fmt);
-            fs::impl::IdString id_string;
-            OutputAccessLog(result, GetPriorityRawName(id_string), start, end, name, handle.handle, fmt, vl);
+            OutputAccessLogWithPriority(result, fs::GetPriorityRawOnCurrentThreadInternal(), start, end, name, handle.handle, fmt, vl);
             va_end(vl);
         }
     }
@@ -463,8 +478,7 @@ namespace ams::fs::impl {
         if (R_FAILED(result)) {
             std::va_list vl;
             va_start(vl, fmt);
-            fs::impl::IdString id_string;
-            OutputAccessLog(result, GetPriorityRawName(id_string), start, end, name, handle.handle, fmt, vl);
+            OutputAccessLogWithPriority(result, fs::GetPriorityRawOnCurrentThreadInternal(), start, end, name, handle.handle, fmt, vl);
             va_end(vl);
         }
     }
@@ -473,8 +487,7 @@ namespace ams::fs::impl {
         if (R_FAILED(result)) {
             std::va_list vl;
             va_start(vl, fmt);
-            fs::impl::IdString id_string;
-            OutputAccessLog(result, GetPriorityRawName(id_string), start, end, name, handle, fmt, vl);
+            OutputAccessLogWithPriority(result, fs::GetPriorityRawOnCurrentThreadInternal(), start, end, name, handle, fmt, vl);
             va_end(vl);
         }
     }
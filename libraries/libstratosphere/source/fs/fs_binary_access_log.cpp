@@ -0,0 +1,428 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "fs_binary_access_log.hpp"
+
+namespace ams::fs::impl {
+
+    namespace {
+
+        constexpr size_t RingRecordCount     = 0x80;
+        constexpr size_t RingCountMax        = 0x20;
+        constexpr size_t StringTableSize     = 0x200;
+        constexpr size_t ChunkRecordCountMax = 0x200;
+        constexpr size_t DrainThreadStackSize = 8_KB;
+        constexpr size_t ChunkBufferSize      = sizeof(BinaryAccessLogChunkHeader) + ChunkRecordCountMax * sizeof(BinaryAccessLogRecord);
+
+        constexpr TimeSpan DrainInterval = TimeSpan::FromMilliSeconds(100);
+
+        /* Each thread owns a ring, which only it pushes to and only the drain thread pops from. */
+        struct RecordRing {
+            std::atomic<u32> head;
+            std::atomic<u32> tail;
+            std::atomic<bool> in_use;
+            BinaryAccessLogRecord records[RingRecordCount];
+
+            bool Push(const BinaryAccessLogRecord &record) {
+                const u32 head = this->head.load(std::memory_order_relaxed);
+                const u32 tail = this->tail.load(std::memory_order_acquire);
+                if (head - tail >= RingRecordCount) {
+                    return false;
+                }
+
+                this->records[head % RingRecordCount] = record;
+                this->head.store(head + 1, std::memory_order_release);
+                return true;
+            }
+
+            size_t GetCount() const {
+                return this->head.load(std::memory_order_relaxed) - this->tail.load(std::memory_order_relaxed);
+            }
+
+            size_t Pop(BinaryAccessLogRecord *dst, size_t max_count) {
+                const u32 tail = this->tail.load(std::memory_order_relaxed);
+                const u32 head = this->head.load(std::memory_order_acquire);
+
+                const size_t count = std::min<size_t>(head - tail, max_count);
+                for (size_t i = 0; i < count; ++i) {
+                    dst[i] = this->records[(tail + i) % RingRecordCount];
+                }
+
+                this->tail.store(tail + count, std::memory_order_release);
+                return count;
+            }
+        };
+
+        constinit std::atomic_bool g_binary_access_log_enabled = false;
+
+        constinit std::atomic<RecordRing *> g_rings[RingCountMax] = {};
+        constinit std::atomic<size_t> g_ring_count = 0;
+        constinit std::atomic<u32> g_dropped_count = 0;
+
+        /* Function names and formats are static strings, so they are identified by address. */
+        /* An id may only be used once its definition record has been queued, so that the decoder always knows the string. */
+        enum StringState : u8 {
+            StringState_Undefined = 0,
+            StringState_Defining  = 1,
+            StringState_Defined   = 2,
+        };
+
+        constinit std::atomic<const char *> g_string_table[StringTableSize] = {};
+        constinit std::atomic<u8> g_string_states[StringTableSize] = {};
+
+        /* Nothing is set up until the first binary record, so that processes which never log pay nothing for it. */
+        constinit os::SdkMutex g_initialization_mutex;
+        constinit std::atomic_bool g_initialized = false;
+        constinit bool g_initialization_failed = false;
+        constinit os::TlsSlot g_ring_tls_slot;
+        constinit os::EventType g_drain_event;
+        constinit os::ThreadType g_drain_thread;
+
+        void ReleaseRing(uintptr_t arg) {
+            /* Release the thread's ring, so that a future thread can use it. */
+            if (RecordRing *ring = reinterpret_cast<RecordRing *>(arg); ring != nullptr) {
+                ring->in_use.store(false, std::memory_order_release);
+            }
+        }
+
+        void DrainThreadFunction(void *arg) {
+            u8 *chunk_buffer = static_cast<u8 *>(arg);
+
+            auto *header  = reinterpret_cast<BinaryAccessLogChunkHeader *>(chunk_buffer);
+            auto *records = reinterpret_cast<BinaryAccessLogRecord *>(chunk_buffer + sizeof(BinaryAccessLogChunkHeader));
+
+            const s64 tick_frequency = os::GetSystemTickFrequency();
+
+            while (true) {
+                /* Wait until a ring fills up, or until it's time to drain anyway. */
+                os::TimedWaitEvent(std::addressof(g_drain_event), DrainInterval);
+
+                /* Drain every ring, in batches as large as we can make them. */
+                bool has_records = true;
+                while (has_records) {
+                    size_t count = 0;
+                    const size_t ring_count = g_ring_count.load(std::memory_order_acquire);
+                    for (size_t i = 0; i < ring_count && count < ChunkRecordCountMax; ++i) {
+                        if (RecordRing *ring = g_rings[i].load(std::memory_order_acquire); ring != nullptr) {
+                            count += ring->Pop(records + count, ChunkRecordCountMax - count);
+                        }
+                    }
+
+                    const u32 dropped_count = g_dropped_count.exchange(0);
+                    if (count == 0 && dropped_count == 0) {
+                        break;
+                    }
+
+                    /* Output the chunk. */
+                    *header = {
+                        .magic          = BinaryAccessLogChunkMagic,
+                        .version        = BinaryAccessLogChunkVersion,
+                        .size           = static_cast<u32>(count * sizeof(BinaryAccessLogRecord)),
+                        .dropped_count  = dropped_count,
+                        .tick_frequency = tick_frequency,
+                    };
+
+                    ::fsOutputAccessLogToSdCard(reinterpret_cast<const char *>(chunk_buffer), sizeof(*header) + header->size);
+
+                    /* If the chunk was full, there may be more to drain. */
+                    has_records = (count == ChunkRecordCountMax);
+                }
+            }
+        }
+
+        bool EnsureInitialized() {
+            if (AMS_LIKELY(g_initialized.load(std::memory_order_acquire))) {
+                return true;
+            }
+
+            std::scoped_lock lk(g_initialization_mutex);
+
+            /* If we can't set up, accesses are logged as text instead. */
+            if (g_initialized.load(std::memory_order_relaxed)) {
+                return true;
+            } else if (g_initialization_failed) {
+                return false;
+            }
+            g_initialization_failed = true;
+
+            /* Allocate the drain thread's chunk buffer and stack; these are never freed, as the thread runs for the lifetime of the process. */
+            u8 *chunk_buffer = static_cast<u8 *>(fs::impl::Allocate(ChunkBufferSize));
+            if (chunk_buffer == nullptr) {
+                return false;
+            }
+            auto chunk_buffer_guard = SCOPE_GUARD { fs::impl::Deallocate(chunk_buffer, ChunkBufferSize); };
+
+            void *stack = fs::impl::Allocate(DrainThreadStackSize + os::ThreadStackAlignment);
+            if (stack == nullptr) {
+                return false;
+            }
+            auto stack_guard = SCOPE_GUARD { fs::impl::Deallocate(stack, DrainThreadStackSize + os::ThreadStackAlignment); };
+
+            /* Allocate the tls slot which holds each thread's ring. */
+            if (R_FAILED(os::SdkAllocateTlsSlot(std::addressof(g_ring_tls_slot), ReleaseRing))) {
+                return false;
+            }
+            auto tls_guard = SCOPE_GUARD { os::FreeTlsSlot(g_ring_tls_slot); };
+
+            /* Create the drain thread. */
+            os::InitializeEvent(std::addressof(g_drain_event), false, os::EventClearMode_AutoClear);
+            auto event_guard = SCOPE_GUARD { os::FinalizeEvent(std::addressof(g_drain_event)); };
+
+            if (R_FAILED(os::CreateThread(std::addressof(g_drain_thread), DrainThreadFunction, chunk_buffer, util::AlignUp(stack, os::ThreadStackAlignment), DrainThreadStackSize, os::LowestThreadPriority))) {
+                return false;
+            }
+            os::SetThreadNamePointer(std::addressof(g_drain_thread), "fs.AccessLogDrainer");
+            os::StartThread(std::addressof(g_drain_thread));
+
+            chunk_buffer_guard.Cancel();
+            stack_guard.Cancel();
+            tls_guard.Cancel();
+            event_guard.Cancel();
+
+            g_initialization_failed = false;
+            g_initialized.store(true, std::memory_order_release);
+            return true;
+        }
+
+        RecordRing *GetCurrentThreadRing() {
+            if (!EnsureInitialized()) {
+                return nullptr;
+            }
+
+            /* Check if the thread already has a ring. */
+            if (RecordRing *ring = reinterpret_cast<RecordRing *>(os::GetTlsValue(g_ring_tls_slot)); ring != nullptr) {
+                return ring;
+            }
+
+            RecordRing *ring = nullptr;
+
+            /* Try to reuse the ring of a thread which has exited. */
+            const size_t ring_count = g_ring_count.load(std::memory_order_acquire);
+            for (size_t i = 0; i < ring_count && ring == nullptr; ++i) {
+                if (RecordRing *candidate = g_rings[i].load(std::memory_order_acquire); candidate != nullptr) {
+                    bool expected = false;
+                    if (candidate->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                        ring = candidate;
+                    }
+                }
+            }
+
+            /* Otherwise, allocate a new ring. */
+            if (ring == nullptr) {
+                const size_t index = g_ring_count.fetch_add(1);
+                if (index >= RingCountMax) {
+                    g_ring_count.fetch_sub(1);
+                    return nullptr;
+                }
+
+                void *ring_storage = fs::impl::Allocate(sizeof(RecordRing));
+                if (ring_storage == nullptr) {
+                    /* Leave the slot empty; the drain thread skips it. */
+                    return nullptr;
+                }
+
+                ring = new (ring_storage) RecordRing{};
+                ring->in_use.store(true, std::memory_order_relaxed);
+                g_rings[index].store(ring, std::memory_order_release);
+            }
+
+            os::SetTlsValue(g_ring_tls_slot, reinterpret_cast<uintptr_t>(ring));
+            return ring;
+        }
+
+        bool PushRecord(RecordRing *ring, const BinaryAccessLogRecord &record) {
+            const bool pushed = ring->Push(record);
+            if (!pushed) {
+                g_dropped_count++;
+            }
+
+            /* Wake the drain thread early, if the ring is filling up. */
+            if (ring->GetCount() == RingRecordCount * 3 / 4) {
+                os::SignalEvent(std::addressof(g_drain_event));
+            }
+
+            return pushed;
+        }
+
+        u16 DefineString(RecordRing *ring, size_t index, const char *str) {
+            /* If the id is undefined, try to become the thread which defines it. */
+            u8 state = g_string_states[index].load(std::memory_order_acquire);
+            if (state == StringState_Undefined && g_string_states[index].compare_exchange_strong(state, StringState_Defining, std::memory_order_acquire)) {
+                BinaryAccessLogRecord record = {};
+                record.definition.type = BinaryAccessLogRecordType_Definition;
+                record.definition.id   = static_cast<u16>(index);
+                util::Strlcpy(record.definition.string, str, static_cast<int>(sizeof(record.definition.string)));
+
+                /* If the definition was dropped, the next use of the string will try again. */
+                state = PushRecord(ring, record) ? StringState_Defined : StringState_Undefined;
+                g_string_states[index].store(state, std::memory_order_release);
+            }
+
+            /* Ids being defined by another thread can't be used yet. */
+            return state == StringState_Defined ? static_cast<u16>(index) : BinaryAccessLogInvalidStringId;
+        }
+
+        u16 GetStringId(RecordRing *ring, const char *str) {
+            if (str == nullptr) {
+                return BinaryAccessLogInvalidStringId;
+            }
+
+            const size_t start = (reinterpret_cast<uintptr_t>(str) >> 3) % StringTableSize;
+            for (size_t i = 0; i < StringTableSize; ++i) {
+                const size_t index = (start + i) % StringTableSize;
+
+                /* Find the string's slot, or claim an empty one for it. */
+                const char *expected = nullptr;
+                if (g_string_table[index].compare_exchange_strong(expected, str) || expected == str) {
+                    return DefineString(ring, index, str);
+                }
+            }
+
+            return BinaryAccessLogInvalidStringId;
+        }
+
+        void CaptureArguments(BinaryAccessLogAccessRecord *out, const char *format, std::va_list vl) {
+            /* NOTE: This must consume arguments exactly as util::VSNPrintf would. */
+            size_t arg_count = 0;
+            size_t strings_size = 0;
+            ON_SCOPE_EXIT {
+                out->arg_count    = static_cast<u8>(arg_count);
+                out->strings_size = static_cast<u8>(strings_size);
+            };
+
+            if (format == nullptr) {
+                return;
+            }
+
+            auto StoreInteger = [&](u64 value) {
+                if (arg_count < BinaryAccessLogArgumentCountMax) {
+                    out->args[arg_count++] = value;
+                }
+            };
+
+            for (const char *cur = format; *cur != '\x00'; ++cur) {
+                if (*cur != '%') {
+                    continue;
+                }
+
+                /* Skip flags, width, and precision. */
+                ++cur;
+                while (*cur == '-' || *cur == '+' || *cur == ' ' || *cur == '#' || *cur == '0') {
+                    ++cur;
+                }
+                while (std::isdigit(static_cast<unsigned char>(*cur)) || *cur == '.') {
+                    ++cur;
+                }
+
+                /* Parse the length. */
+                bool is_64_bit = false;
+                switch (*cur) {
+                    case 'h':
+                        cur += (cur[1] == 'h') ? 2 : 1;
+                        break;
+                    case 'l':
+                        cur += (cur[1] == 'l') ? 2 : 1;
+                        is_64_bit = true;
+                        break;
+                    case 'z':
+                    case 'j':
+                    case 't':
+                        ++cur;
+                        is_64_bit = true;
+                        break;
+                    default:
+                        break;
+                }
+
+                /* Capture the argument. */
+                switch (*cur) {
+                    case 'd':
+                    case 'i':
+                        StoreInteger(is_64_bit ? static_cast<u64>(va_arg(vl, s64)) : static_cast<u64>(static_cast<s64>(va_arg(vl, int))));
+                        break;
+                    case 'u':
+                    case 'x':
+                    case 'X':
+                    case 'o':
+                    case 'b':
+                        StoreInteger(is_64_bit ? va_arg(vl, u64) : static_cast<u64>(va_arg(vl, unsigned int)));
+                        break;
+                    case 'c':
+                        StoreInteger(static_cast<u64>(va_arg(vl, int)));
+                        break;
+                    case 'p':
+                        StoreInteger(reinterpret_cast<uintptr_t>(va_arg(vl, void *)));
+                        break;
+                    case 's':
+                        {
+                            const char *str = va_arg(vl, const char *);
+                            if (str == nullptr) {
+                                str = "(null)";
+                            }
+
+                            if (strings_size < sizeof(out->strings)) {
+                                strings_size += util::Strlcpy(out->strings + strings_size, str, static_cast<int>(sizeof(out->strings) - strings_size)) + 1;
+                                strings_size  = std::min(strings_size, sizeof(out->strings));
+                            }
+                        }
+                        break;
+                    case '\x00':
+                        /* Malformed trailing specifier. */
+                        --cur;
+                        break;
+                    default:
+                        /* Includes "%%". */
+                        break;
+                }
+            }
+        }
+
+    }
+
+    void SetBinaryAccessLogEnabled(bool enabled) {
+        g_binary_access_log_enabled = enabled;
+    }
+
+    bool IsBinaryAccessLogEnabled() {
+        return g_binary_access_log_enabled;
+    }
+
+    bool OutputBinaryAccessLog(Result result, BinaryAccessLogPriorityType priority_type, u8 priority, os::Tick start, os::Tick end, const char *name, const void *handle, const char *format, std::va_list vl) {
+        /* Get the current thread's ring. */
+        RecordRing *ring = GetCurrentThreadRing();
+        if (ring == nullptr) {
+            return false;
+        }
+
+        /* Create the record. */
+        BinaryAccessLogRecord record = {};
+        record.access.type          = BinaryAccessLogRecordType_Access;
+        record.access.priority_type = priority_type;
+        record.access.priority      = priority;
+        record.access.result        = result.GetValue();
+        record.access.start_tick    = start.GetInt64Value();
+        record.access.end_tick      = end.GetInt64Value();
+        record.access.handle        = reinterpret_cast<uintptr_t>(handle);
+        record.access.name_id       = GetStringId(ring, name);
+        record.access.format_id     = GetStringId(ring, format);
+        CaptureArguments(std::addressof(record.access), format, vl);
+
+        /* Push it. */
+        PushRecord(ring, record);
+        return true;
+    }
+
+}
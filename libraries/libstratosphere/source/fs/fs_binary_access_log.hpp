@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+
+namespace ams::fs::impl {
+
+    /* Binary access logs are written as chunks, each a header followed by fixed-size records. */
+    /* Chunks may be interleaved with text lines in the output; utilities/fs_access_log.py decodes both. */
+    constexpr inline u32 BinaryAccessLogChunkMagic   = util::FourCC<'F','S','A','B'>::Code;
+    constexpr inline u32 BinaryAccessLogChunkVersion = 1;
+
+    struct BinaryAccessLogChunkHeader {
+        u32 magic;
+        u32 version;
+        u32 size;
+        u32 dropped_count;
+        s64 tick_frequency;
+    };
+    static_assert(util::is_pod<BinaryAccessLogChunkHeader>::value);
+    static_assert(sizeof(BinaryAccessLogChunkHeader) == 0x18);
+
+    enum BinaryAccessLogRecordType : u8 {
+        BinaryAccessLogRecordType_Access     = 1,
+        BinaryAccessLogRecordType_Definition = 2,
+    };
+
+    enum BinaryAccessLogPriorityType : u8 {
+        BinaryAccessLogPriorityType_Priority    = 0,
+        BinaryAccessLogPriorityType_PriorityRaw = 1,
+    };
+
+    constexpr inline u16    BinaryAccessLogInvalidStringId   = 0xFFFF;
+    constexpr inline size_t BinaryAccessLogArgumentCountMax  = 4;
+    constexpr inline size_t BinaryAccessLogStringsSize       = 0x38;
+    constexpr inline size_t BinaryAccessLogDefinitionSizeMax = 0x7C;
+
+    /* Records an access; its format string's arguments are stored in order, integers in args and strings in strings. */
+    struct BinaryAccessLogAccessRecord {
+        u8 type;
+        u8 priority_type;
+        u8 priority;
+        u8 reserved_03;
+        u32 result;
+        s64 start_tick;
+        s64 end_tick;
+        u64 handle;
+        u16 name_id;
+        u16 format_id;
+        u8 arg_count;
+        u8 strings_size;
+        u8 reserved_26[2];
+        u64 args[BinaryAccessLogArgumentCountMax];
+        char strings[BinaryAccessLogStringsSize];
+    };
+    static_assert(util::is_pod<BinaryAccessLogAccessRecord>::value);
+    static_assert(sizeof(BinaryAccessLogAccessRecord) == 0x80);
+
+    /* Defines the string (function name or format) referred to by an id in access records. */
+    struct BinaryAccessLogDefinitionRecord {
+        u8 type;
+        u8 reserved_01;
+        u16 id;
+        char string[BinaryAccessLogDefinitionSizeMax];
+    };
+    static_assert(util::is_pod<BinaryAccessLogDefinitionRecord>::value);
+    static_assert(sizeof(BinaryAccessLogDefinitionRecord) == sizeof(BinaryAccessLogAccessRecord));
+
+    union BinaryAccessLogRecord {
+        u8 type;
+        BinaryAccessLogAccessRecord access;
+        BinaryAccessLogDefinitionRecord definition;
+    };
+    static_assert(sizeof(BinaryAccessLogRecord) == 0x80);
+
+    void SetBinaryAccessLogEnabled(bool enabled);
+    bool IsBinaryAccessLogEnabled();
+
+    /* Returns false if the access could not be logged in binary form, in which case it should be logged as text. */
+    bool OutputBinaryAccessLog(Result result, BinaryAccessLogPriorityType priority_type, u8 priority, os::Tick start, os::Tick end, const char *name, const void *handle, const char *format, std::va_list vl);
+
+}
@@ -140,6 +140,138 @@ namespace ams::fssystem {
         return ResultSuccess();
     }
 
+    void BucketTree::NodeCache::Initialize(IAllocator *allocator, size_t node_size) {
+        AMS_ASSERT(allocator != nullptr);
+        AMS_ASSERT(this->node_count == 0);
+
+        std::scoped_lock lk(this->mutex);
+
+        /* Cache as many nodes as fit in our budget. Buffers are allocated when first needed. */
+        this->allocator  = allocator;
+        this->node_size  = node_size;
+        this->node_count = static_cast<s32>(std::min<size_t>(NodeCountMax, CacheSizeMax / node_size));
+
+        for (s32 i = 0; i < this->node_count; ++i) {
+            this->nodes[i].buffer    = nullptr;
+            this->nodes[i].key       = InvalidKey;
+            this->nodes[i].last_used = 0;
+        }
+
+        this->use_counter          = 0;
+        this->last_entry_set_index = -1;
+    }
+
+    void BucketTree::NodeCache::Finalize() {
+        std::scoped_lock lk(this->mutex);
+
+        for (s32 i = 0; i < this->node_count; ++i) {
+            if (this->nodes[i].buffer != nullptr) {
+                this->allocator->Deallocate(this->nodes[i].buffer, this->node_size);
+                this->nodes[i].buffer = nullptr;
+            }
+        }
+
+        this->allocator            = nullptr;
+        this->node_size            = 0;
+        this->node_count           = 0;
+        this->last_entry_set_index = -1;
+    }
+
+    void BucketTree::NodeCache::Invalidate() {
+        std::scoped_lock lk(this->mutex);
+
+        for (s32 i = 0; i < this->node_count; ++i) {
+            this->nodes[i].key = InvalidKey;
+        }
+
+        this->last_entry_set_index = -1;
+    }
+
+    BucketTree::NodeCache::CachedNode *BucketTree::NodeCache::FindNode(s64 key) {
+        for (s32 i = 0; i < this->node_count; ++i) {
+            if (this->nodes[i].key == key) {
+                return std::addressof(this->nodes[i]);
+            }
+        }
+        return nullptr;
+    }
+
+    template<typename F>
+    bool BucketTree::NodeCache::Access(Result *out, NodeKind kind, s32 index, F f) {
+        std::scoped_lock lk(this->mutex);
+
+        /* Find the node. */
+        CachedNode *node = this->FindNode(MakeKey(kind, index));
+        if (node == nullptr) {
+            return false;
+        }
+
+        /* Mark it as most recently used, and operate on it while we hold the lock. */
+        node->last_used = ++this->use_counter;
+        *out = f(static_cast<const char *>(node->buffer));
+        return true;
+    }
+
+    void BucketTree::NodeCache::Store(NodeKind kind, s32 index, const char *buffer) {
+        std::scoped_lock lk(this->mutex);
+
+        /* If we can't cache anything, there's nothing to do. */
+        if (this->node_count == 0) {
+            return;
+        }
+
+        /* If another visitor already cached the node, there's nothing to do. */
+        const s64 key = MakeKey(kind, index);
+        if (this->FindNode(key) != nullptr) {
+            return;
+        }
+
+        /* Choose a node to replace, preferring unused ones and otherwise the least recently used. */
+        CachedNode *node = std::addressof(this->nodes[0]);
+        for (s32 i = 0; i < this->node_count; ++i) {
+            CachedNode *cur = std::addressof(this->nodes[i]);
+            if (cur->key == InvalidKey) {
+                node = cur;
+                break;
+            }
+            if (static_cast<s32>(cur->last_used - node->last_used) < 0) {
+                node = cur;
+            }
+        }
+
+        /* Allocate a buffer for the node, if it doesn't have one. If we fail, we just won't cache it. */
+        if (node->buffer == nullptr) {
+            node->buffer = static_cast<char *>(this->allocator->Allocate(this->node_size, sizeof(s64)));
+            if (node->buffer == nullptr) {
+                return;
+            }
+        }
+
+        /* Copy the node. */
+        std::memcpy(node->buffer, buffer, this->node_size);
+        node->key       = key;
+        node->last_used = ++this->use_counter;
+    }
+
+    bool BucketTree::NodeCache::FindLastEntrySet(s32 *out_index, s64 virtual_address) const {
+        std::scoped_lock lk(this->mutex);
+
+        if (this->last_entry_set_index < 0 || virtual_address < this->last_entry_set_start || this->last_entry_set_end <= virtual_address) {
+            return false;
+        }
+
+        *out_index = this->last_entry_set_index;
+        return true;
+    }
+
+    void BucketTree::NodeCache::SetLastEntrySet(s32 index, s64 start, s64 end) {
+        std::scoped_lock lk(this->mutex);
+
+        this->last_entry_set_index = index;
+        this->last_entry_set_start = start;
+        this->last_entry_set_end   = end;
+    }
+
     Result BucketTree::Initialize(IAllocator *allocator, fs::SubStorage node_storage, fs::SubStorage entry_storage, size_t node_size, size_t entry_size, s32 entry_count) {
         /* Validate preconditions. */
         AMS_ASSERT(allocator != nullptr);
@@ -189,6 +321,9 @@ namespace ams::fssystem {
         this->start_offset    = start_offset;
         this->end_offset      = end_offset;
 
+        /* Set up our node cache. */
+        this->node_cache.Initialize(allocator, node_size);
+
         /* Cancel guard. */
         node_guard.Cancel();
         return ResultSuccess();
@@ -206,6 +341,7 @@ namespace ams::fssystem {
 
     void BucketTree::Finalize() {
         if (this->IsInitialized()) {
+            this->node_cache.Finalize();
             this->node_storage    = fs::SubStorage();
             this->entry_storage   = fs::SubStorage();
             this->node_l1.Free(this->node_size);
@@ -232,6 +368,9 @@ namespace ams::fssystem {
     }
 
     Result BucketTree::InvalidateCache() {
+        /* Invalidate our cached nodes. */
+        this->node_cache.Invalidate();
+
         /* Invalidate the node storage cache. */
         {
             s64 storage_size;
@@ -372,31 +511,37 @@ namespace ams::fssystem {
         R_UNLESS(virtual_address < node->GetEndOffset(), fs::ResultOutOfRange());
 
         /* Get the entry set index. */
+        /* If the address is in the entry set we're visiting, or in the one most recently found in the tree */
+        /* (as is typical of sequential access), we can skip searching the L1 and L2 nodes. */
         s32 entry_set_index = -1;
-        if (this->tree->IsExistOffsetL2OnL1() && virtual_address < node->GetBeginOffset()) {
-            const auto start = node->GetEnd();
-            const auto end   = node->GetBegin() + tree->offset_count;
+        if (this->IsValid() && this->entry_set.info.start <= virtual_address && virtual_address < this->entry_set.info.end) {
+            entry_set_index = this->entry_set.info.index;
+        } else if (!this->tree->node_cache.FindLastEntrySet(std::addressof(entry_set_index), virtual_address)) {
+            if (this->tree->IsExistOffsetL2OnL1() && virtual_address < node->GetBeginOffset()) {
+                const auto start = node->GetEnd();
+                const auto end   = node->GetBegin() + tree->offset_count;
 
-            auto pos = std::upper_bound(start, end, virtual_address);
-            R_UNLESS(start < pos, fs::ResultOutOfRange());
-            --pos;
+                auto pos = std::upper_bound(start, end, virtual_address);
+                R_UNLESS(start < pos, fs::ResultOutOfRange());
+                --pos;
 
-            entry_set_index = static_cast<s32>(pos - start);
-        } else {
-            const auto start = node->GetBegin();
-            const auto end   = node->GetEnd();
+                entry_set_index = static_cast<s32>(pos - start);
+            } else {
+                const auto start = node->GetBegin();
+                const auto end   = node->GetEnd();
 
-            auto pos = std::upper_bound(start, end, virtual_address);
-            R_UNLESS(start < pos, fs::ResultOutOfRange());
-            --pos;
+                auto pos = std::upper_bound(start, end, virtual_address);
+                R_UNLESS(start < pos, fs::ResultOutOfRange());
+                --pos;
 
-            if (this->tree->IsExistL2()) {
-                const auto node_index = static_cast<s32>(pos - start);
-                R_UNLESS(0 <= node_index && node_index < this->tree->offset_count, fs::ResultInvalidBucketTreeNodeOffset());
+                if (this->tree->IsExistL2()) {
+                    const auto node_index = static_cast<s32>(pos - start);
+                    R_UNLESS(0 <= node_index && node_index < this->tree->offset_count, fs::ResultInvalidBucketTreeNodeOffset());
 
-                R_TRY(this->FindEntrySet(std::addressof(entry_set_index), virtual_address, node_index));
-            } else {
-                entry_set_index = static_cast<s32>(pos - start);
+                    R_TRY(this->FindEntrySet(std::addressof(entry_set_index), virtual_address, node_index));
+                } else {
+                    entry_set_index = static_cast<s32>(pos - start);
+                }
             }
         }
 
@@ -406,6 +551,9 @@ namespace ams::fssystem {
         /* Find the entry. */
         R_TRY(this->FindEntry(virtual_address, entry_set_index));
 
+        /* Remember the entry set, so that nearby lookups can skip the search. */
+        this->tree->node_cache.SetLastEntrySet(this->entry_set.info.index, this->entry_set.info.start, this->entry_set.info.end);
+
         /* Set count. */
         this->entry_set_count = this->tree->entry_set_count;
         return ResultSuccess();
@@ -414,6 +562,11 @@ namespace ams::fssystem {
     Result BucketTree::Visitor::FindEntrySet(s32 *out_index, s64 virtual_address, s32 node_index) {
         const auto node_size = this->tree->node_size;
 
+        /* If we have the node cached, search it. */
+        if (Result result = ResultSuccess(); this->tree->node_cache.Access(std::addressof(result), NodeCache::NodeKind_Offset, node_index, [&](const char *buffer) { return this->FindEntrySetInBuffer(out_index, virtual_address, buffer); })) {
+            return result;
+        }
+
         PooledBuffer pool(node_size, 1);
         if (node_size <= pool.GetSize()) {
             return this->FindEntrySetWithBuffer(out_index, virtual_address, node_index, pool.GetBuffer());
@@ -437,6 +590,18 @@ namespace ams::fssystem {
         std::memcpy(std::addressof(header), buffer, NodeHeaderSize);
         R_TRY(header.Verify(node_index, node_size, sizeof(s64)));
 
+        /* Cache the node. */
+        this->tree->node_cache.Store(NodeCache::NodeKind_Offset, node_index, buffer);
+
+        /* Find. */
+        return this->FindEntrySetInBuffer(out_index, virtual_address, buffer);
+    }
+
+    Result BucketTree::Visitor::FindEntrySetInBuffer(s32 *out_index, s64 virtual_address, const char *buffer) {
+        /* Get the header, which has already been validated. */
+        NodeHeader header;
+        std::memcpy(std::addressof(header), buffer, NodeHeaderSize);
+
         /* Create the node, and find. */
         StorageNode node(sizeof(s64), header.count);
         node.Find(buffer, virtual_address);
@@ -471,6 +636,11 @@ namespace ams::fssystem {
     Result BucketTree::Visitor::FindEntry(s64 virtual_address, s32 entry_set_index) {
         const auto entry_set_size = this->tree->node_size;
 
+        /* If we have the entry set cached, search it. */
+        if (Result result = ResultSuccess(); this->tree->node_cache.Access(std::addressof(result), NodeCache::NodeKind_EntrySet, entry_set_index, [&](const char *buffer) { return this->FindEntryInBuffer(virtual_address, buffer); })) {
+            return result;
+        }
+
         PooledBuffer pool(entry_set_size, 1);
         if (entry_set_size <= pool.GetSize()) {
             return this->FindEntryWithBuffer(virtual_address, entry_set_index, pool.GetBuffer());
@@ -495,6 +665,20 @@ namespace ams::fssystem {
         std::memcpy(std::addressof(entry_set), buffer, sizeof(EntrySetHeader));
         R_TRY(entry_set.header.Verify(entry_set_index, entry_set_size, entry_size));
 
+        /* Cache the entry set. */
+        this->tree->node_cache.Store(NodeCache::NodeKind_EntrySet, entry_set_index, buffer);
+
+        /* Find. */
+        return this->FindEntryInBuffer(virtual_address, buffer);
+    }
+
+    Result BucketTree::Visitor::FindEntryInBuffer(s64 virtual_address, const char *buffer) {
+        /* Get the entry set, which has already been validated. */
+        const auto entry_size = this->tree->entry_size;
+
+        EntrySetHeader entry_set;
+        std::memcpy(std::addressof(entry_set), buffer, sizeof(EntrySetHeader));
+
         /* Create the node, and find. */
         StorageNode node(entry_size, entry_set.info.count);
         node.Find(buffer, virtual_address);
@@ -15,6 +15,7 @@
  */
 #include <stratosphere.hpp>
 #include "fssystem_hierarchical_sha256_storage.hpp"
+#include "fssystem_parallel_hash_verifier.hpp"
 
 namespace ams::fssystem {
 
@@ -88,42 +89,55 @@ namespace ams::fssystem {
         R_UNLESS(util::IsAligned(offset, this->hash_target_block_size), fs::ResultInvalidArgument());
         R_UNLESS(util::IsAligned(size,   this->hash_target_block_size), fs::ResultInvalidArgument());
 
-        /* Read the data. */
+        /* Determine the size to read. */
         const size_t reduced_size = static_cast<size_t>(std::min<s64>(this->base_storage_size, util::AlignUp(offset + size, this->hash_target_block_size) - offset));
-        R_TRY(this->base_storage->Read(offset, buffer, reduced_size));
 
         /* Temporarily increase our thread priority. */
         ScopedThreadPriorityChanger cp(+1, ScopedThreadPriorityChanger::Mode::Relative);
 
-        /* Setup tracking variables. */
-        auto cur_offset     = offset;
-        auto remaining_size = reduced_size;
-        while (remaining_size > 0) {
-            /* Generate the hash of the region we're validating. */
-            u8 hash[HashSize];
-            const auto cur_size = static_cast<size_t>(std::min<s64>(this->hash_target_block_size, remaining_size));
-            crypto::GenerateSha256Hash(hash, sizeof(hash), static_cast<u8 *>(buffer) + (cur_offset - offset), cur_size);
+        /* Hold the hash buffer for reading while we verify against it. */
+        std::shared_lock lk(this->mutex);
 
-            AMS_ASSERT(static_cast<size_t>(cur_offset >> this->log_size_ratio) < this->hash_buffer_size);
+        /* Read the data, verifying each part while reading the next. */
+        {
+            ParallelHashVerifier verifier(VerifyBlock, this, this->hash_target_block_size);
 
-            /* Check the hash. */
-            {
-                std::scoped_lock lk(this->mutex);
-                auto clear_guard = SCOPE_GUARD { std::memset(buffer, 0, size); };
+            /* Without a worker to verify one part while we read the next, splitting the read would only add overhead. */
+            const size_t pipeline_read_size = ParallelHashVerifier::IsParallelVerificationAvailable() ? std::max<size_t>(PipelineReadSize, this->hash_target_block_size) : reduced_size;
+            for (size_t read_size = 0; read_size < reduced_size; /* ... */) {
+                const size_t cur_size = std::min(pipeline_read_size, reduced_size - read_size);
+                u8 *cur_buffer = static_cast<u8 *>(buffer) + read_size;
 
-                R_UNLESS(crypto::IsSameBytes(hash, std::addressof(this->hash_buffer[cur_offset >> this->log_size_ratio]), HashSize), fs::ResultHierarchicalSha256HashVerificationFailed());
+                R_TRY(this->base_storage->Read(offset + static_cast<s64>(read_size), cur_buffer, cur_size));
+                verifier.Submit(offset + static_cast<s64>(read_size), cur_buffer, cur_size);
 
-                clear_guard.Cancel();
+                read_size += cur_size;
             }
 
-            /* Advance. */
-            cur_offset     += cur_size;
-            remaining_size -= cur_size;
+            /* Check the hashes. */
+            auto clear_guard = SCOPE_GUARD { std::memset(buffer, 0, size); };
+            R_TRY(verifier.Wait());
+            clear_guard.Cancel();
         }
 
         return ResultSuccess();
     }
 
+    Result HierarchicalSha256Storage::VerifyBlock(void *arg, s64 offset, u8 *block, size_t block_size) {
+        auto *storage = static_cast<HierarchicalSha256Storage *>(arg);
+
+        /* Generate the hash of the region we're validating. */
+        u8 hash[HashSize];
+        crypto::GenerateSha256Hash(hash, sizeof(hash), block, block_size);
+
+        AMS_ASSERT(static_cast<size_t>(offset >> storage->log_size_ratio) < storage->hash_buffer_size);
+
+        /* Check the hash. */
+        R_UNLESS(crypto::IsSameBytes(hash, std::addressof(storage->hash_buffer[offset >> storage->log_size_ratio]), HashSize), fs::ResultHierarchicalSha256HashVerificationFailed());
+
+        return ResultSuccess();
+    }
+
     Result HierarchicalSha256Storage::Write(s64 offset, const void *buffer, size_t size) {
         /* Succeed if zero-size. */
         R_SUCCEED_IF(size == 0);
@@ -24,8 +24,9 @@ namespace ams::fssystem {
         public:
             static constexpr s32 LayerCount  = 3;
             static constexpr size_t HashSize = crypto::Sha256Generator::HashSize;
+            static constexpr size_t PipelineReadSize = 256_KB;
         private:
-            os::Mutex mutex;
+            os::ReadWriteLock mutex;
             IStorage *base_storage;
             s64 base_storage_size;
             char *hash_buffer;
@@ -33,7 +34,7 @@ namespace ams::fssystem {
             s32 hash_target_block_size;
             s32 log_size_ratio;
         public:
-            HierarchicalSha256Storage() : mutex(false) { /* ... */ }
+            HierarchicalSha256Storage() : mutex() { /* ... */ }
 
             Result Initialize(IStorage **base_storages, s32 layer_count, size_t htbs, void *hash_buf, size_t hash_buf_size);
 
@@ -52,6 +53,8 @@ namespace ams::fssystem {
             virtual Result SetSize(s64 size) override {
                 return fs::ResultUnsupportedOperationInHierarchicalSha256StorageA();
             }
+        private:
+            static Result VerifyBlock(void *arg, s64 offset, u8 *block, size_t block_size);
     };
 
 }
@@ -516,6 +516,9 @@ namespace ams::fssystem {
                 /* Initialize the table storage. */
                 R_TRY(table_storage->Initialize(fs::SubStorage(decryptable_storage.get(), 0, raw_storage_size), this->buffer_manager, SparseTableCacheBlockSize, SparseTableCacheCount));
 
+                /* Bucket tree lookups read the table randomly, so don't read ahead. */
+                table_storage->SetReadAheadEnabled(false);
+
                 /* Determine storage extents. */
                 const auto node_offset = sparse_info.bucket.offset;
                 const auto node_size   = SparseStorage::QueryNodeStorageSize(header.entry_count);
@@ -711,6 +714,9 @@ namespace ams::fssystem {
         /* Initialize the buffered storage. */
         R_TRY(buffered_storage->Initialize(fs::SubStorage(table_storage.get(), 0, table_size), this->buffer_manager, AesCtrExTableCacheBlockSize, AesCtrExTableCacheCount));
 
+        /* Bucket tree lookups read the table randomly, so don't read ahead. */
+        buffered_storage->SetReadAheadEnabled(false);
+
         /* Create an aligned storage for the buffered storage. */
         using AlignedStorage = AlignmentMatchingStorage<NcaHeader::CtrBlockSize, 1>;
         std::unique_ptr aligned_storage = std::make_unique<AlignedStorage>(buffered_storage.get());
@@ -872,6 +878,9 @@ namespace ams::fssystem {
         /* Initialize the indirect table storage. */
         R_TRY(indirect_table_storage->Initialize(fs::SubStorage(base_storage.get(), indirect_data_size, node_size + entry_size), this->buffer_manager, IndirectTableCacheBlockSize, IndirectTableCacheCount));
 
+        /* Bucket tree lookups read the table randomly, so don't read ahead. */
+        indirect_table_storage->SetReadAheadEnabled(false);
+
         /* Create the indirect data storage. */
         std::unique_ptr indirect_data_storage = std::make_unique<save::BufferedStorage>();
         R_UNLESS(indirect_data_storage != nullptr, fs::ResultAllocationFailureInNew());
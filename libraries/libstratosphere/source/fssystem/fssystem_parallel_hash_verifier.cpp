@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "fssystem_parallel_hash_verifier.hpp"
+
+namespace ams::fssystem {
+
+    namespace {
+
+        constexpr size_t WorkerThreadStackSize = 8_KB;
+
+        /* NOTE: This guards the task queue and the state of every verifier's tasks. */
+        constinit os::SdkMutex g_task_mutex;
+        constinit os::SdkConditionVariable g_task_queue_cv;
+
+        constinit bool g_worker_threads_initialized = false;
+        constinit s32 g_worker_thread_count = 0;
+        constinit os::ThreadType g_worker_threads[ParallelHashVerifier::WorkerCountMax];
+
+        ParallelHashVerifier::TaskList g_task_queue;
+
+    }
+
+    ParallelHashVerifier::ParallelHashVerifier(VerifyFunction f, void *arg, size_t block_size) : function(f), argument(arg), block_size(block_size), tasks(), pending_count(0), cv(), result(ResultSuccess()) {
+        AMS_ASSERT(f != nullptr);
+        AMS_ASSERT(util::IsPowerOfTwo(block_size));
+
+        for (auto &task : this->tasks) {
+            task.verifier = this;
+        }
+    }
+
+    ParallelHashVerifier::~ParallelHashVerifier() {
+        /* Workers may still be using our tasks (and the caller's buffer), so wait for them to finish. */
+        this->Wait();
+    }
+
+    bool ParallelHashVerifier::EnsureWorkerThreadsStarted() {
+        std::scoped_lock lk(g_task_mutex);
+
+        if (!g_worker_threads_initialized) {
+            g_worker_threads_initialized = true;
+
+            /* Workers only help if they can run alongside the submitter, so place them on the other cores we may use. */
+            const s32 current_core = os::GetCurrentCoreNumber();
+            const u64 core_mask    = os::GetThreadAvailableCoreMask();
+            const s32 priority     = os::GetThreadPriority(os::GetCurrentThread());
+
+            for (s32 core = 0; core < static_cast<s32>(BITSIZEOF(core_mask)) && g_worker_thread_count < WorkerCountMax; ++core) {
+                if (core == current_core || (core_mask & (static_cast<u64>(1) << core)) == 0) {
+                    continue;
+                }
+
+                /* Allocate the stack; it is never freed, as the thread runs for the lifetime of the process. */
+                void *stack = fs::impl::Allocate(WorkerThreadStackSize + os::ThreadStackAlignment);
+                if (stack == nullptr) {
+                    break;
+                }
+
+                /* If we can't create a worker, make do with the ones we have. */
+                os::ThreadType *thread = std::addressof(g_worker_threads[g_worker_thread_count]);
+                if (R_FAILED(os::CreateThread(thread, WorkerThreadFunction, nullptr, util::AlignUp(stack, os::ThreadStackAlignment), WorkerThreadStackSize, priority, core))) {
+                    fs::impl::Deallocate(stack, WorkerThreadStackSize + os::ThreadStackAlignment);
+                    break;
+                }
+
+                os::SetThreadNamePointer(thread, "fssystem.HashVerifier");
+                os::StartThread(thread);
+
+                ++g_worker_thread_count;
+            }
+        }
+
+        return g_worker_thread_count > 0;
+    }
+
+    void ParallelHashVerifier::WorkerThreadFunction(void *arg) {
+        AMS_UNUSED(arg);
+
+        while (true) {
+            /* Take the oldest task. */
+            Task *task;
+            {
+                std::scoped_lock lk(g_task_mutex);
+
+                while (g_task_queue.empty()) {
+                    g_task_queue_cv.Wait(g_task_mutex);
+                }
+
+                task = std::addressof(g_task_queue.front());
+                g_task_queue.pop_front();
+                task->queued = false;
+            }
+
+            /* Verify it. */
+            ParallelHashVerifier *verifier = task->verifier;
+            const Result task_result = verifier->Verify(task->offset, task->data, task->size);
+
+            {
+                std::scoped_lock lk(g_task_mutex);
+                verifier->CompleteTask(task, task_result);
+            }
+        }
+    }
+
+    Result ParallelHashVerifier::Verify(s64 offset, u8 *data, size_t size) const {
+        /* Verify every block, even after a failure, as callers may handle failures block-by-block. */
+        Result first_result = ResultSuccess();
+
+        size_t verified_size = 0;
+        while (verified_size < size) {
+            const size_t cur_size = std::min(this->block_size, size - verified_size);
+
+            const Result cur_result = this->function(this->argument, offset + static_cast<s64>(verified_size), data + verified_size, cur_size);
+            if (R_FAILED(cur_result) && R_SUCCEEDED(first_result)) {
+                first_result = cur_result;
+            }
+
+            verified_size += cur_size;
+        }
+
+        return first_result;
+    }
+
+    ParallelHashVerifier::Task *ParallelHashVerifier::AllocateTask() {
+        /* NOTE: This must be called with g_task_mutex held. */
+        for (auto &task : this->tasks) {
+            if (!task.in_use) {
+                task.in_use = true;
+                ++this->pending_count;
+                return std::addressof(task);
+            }
+        }
+        return nullptr;
+    }
+
+    ParallelHashVerifier::Task *ParallelHashVerifier::FindQueuedTask() {
+        /* NOTE: This must be called with g_task_mutex held. */
+        for (auto &task : this->tasks) {
+            if (task.queued) {
+                return std::addressof(task);
+            }
+        }
+        return nullptr;
+    }
+
+    void ParallelHashVerifier::CompleteTask(Task *task, Result task_result) {
+        /* NOTE: This must be called with g_task_mutex held. */
+        this->UpdateResult(task_result);
+
+        task->in_use = false;
+        if ((--this->pending_count) == 0) {
+            this->cv.Broadcast();
+        }
+    }
+
+    void ParallelHashVerifier::UpdateResult(Result r) {
+        /* NOTE: This must be called with g_task_mutex held. */
+        if (R_FAILED(r) && R_SUCCEEDED(this->result)) {
+            this->result = r;
+        }
+    }
+
+    void ParallelHashVerifier::Submit(s64 offset, u8 *data, size_t size) {
+        AMS_ASSERT(util::IsAligned(offset, this->block_size));
+
+        /* Split the data into tasks of whole blocks. */
+        const size_t task_size = std::max(TaskSize, this->block_size);
+
+        /* If the data wouldn't be split, or we have no workers, there's nothing to gain by queueing it. */
+        if (size <= task_size || !EnsureWorkerThreadsStarted()) {
+            const Result verify_result = this->Verify(offset, data, size);
+
+            std::scoped_lock lk(g_task_mutex);
+            this->UpdateResult(verify_result);
+            return;
+        }
+
+        size_t submitted_size = 0;
+        while (submitted_size < size) {
+            const size_t cur_size = std::min(task_size, size - submitted_size);
+
+            /* Queue a task, if we have one free. */
+            bool queued = false;
+            {
+                std::scoped_lock lk(g_task_mutex);
+
+                if (Task *task = this->AllocateTask(); task != nullptr) {
+                    task->offset = offset + static_cast<s64>(submitted_size);
+                    task->data   = data + submitted_size;
+                    task->size   = cur_size;
+                    task->queued = true;
+
+                    g_task_queue.push_back(*task);
+                    g_task_queue_cv.Signal();
+
+                    queued = true;
+                }
+            }
+
+            /* Otherwise, there's plenty of work in flight already; do this part ourselves. */
+            if (!queued) {
+                const Result verify_result = this->Verify(offset + static_cast<s64>(submitted_size), data + submitted_size, cur_size);
+
+                std::scoped_lock lk(g_task_mutex);
+                this->UpdateResult(verify_result);
+            }
+
+            submitted_size += cur_size;
+        }
+    }
+
+    Result ParallelHashVerifier::Wait() {
+        std::unique_lock lk(g_task_mutex);
+
+        while (this->pending_count > 0) {
+            /* Verify any of our tasks which the workers haven't gotten to. */
+            if (Task *task = this->FindQueuedTask(); task != nullptr) {
+                g_task_queue.erase(g_task_queue.iterator_to(*task));
+                task->queued = false;
+
+                lk.unlock();
+                const Result task_result = this->Verify(task->offset, task->data, task->size);
+                lk.lock();
+
+                this->CompleteTask(task, task_result);
+            } else {
+                this->cv.Wait(g_task_mutex);
+            }
+        }
+
+        /* Return our result, resetting it for any further submissions. */
+        const Result wait_result = this->result;
+        this->result = ResultSuccess();
+        return wait_result;
+    }
+
+}
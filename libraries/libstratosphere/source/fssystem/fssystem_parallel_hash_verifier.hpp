@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+
+namespace ams::fssystem {
+
+    /* Verifies the blocks of a read on a small pool of worker threads shared by the process. */
+    /* Data is submitted as it is read, so verification of one part overlaps with reading the next. */
+    /* Parts which no worker has picked up when the submitter waits are verified by the submitter. */
+    class ParallelHashVerifier {
+        NON_COPYABLE(ParallelHashVerifier);
+        NON_MOVEABLE(ParallelHashVerifier);
+        public:
+            /* Verifies a single block, which may be shorter than the block size if it is the last one. */
+            using VerifyFunction = Result (*)(void *arg, s64 offset, u8 *block, size_t block_size);
+
+            static constexpr size_t TaskSize       = 64_KB;
+            static constexpr s32    TaskCountMax   = 8;
+            static constexpr s32    WorkerCountMax = 2;
+
+            struct Task : public util::IntrusiveListBaseNode<Task> {
+                ParallelHashVerifier *verifier;
+                s64 offset;
+                u8 *data;
+                size_t size;
+                bool in_use;
+                bool queued;
+            };
+
+            using TaskList = util::IntrusiveListBaseTraits<Task>::ListType;
+        private:
+            VerifyFunction function;
+            void *argument;
+            size_t block_size;
+            Task tasks[TaskCountMax];
+            s32 pending_count;
+            os::SdkConditionVariable cv;
+            Result result;
+        public:
+            ParallelHashVerifier(VerifyFunction f, void *arg, size_t block_size);
+            ~ParallelHashVerifier();
+
+            /* Verifies the blocks of data, whose first block is at offset. */
+            void Submit(s64 offset, u8 *data, size_t size);
+
+            /* Waits for all submitted data to be verified, returning the first failure since the last wait (if any). */
+            Result Wait();
+
+            /* Returns whether any worker can verify data alongside the submitter; if not, submitted data is verified as it is submitted. */
+            static bool IsParallelVerificationAvailable() { return EnsureWorkerThreadsStarted(); }
+        private:
+            Result Verify(s64 offset, u8 *data, size_t size) const;
+            Task *AllocateTask();
+            Task *FindQueuedTask();
+            void CompleteTask(Task *task, Result task_result);
+            void UpdateResult(Result r);
+        private:
+            static bool EnsureWorkerThreadsStarted();
+            static void WorkerThreadFunction(void *arg);
+    };
+
+}
@@ -580,7 +580,7 @@ namespace ams::fssystem::save {
             }
     };
 
-    BufferedStorage::BufferedStorage() : base_storage(), buffer_manager(), block_size(), base_storage_size(), caches(), cache_count(), next_acquire_cache(), next_fetch_cache(), mutex(false), bulk_read_enabled() {
+    BufferedStorage::BufferedStorage() : base_storage(), buffer_manager(), block_size(), base_storage_size(), caches(), cache_count(), next_acquire_cache(), next_fetch_cache(), mutex(false), bulk_read_enabled(), read_ahead_enabled(true), read_ahead_block_count(), read_ahead_last_offset(InvalidOffset), read_ahead_next_offset(InvalidOffset) {
         /* ... */
     }
 
@@ -622,6 +622,9 @@ namespace ams::fssystem::save {
         this->caches.reset();
         this->cache_count = 0;
         this->next_fetch_cache = nullptr;
+        this->read_ahead_block_count = 0;
+        this->read_ahead_last_offset = InvalidOffset;
+        this->read_ahead_next_offset = InvalidOffset;
     }
 
     Result BufferedStorage::Read(s64 offset, void *buffer, size_t size) {
@@ -774,6 +777,9 @@ namespace ams::fssystem::save {
         s64 cur_offset        = offset;
         s64 buf_offset        = 0;
 
+        /* Determine how far to read ahead, if the access is sequential. */
+        const s32 read_ahead_block_count = this->UpdateReadAheadWindow(offset, remaining_size);
+
         /* Determine what caches are needed, if we have bulk read set. */
         if (this->bulk_read_enabled) {
             /* Check head cache. */
@@ -821,15 +827,28 @@ namespace ams::fssystem::save {
                 SharedCache cache(this);
                 if (!cache.AcquireNextOverlappedCache(cur_offset, cur_size)) {
                     R_TRY(this->PrepareAllocation());
-                    while (true) {
-                        R_UNLESS(cache.AcquireFetchableCache(), fs::ResultOutOfResource());
 
-                        UniqueCache fetch_cache(this);
-                        const auto upgrade_result = fetch_cache.Upgrade(cache);
-                        R_TRY(upgrade_result.first);
-                        if (upgrade_result.second) {
-                            R_TRY(fetch_cache.Fetch(cur_offset));
-                            break;
+                    /* If the access is sequential, fill this cache and the ones after it with a single read. */
+                    bool fetched = false;
+                    if (read_ahead_block_count > 1) {
+                        R_TRY_CATCH(this->ReadAhead(cur_offset, read_ahead_block_count)) {
+                            R_CATCH(fs::ResultAllocationFailurePooledBufferNotEnoughSize) { /* Fall back to fetching just this cache. */ }
+                        } R_END_TRY_CATCH;
+
+                        fetched = cache.AcquireNextOverlappedCache(cur_offset, cur_size);
+                    }
+
+                    if (!fetched) {
+                        while (true) {
+                            R_UNLESS(cache.AcquireFetchableCache(), fs::ResultOutOfResource());
+
+                            UniqueCache fetch_cache(this);
+                            const auto upgrade_result = fetch_cache.Upgrade(cache);
+                            R_TRY(upgrade_result.first);
+                            if (upgrade_result.second) {
+                                R_TRY(fetch_cache.Fetch(cur_offset));
+                                break;
+                            }
                         }
                     }
                     R_TRY(this->ControlDirtiness());
@@ -1007,6 +1026,79 @@ namespace ams::fssystem::save {
         return ResultSuccess();
     }
 
+    s32 BufferedStorage::UpdateReadAheadWindow(s64 offset, size_t size) {
+        std::scoped_lock lk(this->mutex);
+
+        /* Read ahead by at most half of our caches, so that we don't evict everything else. */
+        const s32 block_count_max = std::min(this->cache_count / 2, static_cast<s32>(ReadAheadSizeMax / this->block_size));
+
+        /* A read which starts after the start of the previous one, and no later than its end, continues a sequential access. */
+        if (this->read_ahead_enabled && block_count_max > 1 && this->read_ahead_last_offset < offset && offset <= this->read_ahead_next_offset) {
+            /* Grow the window each time the access continues. */
+            this->read_ahead_block_count = std::min(std::max(this->read_ahead_block_count * 2, 2), block_count_max);
+        } else {
+            this->read_ahead_block_count = 0;
+        }
+
+        this->read_ahead_last_offset = offset;
+        this->read_ahead_next_offset = offset + static_cast<s64>(size);
+
+        return this->read_ahead_block_count;
+    }
+
+    bool BufferedStorage::IsCached(s64 offset) {
+        std::scoped_lock lk(this->mutex);
+
+        /* NOTE: This includes caches which are currently acquired, and so are not in the fetch list. */
+        for (s32 i = 0; i < this->cache_count; ++i) {
+            if (this->caches[i].IsValid() && this->caches[i].Hits(offset, 1)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    Result BufferedStorage::ReadAhead(s64 offset, s32 block_count) {
+        AMS_ASSERT(block_count > 0);
+
+        /* Determine the extents. */
+        const s64 ahead_offset = util::AlignDown(offset, this->block_size);
+        s64 ahead_offset_end   = std::min(ahead_offset + block_count * static_cast<s64>(this->block_size), this->base_storage_size);
+
+        /* Allocate a work buffer, reading ahead only as far as it allows. */
+        PooledBuffer pooled_buffer(static_cast<size_t>(ahead_offset_end - ahead_offset), this->block_size);
+        R_UNLESS(pooled_buffer.GetSize() >= this->block_size, fs::ResultAllocationFailurePooledBufferNotEnoughSize());
+        ahead_offset_end = std::min(ahead_offset_end, ahead_offset + static_cast<s64>(util::AlignDown(pooled_buffer.GetSize(), this->block_size)));
+
+        /* Read from the base storage. */
+        char *work_buffer = pooled_buffer.GetBuffer();
+        R_TRY(this->base_storage.Read(ahead_offset, work_buffer, static_cast<size_t>(ahead_offset_end - ahead_offset)));
+
+        /* Fill the caches for each block which isn't already cached. */
+        /* Cached blocks may be dirty, so we must not replace them with what we read. */
+        for (s64 cur_offset = ahead_offset; cur_offset < ahead_offset_end; cur_offset += this->block_size) {
+            if (this->IsCached(cur_offset)) {
+                continue;
+            }
+
+            SharedCache cache(this);
+            while (true) {
+                R_UNLESS(cache.AcquireFetchableCache(), fs::ResultOutOfResource());
+
+                UniqueCache fetch_cache(this);
+                const auto upgrade_result = fetch_cache.Upgrade(cache);
+                R_TRY(upgrade_result.first);
+                if (upgrade_result.second) {
+                    R_TRY(fetch_cache.FetchFromBuffer(cur_offset, work_buffer + (cur_offset - ahead_offset), static_cast<size_t>(ahead_offset_end - cur_offset)));
+                    break;
+                }
+            }
+        }
+
+        return ResultSuccess();
+    }
+
     Result BufferedStorage::WriteCore(s64 offset, const void *buffer, size_t size) {
         AMS_ASSERT(this->caches != nullptr);
         AMS_ASSERT(buffer != nullptr);
@@ -14,6 +14,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <stratosphere.hpp>
+#include "../fssystem_parallel_hash_verifier.hpp"
 
 namespace ams::fssystem::save {
 
@@ -103,59 +104,77 @@ namespace ams::fssystem::save {
             read_size = static_cast<size_t>(data_size - offset);
         }
 
-        /* Perform the read. */
-        {
-            auto clear_guard = SCOPE_GUARD { std::memset(buffer, 0, size); };
-            R_TRY(this->data_storage.Read(offset, buffer, read_size));
-            clear_guard.Cancel();
-        }
-
         /* Prepare to validate the signatures. */
         const auto signature_count = size >> this->verification_block_order;
         PooledBuffer signature_buffer(signature_count * sizeof(BlockHash), sizeof(BlockHash));
         const auto buffer_count = std::min(signature_count, signature_buffer.GetSize() / sizeof(BlockHash));
 
-        /* Verify the signatures. */
-        Result verify_hash_result = ResultSuccess();
-
-        size_t verified_count = 0;
-        while (verified_count < signature_count) {
-            /* Read the current signatures. */
-            const auto cur_count = std::min(buffer_count, signature_count - verified_count);
-            auto cur_result = this->ReadBlockSignature(signature_buffer.GetBuffer(), signature_buffer.GetSize(), offset + (verified_count << this->verification_block_order), cur_count << this->verification_block_order);
+        /* Split the signature buffer in two if we can, so that we can read one batch while verifying the other. */
+        constexpr s32 SlotCountMax = 2;
+        const s32 slot_count   = buffer_count >= SlotCountMax ? SlotCountMax : 1;
+        const auto batch_count = std::min(buffer_count / slot_count, std::max<size_t>(1, PipelineReadSize >> this->verification_block_order));
 
-            /* Temporarily increase our priority. */
-            ScopedThreadPriorityChanger cp(+1, ScopedThreadPriorityChanger::Mode::Relative);
+        BlockHash *signatures = reinterpret_cast<BlockHash *>(signature_buffer.GetBuffer());
+        VerificationContext contexts[SlotCountMax] = {
+            { this, signatures,               0 },
+            { this, signatures + batch_count, 0 },
+        };
 
-            /* Loop over each signature we read. */
-            for (size_t i = 0; i < cur_count && R_SUCCEEDED(cur_result); ++i) {
-                const auto verified_size = (verified_count + i) << this->verification_block_order;
-                u8 *cur_buf = static_cast<u8 *>(buffer) + verified_size;
-                cur_result = this->VerifyHash(cur_buf, reinterpret_cast<BlockHash *>(signature_buffer.GetBuffer()) + i);
+        /* If we fail, clear the buffer. */
+        /* NOTE: This is declared before the verifiers, so that it runs after they have finished with the buffer. */
+        auto clear_guard = SCOPE_GUARD { std::memset(buffer, 0, size); };
 
-                /* If the data is corrupted, clear the corrupted parts. */
-                if (fs::ResultIntegrityVerificationStorageCorrupted::Includes(cur_result)) {
-                    std::memset(cur_buf, 0, this->verification_block_size);
+        /* Temporarily increase our priority. */
+        ScopedThreadPriorityChanger cp(+1, ScopedThreadPriorityChanger::Mode::Relative);
 
-                    /* Set the result if we should. */
-                    if (!fs::ResultClearedRealDataVerificationFailed::Includes(cur_result) && this->storage_type != fs::StorageType_Authoring) {
-                        verify_hash_result = cur_result;
-                    }
+        ParallelHashVerifier verifier_0(VerifyBlock, std::addressof(contexts[0]), static_cast<size_t>(this->verification_block_size));
+        ParallelHashVerifier verifier_1(VerifyBlock, std::addressof(contexts[1]), static_cast<size_t>(this->verification_block_size));
+        ParallelHashVerifier * const verifiers[SlotCountMax] = { std::addressof(verifier_0), std::addressof(verifier_1) };
 
-                    cur_result = ResultSuccess();
-                }
+        /* Corrupted blocks are cleared as they are verified; we note the failure, and continue. */
+        Result verify_hash_result = ResultSuccess();
+        auto wait_verification = [&](ParallelHashVerifier *verifier) -> Result {
+            const Result result = verifier->Wait();
+            if (R_FAILED(result)) {
+                R_UNLESS(fs::ResultIntegrityVerificationStorageCorrupted::Includes(result), result);
+                verify_hash_result = result;
             }
-
-            /* If we failed, clear and return. */
-            if (R_FAILED(cur_result)) {
-                std::memset(buffer, 0, size);
-                return cur_result;
+            return ResultSuccess();
+        };
+
+        /* Read and verify in batches, verifying each batch while reading the next. */
+        size_t submitted_count = 0;
+        for (s32 slot = 0; submitted_count < signature_count; slot = (slot + 1) % slot_count) {
+            const auto cur_count  = std::min(batch_count, signature_count - submitted_count);
+            const auto cur_pos    = submitted_count << this->verification_block_order;
+            const auto cur_offset = offset + static_cast<s64>(cur_pos);
+            u8 *cur_buf = static_cast<u8 *>(buffer) + cur_pos;
+
+            /* Wait for the slot's previous batch, so that we can reuse its signatures. */
+            R_TRY(wait_verification(verifiers[slot]));
+
+            /* Read the data, excluding any padding. */
+            if (cur_pos < read_size) {
+                R_TRY(this->data_storage.Read(cur_offset, cur_buf, std::min(read_size - cur_pos, cur_count << this->verification_block_order)));
             }
 
+            /* Read the signatures. */
+            contexts[slot].offset = cur_offset;
+            R_TRY(this->ReadBlockSignature(contexts[slot].signatures, batch_count * sizeof(BlockHash), cur_offset, cur_count << this->verification_block_order));
+
+            /* Verify the batch. */
+            verifiers[slot]->Submit(cur_offset, cur_buf, cur_count << this->verification_block_order);
+
             /* Advance. */
-            verified_count += cur_count;
+            submitted_count += cur_count;
         }
 
+        /* Wait for all batches to be verified. */
+        for (s32 slot = 0; slot < slot_count; ++slot) {
+            R_TRY(wait_verification(verifiers[slot]));
+        }
+
+        clear_guard.Cancel();
         return verify_hash_result;
     }
 
@@ -460,6 +479,26 @@ namespace ams::fssystem::save {
         return ResultSuccess();
     }
 
+    Result IntegrityVerificationStorage::VerifyBlock(void *arg, s64 offset, u8 *block, size_t block_size) {
+        auto *context = static_cast<VerificationContext *>(arg);
+        auto *storage = context->storage;
+        AMS_ASSERT(block_size == static_cast<size_t>(storage->verification_block_size));
+
+        /* Verify the block against its signature. */
+        BlockHash *hash = context->signatures + ((offset - context->offset) >> storage->verification_block_order);
+        const Result result = storage->VerifyHash(block, hash);
+
+        /* If the data is corrupted, clear the corrupted parts. */
+        if (fs::ResultIntegrityVerificationStorageCorrupted::Includes(result)) {
+            std::memset(block, 0, block_size);
+
+            /* Report the result if we should. */
+            R_SUCCEED_IF(fs::ResultClearedRealDataVerificationFailed::Includes(result) || storage->storage_type == fs::StorageType_Authoring);
+        }
+
+        return result;
+    }
+
     Result IntegrityVerificationStorage::IsCleared(bool *is_cleared, const BlockHash &hash) {
         /* Validate preconditions. */
         AMS_ASSERT(is_cleared != nullptr);
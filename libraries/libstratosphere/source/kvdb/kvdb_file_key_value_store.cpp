@@ -18,12 +18,114 @@
 namespace ams::kvdb {
 
     /* Cache implementation. */
+    size_t FileKeyValueStore::Cache::GetAlignedOffset(size_t offset) const {
+        /* Entries, buckets, and values are all kept suitably aligned, regardless of the alignment of the buffer. */
+        const uintptr_t buffer_address = reinterpret_cast<uintptr_t>(this->backing_buffer);
+        return std::min<size_t>(util::AlignUp(buffer_address + offset, alignof(std::max_align_t)) - buffer_address, this->backing_buffer_size);
+    }
+
     void *FileKeyValueStore::Cache::Allocate(size_t size) {
-        if (this->backing_buffer_size - this->backing_buffer_free_offset < size) {
+        const size_t offset = this->GetAlignedOffset(this->backing_buffer_free_offset);
+        if (this->backing_buffer_size - offset < size) {
             return nullptr;
         }
-        ON_SCOPE_EXIT { this->backing_buffer_free_offset += size; };
-        return this->backing_buffer + this->backing_buffer_free_offset;
+        ON_SCOPE_EXIT { this->backing_buffer_free_offset = offset + size; };
+        return this->backing_buffer + offset;
+    }
+
+    void *FileKeyValueStore::Cache::AllocateValue(size_t size) {
+        /* Values are allocated from power-of-two size classes, so that freed blocks can be reused. */
+        const size_t size_class = GetBlockSizeClass(size);
+        if (FreeBlock *block = this->free_blocks[size_class]; block != nullptr) {
+            this->free_blocks[size_class] = block->next;
+            return block;
+        }
+
+        return this->Allocate(GetBlockSize(size));
+    }
+
+    void FileKeyValueStore::Cache::FreeValue(void *value, size_t size) {
+        const size_t size_class = GetBlockSizeClass(size);
+
+        FreeBlock *block = static_cast<FreeBlock *>(value);
+        block->next = this->free_blocks[size_class];
+        this->free_blocks[size_class] = block;
+    }
+
+    void FileKeyValueStore::Cache::Reset() {
+        /* Reset the value heap. */
+        this->backing_buffer_free_offset = this->value_heap_offset;
+        std::fill(std::begin(this->free_blocks), std::end(this->free_blocks), nullptr);
+
+        /* Reset the hash table and the lru list. */
+        std::fill(this->buckets, this->buckets + this->bucket_count, nullptr);
+        this->lru_head = nullptr;
+        this->lru_tail = nullptr;
+
+        /* Return all entries to the free list. */
+        this->free_entries = nullptr;
+        for (size_t i = this->capacity; i > 0; i--) {
+            this->entries[i - 1].hash_next = this->free_entries;
+            this->free_entries = std::addressof(this->entries[i - 1]);
+        }
+        this->count = 0;
+    }
+
+    FileKeyValueStore::Entry *FileKeyValueStore::Cache::Find(const void *key, size_t key_size) {
+        for (Entry *entry = *this->GetBucket(key, key_size); entry != nullptr; entry = entry->hash_next) {
+            if (entry->key_size == key_size && std::memcmp(entry->key, key, key_size) == 0) {
+                return entry;
+            }
+        }
+        return nullptr;
+    }
+
+    void FileKeyValueStore::Cache::LinkToFront(Entry *entry) {
+        entry->lru_prev = nullptr;
+        entry->lru_next = this->lru_head;
+        if (this->lru_head != nullptr) {
+            this->lru_head->lru_prev = entry;
+        } else {
+            this->lru_tail = entry;
+        }
+        this->lru_head = entry;
+    }
+
+    void FileKeyValueStore::Cache::Unlink(Entry *entry) {
+        if (entry->lru_prev != nullptr) {
+            entry->lru_prev->lru_next = entry->lru_next;
+        } else {
+            this->lru_head = entry->lru_next;
+        }
+        if (entry->lru_next != nullptr) {
+            entry->lru_next->lru_prev = entry->lru_prev;
+        } else {
+            this->lru_tail = entry->lru_prev;
+        }
+    }
+
+    void FileKeyValueStore::Cache::RemoveEntry(Entry *entry) {
+        /* Remove the entry from its hash chain. */
+        Entry **link = this->GetBucket(entry->key, entry->key_size);
+        while (*link != entry) {
+            link = std::addressof((*link)->hash_next);
+        }
+        *link = entry->hash_next;
+
+        /* Remove the entry from the lru list, and free its value. */
+        this->Unlink(entry);
+        this->FreeValue(entry->value, entry->value_size);
+
+        /* Return the entry to the free list. */
+        entry->hash_next = this->free_entries;
+        this->free_entries = entry;
+        this->count--;
+    }
+
+    void FileKeyValueStore::Cache::EvictLeastRecentlyUsed() {
+        AMS_ABORT_UNLESS(this->lru_tail != nullptr);
+        this->RemoveEntry(this->lru_tail);
+        this->statistics.eviction_count++;
     }
 
     Result FileKeyValueStore::Cache::Initialize(void *buffer, size_t buffer_size, size_t capacity) {
@@ -31,13 +133,25 @@ namespace ams::kvdb {
         this->backing_buffer_size = buffer_size;
         this->backing_buffer_free_offset = 0;
         this->entries = nullptr;
+        this->buckets = nullptr;
+        this->bucket_count = 0;
         this->count = 0;
         this->capacity = capacity;
+        this->statistics = {};
 
-        /* If we have memory to work with, ensure it's at least enough for the cache entries. */
-        if (this->backing_buffer != nullptr) {
+        /* If we have memory to work with, ensure it's at least enough for the cache entries and hash table. */
+        if (this->backing_buffer != nullptr && this->capacity != 0) {
             this->entries = static_cast<decltype(this->entries)>(this->Allocate(sizeof(*this->entries) * this->capacity));
             R_UNLESS(this->entries != nullptr, ResultBufferInsufficient());
+
+            this->bucket_count = util::CeilingPowerOfTwo(this->capacity);
+            this->buckets = static_cast<decltype(this->buckets)>(this->Allocate(sizeof(*this->buckets) * this->bucket_count));
+            R_UNLESS(this->buckets != nullptr, ResultBufferInsufficient());
+
+            /* The rest of the buffer is used for values. */
+            this->value_heap_offset = this->GetAlignedOffset(this->backing_buffer_free_offset);
+
+            this->Reset();
         }
 
         return ResultSuccess();
@@ -48,11 +162,7 @@ namespace ams::kvdb {
             return;
         }
 
-        /* Reset the allocation pool. */
-        this->backing_buffer_free_offset = 0;
-        this->count = 0;
-        this->entries = static_cast<decltype(this->entries)>(this->Allocate(sizeof(*this->entries) * this->capacity));
-        AMS_ABORT_UNLESS(this->entries != nullptr);
+        this->Reset();
     }
 
     std::optional<size_t> FileKeyValueStore::Cache::TryGet(void *out_value, size_t max_out_size, const void *key, size_t key_size) {
@@ -61,20 +171,21 @@ namespace ams::kvdb {
         }
 
         /* Try to find the entry. */
-        for (size_t i = 0; i < this->count; i++) {
-            const auto &entry = this->entries[i];
-            if (entry.key_size == key_size && std::memcmp(entry.key, key, key_size) == 0) {
-                /* If we don't have enough space, fail to read from cache. */
-                if (max_out_size < entry.value_size) {
-                    return std::nullopt;
-                }
-
-                std::memcpy(out_value, entry.value, entry.value_size);
-                return entry.value_size;
-            }
+        Entry *entry = this->Find(key, key_size);
+
+        /* If we don't have the entry, or we don't have enough space, fail to read from cache. */
+        if (entry == nullptr || max_out_size < entry->value_size) {
+            this->statistics.miss_count++;
+            return std::nullopt;
         }
 
-        return std::nullopt;
+        /* Mark the entry as most recently used. */
+        this->Unlink(entry);
+        this->LinkToFront(entry);
+        this->statistics.hit_count++;
+
+        std::memcpy(out_value, entry->value, entry->value_size);
+        return entry->value_size;
     }
 
     std::optional<size_t> FileKeyValueStore::Cache::TryGetSize(const void *key, size_t key_size) {
@@ -83,14 +194,14 @@ namespace ams::kvdb {
         }
 
         /* Try to find the entry. */
-        for (size_t i = 0; i < this->count; i++) {
-            const auto &entry = this->entries[i];
-            if (entry.key_size == key_size && std::memcmp(entry.key, key, key_size) == 0) {
-                return entry.value_size;
-            }
+        Entry *entry = this->Find(key, key_size);
+        if (entry == nullptr) {
+            this->statistics.miss_count++;
+            return std::nullopt;
         }
 
-        return std::nullopt;
+        this->statistics.hit_count++;
+        return entry->value_size;
     }
 
     void FileKeyValueStore::Cache::Set(const void *key, size_t key_size, const void *value, size_t value_size) {
@@ -101,33 +212,64 @@ namespace ams::kvdb {
         /* Ensure key size is small enough. */
         AMS_ABORT_UNLESS(key_size <= MaxKeySize);
 
-        /* If we're at capacity, invalidate the cache. */
+        /* Remove any stale value for the key. */
+        this->Remove(key, key_size);
+
+        /* If the value can never fit, don't evict anything for it. */
+        const size_t heap_size = this->backing_buffer_size - this->value_heap_offset;
+        if (value_size > heap_size || GetBlockSize(value_size) > heap_size) {
+            return;
+        }
+
+        /* If we're at capacity, evict the least recently used entry. */
         if (this->count == this->capacity) {
-            this->Invalidate();
+            this->EvictLeastRecentlyUsed();
+        }
+
+        /* Allocate memory for the value, evicting entries until we have enough. */
+        void *value_buf = this->AllocateValue(value_size);
+        while (value_buf == nullptr && this->count > 0) {
+            this->EvictLeastRecentlyUsed();
+            value_buf = this->AllocateValue(value_size);
         }
 
-        /* Allocate memory for the value. */
-        void *value_buf = this->Allocate(value_size);
         if (value_buf == nullptr) {
-            /* We didn't have enough memory for the value. Invalidating might get us enough memory. */
-            this->Invalidate();
-            value_buf = this->Allocate(value_size);
-            if (value_buf == nullptr) {
-                /* If we still don't have enough memory, just fail to put the value in the cache. */
-                return;
-            }
+            /* The free memory is all in blocks of other sizes. With the cache empty, we can reclaim all of it. */
+            this->Reset();
+            value_buf = this->AllocateValue(value_size);
+            AMS_ABORT_UNLESS(value_buf != nullptr);
+        }
+
+        /* Take a free entry. */
+        Entry *entry = this->free_entries;
+        this->free_entries = entry->hash_next;
+
+        std::memcpy(entry->key, key, key_size);
+        entry->key_size = key_size;
+        entry->value = value_buf;
+        std::memcpy(entry->value, value, value_size);
+        entry->value_size = value_size;
+
+        /* Link the entry into the hash table and the lru list. */
+        Entry **bucket = this->GetBucket(key, key_size);
+        entry->hash_next = *bucket;
+        *bucket = entry;
+        this->LinkToFront(entry);
+        this->count++;
+    }
+
+    void FileKeyValueStore::Cache::Remove(const void *key, size_t key_size) {
+        if (!this->HasEntries()) {
+            return;
         }
 
-        auto &entry = this->entries[this->count++];
-        std::memcpy(entry.key, key, key_size);
-        entry.key_size = key_size;
-        entry.value = value_buf;
-        std::memcpy(entry.value, value, value_size);
-        entry.value_size = value_size;
+        if (Entry *entry = this->Find(key, key_size); entry != nullptr) {
+            this->RemoveEntry(entry);
+        }
     }
 
     bool FileKeyValueStore::Cache::Contains(const void *key, size_t key_size) {
-        return this->TryGetSize(key, key_size).has_value();
+        return this->HasEntries() && this->Find(key, key_size) != nullptr;
     }
 
     /* Store functionality. */
@@ -266,10 +408,8 @@ namespace ams::kvdb {
         /* Ensure key size is small enough. */
         R_UNLESS(key_size <= MaxKeySize, ResultOutOfKeyResource());
 
-        /* When the cache contains the key being set, Nintendo invalidates the cache. */
-        if (this->cache.Contains(key, key_size)) {
-            this->cache.Invalidate();
-        }
+        /* Nintendo invalidates the whole cache when it contains the key being modified; we only drop the stale entry. */
+        this->cache.Remove(key, key_size);
 
         /* Delete the file, if it exists. Don't check result, since it's okay if it's already deleted. */
         auto key_path = this->GetPath(key, key_size);
@@ -295,10 +435,8 @@ namespace ams::kvdb {
         /* Ensure key size is small enough. */
         R_UNLESS(key_size <= MaxKeySize, ResultOutOfKeyResource());
 
-        /* When the cache contains the key being set, Nintendo invalidates the cache. */
-        if (this->cache.Contains(key, key_size)) {
-            this->cache.Invalidate();
-        }
+        /* Nintendo invalidates the whole cache when it contains the key being modified; we only drop the stale entry. */
+        this->cache.Remove(key, key_size);
 
         /* Remove the file. */
         R_TRY_CATCH(fs::DeleteFile(this->GetPath(key, key_size))) {
@@ -308,4 +446,14 @@ namespace ams::kvdb {
         return ResultSuccess();
     }
 
+    void FileKeyValueStore::GetCacheStatistics(CacheStatistics *out) {
+        std::scoped_lock lk(this->lock);
+        this->cache.GetStatistics(out);
+    }
+
+    void FileKeyValueStore::ResetCacheStatistics() {
+        std::scoped_lock lk(this->lock);
+        this->cache.ResetStatistics();
+    }
+
 }
\ No newline at end of file
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+
+namespace ams::kvdb {
+
+    namespace {
+
+        /* Convenience definitions. */
+        constexpr u8 JournalRecordMagic[4] = {'I', 'M', 'J', 'R'};
+
+        constexpr auto Crc32Table = [] {
+            std::array<u32, 0x100> table = {};
+            for (u32 i = 0; i < table.size(); ++i) {
+                u32 v = i;
+                for (size_t j = 0; j < BITSIZEOF(u8); ++j) {
+                    v = (v >> 1) ^ ((v & 1) ? 0xEDB88320 : 0);
+                }
+                table[i] = v;
+            }
+            return table;
+        }();
+
+        u32 UpdateCrc32(u32 crc, const void *data, size_t size) {
+            const u8 *cur = static_cast<const u8 *>(data);
+            for (size_t i = 0; i < size; ++i) {
+                crc = Crc32Table[(crc ^ cur[i]) & 0xFF] ^ (crc >> 8);
+            }
+            return crc;
+        }
+
+        /* Journal types. */
+        struct JournalRecordHeader {
+            u8 magic[sizeof(JournalRecordMagic)];
+            u8 type;
+            u8 reserved[3];
+            u32 key_size;
+            u32 value_size;
+            u32 checksum;
+
+            u32 CalculateChecksum(const void *key, const void *value) const {
+                JournalRecordHeader tmp = *this;
+                tmp.checksum = 0;
+
+                u32 crc = ~0u;
+                crc = UpdateCrc32(crc, std::addressof(tmp), sizeof(tmp));
+                crc = UpdateCrc32(crc, key, this->key_size);
+                crc = UpdateCrc32(crc, value, this->value_size);
+                return ~crc;
+            }
+
+            Result Validate() const {
+                R_UNLESS(std::memcmp(this->magic, JournalRecordMagic, sizeof(JournalRecordMagic)) == 0,                                        ResultInvalidKeyValue());
+                R_UNLESS(this->type == JournalRecordType_Set || this->type == JournalRecordType_Remove || this->type == JournalRecordType_Base, ResultInvalidKeyValue());
+                return ResultSuccess();
+            }
+
+            static JournalRecordHeader Make(JournalRecordType type, size_t ksz, size_t vsz) {
+                JournalRecordHeader header = {};
+                std::memcpy(header.magic, JournalRecordMagic, sizeof(JournalRecordMagic));
+                header.type       = type;
+                header.key_size   = ksz;
+                header.value_size = vsz;
+                return header;
+            }
+        };
+        static_assert(sizeof(JournalRecordHeader) == 0x14 && util::is_pod<JournalRecordHeader>::value, "JournalRecordHeader definition!");
+
+    }
+
+    /* Reader functionality. */
+    Result JournalReader::ReadRecord(JournalRecordType *out_type, const void **out_key, size_t *out_key_size, const void **out_value, size_t *out_value_size) {
+        /* Read and validate the header. */
+        JournalRecordHeader header;
+        R_UNLESS(this->offset + sizeof(header) <= this->buffer.GetSize(), ResultInvalidKeyValue());
+        std::memcpy(std::addressof(header), this->buffer.Get() + this->offset, sizeof(header));
+        R_TRY(header.Validate());
+
+        /* Bounds check the record's data. */
+        const size_t data_offset = this->offset + sizeof(header);
+        const size_t data_size   = static_cast<size_t>(header.key_size) + static_cast<size_t>(header.value_size);
+        R_UNLESS(data_offset + data_size <= this->buffer.GetSize(), ResultInvalidKeyValue());
+
+        /* Verify the checksum, which catches records torn by an interrupted append. */
+        const u8 *key   = this->buffer.Get() + data_offset;
+        const u8 *value = key + header.key_size;
+        R_UNLESS(header.CalculateChecksum(key, value) == header.checksum, ResultInvalidKeyValue());
+
+        *out_type       = static_cast<JournalRecordType>(header.type);
+        *out_key        = key;
+        *out_key_size   = header.key_size;
+        *out_value      = value;
+        *out_value_size = header.value_size;
+
+        this->offset = data_offset + data_size;
+        return ResultSuccess();
+    }
+
+    /* Writer functionality. */
+    Result JournalWriter::Write(const void *src, size_t size) {
+        /* Bounds check. */
+        R_UNLESS(this->offset + size <= this->buffer.GetSize(), ResultInvalidKeyValue());
+        R_UNLESS(this->offset < this->offset + size,            ResultInvalidKeyValue());
+
+        std::memcpy(this->buffer.Get() + this->offset, src, size);
+        this->offset += size;
+        return ResultSuccess();
+    }
+
+    void JournalWriter::WriteRecord(JournalRecordType type, const void *key, size_t key_size, const void *value, size_t value_size) {
+        JournalRecordHeader header = JournalRecordHeader::Make(type, key_size, value_size);
+        header.checksum = header.CalculateChecksum(key, value);
+
+        R_ABORT_UNLESS(this->Write(std::addressof(header), sizeof(header)));
+        if (key_size > 0) {
+            R_ABORT_UNLESS(this->Write(key, key_size));
+        }
+        if (value_size > 0) {
+            R_ABORT_UNLESS(this->Write(value, value_size));
+        }
+    }
+
+    /* Size helper functionality. */
+    void JournalSizeHelper::AddRecord(size_t key_size, size_t value_size) {
+        this->size += sizeof(JournalRecordHeader) + key_size + value_size;
+    }
+
+}
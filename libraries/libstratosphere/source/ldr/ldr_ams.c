@@ -32,6 +32,23 @@ Result ldrPmAtmosphereHasLaunchedBootProgram(bool *out, u64 program_id) {
     return _ldrAtmosphereHasLaunchedBootProgram(ldrPmGetServiceSession(), out, program_id);
 }
 
+Result ldrDmntAtmosphereGetLaunchPhaseTimes(bool *out_found, LoaderLaunchPhaseTimes *out, u64 program_id) {
+    struct {
+        u8 found;
+        LoaderLaunchPhaseTimes times;
+    } tmp;
+    Result rc = serviceDispatchInOut(ldrDmntGetServiceSession(), 65001, program_id, tmp);
+    if (R_SUCCEEDED(rc)) {
+        if (out_found) *out_found = tmp.found & 1;
+        if (out) *out = tmp.times;
+    }
+    return rc;
+}
+
+Result ldrDmntAtmosphereInvalidatePatchIndex(void) {
+    return serviceDispatch(ldrDmntGetServiceSession(), 65002);
+}
+
 Result ldrPmAtmosphereGetProgramInfo(LoaderProgramInfo *out_program_info, CfgOverrideStatus *out_status, const NcmProgramLocation *loc) {
     return serviceDispatchInOut(ldrPmGetServiceSession(), 65001, *loc, *out_status,
         .buffer_attrs = { SfBufferAttr_Out | SfBufferAttr_HipcPointer | SfBufferAttr_FixedSize },
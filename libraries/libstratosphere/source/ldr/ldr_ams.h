@@ -16,8 +16,23 @@ typedef struct {
     u64 flags;
 } CfgOverrideStatus;
 
+/* Nanoseconds spent in each phase of a program's most recent launch. */
+typedef struct {
+    s64 load_meta;
+    s64 load_nso_headers;
+    s64 create_process;
+    s64 load_nsos;
+    s64 read_segments;
+    s64 decompress_segments;
+    s64 hash_segments;
+    s64 patch_nsos;
+    s64 total;
+} LoaderLaunchPhaseTimes;
+
 Result ldrPmAtmosphereHasLaunchedBootProgram(bool *out, u64 program_id);
 Result ldrDmntAtmosphereHasLaunchedBootProgram(bool *out, u64 program_id);
+Result ldrDmntAtmosphereGetLaunchPhaseTimes(bool *out_found, LoaderLaunchPhaseTimes *out, u64 program_id);
+Result ldrDmntAtmosphereInvalidatePatchIndex(void);
 
 Result ldrPmAtmosphereGetProgramInfo(LoaderProgramInfo *out, CfgOverrideStatus *out_status, const NcmProgramLocation *loc);
 Result ldrPmAtmospherePinProgram(u64 *out, const NcmProgramLocation *loc, const CfgOverrideStatus *status);
@@ -0,0 +1,451 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "ncm_install_pipeline.hpp"
+
+namespace ams::ncm::impl {
+
+    std::unique_ptr<InstallPipeline> InstallPipeline::Create(InstallTaskBase *task, void *buffer, size_t buffer_size, s32 max_lane_count) {
+        /* Split the buffer into a ring for each lane, using fewer lanes if their buffers would otherwise be too small. */
+        s32 lane_count = std::min(max_lane_count, LaneCountMax);
+        while (lane_count > 1 && buffer_size / (lane_count * SlotCountPerLane) < SlotSizeMin) {
+            --lane_count;
+        }
+
+        const size_t slot_size = util::AlignDown(buffer_size / (lane_count * SlotCountPerLane), os::MemoryPageSize);
+        if (slot_size < SlotSizeMin) {
+            return nullptr;
+        }
+
+        /* Create the pipeline. */
+        std::unique_ptr<InstallPipeline> pipeline(new (std::nothrow) InstallPipeline(task, static_cast<u8 *>(buffer), slot_size, lane_count));
+        if (pipeline == nullptr || !pipeline->StartThreads()) {
+            return nullptr;
+        }
+
+        return pipeline;
+    }
+
+    InstallPipeline::InstallPipeline(InstallTaskBase *t, u8 *buffer, size_t ss, s32 lc)
+        : task(t), lane_count(lc), slot_size(ss), thread_stack_memory(), thread_count(0), mutex(), slot_cv(), hash_cv(), job_cv(), job_done_cv(),
+          hash_queue(), exit_requested(false), job_writer(nullptr), job_next_index(0), job_id(0), job_running_lane_count(0), job_result(ResultSuccess())
+    {
+        for (s32 i = 0; i < this->lane_count; ++i) {
+            Lane &lane = this->lanes[i];
+
+            lane.pipeline        = this;
+            lane.content_info    = nullptr;
+            lane.next_slot       = 0;
+            lane.filling_slot    = nullptr;
+            lane.in_flight_count = 0;
+            lane.result          = ResultSuccess();
+
+            for (s32 j = 0; j < SlotCountPerLane; ++j) {
+                Slot &slot = lane.slots[j];
+
+                slot.lane      = std::addressof(lane);
+                slot.buffer    = buffer + (i * SlotCountPerLane + j) * this->slot_size;
+                slot.data_size = 0;
+                slot.state     = SlotState::Free;
+            }
+        }
+    }
+
+    InstallPipeline::~InstallPipeline() {
+        /* Tell our threads to exit. */
+        {
+            std::scoped_lock lk(this->mutex);
+
+            this->exit_requested = true;
+            this->job_cv.Broadcast();
+            this->hash_cv.Broadcast();
+
+            for (s32 i = 0; i < this->lane_count; ++i) {
+                this->lanes[i].write_cv.Broadcast();
+            }
+        }
+
+        /* Wait for them to do so. */
+        for (s32 i = 0; i < this->thread_count; ++i) {
+            os::WaitThread(std::addressof(this->threads[i]));
+            os::DestroyThread(std::addressof(this->threads[i]));
+        }
+    }
+
+    bool InstallPipeline::StartThreads() {
+        /* We need a writer for each lane, a hasher, and a thread for each lane but the first. */
+        const s32 num_threads = this->lane_count + 1 + (this->lane_count - 1);
+
+        /* Allocate their stacks. */
+        this->thread_stack_memory.reset(new (std::nothrow) u8[num_threads * ThreadStackSize + os::ThreadStackAlignment]);
+        if (this->thread_stack_memory == nullptr) {
+            return false;
+        }
+        u8 *stack = static_cast<u8 *>(util::AlignUp(static_cast<void *>(this->thread_stack_memory.get()), os::ThreadStackAlignment));
+
+        /* Run our threads at the priority of the thread executing the task. */
+        const s32 priority = os::GetThreadPriority(os::GetCurrentThread());
+
+        for (s32 i = 0; i < num_threads; ++i) {
+            os::ThreadFunction function;
+            void *argument;
+            const char *name;
+            if (i < this->lane_count) {
+                function = WriteThreadEntry;
+                argument = std::addressof(this->lanes[i]);
+                name     = "ncm.InstallPipelineWriter";
+            } else if (i == this->lane_count) {
+                function = HashThreadEntry;
+                argument = this;
+                name     = "ncm.InstallPipelineHasher";
+            } else {
+                function = LaneThreadEntry;
+                argument = std::addressof(this->lanes[i - this->lane_count]);
+                name     = "ncm.InstallPipelineLane";
+            }
+
+            /* NOTE: Any threads we've already started are stopped by our destructor. */
+            os::ThreadType *thread = std::addressof(this->threads[i]);
+            if (R_FAILED(os::CreateThread(thread, function, argument, stack + i * ThreadStackSize, ThreadStackSize, priority))) {
+                return false;
+            }
+
+            os::SetThreadNamePointer(thread, name);
+            os::StartThread(thread);
+
+            ++this->thread_count;
+        }
+
+        return true;
+    }
+
+    Result InstallPipeline::WritePlaceHolders(const InstallContentMetaWriter &writer) {
+        /* Hand the content meta to the lanes. */
+        {
+            std::scoped_lock lk(this->mutex);
+
+            this->job_writer             = std::addressof(writer);
+            this->job_next_index         = 0;
+            this->job_result             = ResultSuccess();
+            this->job_running_lane_count = this->lane_count - 1;
+            ++this->job_id;
+
+            this->job_cv.Broadcast();
+        }
+
+        /* Run the first lane ourselves. */
+        this->RunLane(std::addressof(this->lanes[0]));
+
+        /* Wait for the other lanes to finish. */
+        std::scoped_lock lk(this->mutex);
+
+        while (this->job_running_lane_count > 0) {
+            this->job_done_cv.Wait(this->mutex);
+        }
+
+        this->job_writer = nullptr;
+        return this->job_result;
+    }
+
+    void InstallPipeline::RunLane(Lane *lane) {
+        while (true) {
+            /* Take the next prepared content info, unless another lane has failed. */
+            InstallContentInfo *content_info = nullptr;
+            {
+                std::scoped_lock lk(this->mutex);
+
+                if (R_FAILED(this->job_result)) {
+                    break;
+                }
+
+                while (content_info == nullptr && this->job_next_index < this->job_writer->GetContentCount()) {
+                    auto *cur_info = this->job_writer->GetWritableContentInfo(this->job_next_index++);
+                    if (cur_info->install_state == InstallState::Prepared) {
+                        content_info = cur_info;
+                    }
+                }
+
+                if (content_info == nullptr) {
+                    break;
+                }
+
+                lane->content_info = content_info;
+            }
+
+            /* Write it. */
+            const Result result = this->task->WritePlaceHolder(this->job_writer->GetKey(), content_info);
+
+            std::scoped_lock lk(this->mutex);
+
+            lane->content_info = nullptr;
+            if (R_SUCCEEDED(result)) {
+                content_info->install_state = InstallState::Installed;
+            } else if (R_SUCCEEDED(this->job_result)) {
+                this->job_result = result;
+            }
+        }
+    }
+
+    void InstallPipeline::LaneThreadFunction(Lane *lane) {
+        u32 last_job_id = 0;
+
+        while (true) {
+            /* Wait for a content meta to install. */
+            {
+                std::scoped_lock lk(this->mutex);
+
+                while (!this->exit_requested && this->job_id == last_job_id) {
+                    this->job_cv.Wait(this->mutex);
+                }
+
+                if (this->exit_requested) {
+                    return;
+                }
+
+                last_job_id = this->job_id;
+            }
+
+            this->RunLane(lane);
+
+            /* Let the caller know we're done. */
+            std::scoped_lock lk(this->mutex);
+            if ((--this->job_running_lane_count) == 0) {
+                this->job_done_cv.Broadcast();
+            }
+        }
+    }
+
+    InstallPipeline::Lane *InstallPipeline::FindLane(InstallContentInfo *content_info) {
+        std::scoped_lock lk(this->mutex);
+
+        for (s32 i = 0; i < this->lane_count; ++i) {
+            if (this->lanes[i].content_info == content_info) {
+                return std::addressof(this->lanes[i]);
+            }
+        }
+
+        AMS_ABORT("Content info is not being written by the install pipeline");
+    }
+
+    crypto::Sha256Generator *InstallPipeline::GetSha256Generator(InstallContentInfo *content_info) {
+        return std::addressof(this->FindLane(content_info)->sha256_generator);
+    }
+
+    Result InstallPipeline::Acquire(void **out_buffer, size_t *out_buffer_size, InstallContentInfo *content_info) {
+        Slot *slot;
+        R_TRY(this->AcquireImpl(std::addressof(slot), this->FindLane(content_info)));
+
+        *out_buffer      = slot->buffer;
+        *out_buffer_size = this->slot_size;
+        return ResultSuccess();
+    }
+
+    Result InstallPipeline::AcquireImpl(Slot **out, Lane *lane) {
+        std::scoped_lock lk(this->mutex);
+
+        /* If a buffer was acquired but never submitted, hand it out again. */
+        if (lane->filling_slot == nullptr) {
+            /* Wait for the next buffer in the ring to be written and hashed. */
+            Slot *slot = std::addressof(lane->slots[lane->next_slot]);
+            while (slot->state != SlotState::Free && R_SUCCEEDED(lane->result)) {
+                this->slot_cv.Wait(this->mutex);
+            }
+
+            /* There's no point reading more if we failed to write what we've read. */
+            R_TRY(lane->result);
+
+            slot->state        = SlotState::Filling;
+            lane->filling_slot = slot;
+            lane->next_slot    = (lane->next_slot + 1) % SlotCountPerLane;
+        }
+
+        lane->filling_slot->fill_start_tick = os::GetSystemTick();
+
+        *out = lane->filling_slot;
+        return ResultSuccess();
+    }
+
+    Result InstallPipeline::Submit(InstallContentInfo *content_info, const void *data, size_t data_size) {
+        Lane *lane = this->FindLane(content_info);
+
+        /* NOTE: Only the lane's own thread acquires and submits its buffers, so we can check its filling slot without locking. */
+        Slot *slot = lane->filling_slot;
+        if (slot != nullptr && data == slot->buffer) {
+            AMS_ASSERT(data_size <= this->slot_size);
+            this->SubmitImpl(slot, data_size);
+            return ResultSuccess();
+        }
+
+        /* Data which isn't in a buffer we handed out is copied into the ring. */
+        const u8 *src = static_cast<const u8 *>(data);
+        while (data_size > 0) {
+            R_TRY(this->AcquireImpl(std::addressof(slot), lane));
+
+            const size_t cur_size = std::min(data_size, this->slot_size);
+            std::memcpy(slot->buffer, src, cur_size);
+            this->SubmitImpl(slot, cur_size);
+
+            src       += cur_size;
+            data_size -= cur_size;
+        }
+
+        return ResultSuccess();
+    }
+
+    void InstallPipeline::SubmitImpl(Slot *slot, size_t data_size) {
+        Lane *lane = slot->lane;
+
+        /* Account for the time spent filling the buffer. */
+        if (!lane->content_info->is_temporary) {
+            this->task->UpdatePipelineThroughputMeasurement(InstallPipelineStage::Read, data_size, (os::GetSystemTick() - slot->fill_start_tick).ToTimeSpan());
+        }
+
+        std::scoped_lock lk(this->mutex);
+
+        lane->filling_slot = nullptr;
+
+        if (data_size == 0) {
+            slot->state = SlotState::Free;
+            return;
+        }
+
+        /* Queue the buffer to be written. */
+        slot->data_size = data_size;
+        slot->state     = SlotState::Writing;
+        ++lane->in_flight_count;
+
+        lane->write_queue.push_back(*slot);
+        lane->write_cv.Signal();
+    }
+
+    void InstallPipeline::ReleaseSlot(Slot *slot) {
+        /* NOTE: This must be called with the mutex held. */
+        slot->state = SlotState::Free;
+        --slot->lane->in_flight_count;
+
+        this->slot_cv.Broadcast();
+    }
+
+    Result InstallPipeline::Flush(InstallContentInfo *content_info) {
+        Lane *lane = this->FindLane(content_info);
+
+        std::scoped_lock lk(this->mutex);
+
+        /* Give back any buffer which was acquired but never submitted. */
+        if (lane->filling_slot != nullptr) {
+            lane->filling_slot->state = SlotState::Free;
+            lane->filling_slot        = nullptr;
+        }
+
+        /* Wait for everything submitted to be written and hashed. */
+        while (lane->in_flight_count > 0) {
+            this->slot_cv.Wait(this->mutex);
+        }
+
+        /* Return the first failure since the last flush, if any. */
+        const Result result = lane->result;
+        lane->result = ResultSuccess();
+        return result;
+    }
+
+    void InstallPipeline::WriteThreadFunction(Lane *lane) {
+        while (true) {
+            /* Take the lane's oldest buffer to be written. */
+            Slot *slot;
+            Result result;
+            {
+                std::scoped_lock lk(this->mutex);
+
+                while (!this->exit_requested && lane->write_queue.empty()) {
+                    lane->write_cv.Wait(this->mutex);
+                }
+
+                if (this->exit_requested) {
+                    return;
+                }
+
+                slot = std::addressof(lane->write_queue.front());
+                lane->write_queue.pop_front();
+
+                result = lane->result;
+            }
+
+            /* Write it, unless a previous write for the lane failed; the lane's data must be written (and hashed) in order. */
+            InstallContentInfo *content_info = lane->content_info;
+            if (R_SUCCEEDED(result)) {
+                if (this->task->IsCancelRequested()) {
+                    result = ncm::ResultWritePlaceHolderCancelled();
+                } else {
+                    const auto start_tick = os::GetSystemTick();
+                    result = this->task->WritePlaceHolderData(content_info, slot->buffer, slot->data_size);
+
+                    if (R_SUCCEEDED(result) && !content_info->is_temporary) {
+                        this->task->UpdatePipelineThroughputMeasurement(InstallPipelineStage::Write, slot->data_size, (os::GetSystemTick() - start_tick).ToTimeSpan());
+                    }
+                }
+            }
+
+            std::scoped_lock lk(this->mutex);
+
+            if (R_SUCCEEDED(result)) {
+                /* Queue the buffer to be hashed. */
+                slot->state = SlotState::Hashing;
+
+                this->hash_queue.push_back(*slot);
+                this->hash_cv.Signal();
+            } else {
+                if (R_SUCCEEDED(lane->result)) {
+                    lane->result = result;
+                }
+
+                this->ReleaseSlot(slot);
+            }
+        }
+    }
+
+    void InstallPipeline::HashThreadFunction() {
+        while (true) {
+            /* Take the oldest buffer to be hashed. */
+            Slot *slot;
+            {
+                std::scoped_lock lk(this->mutex);
+
+                while (!this->exit_requested && this->hash_queue.empty()) {
+                    this->hash_cv.Wait(this->mutex);
+                }
+
+                if (this->exit_requested) {
+                    return;
+                }
+
+                slot = std::addressof(this->hash_queue.front());
+                this->hash_queue.pop_front();
+            }
+
+            /* Hash it. */
+            const auto start_tick = os::GetSystemTick();
+            slot->lane->sha256_generator.Update(slot->buffer, slot->data_size);
+
+            if (!slot->lane->content_info->is_temporary) {
+                this->task->UpdatePipelineThroughputMeasurement(InstallPipelineStage::Hash, slot->data_size, (os::GetSystemTick() - start_tick).ToTimeSpan());
+            }
+
+            std::scoped_lock lk(this->mutex);
+            this->ReleaseSlot(slot);
+        }
+    }
+
+}
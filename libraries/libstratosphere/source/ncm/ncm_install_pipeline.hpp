@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+
+namespace ams::ncm::impl {
+
+    /* Installs content infos through a pipeline of three stages, connected by a ring of buffers per content info: */
+    /* the task's reader fills a buffer, the lane's writer thread writes it to the placeholder, and a hasher thread then hashes it. */
+    /* Data is only hashed once it has been written, so a content info's saved hash context always matches what was written. */
+    /* Several content infos ("lanes") may be installed at once; the calling thread runs the first lane. */
+    /* Each lane has its own writer, so a slow placeholder write on one lane never stalls the others; */
+    /* the hasher is shared, as hashing a buffer is far faster than reading or writing it. */
+    class InstallPipeline {
+        NON_COPYABLE(InstallPipeline);
+        NON_MOVEABLE(InstallPipeline);
+        public:
+            static constexpr s32    LaneCountMax     = 4;
+            static constexpr s32    SlotCountPerLane = 4;
+            static constexpr size_t SlotSizeMin      = 64_KB;
+            static constexpr size_t ThreadStackSize  = 16_KB;
+        private:
+            enum class SlotState {
+                Free,
+                Filling,
+                Writing,
+                Hashing,
+            };
+
+            struct Lane;
+
+            struct Slot : public util::IntrusiveListBaseNode<Slot> {
+                Lane *lane;
+                u8 *buffer;
+                size_t data_size;
+                SlotState state;
+                os::Tick fill_start_tick;
+            };
+
+            using SlotList = util::IntrusiveListBaseTraits<Slot>::ListType;
+
+            struct Lane {
+                InstallPipeline *pipeline;
+                InstallContentInfo *content_info;
+                crypto::Sha256Generator sha256_generator;
+                Slot slots[SlotCountPerLane];
+                s32 next_slot;
+                Slot *filling_slot;
+                s32 in_flight_count;
+                Result result;
+                SlotList write_queue;
+                os::SdkConditionVariable write_cv;
+            };
+        private:
+            InstallTaskBase *task;
+            s32 lane_count;
+            size_t slot_size;
+            Lane lanes[LaneCountMax];
+            std::unique_ptr<u8[]> thread_stack_memory;
+            os::ThreadType threads[2 * LaneCountMax];
+            s32 thread_count;
+            os::SdkMutex mutex;
+            os::SdkConditionVariable slot_cv;
+            os::SdkConditionVariable hash_cv;
+            os::SdkConditionVariable job_cv;
+            os::SdkConditionVariable job_done_cv;
+            SlotList hash_queue;
+            bool exit_requested;
+            const InstallContentMetaWriter *job_writer;
+            size_t job_next_index;
+            u32 job_id;
+            s32 job_running_lane_count;
+            Result job_result;
+        public:
+            /* Returns nullptr if the pipeline can't be set up, in which case the caller should install serially. */
+            static std::unique_ptr<InstallPipeline> Create(InstallTaskBase *task, void *buffer, size_t buffer_size, s32 max_lane_count);
+            ~InstallPipeline();
+
+            /* Writes the placeholders of all prepared content infos in the content meta, marking them as installed. */
+            Result WritePlaceHolders(const InstallContentMetaWriter &writer);
+
+            /* These are only valid for the content info a lane is currently writing. */
+            crypto::Sha256Generator *GetSha256Generator(InstallContentInfo *content_info);
+            Result Acquire(void **out_buffer, size_t *out_buffer_size, InstallContentInfo *content_info);
+            Result Submit(InstallContentInfo *content_info, const void *data, size_t data_size);
+            Result Flush(InstallContentInfo *content_info);
+        private:
+            InstallPipeline(InstallTaskBase *task, u8 *buffer, size_t slot_size, s32 lane_count);
+            bool StartThreads();
+
+            Lane *FindLane(InstallContentInfo *content_info);
+            Result AcquireImpl(Slot **out, Lane *lane);
+            void SubmitImpl(Slot *slot, size_t data_size);
+            void ReleaseSlot(Slot *slot);
+            void RunLane(Lane *lane);
+
+            void LaneThreadFunction(Lane *lane);
+            void WriteThreadFunction(Lane *lane);
+            void HashThreadFunction();
+        private:
+            static void LaneThreadEntry(void *arg) { auto *lane = static_cast<Lane *>(arg); lane->pipeline->LaneThreadFunction(lane); }
+            static void WriteThreadEntry(void *arg) { auto *lane = static_cast<Lane *>(arg); lane->pipeline->WriteThreadFunction(lane); }
+            static void HashThreadEntry(void *arg) { static_cast<InstallPipeline *>(arg)->HashThreadFunction(); }
+    };
+
+}
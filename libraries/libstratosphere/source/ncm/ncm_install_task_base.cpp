@@ -14,6 +14,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <stratosphere.hpp>
+#include "ncm_install_pipeline.hpp"
 
 namespace ams::ncm {
 
@@ -330,6 +331,15 @@ namespace ams::ncm {
     Result InstallTaskBase::ExecuteImpl() {
         this->StartThroughputMeasurement();
 
+        /* Set up a pipeline, if we should use one. If we can't, we install serially. */
+        std::unique_ptr<impl::InstallPipeline> pipeline;
+        if (this->pipelined_install_enabled && this->install_buffer != nullptr) {
+            pipeline = impl::InstallPipeline::Create(this, this->install_buffer, this->install_buffer_size, this->max_parallel_content_count);
+        }
+
+        this->pipeline = pipeline.get();
+        ON_SCOPE_EXIT { this->pipeline = nullptr; };
+
         /* Count the number of content meta entries. */
         s32 count;
         R_TRY(this->data->Count(std::addressof(count)));
@@ -348,14 +358,19 @@ namespace ams::ncm {
                 /* Create a writer. */
                 const auto writer = content_meta.GetWriter();
 
-                /* Iterate over content infos. */
-                for (size_t j = 0; j < writer.GetContentCount(); j++) {
-                    auto *content_info = writer.GetWritableContentInfo(j);
-
-                    /* Write prepared content infos. */
-                    if (content_info->install_state == InstallState::Prepared) {
-                        R_TRY(this->WritePlaceHolder(writer.GetKey(), content_info));
-                        content_info->install_state = InstallState::Installed;
+                if (this->pipeline != nullptr) {
+                    /* Write prepared content infos through the pipeline. */
+                    R_TRY(this->pipeline->WritePlaceHolders(writer));
+                } else {
+                    /* Iterate over content infos. */
+                    for (size_t j = 0; j < writer.GetContentCount(); j++) {
+                        auto *content_info = writer.GetWritableContentInfo(j);
+
+                        /* Write prepared content infos. */
+                        if (content_info->install_state == InstallState::Prepared) {
+                            R_TRY(this->WritePlaceHolder(writer.GetKey(), content_info));
+                            content_info->install_state = InstallState::Installed;
+                        }
                     }
                 }
 
@@ -544,6 +559,36 @@ namespace ams::ncm {
     Result InstallTaskBase::WritePlaceHolderBuffer(InstallContentInfo *content_info, const void *data, size_t data_size) {
         R_UNLESS(!this->IsCancelRequested(), ncm::ResultWritePlaceHolderCancelled());
 
+        /* When pipelined, the data is written and hashed by the pipeline. */
+        if (this->pipeline != nullptr) {
+            return this->pipeline->Submit(content_info, data, data_size);
+        }
+
+        /* Write the data. */
+        R_TRY(this->WritePlaceHolderData(content_info, data, data_size));
+
+        /* Update the hash for the new data. */
+        this->sha256_generator.Update(data, data_size);
+        return ResultSuccess();
+    }
+
+    Result InstallTaskBase::AcquirePlaceHolderBuffer(void **out_buffer, size_t *out_buffer_size, InstallContentInfo *content_info) {
+        /* When pipelined, each buffer is part of the pipeline's ring. */
+        if (this->pipeline != nullptr) {
+            return this->pipeline->Acquire(out_buffer, out_buffer_size, content_info);
+        }
+
+        *out_buffer      = this->install_buffer;
+        *out_buffer_size = this->install_buffer_size;
+        return ResultSuccess();
+    }
+
+    void InstallTaskBase::SetInstallBuffer(void *buffer, size_t buffer_size) {
+        this->install_buffer      = buffer;
+        this->install_buffer_size = buffer_size;
+    }
+
+    Result InstallTaskBase::WritePlaceHolderData(InstallContentInfo *content_info, const void *data, size_t data_size) {
         /* Open the content storage for the content info. */
         ContentStorage content_storage;
         R_TRY(OpenContentStorage(&content_storage, content_info->storage_id));
@@ -558,38 +603,49 @@ namespace ams::ncm {
             this->UpdateThroughputMeasurement(data_size);
         }
 
-        /* Update the hash for the new data. */
-        this->sha256_generator.Update(data, data_size);
         return ResultSuccess();
     }
 
     Result InstallTaskBase::WritePlaceHolder(const ContentMetaKey &key, InstallContentInfo *content_info) {
+        /* When pipelined, each content info being written has a generator of its own. */
+        crypto::Sha256Generator *sha256_generator = this->pipeline != nullptr ? this->pipeline->GetSha256Generator(content_info) : std::addressof(this->sha256_generator);
+
         if (content_info->is_sha256_calculated) {
             /* Update the hash with the buffered data. */
-            this->sha256_generator.InitializeWithContext(std::addressof(content_info->context));
-            this->sha256_generator.Update(content_info->buffered_data, content_info->buffered_data_size);
+            sha256_generator->InitializeWithContext(std::addressof(content_info->context));
+            sha256_generator->Update(content_info->buffered_data, content_info->buffered_data_size);
         } else {
             /* Initialize the generator. */
-            this->sha256_generator.Initialize();
+            sha256_generator->Initialize();
         }
 
         {
             ON_SCOPE_EXIT {
+                /* Wait for the pipeline to finish with our data, so that the hash we save is of everything written. */
+                if (this->pipeline != nullptr) {
+                    this->pipeline->Flush(content_info);
+                }
+
                 /* Update this content info's sha256 data. */
-                this->sha256_generator.GetContext(std::addressof(content_info->context));
-                content_info->buffered_data_size = this->sha256_generator.GetBufferedDataSize();
-                this->sha256_generator.GetBufferedData(content_info->buffered_data, this->sha256_generator.GetBufferedDataSize());
+                sha256_generator->GetContext(std::addressof(content_info->context));
+                content_info->buffered_data_size = sha256_generator->GetBufferedDataSize();
+                sha256_generator->GetBufferedData(content_info->buffered_data, sha256_generator->GetBufferedDataSize());
                 content_info->is_sha256_calculated = true;
             };
 
             /* Perform the placeholder write. */
             R_TRY(this->OnWritePlaceHolder(key, content_info));
+
+            /* Check that the pipeline wrote everything. */
+            if (this->pipeline != nullptr) {
+                R_TRY(this->pipeline->Flush(content_info));
+            }
         }
 
         /* Compare generated hash to expected hash if verification required. */
         if (content_info->verify_digest) {
             u8 hash[crypto::Sha256Generator::HashSize];
-            this->sha256_generator.GetHash(hash, crypto::Sha256Generator::HashSize);
+            sha256_generator->GetHash(hash, crypto::Sha256Generator::HashSize);
             R_UNLESS(std::memcmp(hash, content_info->digest.data, crypto::Sha256Generator::HashSize) == 0, ncm::ResultInvalidContentHash());
         }
 
@@ -1075,15 +1131,22 @@ namespace ams::ncm {
         return this->throughput;
     }
 
+    InstallPipelineThroughput InstallTaskBase::GetPipelineThroughput() {
+        std::scoped_lock lk(this->throughput_mutex);
+        return this->pipeline_throughput;
+    }
+
     void InstallTaskBase::ResetThroughputMeasurement() {
         std::scoped_lock lk(this->throughput_mutex);
         this->throughput = { .elapsed_time = TimeSpan() };
+        this->pipeline_throughput = {};
         this->throughput_start_time = TimeSpan();
     }
 
     void InstallTaskBase::StartThroughputMeasurement() {
         std::scoped_lock lk(this->throughput_mutex);
         this->throughput = { .elapsed_time = TimeSpan() };
+        this->pipeline_throughput = {};
         this->throughput_start_time = os::GetSystemTick().ToTimeSpan();
     }
 
@@ -1097,6 +1160,24 @@ namespace ams::ncm {
         }
     }
 
+    void InstallTaskBase::UpdatePipelineThroughputMeasurement(InstallPipelineStage stage, s64 throughput, TimeSpan elapsed_time) {
+        std::scoped_lock lk(this->throughput_mutex);
+
+        /* Update throughput only if start time has been set. */
+        if (this->throughput_start_time.GetNanoSeconds() != 0) {
+            InstallThroughput *stage_throughput = nullptr;
+            switch (stage) {
+                case InstallPipelineStage::Read:  stage_throughput = std::addressof(this->pipeline_throughput.read);  break;
+                case InstallPipelineStage::Write: stage_throughput = std::addressof(this->pipeline_throughput.write); break;
+                case InstallPipelineStage::Hash:  stage_throughput = std::addressof(this->pipeline_throughput.hash);  break;
+                AMS_UNREACHABLE_DEFAULT_CASE();
+            }
+
+            stage_throughput->installed    += throughput;
+            stage_throughput->elapsed_time += elapsed_time;
+        }
+    }
+
     Result InstallTaskBase::CalculateContentsSize(s64 *out_size, const ContentMetaKey &key, StorageId storage_id) {
         /* Count the number of content meta entries. */
         s32 count;
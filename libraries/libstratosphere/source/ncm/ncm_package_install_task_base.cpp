@@ -20,8 +20,7 @@ namespace ams::ncm {
     Result PackageInstallTaskBase::Initialize(const char *package_root_path, void *buffer, size_t buffer_size, StorageId storage_id, InstallTaskDataBase *data, u32 config) {
         R_TRY(InstallTaskBase::Initialize(storage_id, data, config));
         this->package_root.Set(package_root_path);
-        this->buffer = buffer;
-        this->buffer_size = buffer_size;
+        this->SetInstallBuffer(buffer, buffer_size);
         return ResultSuccess();
     }
 
@@ -39,10 +38,17 @@ namespace ams::ncm {
         ON_SCOPE_EXIT { fs::CloseFile(file); };
 
         /* Continuously write the file to the placeholder until there is nothing left to write. */
+        /* NOTE: When pipelined, data we've submitted may not have been written yet, so we track our own read offset. */
+        s64 offset = content_info->written;
         while (true) {
+            /* Get a buffer to read into. */
+            void *buffer;
+            size_t buffer_size;
+            R_TRY(this->AcquirePlaceHolderBuffer(std::addressof(buffer), std::addressof(buffer_size), content_info));
+
             /* Read as much of the remainder of the file as possible. */
             size_t size_read;
-            R_TRY(fs::ReadFile(std::addressof(size_read), file, content_info->written, this->buffer, this->buffer_size));
+            R_TRY(fs::ReadFile(std::addressof(size_read), file, offset, buffer, buffer_size));
 
             /* There is nothing left to read. */
             if (size_read == 0) {
@@ -50,7 +56,8 @@ namespace ams::ncm {
             }
 
             /* Write the placeholder. */
-            R_TRY(this->WritePlaceHolderBuffer(content_info, this->buffer, size_read));
+            R_TRY(this->WritePlaceHolderBuffer(content_info, buffer, size_read));
+            offset += size_read;
         }
 
         return ResultSuccess();
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+#include <sys/mman.h>
+
+namespace ams::os::impl {
+
+    inline bool CheckFreeSpace(uintptr_t address, size_t size) {
+        /* Probe the range with a reservation which fails if anything is already mapped there. */
+        void *reserved = ::mmap(reinterpret_cast<void *>(address), size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED_NOREPLACE, -1, 0);
+        if (reserved == MAP_FAILED) {
+            return false;
+        }
+
+        /* NOTE: Kernels which predate MAP_FIXED_NOREPLACE treat it as a hint, and may place the mapping elsewhere. */
+        ::munmap(reserved, size);
+        return reserved == reinterpret_cast<void *>(address);
+    }
+
+}
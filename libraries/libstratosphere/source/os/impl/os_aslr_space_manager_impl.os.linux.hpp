@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+
+namespace ams::os::impl {
+
+    class AslrSpaceManagerLinuxImpl {
+        NON_COPYABLE(AslrSpaceManagerLinuxImpl);
+        NON_MOVEABLE(AslrSpaceManagerLinuxImpl);
+        private:
+            /* NOTE: This is most of the 47-bit x64 user address space. Ranges which are already mapped */
+            /* (the executable, its heap, the stacks) are skipped when the allocator probes for free space. */
+            static constexpr u64 AslrBase = 0x0000100000000000ul;
+            static constexpr u64 AslrSize = 0x0000500000000000ul;
+        public:
+            constexpr AslrSpaceManagerLinuxImpl() = default;
+
+            static u64 GetAslrSpaceBeginAddress() {
+                return AslrBase;
+            }
+
+            static u64 GetAslrSpaceEndAddress() {
+                return AslrBase + AslrSize;
+            }
+    };
+
+    using AslrSpaceManagerImpl = AslrSpaceManagerLinuxImpl;
+
+}
@@ -20,6 +20,8 @@
 
 #ifdef ATMOSPHERE_OS_HORIZON
     #include "os_aslr_space_manager_impl.os.horizon.hpp"
+#elif defined(ATMOSPHERE_OS_LINUX)
+    #include "os_aslr_space_manager_impl.os.linux.hpp"
 #else
     #error "Unknown OS for AslrSpaceManagerImpl"
 #endif
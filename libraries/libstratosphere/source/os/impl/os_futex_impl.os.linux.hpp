@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+
+namespace ams::os::impl {
+
+    ALWAYS_INLINE u32 GetCurrentNativeThreadId() {
+        /* Cache the kernel thread id, so that lock acquisition doesn't need a syscall. */
+        static thread_local u32 s_current_tid = 0;
+        if (AMS_UNLIKELY(s_current_tid == 0)) {
+            s_current_tid = static_cast<u32>(::syscall(SYS_gettid));
+        }
+        return s_current_tid;
+    }
+
+    ALWAYS_INLINE ::timespec ConvertToTimeSpec(TimeSpan ts) {
+        const s64 ns = std::max<s64>(ts.GetNanoSeconds(), 0);
+        return ::timespec{ .tv_sec = static_cast<time_t>(ns / TimeSpan::FromSeconds(1).GetNanoSeconds()), .tv_nsec = static_cast<long>(ns % TimeSpan::FromSeconds(1).GetNanoSeconds()) };
+    }
+
+    /* Returns false only if the wait timed out; spurious wakeups and value mismatches return true. */
+    inline bool FutexWait(u32 *address, u32 expected, const ::timespec *timeout = nullptr) {
+        const long res = ::syscall(SYS_futex, address, FUTEX_WAIT_PRIVATE, expected, timeout, nullptr, 0);
+        return !(res == -1 && errno == ETIMEDOUT);
+    }
+
+    inline void FutexWake(u32 *address, s32 count) {
+        ::syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+    }
+
+}
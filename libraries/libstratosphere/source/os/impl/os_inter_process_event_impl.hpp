@@ -18,6 +18,8 @@
 
 #if defined(ATMOSPHERE_OS_HORIZON)
     #include "os_inter_process_event_impl.os.horizon.hpp"
+#elif defined(ATMOSPHERE_OS_LINUX)
+    #include "os_inter_process_event_impl.os.linux.hpp"
 #else
     #error "Unknown OS for ams::os::InterProcessEventImpl"
 #endif
\ No newline at end of file
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "os_inter_process_event.hpp"
+#include "os_inter_process_event_impl.os.linux.hpp"
+#include "os_timeout_helper.hpp"
+#include "os_futex_impl.os.linux.hpp"
+#include <poll.h>
+#include <fcntl.h>
+#include <sys/eventfd.h>
+
+namespace ams::os::impl {
+
+    namespace {
+
+        /* An event is an eventfd; it is signaled while its counter is non-zero. */
+        bool PollEvent(Handle handle, const ::timespec *timeout) {
+            ::pollfd fd = { .fd = static_cast<int>(handle), .events = POLLIN, .revents = 0 };
+
+            while (true) {
+                const int res = ::ppoll(std::addressof(fd), 1, timeout, nullptr);
+                if (res < 0) {
+                    AMS_ABORT_UNLESS(errno == EINTR);
+                    continue;
+                }
+
+                AMS_ABORT_UNLESS((fd.revents & POLLNVAL) == 0);
+                return res > 0;
+            }
+        }
+
+        bool ResetSignal(Handle handle) {
+            /* Reading an eventfd atomically resets its counter, and fails if it was already zero. */
+            u64 value;
+            return ::read(static_cast<int>(handle), std::addressof(value), sizeof(value)) == sizeof(value);
+        }
+
+    }
+
+    Result InterProcessEventImpl::Create(Handle *out_write, Handle *out_read) {
+        /* Create the event. */
+        const int rh = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        R_UNLESS(rh >= 0, os::ResultOutOfResource());
+
+        /* Duplicate it, so that each end can be closed independently. */
+        const int wh = ::fcntl(rh, F_DUPFD_CLOEXEC, 0);
+        if (wh < 0) {
+            ::close(rh);
+            return os::ResultOutOfResource();
+        }
+
+        *out_write = static_cast<Handle>(wh);
+        *out_read  = static_cast<Handle>(rh);
+        return ResultSuccess();
+    }
+
+    void InterProcessEventImpl::Close(Handle handle) {
+        if (handle != svc::InvalidHandle) {
+            AMS_ABORT_UNLESS(::close(static_cast<int>(handle)) == 0);
+        }
+    }
+
+    void InterProcessEventImpl::Signal(Handle handle) {
+        /* NOTE: If the counter would overflow the event is already signaled, so EAGAIN is benign. */
+        const u64 value = 1;
+        const auto res = ::write(static_cast<int>(handle), std::addressof(value), sizeof(value));
+        AMS_ABORT_UNLESS(res == sizeof(value) || errno == EAGAIN);
+    }
+
+    void InterProcessEventImpl::Clear(Handle handle) {
+        ResetSignal(handle);
+    }
+
+    void InterProcessEventImpl::Wait(Handle handle, bool auto_clear) {
+        while (true) {
+            /* Continuously wait, until success. */
+            PollEvent(handle, nullptr);
+
+            /* Clear, if we must. */
+            if (auto_clear && !ResetSignal(handle)) {
+                /* Some other thread might have caught this before we did. */
+                continue;
+            }
+
+            return;
+        }
+    }
+
+    bool InterProcessEventImpl::TryWait(Handle handle, bool auto_clear) {
+        /* If we're auto clear, just try to reset. */
+        if (auto_clear) {
+            return ResetSignal(handle);
+        }
+
+        /* Not auto-clear. */
+        const ::timespec timeout = {};
+        return PollEvent(handle, std::addressof(timeout));
+    }
+
+    bool InterProcessEventImpl::TimedWait(Handle handle, bool auto_clear, TimeSpan timeout) {
+        TimeoutHelper timeout_helper(timeout);
+
+        while (true) {
+            /* Continuously wait, until success or timeout. */
+            const ::timespec left = ConvertToTimeSpec(timeout_helper.GetTimeLeftOnTarget());
+            if (PollEvent(handle, std::addressof(left))) {
+                /* Clear, if we must. */
+                if (auto_clear && !ResetSignal(handle)) {
+                    /* Some other thread might have caught this before we did. */
+                    continue;
+                }
+
+                return true;
+            }
+
+            if (timeout_helper.TimedOut()) {
+                return false;
+            }
+        }
+    }
+
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+
+namespace ams::os::impl {
+
+    class InterProcessEventImpl {
+        public:
+            static Result Create(Handle *out_write, Handle *out_read);
+            static void Close(Handle handle);
+            static void Signal(Handle handle);
+            static void Clear(Handle handle);
+            static void Wait(Handle handle, bool auto_clear);
+            static bool TryWait(Handle handle, bool auto_clear);
+            static bool TimedWait(Handle handle, bool auto_clear, TimeSpan timeout);
+    };
+
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "os_timeout_helper.hpp"
+#include "os_futex_impl.os.linux.hpp"
+
+namespace ams::os::impl {
+
+    void InternalConditionVariableImpl::Signal() {
+        __atomic_fetch_add(std::addressof(this->value), 1, __ATOMIC_RELEASE);
+        FutexWake(std::addressof(this->value), 1);
+    }
+
+    void InternalConditionVariableImpl::Broadcast() {
+        __atomic_fetch_add(std::addressof(this->value), 1, __ATOMIC_RELEASE);
+        FutexWake(std::addressof(this->value), std::numeric_limits<s32>::max());
+    }
+
+    void InternalConditionVariableImpl::Wait(InternalCriticalSection *cs) {
+        AMS_ASSERT(cs->IsLockedByCurrentThread());
+
+        /* Sample the sequence before unlocking, so that a signal between unlock and wait isn't lost. */
+        const u32 seq = __atomic_load_n(std::addressof(this->value), __ATOMIC_ACQUIRE);
+
+        cs->Leave();
+        FutexWait(std::addressof(this->value), seq);
+        cs->Enter();
+    }
+
+    ConditionVariableStatus InternalConditionVariableImpl::TimedWait(InternalCriticalSection *cs, const TimeoutHelper &timeout_helper) {
+        AMS_ASSERT(cs->IsLockedByCurrentThread());
+
+        const TimeSpan left = timeout_helper.GetTimeLeftOnTarget();
+        if (left > 0) {
+            const u32 seq = __atomic_load_n(std::addressof(this->value), __ATOMIC_ACQUIRE);
+            const ::timespec timeout = ConvertToTimeSpec(left);
+
+            cs->Leave();
+            const bool woken = FutexWait(std::addressof(this->value), seq, std::addressof(timeout));
+            cs->Enter();
+
+            return woken ? ConditionVariableStatus::Success : ConditionVariableStatus::TimedOut;
+        } else {
+            return ConditionVariableStatus::TimedOut;
+        }
+    }
+
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "os_futex_impl.os.linux.hpp"
+
+namespace ams::os::impl {
+
+    void InternalCriticalSectionImpl::Enter() {
+        const u32 cur_tid = GetCurrentNativeThreadId();
+
+        /* Fast path: take an uncontended lock. */
+        u32 expected = 0;
+        if (__atomic_compare_exchange_n(std::addressof(this->thread_handle), std::addressof(expected), cur_tid, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            return;
+        }
+
+        while (true) {
+            /* If the lock was released, try to take it. We may not be the only waiter, so keep the wait flag set. */
+            if (expected == 0) {
+                if (__atomic_compare_exchange_n(std::addressof(this->thread_handle), std::addressof(expected), cur_tid | WaitMask, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                    return;
+                }
+                continue;
+            }
+
+            /* Mark that there are waiters, so that the owner wakes us on release. */
+            if ((expected & WaitMask) == 0) {
+                if (!__atomic_compare_exchange_n(std::addressof(this->thread_handle), std::addressof(expected), expected | WaitMask, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                    continue;
+                }
+                expected |= WaitMask;
+            }
+
+            FutexWait(std::addressof(this->thread_handle), expected);
+            expected = __atomic_load_n(std::addressof(this->thread_handle), __ATOMIC_RELAXED);
+        }
+    }
+
+    bool InternalCriticalSectionImpl::TryEnter() {
+        u32 expected = 0;
+        return __atomic_compare_exchange_n(std::addressof(this->thread_handle), std::addressof(expected), GetCurrentNativeThreadId(), false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+    }
+
+    void InternalCriticalSectionImpl::Leave() {
+        AMS_ASSERT(this->IsLockedByCurrentThread());
+
+        if (__atomic_exchange_n(std::addressof(this->thread_handle), 0, __ATOMIC_RELEASE) & WaitMask) {
+            FutexWake(std::addressof(this->thread_handle), 1);
+        }
+    }
+
+    bool InternalCriticalSectionImpl::IsLockedByCurrentThread() const {
+        return (__atomic_load_n(std::addressof(this->thread_handle), __ATOMIC_RELAXED) & ~WaitMask) == GetCurrentNativeThreadId();
+    }
+
+}
@@ -18,6 +18,8 @@
 
 #if defined(ATMOSPHERE_OS_HORIZON)
     #include "os_rw_lock_target_impl.os.horizon.hpp"
+#elif defined(ATMOSPHERE_OS_LINUX)
+    #include "os_rw_lock_target_impl.os.linux.hpp"
 #else
     #error "Unknown OS for os::ReadWriteLockTargetImpl"
 #endif
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "os_rw_lock_impl.hpp"
+#include "os_thread_manager.hpp"
+
+namespace ams::os::impl {
+
+    /* NOTE: Without kernel lock arbitration, the lock count is protected by its critical section rather than updated lock-free. */
+
+    namespace {
+
+        ALWAYS_INLINE InternalCriticalSection &GetCriticalSection(os::ReadWriteLockType *rw_lock) {
+            return GetReference(GetLockCount(rw_lock).cs_storage);
+        }
+
+        ALWAYS_INLINE InternalConditionVariable &GetReadLockConditionVariable(os::ReadWriteLockType *rw_lock) {
+            return GetReference(rw_lock->cv_read_lock._storage);
+        }
+
+        ALWAYS_INLINE InternalConditionVariable &GetWriteLockConditionVariable(os::ReadWriteLockType *rw_lock) {
+            return GetReference(rw_lock->cv_write_lock._storage);
+        }
+
+    }
+
+    void ReadWriteLockLinuxImpl::ReleaseWriteLockImpl(os::ReadWriteLockType *rw_lock) {
+        auto &lock_count = GetLockCount(rw_lock);
+        AMS_ASSERT(GetWriteLocked(lock_count) == 1);
+
+        if (GetReadLockCount(lock_count) == 0 && GetWriteLockCount(*rw_lock) == 0) {
+            rw_lock->owner_thread = nullptr;
+            ClearWriteLocked(lock_count);
+
+            if (GetWriteLockWaiterCount(lock_count) > 0) {
+                GetWriteLockConditionVariable(rw_lock).Signal();
+            } else if (GetReadLockWaiterCount(lock_count) > 0) {
+                GetReadLockConditionVariable(rw_lock).Broadcast();
+            }
+        }
+    }
+
+    void ReadWriteLockLinuxImpl::AcquireReadLock(os::ReadWriteLockType *rw_lock) {
+        auto *cur_thread = impl::GetCurrentThread();
+        std::scoped_lock lk(GetCriticalSection(rw_lock));
+
+        auto &lock_count = GetLockCount(rw_lock);
+        if (rw_lock->owner_thread == cur_thread) {
+            AMS_ASSERT(GetWriteLocked(lock_count) == 1);
+            IncReadLockCount(lock_count);
+        } else {
+            /* Writers take precedence over new readers. */
+            if (GetWriteLocked(lock_count) != 0 || GetWriteLockWaiterCount(lock_count) != 0) {
+                IncReadLockWaiterCount(lock_count);
+                do {
+                    GetReadLockConditionVariable(rw_lock).Wait(std::addressof(GetCriticalSection(rw_lock)));
+                } while (GetWriteLocked(lock_count) != 0 || GetWriteLockWaiterCount(lock_count) != 0);
+                DecReadLockWaiterCount(lock_count);
+            }
+
+            IncReadLockCount(lock_count);
+        }
+    }
+
+    bool ReadWriteLockLinuxImpl::TryAcquireReadLock(os::ReadWriteLockType *rw_lock) {
+        auto *cur_thread = impl::GetCurrentThread();
+        std::scoped_lock lk(GetCriticalSection(rw_lock));
+
+        auto &lock_count = GetLockCount(rw_lock);
+        if (rw_lock->owner_thread == cur_thread) {
+            AMS_ASSERT(GetWriteLocked(lock_count) == 1);
+            IncReadLockCount(lock_count);
+            return true;
+        } else {
+            if (GetWriteLocked(lock_count) != 0 || GetWriteLockWaiterCount(lock_count) != 0) {
+                return false;
+            }
+
+            IncReadLockCount(lock_count);
+            return true;
+        }
+    }
+
+    void ReadWriteLockLinuxImpl::ReleaseReadLock(os::ReadWriteLockType *rw_lock) {
+        auto *cur_thread = impl::GetCurrentThread();
+        std::scoped_lock lk(GetCriticalSection(rw_lock));
+
+        auto &lock_count = GetLockCount(rw_lock);
+        AMS_ASSERT(GetReadLockCount(lock_count) > 0);
+
+        DecReadLockCount(lock_count);
+        if (rw_lock->owner_thread == cur_thread) {
+            return ReleaseWriteLockImpl(rw_lock);
+        } else {
+            AMS_ASSERT(GetWriteLocked(lock_count) == 0);
+            if (GetReadLockCount(lock_count) == 0 && GetWriteLockWaiterCount(lock_count) != 0) {
+                GetWriteLockConditionVariable(rw_lock).Signal();
+            }
+        }
+    }
+
+    void ReadWriteLockLinuxImpl::AcquireWriteLock(os::ReadWriteLockType *rw_lock) {
+        auto *cur_thread = impl::GetCurrentThread();
+        std::scoped_lock lk(GetCriticalSection(rw_lock));
+
+        auto &lock_count = GetLockCount(rw_lock);
+        if (rw_lock->owner_thread == cur_thread) {
+            AMS_ASSERT(GetWriteLocked(lock_count) == 1);
+            IncWriteLockCount(*rw_lock);
+        } else {
+            if (GetReadLockCount(lock_count) > 0 || GetWriteLocked(lock_count) != 0) {
+                IncWriteLockWaiterCount(lock_count);
+                do {
+                    GetWriteLockConditionVariable(rw_lock).Wait(std::addressof(GetCriticalSection(rw_lock)));
+                } while (GetReadLockCount(lock_count) > 0 || GetWriteLocked(lock_count) != 0);
+                DecWriteLockWaiterCount(lock_count);
+            }
+
+            SetWriteLocked(lock_count);
+
+            AMS_ASSERT(GetWriteLockCount(*rw_lock) == 0);
+            IncWriteLockCount(*rw_lock);
+            rw_lock->owner_thread = cur_thread;
+        }
+    }
+
+    bool ReadWriteLockLinuxImpl::TryAcquireWriteLock(os::ReadWriteLockType *rw_lock) {
+        auto *cur_thread = impl::GetCurrentThread();
+        std::scoped_lock lk(GetCriticalSection(rw_lock));
+
+        auto &lock_count = GetLockCount(rw_lock);
+        if (rw_lock->owner_thread == cur_thread) {
+            AMS_ASSERT(GetWriteLocked(lock_count) == 1);
+            IncWriteLockCount(*rw_lock);
+            return true;
+        } else {
+            if (GetReadLockCount(lock_count) > 0 || GetWriteLocked(lock_count) != 0) {
+                return false;
+            }
+
+            SetWriteLocked(lock_count);
+
+            AMS_ASSERT(GetWriteLockCount(*rw_lock) == 0);
+            IncWriteLockCount(*rw_lock);
+            rw_lock->owner_thread = cur_thread;
+            return true;
+        }
+    }
+
+    void ReadWriteLockLinuxImpl::ReleaseWriteLock(os::ReadWriteLockType *rw_lock) {
+        std::scoped_lock lk(GetCriticalSection(rw_lock));
+
+        AMS_ASSERT(GetWriteLockCount(*rw_lock) > 0);
+        AMS_ASSERT(GetWriteLocked(GetLockCount(rw_lock)) != 0);
+
+        DecWriteLockCount(*rw_lock);
+        return ReleaseWriteLockImpl(rw_lock);
+    }
+
+}
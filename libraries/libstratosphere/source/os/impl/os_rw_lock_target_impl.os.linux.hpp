@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+
+namespace ams::os::impl {
+
+    class ReadWriteLockLinuxImpl {
+        private:
+            static void ReleaseWriteLockImpl(os::ReadWriteLockType *rw_lock);
+        public:
+            static void AcquireReadLock(os::ReadWriteLockType *rw_lock);
+            static bool TryAcquireReadLock(os::ReadWriteLockType *rw_lock);
+            static void ReleaseReadLock(os::ReadWriteLockType *rw_lock);
+
+            static void AcquireWriteLock(os::ReadWriteLockType *rw_lock);
+            static bool TryAcquireWriteLock(os::ReadWriteLockType *rw_lock);
+            static void ReleaseWriteLock(os::ReadWriteLockType *rw_lock);
+    };
+
+    using ReadWriteLockTargetImpl = ReadWriteLockLinuxImpl;
+
+}
@@ -31,8 +31,12 @@ namespace ams::os::impl {
     }
 
     ALWAYS_INLINE Handle GetCurrentThreadHandle() {
-        /* return GetCurrentThread()->thread_impl->handle; */
-        return ::threadGetCurHandle();
+        #if defined(ATMOSPHERE_OS_HORIZON)
+            /* return GetCurrentThread()->thread_impl->handle; */
+            return ::threadGetCurHandle();
+        #else
+            return GetCurrentThread()->thread_impl->handle;
+        #endif
     }
 
     void SetupThreadObjectUnsafe(ThreadType *thread, ThreadImpl *thread_impl, ThreadFunction function, void *arg, void *stack, size_t stack_size, s32 priority);
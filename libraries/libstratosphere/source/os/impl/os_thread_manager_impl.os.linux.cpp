@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "os_thread_manager_impl.os.linux.hpp"
+#include "os_thread_manager.hpp"
+#include "os_futex_impl.os.linux.hpp"
+#include <sched.h>
+#include <signal.h>
+#include <sys/eventfd.h>
+
+namespace ams::os::impl {
+
+    thread_local ThreadType *g_current_thread_pointer;
+
+    namespace {
+
+        ALWAYS_INLINE int GetSuspendSignal() {
+            return SIGRTMIN + 1;
+        }
+
+        void SuspendSignalHandler(int) {
+            /* Park the thread until it is resumed. */
+            if (g_current_thread_pointer == nullptr) {
+                return;
+            }
+
+            const int prev_errno = errno;
+
+            ThreadImpl *thread_impl = g_current_thread_pointer->thread_impl;
+            while (__atomic_load_n(std::addressof(thread_impl->suspended), __ATOMIC_ACQUIRE) != 0) {
+                FutexWait(std::addressof(thread_impl->suspended), 1);
+            }
+
+            errno = prev_errno;
+        }
+
+        Result SetupThreadImpl(ThreadImpl *thread_impl, s32 priority, s32 ideal_core, u64 affinity_mask) {
+            /* Create the event used to cancel the thread's blocking waits. */
+            const int cancel_handle = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+            R_UNLESS(cancel_handle >= 0, os::ResultOutOfResource());
+
+            thread_impl->pthread       = {};
+            thread_impl->handle        = 0;
+            thread_impl->cancel_handle = cancel_handle;
+            thread_impl->started       = 0;
+            thread_impl->exited        = 0;
+            thread_impl->suspended     = 0;
+            thread_impl->priority      = priority;
+            thread_impl->ideal_core    = ideal_core;
+            thread_impl->affinity_mask = affinity_mask;
+
+            return ResultSuccess();
+        }
+
+        void ApplyThreadCoreMask(const ThreadImpl *thread_impl) {
+            if (thread_impl->affinity_mask == 0) {
+                return;
+            }
+
+            cpu_set_t cpu_set;
+            CPU_ZERO(std::addressof(cpu_set));
+            for (s32 core = 0; core < CoreAffinityMaskBitWidth; ++core) {
+                if (thread_impl->affinity_mask & (1ul << core)) {
+                    CPU_SET(core, std::addressof(cpu_set));
+                }
+            }
+
+            AMS_ABORT_UNLESS(::pthread_setaffinity_np(thread_impl->pthread, sizeof(cpu_set), std::addressof(cpu_set)) == 0);
+        }
+
+        void *InvokeThread(void *arg) {
+            ThreadType *thread = static_cast<ThreadType *>(arg);
+            ThreadImpl *thread_impl = thread->thread_impl;
+
+            /* Set the thread's id. */
+            thread_impl->pthread = ::pthread_self();
+            thread_impl->handle  = GetCurrentNativeThreadId();
+            thread->thread_id    = thread_impl->handle;
+
+            /* Invoke the thread. */
+            ThreadManager::InvokeThread(thread);
+
+            /* Signal to waiters that we've exited. */
+            __atomic_store_n(std::addressof(thread_impl->exited), 1, __ATOMIC_RELEASE);
+            FutexWake(std::addressof(thread_impl->exited), std::numeric_limits<s32>::max());
+
+            return nullptr;
+        }
+
+    }
+
+    ThreadManagerLinuxImpl::ThreadManagerLinuxImpl(ThreadType *main_thread) {
+        /* Get the main thread's stack. */
+        void *stack = nullptr;
+        size_t stack_size = 0;
+        {
+            pthread_attr_t attr;
+            if (::pthread_getattr_np(::pthread_self(), std::addressof(attr)) == 0) {
+                ::pthread_attr_getstack(std::addressof(attr), std::addressof(stack), std::addressof(stack_size));
+                ::pthread_attr_destroy(std::addressof(attr));
+            }
+        }
+
+        SetupThreadObjectUnsafe(main_thread, nullptr, nullptr, nullptr, stack, stack_size, DefaultThreadPriority);
+
+        /* Set up the thread impl for the already-running main thread. */
+        ThreadImpl *thread_impl = main_thread->thread_impl;
+        R_ABORT_UNLESS(SetupThreadImpl(thread_impl, DefaultThreadPriority, IdealCoreDontCare, 0));
+
+        thread_impl->pthread = ::pthread_self();
+        thread_impl->handle  = GetCurrentNativeThreadId();
+        thread_impl->started = 1;
+
+        /* Set the thread id. */
+        main_thread->thread_id = thread_impl->handle;
+
+        /* Install the handler used to implement thread suspension. */
+        struct sigaction sa = {};
+        sa.sa_handler = SuspendSignalHandler;
+        sa.sa_flags   = SA_RESTART;
+        ::sigemptyset(std::addressof(sa.sa_mask));
+        AMS_ABORT_UNLESS(::sigaction(GetSuspendSignal(), std::addressof(sa), nullptr) == 0);
+    }
+
+    Result ThreadManagerLinuxImpl::CreateThread(ThreadType *thread, s32 ideal_core) {
+        /* NOTE: pthreads can't be created suspended, so the native thread is created by StartThread. */
+        const u64 affinity_mask = (ideal_core >= 0) ? (1ul << ideal_core) : 0;
+        return SetupThreadImpl(thread->thread_impl, thread->base_priority, ideal_core, affinity_mask);
+    }
+
+    void ThreadManagerLinuxImpl::DestroyThreadUnsafe(ThreadType *thread) {
+        ThreadImpl *thread_impl = thread->thread_impl;
+
+        if (thread_impl->started) {
+            AMS_ABORT_UNLESS(::pthread_join(thread_impl->pthread, nullptr) == 0);
+            thread_impl->started = 0;
+        }
+
+        ::close(thread_impl->cancel_handle);
+        thread_impl->cancel_handle = -1;
+    }
+
+    void ThreadManagerLinuxImpl::StartThread(const ThreadType *thread) {
+        ThreadImpl *thread_impl = thread->thread_impl;
+        AMS_ASSERT(!thread_impl->started);
+
+        pthread_attr_t attr;
+        AMS_ABORT_UNLESS(::pthread_attr_init(std::addressof(attr)) == 0);
+        ON_SCOPE_EXIT { ::pthread_attr_destroy(std::addressof(attr)); };
+
+        /* Use the caller's stack, if it's large enough for the host's requirements. */
+        if (thread->stack != nullptr && thread->stack_size >= static_cast<size_t>(PTHREAD_STACK_MIN)) {
+            AMS_ABORT_UNLESS(::pthread_attr_setstack(std::addressof(attr), thread->stack, thread->stack_size) == 0);
+        }
+
+        AMS_ABORT_UNLESS(::pthread_create(std::addressof(thread_impl->pthread), std::addressof(attr), InvokeThread, const_cast<ThreadType *>(thread)) == 0);
+        thread_impl->started = 1;
+
+        ApplyThreadCoreMask(thread_impl);
+    }
+
+    void ThreadManagerLinuxImpl::WaitForThreadExit(ThreadType *thread) {
+        ThreadImpl *thread_impl = thread->thread_impl;
+
+        while (__atomic_load_n(std::addressof(thread_impl->exited), __ATOMIC_ACQUIRE) == 0) {
+            FutexWait(std::addressof(thread_impl->exited), 0);
+        }
+    }
+
+    bool ThreadManagerLinuxImpl::TryWaitForThreadExit(ThreadType *thread) {
+        return __atomic_load_n(std::addressof(thread->thread_impl->exited), __ATOMIC_ACQUIRE) != 0;
+    }
+
+    void ThreadManagerLinuxImpl::YieldThread() {
+        ::sched_yield();
+    }
+
+    bool ThreadManagerLinuxImpl::ChangePriority(ThreadType *thread, s32 priority) {
+        /* NOTE: The default host scheduling policy has no static priorities, so we only track the value. */
+        thread->thread_impl->priority = priority;
+        return true;
+    }
+
+    s32 ThreadManagerLinuxImpl::GetCurrentPriority(const ThreadType *thread) const {
+        return thread->thread_impl->priority;
+    }
+
+    ThreadId ThreadManagerLinuxImpl::GetThreadId(const ThreadType *thread) const {
+        return thread->thread_id;
+    }
+
+    void ThreadManagerLinuxImpl::SuspendThreadUnsafe(ThreadType *thread) {
+        ThreadImpl *thread_impl = thread->thread_impl;
+
+        __atomic_store_n(std::addressof(thread_impl->suspended), 1, __ATOMIC_RELEASE);
+        if (thread_impl->started) {
+            AMS_ABORT_UNLESS(::pthread_kill(thread_impl->pthread, GetSuspendSignal()) == 0);
+        }
+    }
+
+    void ThreadManagerLinuxImpl::ResumeThreadUnsafe(ThreadType *thread) {
+        ThreadImpl *thread_impl = thread->thread_impl;
+
+        __atomic_store_n(std::addressof(thread_impl->suspended), 0, __ATOMIC_RELEASE);
+        FutexWake(std::addressof(thread_impl->suspended), 1);
+    }
+
+    void ThreadManagerLinuxImpl::CancelThreadSynchronizationUnsafe(ThreadType *thread) {
+        const u64 value = 1;
+        AMS_ABORT_UNLESS(::write(thread->thread_impl->cancel_handle, std::addressof(value), sizeof(value)) == sizeof(value));
+    }
+
+    /* TODO: void GetThreadContextUnsafe(ThreadContextInfo *out_context, const ThreadType *thread); */
+
+    void ThreadManagerLinuxImpl::NotifyThreadNameChangedImpl(const ThreadType *thread) const {
+        const ThreadImpl *thread_impl = thread->thread_impl;
+        if (!thread_impl->started || thread_impl->handle == 0) {
+            return;
+        }
+
+        /* Host thread names are limited to fifteen characters. */
+        char name[16];
+        util::Strlcpy(name, thread->name_pointer, sizeof(name));
+        ::pthread_setname_np(thread_impl->pthread, name);
+    }
+
+    s32 ThreadManagerLinuxImpl::GetCurrentCoreNumber() const {
+        return ::sched_getcpu();
+    }
+
+    void ThreadManagerLinuxImpl::SetThreadCoreMask(ThreadType *thread, s32 ideal_core, u64 affinity_mask) const {
+        ThreadImpl *thread_impl = thread->thread_impl;
+
+        if (ideal_core != IdealCoreNoUpdate) {
+            thread_impl->ideal_core = ideal_core;
+        }
+        thread_impl->affinity_mask = affinity_mask;
+
+        if (thread_impl->started) {
+            ApplyThreadCoreMask(thread_impl);
+        }
+    }
+
+    void ThreadManagerLinuxImpl::GetThreadCoreMask(s32 *out_ideal_core, u64 *out_affinity_mask, const ThreadType *thread) const {
+        const ThreadImpl *thread_impl = thread->thread_impl;
+
+        if (out_ideal_core) {
+            *out_ideal_core = thread_impl->ideal_core;
+        }
+        if (out_affinity_mask) {
+            *out_affinity_mask = thread_impl->affinity_mask != 0 ? thread_impl->affinity_mask : this->GetThreadAvailableCoreMask();
+        }
+    }
+
+    u64 ThreadManagerLinuxImpl::GetThreadAvailableCoreMask() const {
+        cpu_set_t cpu_set;
+        CPU_ZERO(std::addressof(cpu_set));
+        AMS_ABORT_UNLESS(::sched_getaffinity(0, sizeof(cpu_set), std::addressof(cpu_set)) == 0);
+
+        u64 core_mask = 0;
+        for (s32 core = 0; core < CoreAffinityMaskBitWidth; ++core) {
+            if (CPU_ISSET(core, std::addressof(cpu_set))) {
+                core_mask |= (1ul << core);
+            }
+        }
+        return core_mask;
+    }
+
+}
@@ -18,6 +18,8 @@
 
 #ifdef ATMOSPHERE_OS_HORIZON
     #include "os_thread_manager_impl.os.horizon.hpp"
+#elif defined(ATMOSPHERE_OS_LINUX)
+    #include "os_thread_manager_impl.os.linux.hpp"
 #else
     #error "Unknown OS for ThreadManagerImpl"
 #endif
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+#include <time.h>
+
+namespace ams::os::impl {
+
+    class TickManagerImpl {
+        public:
+            constexpr TickManagerImpl() { /* ... */ }
+
+            ALWAYS_INLINE Tick GetTick() const {
+                /* The monotonic clock is reported in nanoseconds, so one tick is one nanosecond. */
+                ::timespec ts;
+                ::clock_gettime(CLOCK_MONOTONIC, std::addressof(ts));
+                return Tick(static_cast<s64>(ts.tv_sec) * TimeSpan::FromSeconds(1).GetNanoSeconds() + static_cast<s64>(ts.tv_nsec));
+            }
+
+            ALWAYS_INLINE Tick GetSystemTickOrdered() const {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                const Tick tick = this->GetTick();
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                return tick;
+            }
+
+            static constexpr ALWAYS_INLINE s64 GetTickFrequency() {
+                return TimeSpan::FromSeconds(1).GetNanoSeconds();
+            }
+
+            static constexpr ALWAYS_INLINE s64 GetMaxTick() {
+                static_assert(GetTickFrequency() <= TimeSpan::FromSeconds(1).GetNanoSeconds());
+                return (std::numeric_limits<s64>::max() / TimeSpan::FromSeconds(1).GetNanoSeconds()) * GetTickFrequency();
+            }
+
+            static constexpr ALWAYS_INLINE s64 GetMaxTimeSpanNs() {
+                static_assert(GetTickFrequency() <= TimeSpan::FromSeconds(1).GetNanoSeconds());
+                return TimeSpan::FromNanoSeconds(std::numeric_limits<s64>::max()).GetNanoSeconds();
+            }
+    };
+
+}
@@ -19,6 +19,8 @@
 
 #if defined(ATMOSPHERE_OS_HORIZON)
     #include "os_timeout_helper_impl.os.horizon.hpp"
+#elif defined(ATMOSPHERE_OS_LINUX)
+    #include "os_timeout_helper_impl.os.linux.hpp"
 #else
     #error "Unknown OS for ams::os::TimeoutHelper"
 #endif
@@ -27,6 +27,7 @@ namespace ams::os::impl {
         public:
             util::IntrusiveListNode manager_node;
             util::IntrusiveListNode object_list_node;
+            util::IntrusiveListNode user_object_node;
         public:
             /* Gets whether the held waitable is currently signaled. */
             virtual TriBool IsSignaled() const = 0;
@@ -17,7 +17,9 @@
 #include "os_waitable_holder_of_handle.hpp"
 #include "os_waitable_holder_of_event.hpp"
 #include "os_waitable_holder_of_inter_process_event.hpp"
+#if defined(ATMOSPHERE_OS_HORIZON)
 #include "os_waitable_holder_of_interrupt_event.hpp"
+#endif
 #include "os_waitable_holder_of_timer_event.hpp"
 #include "os_waitable_holder_of_thread.hpp"
 #include "os_waitable_holder_of_semaphore.hpp"
@@ -30,7 +32,9 @@ namespace ams::os::impl {
             util::TypedStorage<WaitableHolderOfHandle>                   holder_of_handle_storage;
             util::TypedStorage<WaitableHolderOfEvent>                    holder_of_event_storage;
             util::TypedStorage<WaitableHolderOfInterProcessEvent>        holder_of_inter_process_event_storage;
+            #if defined(ATMOSPHERE_OS_HORIZON)
             util::TypedStorage<WaitableHolderOfInterruptEvent>           holder_of_interrupt_event_storage;
+            #endif
             util::TypedStorage<WaitableHolderOfTimerEvent>               holder_of_timer_event_storage;
             util::TypedStorage<WaitableHolderOfThread>                   holder_of_thread_storage;
             util::TypedStorage<WaitableHolderOfSemaphore>                holder_of_semaphore_storage;
@@ -45,7 +49,9 @@ namespace ams::os::impl {
     CHECK_HOLDER(WaitableHolderOfHandle);
     CHECK_HOLDER(WaitableHolderOfEvent);
     CHECK_HOLDER(WaitableHolderOfInterProcessEvent);
+    #if defined(ATMOSPHERE_OS_HORIZON)
     CHECK_HOLDER(WaitableHolderOfInterruptEvent);
+    #endif
     CHECK_HOLDER(WaitableHolderOfTimerEvent);
     CHECK_HOLDER(WaitableHolderOfThread);
     CHECK_HOLDER(WaitableHolderOfSemaphore);
@@ -20,6 +20,153 @@
 
 namespace ams::os::impl {
 
+    void WaitableManagerRelay::ThreadFunction(void *arg) {
+        static_cast<WaitableManagerRelay *>(arg)->ThreadFunctionImpl();
+    }
+
+    void WaitableManagerRelay::ThreadFunctionImpl() {
+        /* Let our owner know that we can now be cancelled. */
+        this->target_impl.SetCurrentThreadHandleForCancelWait();
+        {
+            std::scoped_lock lk(this->cs);
+            this->is_ready = true;
+            this->cv.Broadcast();
+        }
+
+        while (true) {
+            /* Wait for our owner to begin a wait. */
+            {
+                std::scoped_lock lk(this->cs);
+                while (!this->is_waiting && !this->is_exit_requested) {
+                    this->cv.Wait(std::addressof(this->cs));
+                }
+
+                if (this->is_exit_requested) {
+                    break;
+                }
+            }
+
+            /* Wait on our handles; our owner cancels us when its own wait completes. */
+            s32 index = WaitableManagerImpl::WaitInvalid;
+            R_ABORT_UNLESS(this->target_impl.WaitAny(std::addressof(index), this->handle_group.handles, WaitableHandleGroup::MaximumHandleCount, this->handle_group.count));
+
+            if (index >= 0) {
+                this->manager->SignalAndWakeupThread(this->handle_group.objects[index]);
+            }
+
+            /* Park until the next wait. */
+            std::scoped_lock lk(this->cs);
+
+            if (this->is_cancel_requested && index != WaitableManagerImpl::WaitCancelled) {
+                /* Our owner cancelled us after our wait completed; consume the pending cancellation so that it can't end our next wait early. */
+                s32 dummy_index;
+                R_ABORT_UNLESS(this->target_impl.TryWaitAny(std::addressof(dummy_index), this->handle_group.handles, WaitableHandleGroup::MaximumHandleCount, this->handle_group.count));
+            }
+
+            this->is_cancel_requested = false;
+            this->is_waiting          = false;
+            this->cv.Broadcast();
+        }
+
+        this->target_impl.ClearCurrentThreadHandleForCancelWait();
+    }
+
+    WaitableManagerRelay::~WaitableManagerRelay() {
+        if (this->has_thread) {
+            {
+                std::scoped_lock lk(this->cs);
+                this->is_exit_requested = true;
+                this->cv.Broadcast();
+            }
+
+            os::WaitThread(std::addressof(this->thread));
+            os::DestroyThread(std::addressof(this->thread));
+        }
+    }
+
+    Result WaitableManagerRelay::StartThread(void *stack, size_t stack_size, s32 priority) {
+        AMS_ASSERT(!this->has_thread);
+
+        /* Create the thread. */
+        R_TRY(os::CreateThread(std::addressof(this->thread), ThreadFunction, this, stack, stack_size, priority));
+        os::SetThreadNamePointer(std::addressof(this->thread), "WaitableManagerRelay");
+        os::StartThread(std::addressof(this->thread));
+        this->has_thread = true;
+
+        /* Wait for the thread to be ready to be cancelled. */
+        {
+            std::scoped_lock lk(this->cs);
+            while (!this->is_ready) {
+                this->cv.Wait(std::addressof(this->cs));
+            }
+        }
+
+        return ResultSuccess();
+    }
+
+    void WaitableManagerRelay::StartWait() {
+        /* Relays with nothing to wait on stay parked. */
+        if (this->handle_group.count == 0) {
+            return;
+        }
+
+        std::scoped_lock lk(this->cs);
+        AMS_ASSERT(!this->is_waiting);
+
+        this->is_waiting = true;
+        this->cv.Broadcast();
+    }
+
+    void WaitableManagerRelay::StopWait() {
+        std::scoped_lock lk(this->cs);
+
+        if (this->is_waiting) {
+            this->is_cancel_requested = true;
+            this->target_impl.CancelWait();
+
+            while (this->is_waiting) {
+                this->cv.Wait(std::addressof(this->cs));
+            }
+        }
+    }
+
+    WaitableManagerImpl::~WaitableManagerImpl() {
+        /* The relays' storage belongs to our user, so we only destroy them. */
+        while (this->relay_list != nullptr) {
+            auto *relay = this->relay_list;
+            this->relay_list = relay->next;
+
+            std::destroy_at(relay);
+        }
+    }
+
+    Result WaitableManagerImpl::AttachRelay(WaitableManagerRelay *relay) {
+        /* Only the first relay may be waited on by our own thread; the rest need threads of their own. */
+        WaitableManagerRelay **link = std::addressof(this->relay_list);
+        while (*link != nullptr) {
+            link = std::addressof((*link)->next);
+        }
+        AMS_ASSERT(relay->HasThread() == (this->relay_list != nullptr));
+
+        /* The first relay takes over the handles we'd otherwise gather on each wait. */
+        if (this->relay_list == nullptr) {
+            auto &group = relay->GetHandleGroup();
+            for (WaitableHolderBase &holder_base : this->waitable_list) {
+                if (const Handle handle = holder_base.GetHandle(); handle != svc::InvalidHandle) {
+                    if (group.IsFull()) {
+                        group.count = 0;
+                        return os::ResultOutOfResource();
+                    }
+
+                    group.Add(std::addressof(holder_base), handle);
+                }
+            }
+        }
+
+        *link = relay;
+        return ResultSuccess();
+    }
+
     Result WaitableManagerImpl::WaitAnyImpl(WaitableHolderBase **out, bool infinite, TimeSpan timeout, bool reply, Handle reply_target) {
         /* Prepare for processing. */
         this->signaled_holder = nullptr;
@@ -60,12 +207,38 @@ namespace ams::os::impl {
     }
 
     Result WaitableManagerImpl::WaitAnyHandleImpl(WaitableHolderBase **out, bool infinite, TimeSpan timeout, bool reply, Handle reply_target) {
-        Handle object_handles[MaximumHandleCount];
-        WaitableHolderBase *objects[MaximumHandleCount];
+        Handle handle_array[MaximumHandleCount];
+        WaitableHolderBase *object_array[MaximumHandleCount];
+
+        /* Without relays, we build our handle array from our holders; otherwise, we wait on the first relay's group. */
+        Handle *object_handles       = handle_array;
+        WaitableHolderBase **objects = object_array;
+        s32 count;
+        if (this->relay_list == nullptr) {
+            count = this->BuildHandleArray(object_handles, objects, MaximumHandleCount);
+        } else {
+            auto &group    = this->relay_list->GetHandleGroup();
+            object_handles = group.handles;
+            objects        = group.objects;
+            count          = group.count;
+        }
 
-        const s32 count = this->BuildHandleArray(object_handles, objects, MaximumHandleCount);
         const TimeSpan end_time = infinite ? TimeSpan::FromNanoSeconds(std::numeric_limits<s64>::max()) : GetCurrentTick().ToTimeSpan() + timeout;
 
+        /* Handles beyond the first group are waited on by relay threads, which wake us via SignalAndWakeupThread. */
+        const bool has_relay_threads = this->relay_list != nullptr && this->relay_list->next != nullptr;
+        if (has_relay_threads) {
+            if (!infinite && timeout == 0) {
+                if (WaitableHolderBase *holder = this->PollRelays(); holder != nullptr) {
+                    *out = holder;
+                    return ResultSuccess();
+                }
+            } else {
+                this->StartRelays();
+            }
+        }
+        ON_SCOPE_EXIT { if (has_relay_threads) { this->StopRelays(); } };
+
         while (true) {
             this->current_time = GetCurrentTick().ToTimeSpan();
 
@@ -135,6 +308,102 @@ namespace ams::os::impl {
         }
     }
 
+    WaitableManagerRelay *WaitableManagerImpl::FindRelayWithSpace() const {
+        /* Earlier relays are preferred, as the first is waited on without a thread hop. */
+        WaitableManagerRelay *relay = this->relay_list;
+        while (relay != nullptr && relay->GetHandleGroup().IsFull()) {
+            relay = relay->next;
+        }
+        return relay;
+    }
+
+    bool WaitableManagerImpl::CanAddToWaitSet(const WaitableHolderBase &holder_base) const {
+        return holder_base.GetHandle() == svc::InvalidHandle || this->relay_list == nullptr || this->FindRelayWithSpace() != nullptr;
+    }
+
+    Result WaitableManagerImpl::AddToWaitSet(WaitableHolderBase &holder_base) {
+        /* Holders without a handle must be linked to their object lists on each wait, so we track them separately. */
+        const Handle handle = holder_base.GetHandle();
+        if (handle == svc::InvalidHandle) {
+            this->user_object_list.push_back(holder_base);
+            return ResultSuccess();
+        }
+
+        /* Without relays, our handle array is built on each wait. */
+        if (this->relay_list == nullptr) {
+            return ResultSuccess();
+        }
+
+        /* Otherwise, the handle goes in the first relay with space. */
+        WaitableManagerRelay *relay = this->FindRelayWithSpace();
+        R_UNLESS(relay != nullptr, os::ResultOutOfResource());
+
+        relay->GetHandleGroup().Add(std::addressof(holder_base), handle);
+        return ResultSuccess();
+    }
+
+    void WaitableManagerImpl::RemoveFromWaitSet(WaitableHolderBase &holder_base) {
+        if (holder_base.GetHandle() == svc::InvalidHandle) {
+            this->user_object_list.erase(this->user_object_list.iterator_to(holder_base));
+            return;
+        }
+
+        if (this->relay_list == nullptr) {
+            return;
+        }
+
+        for (auto *relay = this->relay_list; relay != nullptr; relay = relay->next) {
+            if (relay->GetHandleGroup().Remove(std::addressof(holder_base))) {
+                return;
+            }
+        }
+
+        AMS_ABORT("Linked waitable holder was not in the wait set");
+    }
+
+    void WaitableManagerImpl::ClearWaitSet() {
+        this->user_object_list.clear();
+
+        for (auto *relay = this->relay_list; relay != nullptr; relay = relay->next) {
+            relay->GetHandleGroup().count = 0;
+        }
+    }
+
+    WaitableHolderBase *WaitableManagerImpl::PollRelays() {
+        for (auto *relay = this->relay_list->next; relay != nullptr; relay = relay->next) {
+            auto &group = relay->GetHandleGroup();
+            if (group.count == 0) {
+                continue;
+            }
+
+            s32 index = WaitInvalid;
+            R_ABORT_UNLESS(this->target_impl.TryWaitAny(std::addressof(index), group.handles, MaximumHandleCount, group.count));
+
+            std::scoped_lock lk(this->cs_wait);
+            if (index >= 0) {
+                this->signaled_holder = group.objects[index];
+                return this->signaled_holder;
+            } else if (index == WaitCancelled && this->signaled_holder != nullptr) {
+                /* We consumed a wakeup meant for a user object; honor it here. */
+                return this->signaled_holder;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void WaitableManagerImpl::StartRelays() {
+        for (auto *relay = this->relay_list->next; relay != nullptr; relay = relay->next) {
+            relay->StartWait();
+        }
+    }
+
+    void WaitableManagerImpl::StopRelays() {
+        for (auto *relay = this->relay_list->next; relay != nullptr; relay = relay->next) {
+            relay->StopWait();
+        }
+    }
+
     s32 WaitableManagerImpl::BuildHandleArray(Handle out_handles[], WaitableHolderBase *out_objects[], s32 num) {
         s32 count = 0;
 
@@ -154,7 +423,7 @@ namespace ams::os::impl {
     WaitableHolderBase *WaitableManagerImpl::LinkHoldersToObjectList() {
         WaitableHolderBase *signaled_holder = nullptr;
 
-        for (WaitableHolderBase &holder_base : this->waitable_list) {
+        for (WaitableHolderBase &holder_base : this->user_object_list) {
             TriBool is_signaled = holder_base.LinkToObjectList();
 
             if (signaled_holder == nullptr && is_signaled == TriBool::True) {
@@ -166,7 +435,7 @@ namespace ams::os::impl {
     }
 
     void WaitableManagerImpl::UnlinkHoldersFromObjectList() {
-        for (WaitableHolderBase &holder_base : this->waitable_list) {
+        for (WaitableHolderBase &holder_base : this->user_object_list) {
             holder_base.UnlinkFromObjectList();
         }
     }
@@ -175,7 +444,8 @@ namespace ams::os::impl {
         WaitableHolderBase *min_timeout_holder = nullptr;
         TimeSpan min_time = end_time;
 
-        for (WaitableHolderBase &holder_base : this->waitable_list) {
+        /* Only holders without a handle (e.g. timer events) can have a wakeup time. */
+        for (WaitableHolderBase &holder_base : this->user_object_list) {
             if (const TimeSpan cur_time = holder_base.GetAbsoluteWakeupTime(); cur_time < min_time) {
                 min_timeout_holder = &holder_base;
                 min_time = cur_time;
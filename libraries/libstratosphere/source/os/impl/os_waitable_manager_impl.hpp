@@ -18,29 +18,128 @@
 
 #if defined(ATMOSPHERE_OS_HORIZON)
     #include "os_waitable_manager_target_impl.os.horizon.hpp"
+#elif defined(ATMOSPHERE_OS_LINUX)
+    #include "os_waitable_manager_target_impl.os.linux.hpp"
 #else
     #error "Unknown OS for ams::os::WaitableManagerTargetImpl"
 #endif
 
 namespace ams::os::impl {
 
+    struct WaitableHandleGroup {
+        static constexpr size_t MaximumHandleCount = WaitableManagerTargetImpl::MaximumHandleCount;
+
+        WaitableHolderBase *objects[MaximumHandleCount];
+        Handle handles[MaximumHandleCount];
+        s32 count;
+
+        bool IsFull() const {
+            return this->count == static_cast<s32>(MaximumHandleCount);
+        }
+
+        void Add(WaitableHolderBase *holder_base, Handle handle) {
+            AMS_ASSERT(!this->IsFull());
+
+            this->objects[this->count] = holder_base;
+            this->handles[this->count] = handle;
+            ++this->count;
+        }
+
+        bool Remove(WaitableHolderBase *holder_base) {
+            for (s32 i = 0; i < this->count; ++i) {
+                if (this->objects[i] == holder_base) {
+                    /* Preserve ordering, as earlier handles take priority when several are signaled. */
+                    const size_t num_after = this->count - (i + 1);
+                    std::memmove(this->objects + i, this->objects + i + 1, num_after * sizeof(this->objects[0]));
+                    std::memmove(this->handles + i, this->handles + i + 1, num_after * sizeof(this->handles[0]));
+                    --this->count;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+    };
+
+    class WaitableManagerImpl;
+
+    /* Holds one group of a manager's persistent wait set, in storage provided by the manager's user. */
+    /* Relays other than the first wait on their group from their own thread, and wake the manager when a handle is signaled. */
+    class WaitableManagerRelay {
+        NON_COPYABLE(WaitableManagerRelay);
+        NON_MOVEABLE(WaitableManagerRelay);
+        private:
+            ThreadType thread;
+        public:
+            WaitableManagerRelay *next;
+        private:
+            WaitableManagerImpl *manager;
+            WaitableHandleGroup handle_group;
+            WaitableManagerTargetImpl target_impl;
+            InternalCriticalSection cs;
+            InternalConditionVariable cv;
+            bool has_thread;
+            bool is_ready;
+            bool is_waiting;
+            bool is_cancel_requested;
+            bool is_exit_requested;
+        private:
+            static void ThreadFunction(void *arg);
+            void ThreadFunctionImpl();
+        public:
+            explicit WaitableManagerRelay(WaitableManagerImpl *m)
+                : next(nullptr), manager(m), target_impl(), cs(), cv(), has_thread(false), is_ready(false), is_waiting(false), is_cancel_requested(false), is_exit_requested(false)
+            {
+                this->handle_group.count = 0;
+            }
+
+            ~WaitableManagerRelay();
+
+            Result StartThread(void *stack, size_t stack_size, s32 priority);
+
+            bool HasThread() const {
+                return this->has_thread;
+            }
+
+            WaitableHandleGroup &GetHandleGroup() {
+                return this->handle_group;
+            }
+
+            void StartWait();
+            void StopWait();
+    };
+
     class WaitableManagerImpl {
         public:
             static constexpr size_t MaximumHandleCount = WaitableManagerTargetImpl::MaximumHandleCount;
             static constexpr s32 WaitInvalid   = -3;
             static constexpr s32 WaitCancelled = -2;
             static constexpr s32 WaitTimedOut  = -1;
-            using ListType = util::IntrusiveListMemberTraits<&WaitableHolderBase::manager_node>::ListType;
+            using ListType           = util::IntrusiveListMemberTraits<&WaitableHolderBase::manager_node>::ListType;
+            using UserObjectListType = util::IntrusiveListMemberTraits<&WaitableHolderBase::user_object_node>::ListType;
         private:
             ListType waitable_list;
+            UserObjectListType user_object_list;
             WaitableHolderBase *signaled_holder;
             TimeSpan current_time;
+            WaitableManagerRelay *relay_list;
             InternalCriticalSection cs_wait;
             WaitableManagerTargetImpl target_impl;
         private:
             Result WaitAnyImpl(WaitableHolderBase **out, bool infinite, TimeSpan timeout, bool reply, Handle reply_target);
             Result WaitAnyHandleImpl(WaitableHolderBase **out, bool infinite, TimeSpan timeout, bool reply, Handle reply_target);
-            s32                BuildHandleArray(Handle out_handles[], WaitableHolderBase *out_objects[], s32 num);
+
+            s32 BuildHandleArray(Handle out_handles[], WaitableHolderBase *out_objects[], s32 num);
+
+            WaitableManagerRelay *FindRelayWithSpace() const;
+            bool CanAddToWaitSet(const WaitableHolderBase &holder_base) const;
+            Result AddToWaitSet(WaitableHolderBase &holder_base);
+            void RemoveFromWaitSet(WaitableHolderBase &holder_base);
+            void ClearWaitSet();
+
+            WaitableHolderBase *PollRelays();
+            void StartRelays();
+            void StopRelays();
 
             WaitableHolderBase *LinkHoldersToObjectList();
             void                UnlinkHoldersFromObjectList();
@@ -54,6 +153,10 @@ namespace ams::os::impl {
                 return holder;
             }
         public:
+            WaitableManagerImpl() : waitable_list(), user_object_list(), signaled_holder(nullptr), current_time(0), relay_list(nullptr), cs_wait(), target_impl() { /* ... */ }
+
+            ~WaitableManagerImpl();
+
             /* Wait. */
             WaitableHolderBase *WaitAny() {
                 return this->WaitAnyImpl(true, TimeSpan::FromNanoSeconds(std::numeric_limits<s64>::max()));
@@ -71,32 +174,46 @@ namespace ams::os::impl {
                 return this->WaitAnyImpl(out, true, TimeSpan::FromNanoSeconds(std::numeric_limits<s64>::max()), true, reply_target);
             }
 
+            /* Relay management. */
+            Result AttachRelay(WaitableManagerRelay *relay);
+
             /* List management. */
             bool IsEmpty() const {
                 return this->waitable_list.empty();
             }
 
-            void LinkWaitableHolder(WaitableHolderBase &holder_base) {
+            Result LinkWaitableHolder(WaitableHolderBase &holder_base) {
+                R_TRY(this->AddToWaitSet(holder_base));
                 this->waitable_list.push_back(holder_base);
+                return ResultSuccess();
             }
 
             void UnlinkWaitableHolder(WaitableHolderBase &holder_base) {
+                this->RemoveFromWaitSet(holder_base);
                 this->waitable_list.erase(this->waitable_list.iterator_to(holder_base));
             }
 
             void UnlinkAll() {
+                this->ClearWaitSet();
+
                 while (!this->IsEmpty()) {
                     this->waitable_list.front().SetManager(nullptr);
                     this->waitable_list.pop_front();
                 }
             }
 
-            void MoveAllFrom(WaitableManagerImpl &other) {
-                /* Set manager for all of the other's waitables. */
-                for (auto &w : other.waitable_list) {
+            Result MoveAllFrom(WaitableManagerImpl &other) {
+                /* Take the other's waitables into our wait set in order, leaving any we have no space for with the other. */
+                while (!other.IsEmpty()) {
+                    auto &w = other.waitable_list.front();
+                    R_UNLESS(this->CanAddToWaitSet(w), os::ResultOutOfResource());
+
+                    other.UnlinkWaitableHolder(w);
+                    R_ABORT_UNLESS(this->LinkWaitableHolder(w));
                     w.SetManager(this);
                 }
-                this->waitable_list.splice(this->waitable_list.end(), other.waitable_list);
+
+                return ResultSuccess();
             }
 
             /* Other. */
@@ -107,4 +224,7 @@ namespace ams::os::impl {
             void SignalAndWakeupThread(WaitableHolderBase *holder_base);
     };
 
+    static_assert(sizeof(WaitableManagerImpl) == sizeof(os::WaitableManagerType::impl_storage));
+    static_assert(sizeof(WaitableManagerRelay) == sizeof(os::WaitableManagerRelayType::impl_storage));
+
 }
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "os_waitable_holder_base.hpp"
+#include "os_waitable_manager_impl.hpp"
+#include "os_futex_impl.os.linux.hpp"
+#include <poll.h>
+
+namespace ams::os::impl {
+
+    Result WaitableManagerLinuxImpl::PollN(s32 *out_index, s32 num, Handle arr[], s32 array_size, s64 ns) {
+        AMS_ASSERT(!(num == 0 && ns == 0));
+        AMS_ASSERT(0 <= num && num <= array_size && static_cast<size_t>(num) <= MaximumHandleCount);
+        AMS_UNUSED(array_size);
+
+        /* Wait on the handles, plus the current thread's cancel event. */
+        ::pollfd fds[MaximumHandleCount + 1];
+        for (s32 i = 0; i < num; ++i) {
+            fds[i] = { .fd = static_cast<int>(arr[i]), .events = POLLIN, .revents = 0 };
+        }
+
+        const int cancel_handle = GetCurrentThread()->thread_impl->cancel_handle;
+        fds[num] = { .fd = cancel_handle, .events = POLLIN, .revents = 0 };
+
+        const ::timespec timeout = ConvertToTimeSpec(TimeSpan::FromNanoSeconds(ns));
+
+        while (true) {
+            const int res = ::ppoll(fds, num + 1, ns >= 0 ? std::addressof(timeout) : nullptr, nullptr);
+            if (res < 0) {
+                AMS_ABORT_UNLESS(errno == EINTR);
+                continue;
+            }
+
+            s32 index = WaitableManagerImpl::WaitTimedOut;
+            if (fds[num].revents != 0) {
+                /* Consume the cancellation request. */
+                u64 value;
+                const auto read_size = ::read(cancel_handle, std::addressof(value), sizeof(value));
+                AMS_UNUSED(read_size);
+                index = WaitableManagerImpl::WaitCancelled;
+            } else {
+                for (s32 i = 0; i < num; ++i) {
+                    /* Invalid handles are critical errors, as on horizon. */
+                    AMS_ABORT_UNLESS((fds[i].revents & POLLNVAL) == 0);
+                    if (fds[i].revents != 0) {
+                        index = i;
+                        break;
+                    }
+                }
+            }
+
+            *out_index = index;
+            return ResultSuccess();
+        }
+    }
+
+    void WaitableManagerLinuxImpl::CancelWait() {
+        const u64 value = 1;
+        AMS_ABORT_UNLESS(::write(this->cancel_handle, std::addressof(value), sizeof(value)) == sizeof(value));
+    }
+
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+#include "os_thread_manager.hpp"
+
+namespace ams::os::impl {
+
+    class WaitableManagerLinuxImpl {
+        public:
+            /* NOTE: This matches the horizon limit, so that callers size their handle arrays identically. */
+            static constexpr size_t MaximumHandleCount = 64;
+        private:
+            s32 cancel_handle;
+        private:
+            Result PollN(s32 *out_index, s32 num, Handle arr[], s32 array_size, s64 ns);
+        public:
+            void CancelWait();
+
+            Result WaitAny(s32 *out_index, Handle arr[], s32 array_size, s32 num) {
+                return this->PollN(out_index, num, arr, array_size, -1);
+            }
+
+            Result TryWaitAny(s32 *out_index, Handle arr[], s32 array_size, s32 num) {
+                return this->PollN(out_index, num, arr, array_size, 0);
+            }
+
+            Result TimedWaitAny(s32 *out_index, Handle arr[], s32 array_size, s32 num, TimeSpan ts) {
+                s64 timeout = ts.GetNanoSeconds();
+                if (timeout < 0) {
+                    timeout = 0;
+                }
+                return this->PollN(out_index, num, arr, array_size, timeout);
+            }
+
+            /* NOTE: Linux has no ipc sessions to reply to, so these fail the way an unimplemented svc would. */
+            Result ReplyAndReceive(s32 *out_index, Handle arr[], s32 array_size, s32 num, Handle reply_target) {
+                AMS_UNUSED(out_index, arr, array_size, num, reply_target);
+                return svc::ResultNotImplemented();
+            }
+
+            Result TimedReplyAndReceive(s32 *out_index, Handle arr[], s32 array_size, s32 num, Handle reply_target, TimeSpan ts) {
+                AMS_UNUSED(out_index, arr, array_size, num, reply_target, ts);
+                return svc::ResultNotImplemented();
+            }
+
+            void SetCurrentThreadHandleForCancelWait() {
+                this->cancel_handle = GetCurrentThread()->thread_impl->cancel_handle;
+            }
+
+            void ClearCurrentThreadHandleForCancelWait() {
+                this->cancel_handle = -1;
+            }
+    };
+
+    using WaitableManagerTargetImpl = WaitableManagerLinuxImpl;
+
+}
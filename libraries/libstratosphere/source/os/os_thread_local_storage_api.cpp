@@ -17,6 +17,8 @@
 
 namespace ams::os {
 
+    #if defined(ATMOSPHERE_OS_HORIZON)
+
     /* TODO: How will this work without libnx? */
 
     namespace {
@@ -45,4 +47,36 @@ namespace ams::os {
         ::threadTlsSet(static_cast<s32>(slot._value), reinterpret_cast<void *>(value));
     }
 
+    #elif defined(ATMOSPHERE_OS_LINUX)
+
+    namespace {
+
+        using PthreadTlsDestructor = void (*)(void *);
+
+    }
+
+    Result AllocateTlsSlot(TlsSlot *out, TlsDestructor destructor) {
+        ::pthread_key_t key;
+        R_UNLESS(::pthread_key_create(std::addressof(key), reinterpret_cast<PthreadTlsDestructor>(destructor)) == 0, os::ResultOutOfResource());
+
+        *out = { static_cast<u32>(key) };
+        return ResultSuccess();
+    }
+
+    void FreeTlsSlot(TlsSlot slot) {
+        ::pthread_key_delete(static_cast<::pthread_key_t>(slot._value));
+    }
+
+    uintptr_t GetTlsValue(TlsSlot slot) {
+        return reinterpret_cast<uintptr_t>(::pthread_getspecific(static_cast<::pthread_key_t>(slot._value)));
+    }
+
+    void SetTlsValue(TlsSlot slot, uintptr_t value) {
+        AMS_ABORT_UNLESS(::pthread_setspecific(static_cast<::pthread_key_t>(slot._value), reinterpret_cast<void *>(value)) == 0);
+    }
+
+    #else
+        #error "Unknown OS for TlsSlot"
+    #endif
+
 }
@@ -21,12 +21,17 @@ namespace ams::os {
 
         /* TODO: Remove, add VammManager */
         size_t GetSystemResourceSize() {
+            #if defined(ATMOSPHERE_OS_HORIZON)
             u64 v;
             if (R_SUCCEEDED(svcGetInfo(std::addressof(v), InfoType_SystemResourceSizeTotal, CUR_PROCESS_HANDLE, 0))) {
                 return v;
             } else {
                 return 0;
             }
+            #else
+            /* Host processes have no system resource, and so no virtual address memory. */
+            return 0;
+            #endif
         }
 
     }
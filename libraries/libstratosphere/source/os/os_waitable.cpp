@@ -53,6 +53,25 @@ namespace ams::os {
         util::DestroyAt(manager->impl_storage);
     }
 
+    Result AttachWaitableManagerRelay(WaitableManagerType *manager, WaitableManagerRelayType *relay, void *stack, size_t stack_size, s32 priority) {
+        auto &impl = GetWaitableManagerImpl(manager);
+
+        AMS_ASSERT(manager->state == WaitableManagerType::State_Initialized);
+
+        /* Construct the relay, destroying it if it can't be attached. */
+        auto *relay_impl = util::ConstructAt(relay->impl_storage, std::addressof(impl));
+        auto relay_guard = SCOPE_GUARD { util::DestroyAt(relay->impl_storage); };
+
+        if (stack != nullptr) {
+            R_TRY(relay_impl->StartThread(stack, stack_size, priority));
+        }
+
+        R_TRY(impl.AttachRelay(relay_impl));
+        relay_guard.Cancel();
+
+        return ResultSuccess();
+    }
+
     WaitableHolderType *WaitAny(WaitableManagerType *manager) {
         auto &impl = GetWaitableManagerImpl(manager);
 
@@ -93,15 +112,21 @@ namespace ams::os {
         std::destroy_at(holder_base);
     }
 
-    void LinkWaitableHolder(WaitableManagerType *manager, WaitableHolderType *holder) {
+    Result TryLinkWaitableHolder(WaitableManagerType *manager, WaitableHolderType *holder) {
         auto &impl = GetWaitableManagerImpl(manager);
         auto *holder_base = reinterpret_cast<impl::WaitableHolderBase *>(GetPointer(holder->impl_storage));
 
         AMS_ASSERT(manager->state == WaitableManagerType::State_Initialized);
         AMS_ASSERT(!holder_base->IsLinkedToManager());
 
-        impl.LinkWaitableHolder(*holder_base);
+        R_TRY(impl.LinkWaitableHolder(*holder_base));
         holder_base->SetManager(&impl);
+
+        return ResultSuccess();
+    }
+
+    void LinkWaitableHolder(WaitableManagerType *manager, WaitableHolderType *holder) {
+        R_ABORT_UNLESS(TryLinkWaitableHolder(manager, holder));
     }
 
     void UnlinkWaitableHolder(WaitableHolderType *holder) {
@@ -122,7 +147,7 @@ namespace ams::os {
         return impl.UnlinkAll();
     }
 
-    void MoveAllWaitableHolder(WaitableManagerType *_dst, WaitableManagerType *_src) {
+    Result TryMoveAllWaitableHolder(WaitableManagerType *_dst, WaitableManagerType *_src) {
         auto &dst = GetWaitableManagerImpl(_dst);
         auto &src = GetWaitableManagerImpl(_src);
 
@@ -132,6 +157,10 @@ namespace ams::os {
         return dst.MoveAllFrom(src);
     }
 
+    void MoveAllWaitableHolder(WaitableManagerType *dst, WaitableManagerType *src) {
+        R_ABORT_UNLESS(TryMoveAllWaitableHolder(dst, src));
+    }
+
     void SetWaitableHolderUserData(WaitableHolderType *holder, uintptr_t user_data) {
         holder->user_data = user_data;
     }
@@ -30,9 +30,48 @@ namespace ams::patcher {
         constexpr size_t IpsFileExtensionLength = std::strlen(IpsFileExtension);
         constexpr size_t ModuleIpsPatchLength = 2 * sizeof(ro::ModuleId) + IpsFileExtensionLength;
 
+        constexpr size_t PatchReadBufferSize      = 8_KB;
+        constexpr s64    PatchDirectoryEntryCount = 1;
+        constexpr s64    PatchFileEntryCount      = 4;
+
+        constexpr size_t PatchIndexEntryCountMax     = 128;
+        constexpr size_t PatchIndexNameBufferSize    = 1_KB;
+        constexpr size_t PatchIndexRootPathLengthMax = 0x40;
+
+        /* NOTE: File names aren't stored, as they can be printed from the module id; the sd card's file system ignores case. */
+        struct PatchIndexEntry {
+            ro::ModuleId module_id;
+            u16 directory_name_offset;
+            u8 module_id_name_length;
+        };
+
+        struct IpsRecord {
+            u32 offset;
+            u32 size;
+            bool is_rle;
+            u8 rle_value;
+        };
+
         /* Global data. */
         os::Mutex apply_patch_lock(false);
-        u8 g_patch_read_buffer[os::MemoryPageSize];
+        constinit u8 g_patch_read_buffer[PatchReadBufferSize];
+        constinit fs::DirectoryEntry g_patch_directory_entries[PatchDirectoryEntryCount];
+        constinit fs::DirectoryEntry g_patch_file_entries[PatchFileEntryCount];
+
+        /* The ips files under the patch directory, which we keep until the index is invalidated or the sd card is inserted or removed. */
+        constinit bool g_patch_index_valid = false;
+        constinit bool g_patch_index_complete = false;
+        constinit char g_patch_index_root_path[PatchIndexRootPathLengthMax + 1];
+        constinit PatchIndexEntry g_patch_index_entries[PatchIndexEntryCountMax];
+        constinit size_t g_patch_index_entry_count = 0;
+        constinit char g_patch_index_directory_names[PatchIndexNameBufferSize];
+        constinit size_t g_patch_index_directory_names_size = 0;
+
+        /* NOTE: These are not constinit, as they have global constructors. */
+        std::unique_ptr<fs::IEventNotifier> g_sd_card_detection_event_notifier;
+        os::SystemEventType g_sd_card_detection_event;
+        constinit bool g_sd_card_detection_event_bound = false;
+        constinit bool g_sd_card_detection_event_unavailable = false;
 
         /* Helpers. */
         inline u8 ConvertHexNybble(const char nybble) {
@@ -63,17 +102,7 @@ namespace ams::patcher {
             return true;
         }
 
-        bool MatchesModuleId(const char *name, size_t name_len, size_t extension_len, const ro::ModuleId *module_id) {
-            /* Get module id. */
-            ro::ModuleId module_id_from_name;
-            if (!ParseModuleIdFromPath(&module_id_from_name, name, name_len, extension_len)) {
-                return false;
-            }
-
-            return std::memcmp(&module_id_from_name, module_id, sizeof(*module_id)) == 0;
-        }
-
-        bool IsIpsFileForModule(const char *name, const ro::ModuleId *module_id) {
+        bool ParseIpsFileName(ro::ModuleId *out_module_id, const char *name) {
             const size_t name_len = std::strlen(name);
 
             /* The path must be correct size for a build id (with trailing zeroes optionally trimmed) + ".ips". */
@@ -91,8 +120,8 @@ namespace ams::patcher {
                 return false;
             }
 
-            /* The path needs to match the module id. */
-            return MatchesModuleId(name, name_len, IpsFileExtensionLength, module_id);
+            /* The rest of the path needs to be a module id. */
+            return ParseModuleIdFromPath(out_module_id, name, name_len, IpsFileExtensionLength);
         }
 
         inline bool IsIpsTail(bool is_ips32, u8 *buffer) {
@@ -115,100 +144,350 @@ namespace ams::patcher {
             return (buffer[0] << 8) | (buffer[1]);
         }
 
-        void ApplyIpsPatch(u8 *mapped_module, size_t mapped_size, size_t protected_size, size_t offset, bool is_ips32, fs::FileHandle file) {
-            /* Validate offset/protected size. */
-            AMS_ABORT_UNLESS(offset <= protected_size);
+        /* Reads a patch file front to back through g_patch_read_buffer, so that most patches take a single read. */
+        class PatchFileReader {
+            NON_COPYABLE(PatchFileReader);
+            NON_MOVEABLE(PatchFileReader);
+            private:
+                fs::FileHandle file;
+                s64 file_size;
+                s64 position;
+                s64 buffer_offset;
+                size_t buffer_size;
+            public:
+                PatchFileReader(fs::FileHandle f, s64 size) : file(f), file_size(size), position(0), buffer_offset(0), buffer_size(0) { /* ... */ }
+
+                void Seek(s64 pos) {
+                    AMS_ASSERT(0 <= pos && pos <= this->file_size);
+                    this->position = pos;
+                }
+
+                Result Read(void *dst, size_t size) {
+                    R_UNLESS(static_cast<s64>(size) <= this->file_size - this->position, fs::ResultOutOfRange());
+
+                    u8 *cur_dst = static_cast<u8 *>(dst);
+                    while (size > 0) {
+                        if (this->buffer_offset <= this->position && this->position < this->buffer_offset + static_cast<s64>(this->buffer_size)) {
+                            /* Copy out whatever is buffered. */
+                            const size_t buffer_pos = static_cast<size_t>(this->position - this->buffer_offset);
+                            const size_t cur_size   = std::min(size, this->buffer_size - buffer_pos);
+                            std::memcpy(cur_dst, g_patch_read_buffer + buffer_pos, cur_size);
+
+                            cur_dst        += cur_size;
+                            size           -= cur_size;
+                            this->position += cur_size;
+                        } else if (size >= sizeof(g_patch_read_buffer)) {
+                            /* Data which wouldn't fit in the buffer is read directly. */
+                            R_TRY(fs::ReadFile(this->file, this->position, cur_dst, size));
+
+                            this->position += size;
+                            break;
+                        } else {
+                            R_TRY(this->FillBuffer());
+                        }
+                    }
+
+                    return ResultSuccess();
+                }
+
+                Result Skip(size_t size) {
+                    R_UNLESS(static_cast<s64>(size) <= this->file_size - this->position, fs::ResultOutOfRange());
 
-            s64 file_offset = sizeof(IpsHeadMagic);
-            auto ReadData = [&](void *dst, size_t size) ALWAYS_INLINE_LAMBDA {
-                R_ABORT_UNLESS(fs::ReadFile(file, file_offset, dst, size));
-                file_offset += size;
-            };
+                    this->position += size;
+                    return ResultSuccess();
+                }
+            private:
+                Result FillBuffer() {
+                    const size_t read_size = static_cast<size_t>(std::min<s64>(sizeof(g_patch_read_buffer), this->file_size - this->position));
+
+                    this->buffer_size = 0;
+                    R_TRY(fs::ReadFile(this->file, this->position, g_patch_read_buffer, read_size));
 
+                    this->buffer_offset = this->position;
+                    this->buffer_size   = read_size;
+                    return ResultSuccess();
+                }
+        };
+
+        Result ReadIpsRecord(bool *out_is_tail, IpsRecord *out_record, PatchFileReader &reader, bool is_ips32) {
             u8 buffer[sizeof(Ips32TailMagic)];
+            R_TRY(reader.Read(buffer, is_ips32 ? sizeof(Ips32TailMagic) : sizeof(IpsTailMagic)));
+
+            *out_is_tail = IsIpsTail(is_ips32, buffer);
+            R_SUCCEED_IF(*out_is_tail);
+
+            /* Offset of patch. */
+            out_record->offset = GetIpsPatchOffset(is_ips32, buffer);
+
+            /* Size of patch. */
+            R_TRY(reader.Read(buffer, 2));
+            out_record->size = GetIpsPatchSize(is_ips32, buffer);
+
+            /* Check for RLE encoding. */
+            out_record->is_rle = out_record->size == 0;
+            if (out_record->is_rle) {
+                /* Size and value of RLE. */
+                R_TRY(reader.Read(buffer, 3));
+                out_record->size      = (buffer[0] << 8) | (buffer[1]);
+                out_record->rle_value = buffer[2];
+            }
+
+            return ResultSuccess();
+        }
+
+        Result ValidateIpsPatch(PatchFileReader &reader, bool is_ips32) {
+            /* Check that every record lies within the file, and that the file has a tail. */
             while (true) {
-                ReadData(buffer, is_ips32 ? sizeof(Ips32TailMagic) : sizeof(IpsTailMagic));
+                bool is_tail;
+                IpsRecord record;
+                R_TRY(ReadIpsRecord(std::addressof(is_tail), std::addressof(record), reader, is_ips32));
 
-                if (IsIpsTail(is_ips32, buffer)) {
-                    break;
-                }
+                R_SUCCEED_IF(is_tail);
 
-                /* Offset of patch. */
-                u32 patch_offset = GetIpsPatchOffset(is_ips32, buffer);
+                if (!record.is_rle) {
+                    R_TRY(reader.Skip(record.size));
+                }
+            }
+        }
 
-                /* Size of patch. */
-                ReadData(buffer, 2);
-                u32 patch_size = GetIpsPatchSize(is_ips32, buffer);
+        void ApplyIpsPatch(u8 *mapped_module, size_t mapped_size, size_t protected_size, size_t offset, bool is_ips32, PatchFileReader &reader) {
+            /* Validate offset/protected size. */
+            AMS_ABORT_UNLESS(offset <= protected_size);
 
-                /* Check for RLE encoding. */
-                if (patch_size == 0) {
-                    /* Size of RLE. */
-                    ReadData(buffer, 2);
+            /* NOTE: The patch has been validated, so failures here are failures to read it. */
+            while (true) {
+                bool is_tail;
+                IpsRecord record;
+                R_ABORT_UNLESS(ReadIpsRecord(std::addressof(is_tail), std::addressof(record), reader, is_ips32));
 
-                    u32 rle_size = (buffer[0] << 8) | (buffer[1]);
+                if (is_tail) {
+                    break;
+                }
 
-                    /* Value for RLE. */
-                    ReadData(buffer, 1);
+                size_t patch_offset = record.offset;
+                size_t patch_size   = record.size;
 
-                    /* Ensure we don't write to protected region. */
-                    if (patch_offset < protected_size) {
-                        if (patch_offset + rle_size > protected_size) {
-                            const u32 diff = protected_size - patch_offset;
-                            patch_offset += diff;
-                            rle_size -= diff;
-                        } else {
-                            continue;
-                        }
-                    }
+                /* Ensure we don't write to protected region. */
+                if (patch_offset < protected_size) {
+                    const size_t diff = std::min(protected_size - patch_offset, patch_size);
+                    patch_offset += diff;
+                    patch_size   -= diff;
+                }
 
-                    /* Adjust offset, if relevant. */
+                /* Adjust offset, if relevant, and ensure we don't write past the end of the module. */
+                size_t apply_size = 0;
+                if (patch_size > 0) {
                     patch_offset -= offset;
+                    if (patch_offset < mapped_size) {
+                        apply_size = std::min(patch_size, mapped_size - patch_offset);
+                    }
+                }
 
-                    /* Apply patch. */
-                    if (patch_offset + rle_size > mapped_size) {
-                        rle_size = mapped_size - patch_offset;
+                /* Apply patch. */
+                if (record.is_rle) {
+                    if (apply_size > 0) {
+                        std::memset(mapped_module + patch_offset, record.rle_value, apply_size);
                     }
-                    std::memset(mapped_module + patch_offset, buffer[0], rle_size);
                 } else {
-                    /* Ensure we don't write to protected region. */
-                    if (patch_offset < protected_size) {
-                        if (patch_offset + patch_size > protected_size) {
-                            const u32 diff = protected_size - patch_offset;
-                            patch_offset += diff;
-                            patch_size -= diff;
-                            file_offset += diff;
-                        } else {
-                            file_offset += patch_size;
-                            continue;
-                        }
+                    R_ABORT_UNLESS(reader.Skip(record.size - patch_size));
+                    if (apply_size > 0) {
+                        R_ABORT_UNLESS(reader.Read(mapped_module + patch_offset, apply_size));
                     }
+                    R_ABORT_UNLESS(reader.Skip(patch_size - apply_size));
+                }
+            }
+        }
 
-                    /* Adjust offset, if relevant. */
-                    patch_offset -= offset;
+        void ApplyIpsPatchFile(u8 *mapped_module, size_t mapped_size, size_t protected_size, size_t offset, const char *path) {
+            /* Open the file. */
+            fs::FileHandle file;
+            if (R_FAILED(fs::OpenFile(std::addressof(file), path, fs::OpenMode_Read))) {
+                return;
+            }
+            ON_SCOPE_EXIT { fs::CloseFile(file); };
+
+            s64 file_size;
+            if (R_FAILED(fs::GetFileSize(std::addressof(file_size), file))) {
+                return;
+            }
+
+            PatchFileReader reader(file, file_size);
+
+            /* Read the header. */
+            u8 header[sizeof(IpsHeadMagic)];
+            if (R_FAILED(reader.Read(header, sizeof(header)))) {
+                return;
+            }
+
+            bool is_ips32;
+            if (std::memcmp(header, IpsHeadMagic, sizeof(header)) == 0) {
+                is_ips32 = false;
+            } else if (std::memcmp(header, Ips32HeadMagic, sizeof(header)) == 0) {
+                is_ips32 = true;
+            } else {
+                return;
+            }
+
+            /* Only apply patches which are entirely well-formed, so that a bad patch can't be partially applied. */
+            if (R_FAILED(ValidateIpsPatch(reader, is_ips32))) {
+                return;
+            }
+
+            reader.Seek(sizeof(header));
+            ApplyIpsPatch(mapped_module, mapped_size, protected_size, offset, is_ips32, reader);
+        }
+
+        /* Invokes f(path, patch_dir_path_len, dir_name, file_name, module_id) for each ips file in the subdirectories of the path. */
+        template<typename F>
+        void ForEachIpsPatchFile(char *path, size_t path_size, F f) {
+            const size_t patches_dir_path_len = std::strlen(path);
+
+            /* Open the patch directory. */
+            fs::DirectoryHandle patches_dir;
+            if (R_FAILED(fs::OpenDirectory(std::addressof(patches_dir), path, fs::OpenDirectoryMode_Directory))) {
+                return;
+            }
+            ON_SCOPE_EXIT { fs::CloseDirectory(patches_dir); };
 
-                    /* Apply patch. */
-                    u32 read_size = patch_size;
-                    if (patch_offset + read_size > mapped_size) {
-                        read_size = mapped_size - patch_offset;
+            /* Iterate over the patches directory to find patch subdirectories. */
+            while (true) {
+                /* Read the next entries. */
+                s64 dir_count;
+                if (R_FAILED(fs::ReadDirectory(std::addressof(dir_count), g_patch_directory_entries, patches_dir, PatchDirectoryEntryCount)) || dir_count == 0) {
+                    break;
+                }
+
+                for (s64 i = 0; i < dir_count; ++i) {
+                    const char *dir_name = g_patch_directory_entries[i].name;
+
+                    /* Print the path for this directory. */
+                    util::SNPrintf(path + patches_dir_path_len, path_size - patches_dir_path_len, "/%s", dir_name);
+                    const size_t patch_dir_path_len = patches_dir_path_len + 1 + std::strlen(dir_name);
+
+                    /* Open the patch directory. */
+                    fs::DirectoryHandle patch_dir;
+                    if (R_FAILED(fs::OpenDirectory(std::addressof(patch_dir), path, fs::OpenDirectoryMode_File))) {
+                        continue;
                     }
-                    {
-                        size_t remaining   = read_size;
-                        size_t copy_offset = patch_offset;
-                        while (remaining > 0) {
-                            const size_t cur_read = std::min(remaining, sizeof(g_patch_read_buffer));
-                            ReadData(g_patch_read_buffer, cur_read);
-                            std::memcpy(mapped_module + copy_offset, g_patch_read_buffer, cur_read);
-                            remaining   -= cur_read;
-                            copy_offset += cur_read;
+                    ON_SCOPE_EXIT { fs::CloseDirectory(patch_dir); };
+
+                    /* Iterate over files in the patch directory. */
+                    while (true) {
+                        s64 file_count;
+                        if (R_FAILED(fs::ReadDirectory(std::addressof(file_count), g_patch_file_entries, patch_dir, PatchFileEntryCount)) || file_count == 0) {
+                            break;
+                        }
+
+                        for (s64 j = 0; j < file_count; ++j) {
+                            const char *file_name = g_patch_file_entries[j].name;
+
+                            /* Check if this file is an ips. */
+                            ro::ModuleId module_id;
+                            if (!ParseIpsFileName(std::addressof(module_id), file_name)) {
+                                continue;
+                            }
+
+                            f(path, patch_dir_path_len, dir_name, file_name, module_id);
                         }
                     }
-                    if (patch_size > read_size) {
-                        file_offset += patch_size - read_size;
-                    }
                 }
             }
         }
 
+        bool IsSdCardChanged() {
+            /* If we can't be told about sd card changes, assume the worst. */
+            if (!g_sd_card_detection_event_bound) {
+                if (g_sd_card_detection_event_unavailable) {
+                    return true;
+                }
+
+                if (R_FAILED(fs::OpenSdCardDetectionEventNotifier(std::addressof(g_sd_card_detection_event_notifier)))) {
+                    g_sd_card_detection_event_unavailable = true;
+                    return true;
+                }
+
+                if (R_FAILED(g_sd_card_detection_event_notifier->BindEvent(std::addressof(g_sd_card_detection_event), os::EventClearMode_AutoClear))) {
+                    g_sd_card_detection_event_notifier.reset();
+                    g_sd_card_detection_event_unavailable = true;
+                    return true;
+                }
+
+                g_sd_card_detection_event_bound = true;
+                return true;
+            }
+
+            return os::TryWaitSystemEvent(std::addressof(g_sd_card_detection_event));
+        }
+
+        void PrintIpsFileName(char *dst, size_t dst_size, const ro::ModuleId &module_id, size_t module_id_name_length) {
+            for (size_t i = 0; i < module_id_name_length / 2; ++i) {
+                util::SNPrintf(dst + 2 * i, dst_size - 2 * i, "%02x", module_id.build_id[i]);
+            }
+            util::SNPrintf(dst + module_id_name_length, dst_size - module_id_name_length, "%s", IpsFileExtension);
+        }
+
+        void AddPatchIndexEntry(const char *dir_name, const char *file_name, const ro::ModuleId &module_id) {
+            /* Files are visited directory by directory, so we only need to store a directory's name once. */
+            size_t dir_name_offset;
+            if (g_patch_index_entry_count > 0 && std::strcmp(g_patch_index_directory_names + g_patch_index_entries[g_patch_index_entry_count - 1].directory_name_offset, dir_name) == 0) {
+                dir_name_offset = g_patch_index_entries[g_patch_index_entry_count - 1].directory_name_offset;
+            } else {
+                dir_name_offset = g_patch_index_directory_names_size;
+
+                const size_t dir_name_size = std::strlen(dir_name) + 1;
+                if (dir_name_size > sizeof(g_patch_index_directory_names) - dir_name_offset) {
+                    g_patch_index_complete = false;
+                    return;
+                }
+
+                std::memcpy(g_patch_index_directory_names + dir_name_offset, dir_name, dir_name_size);
+                g_patch_index_directory_names_size += dir_name_size;
+            }
+
+            if (g_patch_index_entry_count >= PatchIndexEntryCountMax) {
+                g_patch_index_complete = false;
+                return;
+            }
+
+            auto &entry = g_patch_index_entries[g_patch_index_entry_count++];
+            entry.module_id             = module_id;
+            entry.directory_name_offset = static_cast<u16>(dir_name_offset);
+            entry.module_id_name_length = static_cast<u8>(std::strlen(file_name) - IpsFileExtensionLength);
+        }
+
+        bool UpdatePatchIndex(char *path, size_t path_size) {
+            const size_t root_path_len = std::strlen(path);
+            if (root_path_len > PatchIndexRootPathLengthMax) {
+                return false;
+            }
+
+            /* Check whether our index is of this directory, and whether the sd card has changed since we made it. */
+            /* NOTE: Patch files changed while the sd card stays inserted are found once the index is invalidated. */
+            const bool sd_card_changed = IsSdCardChanged();
+            if (g_patch_index_valid && !sd_card_changed && std::strcmp(g_patch_index_root_path, path) == 0) {
+                return g_patch_index_complete;
+            }
+
+            /* Index the directory. */
+            g_patch_index_complete             = true;
+            g_patch_index_entry_count          = 0;
+            g_patch_index_directory_names_size = 0;
+
+            ForEachIpsPatchFile(path, path_size, [](char *, size_t, const char *dir_name, const char *file_name, const ro::ModuleId &module_id) {
+                if (g_patch_index_complete) {
+                    AddPatchIndexEntry(dir_name, file_name, module_id);
+                }
+            });
+            path[root_path_len] = '\0';
+
+            /* We can only keep the index if we'll find out when the sd card changes. */
+            /* Directories with more patches than we can index are searched on each load instead. */
+            std::memcpy(g_patch_index_root_path, path, root_path_len + 1);
+            g_patch_index_valid = g_sd_card_detection_event_bound;
+
+            return g_patch_index_complete;
+        }
+
     }
 
     void LocateAndApplyIpsPatchesToModule(const char *mount_name, const char *patch_dir_name, size_t protected_size, size_t offset, const ro::ModuleId *module_id, u8 *mapped_module, size_t mapped_size) {
@@ -220,65 +499,40 @@ namespace ams::patcher {
         util::SNPrintf(path, sizeof(path), "%s:/atmosphere/%s", mount_name, patch_dir_name);
         const size_t patches_dir_path_len = std::strlen(path);
 
-        /* Open the patch directory. */
-        fs::DirectoryHandle patches_dir;
-        if (R_FAILED(fs::OpenDirectory(std::addressof(patches_dir), path, fs::OpenDirectoryMode_Directory))) {
-            return;
-        }
-        ON_SCOPE_EXIT { fs::CloseDirectory(patches_dir); };
-
-        /* Iterate over the patches directory to find patch subdirectories. */
-        while (true) {
-            /* Read the next entry. */
-            s64 count;
-            fs::DirectoryEntry entry;
-            if (R_FAILED(fs::ReadDirectory(std::addressof(count), std::addressof(entry), patches_dir, 1)) || count == 0) {
-                break;
-            }
+        if (UpdatePatchIndex(path, sizeof(path))) {
+            /* Apply the patches for the module from our index. */
+            for (size_t i = 0; i < g_patch_index_entry_count; ++i) {
+                const auto &entry = g_patch_index_entries[i];
+                if (std::memcmp(std::addressof(entry.module_id), module_id, sizeof(*module_id)) != 0) {
+                    continue;
+                }
 
-            /* Print the path for this directory. */
-            util::SNPrintf(path + patches_dir_path_len, sizeof(path) - patches_dir_path_len, "/%s", entry.name);
-            const size_t patch_dir_path_len = patches_dir_path_len + 1 + std::strlen(entry.name);
+                /* Print the path for this file. */
+                util::SNPrintf(path + patches_dir_path_len, sizeof(path) - patches_dir_path_len, "/%s/", g_patch_index_directory_names + entry.directory_name_offset);
+                const size_t patch_dir_path_len = std::strlen(path);
+                PrintIpsFileName(path + patch_dir_path_len, sizeof(path) - patch_dir_path_len, entry.module_id, entry.module_id_name_length);
 
-            /* Open the patch directory. */
-            fs::DirectoryHandle patch_dir;
-            if (R_FAILED(fs::OpenDirectory(std::addressof(patch_dir), path, fs::OpenDirectoryMode_File))) {
-                continue;
+                ApplyIpsPatchFile(mapped_module, mapped_size, protected_size, offset, path);
             }
-            ON_SCOPE_EXIT { fs::CloseDirectory(patch_dir); };
-
-            /* Iterate over files in the patch directory. */
-            while (true) {
-                if (R_FAILED(fs::ReadDirectory(std::addressof(count), std::addressof(entry), patch_dir, 1)) || count == 0) {
-                    break;
-                }
-
-                /* Check if this file is an ips. */
-                if (!IsIpsFileForModule(entry.name, module_id)) {
-                    continue;
+        } else {
+            /* There are too many patches to index, so search the patch directory for the module's patches. */
+            ForEachIpsPatchFile(path, sizeof(path), [&](char *cur_path, size_t patch_dir_path_len, const char *, const char *file_name, const ro::ModuleId &file_module_id) {
+                if (std::memcmp(std::addressof(file_module_id), module_id, sizeof(*module_id)) != 0) {
+                    return;
                 }
 
                 /* Print the path for this file. */
-                util::SNPrintf(path + patch_dir_path_len, sizeof(path) - patch_dir_path_len, "/%s", entry.name);
+                util::SNPrintf(cur_path + patch_dir_path_len, sizeof(path) - patch_dir_path_len, "/%s", file_name);
 
-                /* Open the file. */
-                fs::FileHandle file;
-                if (R_FAILED(fs::OpenFile(std::addressof(file), path, fs::OpenMode_Read))) {
-                    continue;
-                }
-                ON_SCOPE_EXIT { fs::CloseFile(file); };
-
-                /* Read the header. */
-                u8 header[sizeof(IpsHeadMagic)];
-                if (R_SUCCEEDED(fs::ReadFile(file, 0, header, sizeof(header)))) {
-                    if (std::memcmp(header, IpsHeadMagic, sizeof(header)) == 0) {
-                        ApplyIpsPatch(mapped_module, mapped_size, protected_size, offset, false, file);
-                    } else if (std::memcmp(header, Ips32HeadMagic, sizeof(header)) == 0) {
-                        ApplyIpsPatch(mapped_module, mapped_size, protected_size, offset, true, file);
-                    }
-                }
-            }
+                ApplyIpsPatchFile(mapped_module, mapped_size, protected_size, offset, cur_path);
+            });
         }
     }
 
+    void InvalidatePatchIndex() {
+        std::scoped_lock lk(apply_patch_lock);
+
+        g_patch_index_valid = false;
+    }
+
 }
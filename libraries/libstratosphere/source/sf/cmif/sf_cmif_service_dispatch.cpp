@@ -17,7 +17,7 @@
 
 namespace ams::sf::cmif {
 
-    Result impl::ServiceDispatchTableBase::ProcessMessageImpl(ServiceDispatchContext &ctx, const cmif::PointerAndSize &in_raw_data, const ServiceCommandMeta *entries, const size_t entry_count) const {
+    Result impl::ServiceDispatchTableBase::ProcessMessageImpl(ServiceDispatchContext &ctx, const cmif::PointerAndSize &in_raw_data, const ServiceCommandIndex &cmd_index) const {
         /* Get versioning info. */
         const auto hos_version      = hos::GetVersion();
         const u32  max_cmif_version = hos_version >= hos::Version_5_0_0 ? 1 : 0;
@@ -30,13 +30,8 @@ namespace ams::sf::cmif {
         const u32 cmd_id = in_header->command_id;
 
         /* Find a handler. */
-        decltype(ServiceCommandMeta::handler) cmd_handler = nullptr;
-        for (size_t i = 0; i < entry_count; i++) {
-            if (entries[i].Matches(cmd_id, hos_version)) {
-                cmd_handler = entries[i].GetHandler();
-                break;
-            }
-        }
+        const ServiceCommandMeta *cmd_meta = cmd_index.Find(cmd_id, hos_version);
+        decltype(ServiceCommandMeta::handler) cmd_handler = (cmd_meta != nullptr) ? cmd_meta->GetHandler() : nullptr;
         R_UNLESS(cmd_handler != nullptr, sf::cmif::ResultUnknownCommandId());
 
         /* Invoke handler. */
@@ -60,7 +55,7 @@ namespace ams::sf::cmif {
         return ResultSuccess();
     }
 
-    Result impl::ServiceDispatchTableBase::ProcessMessageForMitmImpl(ServiceDispatchContext &ctx, const cmif::PointerAndSize &in_raw_data, const ServiceCommandMeta *entries, const size_t entry_count) const {
+    Result impl::ServiceDispatchTableBase::ProcessMessageForMitmImpl(ServiceDispatchContext &ctx, const cmif::PointerAndSize &in_raw_data, const ServiceCommandIndex &cmd_index) const {
         /* Get versioning info. */
         const auto hos_version      = hos::GetVersion();
         const u32  max_cmif_version = hos_version >= hos::Version_5_0_0 ? 1 : 0;
@@ -73,13 +68,8 @@ namespace ams::sf::cmif {
         const u32 cmd_id = in_header->command_id;
 
         /* Find a handler. */
-        decltype(ServiceCommandMeta::handler) cmd_handler = nullptr;
-        for (size_t i = 0; i < entry_count; i++) {
-            if (entries[i].Matches(cmd_id, hos_version)) {
-                cmd_handler = entries[i].GetHandler();
-                break;
-            }
-        }
+        const ServiceCommandMeta *cmd_meta = cmd_index.Find(cmd_id, hos_version);
+        decltype(ServiceCommandMeta::handler) cmd_handler = (cmd_meta != nullptr) ? cmd_meta->GetHandler() : nullptr;
 
         /* If we didn't find a handler, forward the request. */
         if (cmd_handler == nullptr) {
@@ -49,11 +49,37 @@ namespace ams::sf::hipc {
 
     void ServerManagerBase::ProcessWaitList() {
         std::scoped_lock lk(this->waitlist_mutex);
-        os::MoveAllWaitableHolder(std::addressof(this->waitable_manager), std::addressof(this->waitlist));
+
+        /* Holders we have no space for stay on the wait list, and are moved over once others are unlinked. */
+        R_TRY_CATCH(os::TryMoveAllWaitableHolder(std::addressof(this->waitable_manager), std::addressof(this->waitlist))) {
+            R_CATCH(os::ResultOutOfResource) { /* ... */ }
+        } R_END_TRY_CATCH_WITH_ABORT_UNLESS;
+    }
+
+    void ServerManagerBase::AttachWaitableManagerRelays() {
+        /* Our first relay keeps our handles in a persistent set, and is waited on by whichever thread is processing for us. */
+        R_ABORT_UNLESS(os::AttachWaitableManagerRelay(std::addressof(this->waitable_manager), std::addressof(this->relays[0]), nullptr, 0, 0));
+
+        /* The rest wait from threads of their own, at the priority of the threads processing for us. */
+        /* If one can't be created, the holders it would have taken wait on the wait list until there is space for them. */
+        const s32 priority = os::GetThreadCurrentPriority(os::GetCurrentThread());
+        for (size_t i = 1; i < this->num_relays; ++i) {
+            void *stack = this->relay_thread_stacks + (i - 1) * WaitableManagerRelayThreadStackSize;
+            if (R_FAILED(os::AttachWaitableManagerRelay(std::addressof(this->waitable_manager), std::addressof(this->relays[i]), stack, WaitableManagerRelayThreadStackSize, priority))) {
+                break;
+            }
+        }
     }
 
     os::WaitableHolderType *ServerManagerBase::WaitSignaled() {
         std::scoped_lock lk(this->waitable_selection_mutex);
+
+        /* Relays are attached on first wait, as threads can't be created while we're being constructed. */
+        if (AMS_UNLIKELY(!this->attached_relays)) {
+            this->AttachWaitableManagerRelays();
+            this->attached_relays = true;
+        }
+
         while (true) {
             this->ProcessWaitList();
             auto selected = os::WaitAny(std::addressof(this->waitable_manager));
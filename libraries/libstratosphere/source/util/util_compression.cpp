@@ -18,6 +18,190 @@
 
 namespace ams::util {
 
+    namespace {
+
+        constexpr u32 LZ4FrameMagic = util::FourCC<'L','Z','4','F'>::Code;
+
+        struct LZ4FrameHeader {
+            u32 magic;
+            u32 block_size;
+            u64 uncompressed_size;
+            u32 block_count;
+            u32 reserved;
+        };
+        static_assert(sizeof(LZ4FrameHeader) == 0x18);
+
+        /* A block whose size is its uncompressed size is stored uncompressed. */
+        struct LZ4FrameBlockEntry {
+            u32 offset;
+            u32 size;
+        };
+        static_assert(sizeof(LZ4FrameBlockEntry) == 0x8);
+
+        /* LZ4 keeps its compression state on the stack. */
+        constexpr size_t LZ4FrameThreadStackSize = 32_KB;
+
+        constexpr s32 GetLZ4FrameBlockCount(size_t size, size_t block_size) {
+            return static_cast<s32>(util::DivideUp(size, block_size));
+        }
+
+        constexpr size_t GetLZ4FrameDataOffset(s32 block_count) {
+            return sizeof(LZ4FrameHeader) + block_count * sizeof(LZ4FrameBlockEntry);
+        }
+
+        constexpr size_t GetLZ4FrameBlockSize(const LZ4FrameInfo &info, s32 block_index) {
+            return std::min(info.block_size, info.uncompressed_size - block_index * info.block_size);
+        }
+
+        /* NOTE: Frames needn't be aligned, so block entries are always copied in and out. */
+        LZ4FrameBlockEntry ReadLZ4FrameBlockEntry(const void *frame, s32 block_index) {
+            LZ4FrameBlockEntry entry;
+            std::memcpy(std::addressof(entry), static_cast<const u8 *>(frame) + sizeof(LZ4FrameHeader) + block_index * sizeof(LZ4FrameBlockEntry), sizeof(entry));
+            return entry;
+        }
+
+        void WriteLZ4FrameBlockEntry(void *frame, s32 block_index, u32 offset, u32 size) {
+            const LZ4FrameBlockEntry entry = { .offset = offset, .size = size };
+            std::memcpy(static_cast<u8 *>(frame) + sizeof(LZ4FrameHeader) + block_index * sizeof(LZ4FrameBlockEntry), std::addressof(entry), sizeof(entry));
+        }
+
+        /* Runs a function on each block, sharing the blocks out between the calling thread and up to thread_count - 1 others. */
+        struct LZ4FrameBlockJob {
+            bool (*function)(void *arg, s32 block_index);
+            void *argument;
+            s32 block_count;
+            std::atomic<s32> next_block_index;
+            std::atomic<bool> failed;
+        };
+
+        void RunLZ4FrameBlockJob(LZ4FrameBlockJob *job) {
+            while (!job->failed.load()) {
+                const s32 block_index = job->next_block_index.fetch_add(1);
+                if (block_index >= job->block_count) {
+                    break;
+                }
+
+                if (!job->function(job->argument, block_index)) {
+                    job->failed = true;
+                }
+            }
+        }
+
+        void LZ4FrameThreadFunction(void *arg) {
+            RunLZ4FrameBlockJob(static_cast<LZ4FrameBlockJob *>(arg));
+        }
+
+        bool ForEachLZ4FrameBlock(s32 block_count, s32 thread_count, bool (*function)(void *arg, s32 block_index), void *argument) {
+            LZ4FrameBlockJob job = { .function = function, .argument = argument, .block_count = block_count, .next_block_index = 0, .failed = false };
+
+            /* Start helper threads. Blocks are pure computation, so they only help on the other cores we may use. */
+            os::ThreadType threads[LZ4FrameThreadCountMax - 1];
+            s32 helper_count = 0;
+
+            const s32 helper_count_max = std::min(std::min(thread_count, block_count), LZ4FrameThreadCountMax) - 1;
+            std::unique_ptr<u8[]> stack_memory;
+            if (helper_count_max > 0) {
+                /* If we can't get stacks, do the work ourselves. */
+                stack_memory.reset(new (std::nothrow) u8[helper_count_max * LZ4FrameThreadStackSize + os::ThreadStackAlignment]);
+            }
+
+            if (stack_memory != nullptr) {
+                u8 *stacks = static_cast<u8 *>(util::AlignUp(static_cast<void *>(stack_memory.get()), os::ThreadStackAlignment));
+
+                const s32 current_core = os::GetCurrentCoreNumber();
+                const u64 core_mask    = os::GetThreadAvailableCoreMask();
+                const s32 priority     = os::GetThreadPriority(os::GetCurrentThread());
+
+                for (s32 core = 0; core < static_cast<s32>(BITSIZEOF(core_mask)) && helper_count < helper_count_max; ++core) {
+                    if (core == current_core || (core_mask & (static_cast<u64>(1) << core)) == 0) {
+                        continue;
+                    }
+
+                    /* If we can't create a helper, make do with the ones we have. */
+                    os::ThreadType *thread = std::addressof(threads[helper_count]);
+                    if (R_FAILED(os::CreateThread(thread, LZ4FrameThreadFunction, std::addressof(job), stacks + helper_count * LZ4FrameThreadStackSize, LZ4FrameThreadStackSize, priority, core))) {
+                        break;
+                    }
+
+                    os::SetThreadNamePointer(thread, "util.LZ4Frame");
+                    os::StartThread(thread);
+
+                    ++helper_count;
+                }
+            }
+
+            /* Work alongside the helpers, then wait for them to finish. */
+            RunLZ4FrameBlockJob(std::addressof(job));
+
+            for (s32 i = 0; i < helper_count; ++i) {
+                os::WaitThread(std::addressof(threads[i]));
+                os::DestroyThread(std::addressof(threads[i]));
+            }
+
+            return !job.failed.load();
+        }
+
+        struct LZ4FrameCompressContext {
+            u8 *dst_data;
+            void *frame;
+            const u8 *src;
+            size_t src_size;
+            size_t block_size;
+            size_t block_bound;
+        };
+
+        bool CompressLZ4FrameBlockToSlot(void *arg, s32 block_index) {
+            const auto *ctx = static_cast<const LZ4FrameCompressContext *>(arg);
+
+            const u8 *block_src     = ctx->src + block_index * ctx->block_size;
+            const size_t block_size = std::min(ctx->block_size, ctx->src_size - block_index * ctx->block_size);
+            u8 *block_dst           = ctx->dst_data + block_index * ctx->block_bound;
+
+            /* Store blocks which don't get smaller as they are. */
+            int compressed_size = LZ4_compress_default(reinterpret_cast<const char *>(block_src), reinterpret_cast<char *>(block_dst), static_cast<int>(block_size), static_cast<int>(ctx->block_bound));
+            if (compressed_size <= 0 || static_cast<size_t>(compressed_size) >= block_size) {
+                std::memcpy(block_dst, block_src, block_size);
+                compressed_size = static_cast<int>(block_size);
+            }
+
+            /* The block's offset is filled in once the blocks are packed. */
+            WriteLZ4FrameBlockEntry(ctx->frame, block_index, 0, static_cast<u32>(compressed_size));
+            return true;
+        }
+
+        struct LZ4FrameDecompressContext {
+            u8 *dst;
+            const void *src;
+            size_t src_size;
+            LZ4FrameInfo info;
+        };
+
+        bool DecompressLZ4FrameBlockImpl(void *dst, const void *src, size_t src_size, const LZ4FrameInfo &info, s32 block_index) {
+            const size_t block_size  = GetLZ4FrameBlockSize(info, block_index);
+            const size_t data_offset = GetLZ4FrameDataOffset(info.block_count);
+            const auto entry         = ReadLZ4FrameBlockEntry(src, block_index);
+
+            /* Validate the entry. */
+            if (entry.size > block_size || static_cast<u64>(entry.offset) + entry.size > src_size - data_offset) {
+                return false;
+            }
+
+            const u8 *block_src = static_cast<const u8 *>(src) + data_offset + entry.offset;
+            if (entry.size == block_size) {
+                std::memcpy(dst, block_src, block_size);
+                return true;
+            } else {
+                return LZ4_decompress_safe(reinterpret_cast<const char *>(block_src), static_cast<char *>(dst), static_cast<int>(entry.size), static_cast<int>(block_size)) == static_cast<int>(block_size);
+            }
+        }
+
+        bool DecompressLZ4FrameBlockFromContext(void *arg, s32 block_index) {
+            const auto *ctx = static_cast<const LZ4FrameDecompressContext *>(arg);
+            return DecompressLZ4FrameBlockImpl(ctx->dst + block_index * ctx->info.block_size, ctx->src, ctx->src_size, ctx->info, block_index);
+        }
+
+    }
+
     /* Compression utilities. */
     int CompressLZ4(void *dst, size_t dst_size, const void *src, size_t src_size) {
         /* Size checks. */
@@ -38,4 +222,133 @@ namespace ams::util {
         return LZ4_decompress_safe(reinterpret_cast<const char *>(src), reinterpret_cast<char *>(dst), static_cast<int>(src_size), static_cast<int>(dst_size));
     }
 
-}
\ No newline at end of file
+    /* Framed compression utilities. */
+    size_t GetCompressLZ4FrameBound(size_t src_size, size_t block_size) {
+        /* Size checks. */
+        AMS_ABORT_UNLESS(src_size <= std::numeric_limits<int>::max());
+        AMS_ABORT_UNLESS(LZ4FrameBlockSizeMin <= block_size && block_size <= LZ4FrameBlockSizeMax);
+
+        const s32 block_count = GetLZ4FrameBlockCount(src_size, block_size);
+        return GetLZ4FrameDataOffset(block_count) + block_count * static_cast<size_t>(LZ4_COMPRESSBOUND(block_size));
+    }
+
+    bool CompressLZ4Frame(size_t *out_size, void *dst, size_t dst_size, const void *src, size_t src_size, size_t block_size, s32 thread_count) {
+        /* Size checks. */
+        AMS_ABORT_UNLESS(src_size <= std::numeric_limits<int>::max());
+        AMS_ABORT_UNLESS(LZ4FrameBlockSizeMin <= block_size && block_size <= LZ4FrameBlockSizeMax);
+        AMS_ABORT_UNLESS(thread_count > 0);
+
+        const s32 block_count    = GetLZ4FrameBlockCount(src_size, block_size);
+        const size_t data_offset = GetLZ4FrameDataOffset(block_count);
+        const size_t block_bound = LZ4_COMPRESSBOUND(block_size);
+        if (dst_size < data_offset) {
+            return false;
+        }
+
+        u8 *dst_data = static_cast<u8 *>(dst) + data_offset;
+        const u8 *src_bytes = static_cast<const u8 *>(src);
+
+        size_t data_size = 0;
+        if (dst_size >= GetCompressLZ4FrameBound(src_size, block_size)) {
+            /* With room for every block's worst case, compress each block to its own slot (in parallel), then pack the blocks. */
+            LZ4FrameCompressContext ctx = { .dst_data = dst_data, .frame = dst, .src = src_bytes, .src_size = src_size, .block_size = block_size, .block_bound = block_bound };
+            ForEachLZ4FrameBlock(block_count, thread_count, CompressLZ4FrameBlockToSlot, std::addressof(ctx));
+
+            /* NOTE: Each block only ever moves towards the start, so packing in order never overwrites a block still to be moved. */
+            for (s32 i = 0; i < block_count; ++i) {
+                const auto entry = ReadLZ4FrameBlockEntry(dst, i);
+                std::memmove(dst_data + data_size, dst_data + i * block_bound, entry.size);
+                WriteLZ4FrameBlockEntry(dst, i, static_cast<u32>(data_size), entry.size);
+                data_size += entry.size;
+            }
+        } else {
+            /* Otherwise, compress each block directly after the last, on this thread. */
+            for (s32 i = 0; i < block_count; ++i) {
+                const u8 *block_src      = src_bytes + i * block_size;
+                const size_t cur_size    = std::min(block_size, src_size - i * block_size);
+                const size_t remaining   = dst_size - data_offset - data_size;
+                const size_t compress_to = std::min(remaining, cur_size - 1);
+
+                /* Store blocks which don't get smaller as they are. */
+                int compressed_size = (compress_to > 0) ? LZ4_compress_default(reinterpret_cast<const char *>(block_src), reinterpret_cast<char *>(dst_data + data_size), static_cast<int>(cur_size), static_cast<int>(compress_to)) : 0;
+                if (compressed_size <= 0) {
+                    if (remaining < cur_size) {
+                        return false;
+                    }
+
+                    std::memcpy(dst_data + data_size, block_src, cur_size);
+                    compressed_size = static_cast<int>(cur_size);
+                }
+
+                WriteLZ4FrameBlockEntry(dst, i, static_cast<u32>(data_size), static_cast<u32>(compressed_size));
+                data_size += compressed_size;
+            }
+        }
+
+        /* Write the header. */
+        const LZ4FrameHeader header = { .magic = LZ4FrameMagic, .block_size = static_cast<u32>(block_size), .uncompressed_size = src_size, .block_count = static_cast<u32>(block_count), .reserved = 0 };
+        std::memcpy(dst, std::addressof(header), sizeof(header));
+
+        *out_size = data_offset + data_size;
+        return true;
+    }
+
+    bool GetLZ4FrameInfo(LZ4FrameInfo *out, const void *src, size_t src_size) {
+        /* Read the header. */
+        LZ4FrameHeader header;
+        if (src_size < sizeof(header)) {
+            return false;
+        }
+        std::memcpy(std::addressof(header), src, sizeof(header));
+
+        /* Validate it. */
+        if (header.magic != LZ4FrameMagic || header.block_size < LZ4FrameBlockSizeMin || header.block_size > LZ4FrameBlockSizeMax) {
+            return false;
+        }
+        if (header.uncompressed_size > static_cast<u64>(std::numeric_limits<int>::max()) || header.block_count != static_cast<u32>(GetLZ4FrameBlockCount(header.uncompressed_size, header.block_size))) {
+            return false;
+        }
+        if (src_size < GetLZ4FrameDataOffset(header.block_count)) {
+            return false;
+        }
+
+        *out = { .uncompressed_size = static_cast<size_t>(header.uncompressed_size), .block_size = header.block_size, .block_count = static_cast<s32>(header.block_count) };
+        return true;
+    }
+
+    bool DecompressLZ4Frame(size_t *out_size, void *dst, size_t dst_size, const void *src, size_t src_size, s32 thread_count) {
+        AMS_ABORT_UNLESS(thread_count > 0);
+
+        /* Get and check the frame's info. */
+        LZ4FrameInfo info;
+        if (!GetLZ4FrameInfo(std::addressof(info), src, src_size) || dst_size < info.uncompressed_size) {
+            return false;
+        }
+
+        /* Decompress each block to its place. */
+        LZ4FrameDecompressContext ctx = { .dst = static_cast<u8 *>(dst), .src = src, .src_size = src_size, .info = info };
+        if (!ForEachLZ4FrameBlock(info.block_count, thread_count, DecompressLZ4FrameBlockFromContext, std::addressof(ctx))) {
+            return false;
+        }
+
+        *out_size = info.uncompressed_size;
+        return true;
+    }
+
+    bool DecompressLZ4FrameBlock(size_t *out_size, void *dst, size_t dst_size, const void *src, size_t src_size, s32 block_index) {
+        /* Get and check the frame's info. */
+        LZ4FrameInfo info;
+        if (!GetLZ4FrameInfo(std::addressof(info), src, src_size) || block_index < 0 || block_index >= info.block_count) {
+            return false;
+        }
+
+        const size_t block_size = GetLZ4FrameBlockSize(info, block_index);
+        if (dst_size < block_size || !DecompressLZ4FrameBlockImpl(dst, src, src_size, info, block_index)) {
+            return false;
+        }
+
+        *out_size = block_size;
+        return true;
+    }
+
+}
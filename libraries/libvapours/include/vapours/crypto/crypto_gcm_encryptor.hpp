@@ -49,7 +49,7 @@ namespace ams::crypto {
             }
 
             size_t Update(void *dst, size_t dst_size, const void *src, size_t src_size) {
-                return this->impl.Update(dst, dst_size, src, src_size);
+                return this->impl.UpdateEncrypt(dst, dst_size, src, src_size);
             }
 
             void UpdateAad(const void *aad, size_t aad_size) {
@@ -101,6 +101,12 @@ namespace ams::crypto::impl {
 
             void InitializeHashKey();
             void ComputeMac(bool encrypt);
+
+            template<bool IsEncrypt>
+            size_t UpdateMessage(u8 *dst, const u8 *src, size_t src_size);
+
+            void GhashBlocks(const u8 *data, size_t num_blocks);
+            void GenerateKeyStream(u8 *dst, size_t num_blocks);
     };
 
 }
@@ -53,15 +53,19 @@
 #include <unordered_map>
 #include <set>
 
+#endif /* ATMOSPHERE_IS_STRATOSPHERE */
+
+#if defined(ATMOSPHERE_IS_STRATOSPHERE) && defined(ATMOSPHERE_OS_HORIZON)
+
 /* Libnx. */
 #include <switch.h>
 
 #else
 
-/* Non-EL0 code can't include libnx. */
+/* Non-EL0 code and host builds can't include libnx. */
 #include "types.hpp"
 
-#endif /* ATMOSPHERE_IS_STRATOSPHERE */
+#endif
 
 /* Atmosphere meta. */
 #include <vapours/ams_version.h>
@@ -45,6 +45,14 @@ namespace ams::dmnt {
         R_DEFINE_ABSTRACT_ERROR_RANGE(VirtualMachineError, 6700, 6799);
             R_DEFINE_ERROR_RESULT(VirtualMachineInvalidConditionDepth, 6700);
 
+        R_DEFINE_ABSTRACT_ERROR_RANGE(SearchError, 6800, 6899);
+            R_DEFINE_ERROR_RESULT(SearchInvalidValueType,    6800);
+            R_DEFINE_ERROR_RESULT(SearchInvalidCondition,    6801);
+            R_DEFINE_ERROR_RESULT(SearchNotStarted,          6802);
+            R_DEFINE_ERROR_RESULT(SearchValueTypeMismatch,   6803);
+            R_DEFINE_ERROR_RESULT(SearchInvalidPointerDepth, 6804);
+            R_DEFINE_ERROR_RESULT(SearchOutOfMemory,         6805);
+
     }
 
 }
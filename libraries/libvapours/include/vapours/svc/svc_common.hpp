@@ -22,7 +22,7 @@
 namespace ams::svc {
 
     /* TODO: C++ style handle? */
-#ifdef ATMOSPHERE_IS_STRATOSPHERE
+#if defined(ATMOSPHERE_IS_STRATOSPHERE) && defined(ATMOSPHERE_OS_HORIZON)
     using Handle = ::Handle;
 #else
     using Handle = u32;
@@ -87,6 +87,17 @@ namespace ams::svc {
     using namespace ::ams::svc::ilp32;
     using namespace ::ams::svc::aarch32;
 
+#elif defined(ATMOSPHERE_ARCH_X64)
+
+    /* NOTE: Host builds use the types of the aarch64 lp64 kernel abi. */
+    namespace lp64    { /* ... */ }
+    namespace aarch64 { /* ... */ }
+    using namespace ::ams::svc::lp64;
+    using namespace ::ams::svc::aarch64;
+
+    namespace aarch64::lp64  { /* ... */ }
+    using namespace ::ams::svc::aarch64::lp64;
+
 #else
 
     #error "Unknown Architecture"
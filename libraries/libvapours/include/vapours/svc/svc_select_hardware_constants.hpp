@@ -24,6 +24,13 @@
         using namespace ams::svc::board::nintendo::nx;
     }
 
+#elif defined(ATMOSPHERE_BOARD_GENERIC_LINUX)
+
+    #include <vapours/svc/board/generic/svc_hardware_constants.hpp>
+    namespace ams::svc {
+        using namespace ams::svc::board::generic;
+    }
+
 #else
 
     #error "Unknown board for svc::DeviceName"
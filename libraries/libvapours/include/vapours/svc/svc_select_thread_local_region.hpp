@@ -33,6 +33,14 @@
         using ams::svc::arch::arm::GetThreadLocalRegion;
     }
 
+#elif defined(ATMOSPHERE_ARCH_X64)
+
+    #include <vapours/svc/arch/x64/svc_thread_local_region.hpp>
+    namespace ams::svc {
+        using ams::svc::arch::x64::ThreadLocalRegion;
+        using ams::svc::arch::x64::GetThreadLocalRegion;
+    }
+
 #else
 
     #error "Unknown architecture for svc::ThreadLocalRegion"
@@ -41,7 +41,7 @@ typedef volatile s16 vs16;   ///<  16-bit volatile signed integer.
 typedef volatile s32 vs32;   ///<  32-bit volatile signed integer.
 typedef volatile s64 vs64;   ///<  64-bit volatile signed integer.
 
-#ifdef ATMOSPHERE_ARCH_ARM64
+#if defined(ATMOSPHERE_ARCH_ARM64) || defined(ATMOSPHERE_ARCH_X64)
 typedef __uint128_t u128; ///< 128-bit unsigned integer.
 typedef __int128_t s128; ///< 128-bit unsigned integer.
 typedef volatile u128 vu128; ///< 128-bit volatile unsigned integer.
@@ -569,8 +569,12 @@ namespace ams::util {
                 return util::GetParentReference<Member, Derived>(&node);
             }
         private:
+            #if AMS_UTIL_OFFSET_OF_STANDARD_COMPLIANT
+            static_assert(util::impl::IsValidOffsetOf<Member, Derived>);
+            #else
             static constexpr TypedStorage<Derived> DerivedStorage = {};
             static_assert(std::addressof(GetParent(GetNode(GetReference(DerivedStorage)))) == GetPointer(DerivedStorage));
+            #endif
     };
 
     template<auto T, class Derived = util::impl::GetParentType<T>>
@@ -582,8 +586,12 @@ namespace ams::util {
             using ListType = IntrusiveList<Derived, IntrusiveListMemberTraitsDeferredAssert>;
 
             static constexpr bool IsValid() {
+                #if AMS_UTIL_OFFSET_OF_STANDARD_COMPLIANT
+                return util::impl::IsValidOffsetOf<Member, Derived>;
+                #else
                 TypedStorage<Derived> DerivedStorage = {};
                 return std::addressof(GetParent(GetNode(GetReference(DerivedStorage)))) == GetPointer(DerivedStorage);
+                #endif
             }
         private:
             friend class IntrusiveList<Derived, IntrusiveListMemberTraitsDeferredAssert>;
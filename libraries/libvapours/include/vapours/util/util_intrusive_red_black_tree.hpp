@@ -499,8 +499,12 @@ namespace ams::util {
                 return util::GetParentPointer<Member, Derived>(node);
             }
         private:
+            #if AMS_UTIL_OFFSET_OF_STANDARD_COMPLIANT
+            static_assert(util::impl::IsValidOffsetOf<Member, Derived>);
+            #else
             static constexpr TypedStorage<Derived> DerivedStorage = {};
             static_assert(GetParent(GetNode(GetPointer(DerivedStorage))) == GetPointer(DerivedStorage));
+            #endif
     };
 
     template<auto T, class Derived = util::impl::GetParentType<T>>
@@ -514,8 +518,12 @@ namespace ams::util {
             using TreeTypeImpl = impl::IntrusiveRedBlackTreeImpl;
 
             static constexpr bool IsValid() {
+                #if AMS_UTIL_OFFSET_OF_STANDARD_COMPLIANT
+                return util::impl::IsValidOffsetOf<Member, Derived>;
+                #else
                 TypedStorage<Derived> DerivedStorage = {};
                 return GetParent(GetNode(GetPointer(DerivedStorage))) == GetPointer(DerivedStorage);
+                #endif
             }
         private:
             template<class, class, class>
@@ -23,7 +23,12 @@ namespace ams::util {
 
     namespace impl {
 
-        #define AMS_UTIL_OFFSET_OF_STANDARD_COMPLIANT 0
+        /* NOTE: gcc 11 and later no longer allow casts from void * during constant evaluation, and host builds may use them. */
+        #if !defined(ATMOSPHERE_OS_HORIZON) && defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+            #define AMS_UTIL_OFFSET_OF_STANDARD_COMPLIANT 1
+        #else
+            #define AMS_UTIL_OFFSET_OF_STANDARD_COMPLIANT 0
+        #endif
 
         #if AMS_UTIL_OFFSET_OF_STANDARD_COMPLIANT
 
@@ -63,10 +68,11 @@ namespace ams::util {
                 union Union {
                     char c;
                     UnionHolder first_union;
-                    TypedStorage<ParentType> parent;
+                    ParentType parent;
 
                     /* This coerces the active member to be c. */
                     constexpr Union() : c() { /* ... */ }
+                    constexpr ~Union() { /* ... */ }
                 };
                 static constexpr Union U = {};
 
@@ -84,7 +90,7 @@ namespace ams::util {
                 template<typename CurUnion>
                 static constexpr std::ptrdiff_t OffsetOfImpl(MemberType ParentType::*member, CurUnion &cur_union) {
                     constexpr size_t Offset = CurUnion::GetOffset();
-                    const auto target = std::addressof(GetPointer(U.parent)->*member);
+                    const auto target = std::addressof(U.parent.*member);
                     const auto start  = std::addressof(cur_union.data.members[0]);
                     const auto next   = GetNextAddress(start, target);
 
@@ -144,17 +150,46 @@ namespace ams::util {
             return OffsetOfCalculator<RealParentType, MemberType>::OffsetOf(MemberPtr);
         }();
 
+        template<auto MemberPtr, typename RealParentType = GetParentType<MemberPtr>>
+        constexpr ALWAYS_INLINE std::ptrdiff_t GetOffsetOf() {
+            #if AMS_UTIL_OFFSET_OF_STANDARD_COMPLIANT
+            if constexpr (std::is_abstract<RealParentType>::value) {
+                /* Abstract types can't be members of the calculator's union, and member pointers can't be inspected during constant evaluation. */
+                /* Host ABIs represent a data member pointer as the member's offset within its class, so we use that instead. */
+                static_assert(std::is_same<RealParentType, GetParentType<MemberPtr>>::value);
+                static_assert(sizeof(MemberPtr) == sizeof(std::ptrdiff_t));
+                return std::bit_cast<std::ptrdiff_t>(MemberPtr);
+            } else {
+                return OffsetOf<MemberPtr, RealParentType>;
+            }
+            #else
+            return OffsetOf<MemberPtr, RealParentType>;
+            #endif
+        }
+
+        /* Checks during constant evaluation that a member lies within its parent, for builds which can't check GetParentReference itself. */
+        template<auto MemberPtr, typename RealParentType = GetParentType<MemberPtr>>
+        constexpr inline bool IsValidOffsetOf = [] {
+            if constexpr (std::is_abstract<RealParentType>::value) {
+                /* Abstract types can't be held during constant evaluation, but their offsets come straight from the member pointer. */
+                return true;
+            } else {
+                constexpr std::ptrdiff_t Offset = OffsetOf<MemberPtr, RealParentType>;
+                return 0 <= Offset && Offset + sizeof(GetMemberType<MemberPtr>) <= sizeof(RealParentType);
+            }
+        }();
+
     }
 
     template<auto MemberPtr, typename RealParentType = impl::GetParentType<MemberPtr>>
     constexpr ALWAYS_INLINE RealParentType &GetParentReference(impl::GetMemberType<MemberPtr> *member) {
-        constexpr std::ptrdiff_t Offset = impl::OffsetOf<MemberPtr, RealParentType>;
+        const std::ptrdiff_t Offset = impl::GetOffsetOf<MemberPtr, RealParentType>();
         return *static_cast<RealParentType *>(static_cast<void *>(static_cast<uint8_t *>(static_cast<void *>(member)) - Offset));
     }
 
     template<auto MemberPtr, typename RealParentType = impl::GetParentType<MemberPtr>>
     constexpr ALWAYS_INLINE RealParentType const &GetParentReference(impl::GetMemberType<MemberPtr> const *member) {
-        constexpr std::ptrdiff_t Offset = impl::OffsetOf<MemberPtr, RealParentType>;
+        const std::ptrdiff_t Offset = impl::GetOffsetOf<MemberPtr, RealParentType>();
         return *static_cast<const RealParentType *>(static_cast<const void *>(static_cast<const uint8_t *>(static_cast<const void *>(member)) - Offset));
     }
 
@@ -223,12 +258,15 @@ namespace ams::util {
 
         constexpr Struct3 TestStruct3 = {};
 
+        /* NOTE: Standard compliant builds can't constant evaluate GetParentReference, so only check the offsets above. */
+        #if !AMS_UTIL_OFFSET_OF_STANDARD_COMPLIANT
         static_assert(std::addressof(TestStruct3) == GET_PARENT_PTR(Struct3, a, TestStruct3.a));
         static_assert(std::addressof(TestStruct3) == GET_PARENT_PTR(Struct3, a, std::addressof(TestStruct3.a)));
         static_assert(std::addressof(TestStruct3) == GET_PARENT_PTR(Struct3, b, TestStruct3.b));
         static_assert(std::addressof(TestStruct3) == GET_PARENT_PTR(Struct3, b, std::addressof(TestStruct3.b)));
         static_assert(std::addressof(TestStruct3) == GET_PARENT_PTR(Struct3, c, TestStruct3.c));
         static_assert(std::addressof(TestStruct3) == GET_PARENT_PTR(Struct3, c, std::addressof(TestStruct3.c)));
+        #endif
 
         struct CharArray {
             char c0;
@@ -252,6 +290,7 @@ namespace ams::util {
 
         constexpr CharArray TestCharArray = {};
 
+        #if !AMS_UTIL_OFFSET_OF_STANDARD_COMPLIANT
         static_assert(std::addressof(TestCharArray) == GET_PARENT_PTR(CharArray, c0, TestCharArray.c0));
         static_assert(std::addressof(TestCharArray) == GET_PARENT_PTR(CharArray, c0, std::addressof(TestCharArray.c0)));
         static_assert(std::addressof(TestCharArray) == GET_PARENT_PTR(CharArray, c1, TestCharArray.c1));
@@ -268,6 +307,7 @@ namespace ams::util {
         static_assert(std::addressof(TestCharArray) == GET_PARENT_PTR(CharArray, c6, std::addressof(TestCharArray.c6)));
         static_assert(std::addressof(TestCharArray) == GET_PARENT_PTR(CharArray, c7, TestCharArray.c7));
         static_assert(std::addressof(TestCharArray) == GET_PARENT_PTR(CharArray, c7, std::addressof(TestCharArray.c7)));
+        #endif
 
     }
 
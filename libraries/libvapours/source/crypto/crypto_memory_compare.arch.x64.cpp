@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vapours.hpp>
+
+namespace ams::crypto {
+
+    bool IsSameBytes(const void *lhs, const void *rhs, size_t size) {
+        const volatile u8 *lhs_u8 = static_cast<const volatile u8 *>(lhs);
+        const volatile u8 *rhs_u8 = static_cast<const volatile u8 *>(rhs);
+
+        /* Compare all bytes in constant time. */
+        u8 xor_acc = 0;
+        for (size_t i = 0; i < size; ++i) {
+            xor_acc |= lhs_u8[i] ^ rhs_u8[i];
+        }
+
+        /* Prevent the compiler from reasoning about the accumulator to short-circuit the loop. */
+        __asm__ __volatile__("" : "+r"(xor_acc));
+
+        return xor_acc == 0;
+    }
+
+}
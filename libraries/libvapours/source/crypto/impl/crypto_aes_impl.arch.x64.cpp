@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vapours.hpp>
+
+#ifdef ATMOSPHERE_IS_STRATOSPHERE
+#include "crypto_x64_impl.hpp"
+
+namespace ams::crypto::impl {
+
+    namespace {
+
+        constexpr bool IsSupportedKeySize(size_t size) {
+            return size == 16 || size == 24 || size == 32;
+        }
+
+        constexpr size_t BlockSize = 0x10;
+
+        constexpr const u8 SubBytesTable[0x100] = {
+            0x63, 0x7C, 0x77, 0x7B, 0xF2, 0x6B, 0x6F, 0xC5, 0x30, 0x01, 0x67, 0x2B, 0xFE, 0xD7, 0xAB, 0x76,
+            0xCA, 0x82, 0xC9, 0x7D, 0xFA, 0x59, 0x47, 0xF0, 0xAD, 0xD4, 0xA2, 0xAF, 0x9C, 0xA4, 0x72, 0xC0,
+            0xB7, 0xFD, 0x93, 0x26, 0x36, 0x3F, 0xF7, 0xCC, 0x34, 0xA5, 0xE5, 0xF1, 0x71, 0xD8, 0x31, 0x15,
+            0x04, 0xC7, 0x23, 0xC3, 0x18, 0x96, 0x05, 0x9A, 0x07, 0x12, 0x80, 0xE2, 0xEB, 0x27, 0xB2, 0x75,
+            0x09, 0x83, 0x2C, 0x1A, 0x1B, 0x6E, 0x5A, 0xA0, 0x52, 0x3B, 0xD6, 0xB3, 0x29, 0xE3, 0x2F, 0x84,
+            0x53, 0xD1, 0x00, 0xED, 0x20, 0xFC, 0xB1, 0x5B, 0x6A, 0xCB, 0xBE, 0x39, 0x4A, 0x4C, 0x58, 0xCF,
+            0xD0, 0xEF, 0xAA, 0xFB, 0x43, 0x4D, 0x33, 0x85, 0x45, 0xF9, 0x02, 0x7F, 0x50, 0x3C, 0x9F, 0xA8,
+            0x51, 0xA3, 0x40, 0x8F, 0x92, 0x9D, 0x38, 0xF5, 0xBC, 0xB6, 0xDA, 0x21, 0x10, 0xFF, 0xF3, 0xD2,
+            0xCD, 0x0C, 0x13, 0xEC, 0x5F, 0x97, 0x44, 0x17, 0xC4, 0xA7, 0x7E, 0x3D, 0x64, 0x5D, 0x19, 0x73,
+            0x60, 0x81, 0x4F, 0xDC, 0x22, 0x2A, 0x90, 0x88, 0x46, 0xEE, 0xB8, 0x14, 0xDE, 0x5E, 0x0B, 0xDB,
+            0xE0, 0x32, 0x3A, 0x0A, 0x49, 0x06, 0x24, 0x5C, 0xC2, 0xD3, 0xAC, 0x62, 0x91, 0x95, 0xE4, 0x79,
+            0xE7, 0xC8, 0x37, 0x6D, 0x8D, 0xD5, 0x4E, 0xA9, 0x6C, 0x56, 0xF4, 0xEA, 0x65, 0x7A, 0xAE, 0x08,
+            0xBA, 0x78, 0x25, 0x2E, 0x1C, 0xA6, 0xB4, 0xC6, 0xE8, 0xDD, 0x74, 0x1F, 0x4B, 0xBD, 0x8B, 0x8A,
+            0x70, 0x3E, 0xB5, 0x66, 0x48, 0x03, 0xF6, 0x0E, 0x61, 0x35, 0x57, 0xB9, 0x86, 0xC1, 0x1D, 0x9E,
+            0xE1, 0xF8, 0x98, 0x11, 0x69, 0xD9, 0x8E, 0x94, 0x9B, 0x1E, 0x87, 0xE9, 0xCE, 0x55, 0x28, 0xDF,
+            0x8C, 0xA1, 0x89, 0x0D, 0xBF, 0xE6, 0x42, 0x68, 0x41, 0x99, 0x2D, 0x0F, 0xB0, 0x54, 0xBB, 0x16,
+        };
+
+        constexpr const auto InvSubBytesTable = [] {
+            std::array<u8, 0x100> table = {};
+            for (size_t i = 0; i < table.size(); ++i) {
+                table[SubBytesTable[i]] = static_cast<u8>(i);
+            }
+            return table;
+        }();
+
+        constexpr const u8 RoundConstants[] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1B, 0x36 };
+
+        constexpr ALWAYS_INLINE u8 MultiplyX(u8 v) {
+            return static_cast<u8>((v << 1) ^ ((v & 0x80) ? 0x1B : 0x00));
+        }
+
+        constexpr ALWAYS_INLINE u8 Multiply(u8 a, u8 b) {
+            u8 result = 0;
+            while (b != 0) {
+                if (b & 1) {
+                    result ^= a;
+                }
+                a   = MultiplyX(a);
+                b >>= 1;
+            }
+            return result;
+        }
+
+        void SubBytes(u8 *state, const u8 *table) {
+            for (size_t i = 0; i < BlockSize; ++i) {
+                state[i] = table[state[i]];
+            }
+        }
+
+        void ShiftRows(u8 *state) {
+            /* State is column-major: byte (row r, column c) lives at index r + 4 * c. */
+            u8 tmp[BlockSize];
+            for (size_t c = 0; c < 4; ++c) {
+                for (size_t r = 0; r < 4; ++r) {
+                    tmp[r + 4 * c] = state[r + 4 * ((c + r) % 4)];
+                }
+            }
+            std::memcpy(state, tmp, BlockSize);
+        }
+
+        void InvShiftRows(u8 *state) {
+            u8 tmp[BlockSize];
+            for (size_t c = 0; c < 4; ++c) {
+                for (size_t r = 0; r < 4; ++r) {
+                    tmp[r + 4 * ((c + r) % 4)] = state[r + 4 * c];
+                }
+            }
+            std::memcpy(state, tmp, BlockSize);
+        }
+
+        void MixColumns(u8 *state) {
+            for (size_t c = 0; c < 4; ++c) {
+                u8 *col = state + 4 * c;
+                const u8 a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+                const u8 all = a0 ^ a1 ^ a2 ^ a3;
+                col[0] = a0 ^ all ^ MultiplyX(a0 ^ a1);
+                col[1] = a1 ^ all ^ MultiplyX(a1 ^ a2);
+                col[2] = a2 ^ all ^ MultiplyX(a2 ^ a3);
+                col[3] = a3 ^ all ^ MultiplyX(a3 ^ a0);
+            }
+        }
+
+        void InvMixColumns(u8 *state) {
+            for (size_t c = 0; c < 4; ++c) {
+                u8 *col = state + 4 * c;
+                const u8 a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+                col[0] = Multiply(a0, 0x0E) ^ Multiply(a1, 0x0B) ^ Multiply(a2, 0x0D) ^ Multiply(a3, 0x09);
+                col[1] = Multiply(a0, 0x09) ^ Multiply(a1, 0x0E) ^ Multiply(a2, 0x0B) ^ Multiply(a3, 0x0D);
+                col[2] = Multiply(a0, 0x0D) ^ Multiply(a1, 0x09) ^ Multiply(a2, 0x0E) ^ Multiply(a3, 0x0B);
+                col[3] = Multiply(a0, 0x0B) ^ Multiply(a1, 0x0D) ^ Multiply(a2, 0x09) ^ Multiply(a3, 0x0E);
+            }
+        }
+
+        void AddRoundKey(u8 *state, const u8 *round_key) {
+            for (size_t i = 0; i < BlockSize; ++i) {
+                state[i] ^= round_key[i];
+            }
+        }
+
+        void ExpandKey(u8 *dst, const u8 *key, size_t key_size, s32 round_count, bool is_encrypt) {
+            /* Perform the standard FIPS-197 key expansion. */
+            const size_t key_words   = key_size / sizeof(u32);
+            const size_t total_words = 4 * (round_count + 1);
+
+            std::memcpy(dst, key, key_size);
+            for (size_t i = key_words; i < total_words; ++i) {
+                u8 tmp[4];
+                std::memcpy(tmp, dst + 4 * (i - 1), sizeof(tmp));
+
+                if ((i % key_words) == 0) {
+                    const u8 first = tmp[0];
+                    tmp[0] = SubBytesTable[tmp[1]] ^ RoundConstants[(i / key_words) - 1];
+                    tmp[1] = SubBytesTable[tmp[2]];
+                    tmp[2] = SubBytesTable[tmp[3]];
+                    tmp[3] = SubBytesTable[first];
+                } else if (key_words > 6 && (i % key_words) == 4) {
+                    for (size_t j = 0; j < sizeof(tmp); ++j) {
+                        tmp[j] = SubBytesTable[tmp[j]];
+                    }
+                }
+
+                for (size_t j = 0; j < sizeof(tmp); ++j) {
+                    dst[4 * i + j] = dst[4 * (i - key_words) + j] ^ tmp[j];
+                }
+            }
+
+            /* If we're decrypting, convert the schedule for the equivalent inverse cipher. */
+            if (!is_encrypt) {
+                for (s32 i = 0, j = round_count; i < j; ++i, --j) {
+                    u8 tmp[BlockSize];
+                    std::memcpy(tmp,                 dst + BlockSize * i, BlockSize);
+                    std::memcpy(dst + BlockSize * i, dst + BlockSize * j, BlockSize);
+                    std::memcpy(dst + BlockSize * j, tmp,                 BlockSize);
+                }
+                for (s32 i = 1; i < round_count; ++i) {
+                    InvMixColumns(dst + BlockSize * i);
+                }
+            }
+        }
+
+        void EncryptBlockSoftware(u8 *dst, const u8 *src, const u8 *round_keys, s32 round_count) {
+            u8 state[BlockSize];
+            std::memcpy(state, src, BlockSize);
+
+            AddRoundKey(state, round_keys);
+            for (s32 r = 1; r < round_count; ++r) {
+                SubBytes(state, SubBytesTable);
+                ShiftRows(state);
+                MixColumns(state);
+                AddRoundKey(state, round_keys + BlockSize * r);
+            }
+            SubBytes(state, SubBytesTable);
+            ShiftRows(state);
+            AddRoundKey(state, round_keys + BlockSize * round_count);
+
+            std::memcpy(dst, state, BlockSize);
+            ClearMemory(state, sizeof(state));
+        }
+
+        void DecryptBlockSoftware(u8 *dst, const u8 *src, const u8 *round_keys, s32 round_count) {
+            u8 state[BlockSize];
+            std::memcpy(state, src, BlockSize);
+
+            AddRoundKey(state, round_keys);
+            for (s32 r = 1; r < round_count; ++r) {
+                SubBytes(state, InvSubBytesTable.data());
+                InvShiftRows(state);
+                InvMixColumns(state);
+                AddRoundKey(state, round_keys + BlockSize * r);
+            }
+            SubBytes(state, InvSubBytesTable.data());
+            InvShiftRows(state);
+            AddRoundKey(state, round_keys + BlockSize * round_count);
+
+            std::memcpy(dst, state, BlockSize);
+            ClearMemory(state, sizeof(state));
+        }
+
+        template<s32 RoundCount>
+        AMS_CRYPTO_X64_TARGET_AES void EncryptBlockAesNi(u8 *dst, const u8 *src, const u8 *round_keys) {
+            __m128i keys[RoundCount + 1];
+            x64::LoadRoundKeys<RoundCount>(keys, round_keys);
+
+            const __m128i block = x64::EncryptBlockAesNi<RoundCount>(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)), keys);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), block);
+        }
+
+        template<s32 RoundCount>
+        AMS_CRYPTO_X64_TARGET_AES void DecryptBlockAesNi(u8 *dst, const u8 *src, const u8 *round_keys) {
+            __m128i keys[RoundCount + 1];
+            x64::LoadRoundKeys<RoundCount>(keys, round_keys);
+
+            const __m128i block = x64::DecryptBlockAesNi<RoundCount>(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)), keys);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), block);
+        }
+
+    }
+
+    template<size_t KeySize>
+    AesImpl<KeySize>::~AesImpl() {
+        ClearMemory(this, sizeof(*this));
+    }
+
+    template<size_t KeySize>
+    void AesImpl<KeySize>::Initialize(const void *key, size_t key_size, bool is_encrypt) {
+        static_assert(IsSupportedKeySize(KeySize));
+        static_assert(sizeof(this->round_keys) == BlockSize * (RoundCount + 1));
+        AMS_ASSERT(key_size == KeySize);
+
+        /* NOTE: The schedule is computed in software; it is shared by the AES-NI and portable block functions. */
+        ExpandKey(reinterpret_cast<u8 *>(this->round_keys), static_cast<const u8 *>(key), KeySize, RoundCount, is_encrypt);
+    }
+
+    template<size_t KeySize>
+    void AesImpl<KeySize>::EncryptBlock(void *dst, size_t dst_size, const void *src, size_t src_size) const {
+        static_assert(IsSupportedKeySize(KeySize));
+        AMS_ASSERT(src_size >= BlockSize);
+        AMS_ASSERT(dst_size >= BlockSize);
+        AMS_UNUSED(src_size, dst_size);
+
+        if (x64::IsAesNiAvailable()) {
+            EncryptBlockAesNi<RoundCount>(static_cast<u8 *>(dst), static_cast<const u8 *>(src), this->GetRoundKey());
+        } else {
+            EncryptBlockSoftware(static_cast<u8 *>(dst), static_cast<const u8 *>(src), this->GetRoundKey(), RoundCount);
+        }
+    }
+
+    template<size_t KeySize>
+    void AesImpl<KeySize>::DecryptBlock(void *dst, size_t dst_size, const void *src, size_t src_size) const {
+        static_assert(IsSupportedKeySize(KeySize));
+        AMS_ASSERT(src_size >= BlockSize);
+        AMS_ASSERT(dst_size >= BlockSize);
+        AMS_UNUSED(src_size, dst_size);
+
+        if (x64::IsAesNiAvailable()) {
+            DecryptBlockAesNi<RoundCount>(static_cast<u8 *>(dst), static_cast<const u8 *>(src), this->GetRoundKey());
+        } else {
+            DecryptBlockSoftware(static_cast<u8 *>(dst), static_cast<const u8 *>(src), this->GetRoundKey(), RoundCount);
+        }
+    }
+
+
+    /* Explicitly instantiate the three supported key sizes. */
+    template class AesImpl<16>;
+    template class AesImpl<24>;
+    template class AesImpl<32>;
+
+}
+
+#else
+
+    /* TODO: Non-EL0 implementation. */
+
+#endif
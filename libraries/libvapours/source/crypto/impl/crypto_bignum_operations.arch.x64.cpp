@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vapours.hpp>
+
+namespace ams::crypto::impl {
+
+    /* NOTE: On arm64, these primitives are implemented in assembly. */
+    /* On x64, the compiler generates good add-with-carry sequences from portable code. */
+
+    BigNum::Word BigNum::Add(Word *dst, const Word *lhs, const Word *rhs, size_t num_words) {
+        DoubleWord carry = 0;
+        for (size_t i = 0; i < num_words; ++i) {
+            carry  = static_cast<DoubleWord>(lhs[i]) + static_cast<DoubleWord>(rhs[i]) + carry;
+            dst[i] = static_cast<Word>(carry);
+            carry >>= BITSIZEOF(Word);
+        }
+        return static_cast<Word>(carry);
+    }
+
+    BigNum::Word BigNum::Sub(Word *dst, const Word *lhs, const Word *rhs, size_t num_words) {
+        Word borrow = 0;
+        for (size_t i = 0; i < num_words; ++i) {
+            const DoubleWord diff = static_cast<DoubleWord>(lhs[i]) - static_cast<DoubleWord>(rhs[i]) - borrow;
+            dst[i] = static_cast<Word>(diff);
+            borrow = static_cast<Word>(diff >> (BITSIZEOF(DoubleWord) - 1));
+        }
+        return borrow;
+    }
+
+    BigNum::Word BigNum::MultAdd(Word *dst, const Word *w, size_t num_words, Word mult) {
+        DoubleWord carry = 0;
+        for (size_t i = 0; i < num_words; ++i) {
+            carry  = static_cast<DoubleWord>(w[i]) * static_cast<DoubleWord>(mult) + static_cast<DoubleWord>(dst[i]) + (carry >> BITSIZEOF(Word));
+            dst[i] = static_cast<Word>(carry);
+        }
+        return static_cast<Word>(carry >> BITSIZEOF(Word));
+    }
+
+}
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vapours.hpp>
+
+#ifdef ATMOSPHERE_IS_STRATOSPHERE
+#include "crypto_x64_impl.hpp"
+
+namespace ams::crypto::impl {
+
+    namespace {
+
+        constexpr size_t BlockSize = 0x10;
+
+        /* Number of blocks kept in flight, to hide aesenc latency. */
+        constexpr size_t AesNiParallelBlocks = 8;
+        constexpr size_t VaesParallelBlocks  = 16;
+
+        struct Counter {
+            u64 high;
+            u64 low;
+
+            ALWAYS_INLINE void Load(const u8 *src) {
+                this->high = util::LoadBigEndian(reinterpret_cast<const u64 *>(src + 0));
+                this->low  = util::LoadBigEndian(reinterpret_cast<const u64 *>(src + 8));
+            }
+
+            ALWAYS_INLINE void Store(u8 *dst) const {
+                util::StoreBigEndian(reinterpret_cast<u64 *>(dst + 0), this->high);
+                util::StoreBigEndian(reinterpret_cast<u64 *>(dst + 8), this->low);
+            }
+
+            ALWAYS_INLINE void Increment() {
+                if ((++this->low) == 0) {
+                    ++this->high;
+                }
+            }
+        };
+
+        AMS_CRYPTO_X64_TARGET_AES ALWAYS_INLINE __m128i MakeCounterBlock(const Counter &ctr) {
+            return _mm_set_epi64x(static_cast<s64>(__builtin_bswap64(ctr.low)), static_cast<s64>(__builtin_bswap64(ctr.high)));
+        }
+
+        template<s32 RoundCount>
+        AMS_CRYPTO_X64_TARGET_AES void ProcessBlocksAesNi(u8 *dst, const u8 *src, size_t num_blocks, u8 *counter, const u8 *round_keys) {
+            __m128i keys[RoundCount + 1];
+            x64::LoadRoundKeys<RoundCount>(keys, round_keys);
+
+            Counter ctr;
+            ctr.Load(counter);
+
+            while (num_blocks >= AesNiParallelBlocks) {
+                __m128i blocks[AesNiParallelBlocks];
+                for (size_t i = 0; i < AesNiParallelBlocks; ++i) {
+                    blocks[i] = MakeCounterBlock(ctr);
+                    ctr.Increment();
+                }
+
+                x64::EncryptBlocksAesNi<RoundCount, AesNiParallelBlocks>(blocks, keys);
+
+                for (size_t i = 0; i < AesNiParallelBlocks; ++i) {
+                    const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + BlockSize * i));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + BlockSize * i), _mm_xor_si128(in, blocks[i]));
+                }
+
+                src        += BlockSize * AesNiParallelBlocks;
+                dst        += BlockSize * AesNiParallelBlocks;
+                num_blocks -= AesNiParallelBlocks;
+            }
+
+            while (num_blocks > 0) {
+                const __m128i block = x64::EncryptBlockAesNi<RoundCount>(MakeCounterBlock(ctr), keys);
+                ctr.Increment();
+
+                const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_xor_si128(in, block));
+
+                src += BlockSize;
+                dst += BlockSize;
+                --num_blocks;
+            }
+
+            ctr.Store(counter);
+        }
+
+        template<s32 RoundCount>
+        AMS_CRYPTO_X64_TARGET_VAES void ProcessBlocksVaes(u8 *dst, const u8 *src, size_t num_blocks, u8 *counter, const u8 *round_keys) {
+            constexpr size_t VectorCount = VaesParallelBlocks / 2;
+
+            __m256i keys[RoundCount + 1];
+            for (s32 i = 0; i <= RoundCount; ++i) {
+                keys[i] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(round_keys + BlockSize * i)));
+            }
+
+            Counter ctr;
+            ctr.Load(counter);
+
+            while (num_blocks >= VaesParallelBlocks) {
+                __m256i blocks[VectorCount];
+                for (size_t i = 0; i < VectorCount; ++i) {
+                    const __m128i lo = MakeCounterBlock(ctr);
+                    ctr.Increment();
+                    const __m128i hi = MakeCounterBlock(ctr);
+                    ctr.Increment();
+
+                    blocks[i] = _mm256_xor_si256(_mm256_set_m128i(hi, lo), keys[0]);
+                }
+
+                for (s32 r = 1; r < RoundCount; ++r) {
+                    for (size_t i = 0; i < VectorCount; ++i) {
+                        blocks[i] = _mm256_aesenc_epi128(blocks[i], keys[r]);
+                    }
+                }
+                for (size_t i = 0; i < VectorCount; ++i) {
+                    blocks[i] = _mm256_aesenclast_epi128(blocks[i], keys[RoundCount]);
+                }
+
+                for (size_t i = 0; i < VectorCount; ++i) {
+                    const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 2 * BlockSize * i));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 2 * BlockSize * i), _mm256_xor_si256(in, blocks[i]));
+                }
+
+                src        += BlockSize * VaesParallelBlocks;
+                dst        += BlockSize * VaesParallelBlocks;
+                num_blocks -= VaesParallelBlocks;
+            }
+
+            ctr.Store(counter);
+
+            /* Process any tail with the 128-bit path. */
+            if (num_blocks > 0) {
+                ProcessBlocksAesNi<RoundCount>(dst, src, num_blocks, counter, round_keys);
+            }
+        }
+
+        template<s32 RoundCount>
+        ALWAYS_INLINE bool ProcessBlocksAccelerated(u8 *dst, const u8 *src, size_t num_blocks, u8 *counter, const u8 *round_keys) {
+            if (x64::IsVaesAvailable()) {
+                ProcessBlocksVaes<RoundCount>(dst, src, num_blocks, counter, round_keys);
+                return true;
+            } else if (x64::IsAesNiAvailable()) {
+                ProcessBlocksAesNi<RoundCount>(dst, src, num_blocks, counter, round_keys);
+                return true;
+            } else {
+                return false;
+            }
+        }
+
+    }
+
+    template<>
+    void CtrModeImpl<AesEncryptor128>::ProcessBlocks(u8 *dst, const u8 *src, size_t num_blocks) {
+        if (!ProcessBlocksAccelerated<x64::GetAesRoundCount(AesEncryptor128::KeySize)>(dst, src, num_blocks, this->counter, this->block_cipher->GetRoundKey())) {
+            while (num_blocks--) {
+                this->ProcessBlock(dst, src, BlockSize);
+                dst += BlockSize;
+                src += BlockSize;
+            }
+        }
+    }
+
+    template<>
+    void CtrModeImpl<AesEncryptor192>::ProcessBlocks(u8 *dst, const u8 *src, size_t num_blocks) {
+        if (!ProcessBlocksAccelerated<x64::GetAesRoundCount(AesEncryptor192::KeySize)>(dst, src, num_blocks, this->counter, this->block_cipher->GetRoundKey())) {
+            while (num_blocks--) {
+                this->ProcessBlock(dst, src, BlockSize);
+                dst += BlockSize;
+                src += BlockSize;
+            }
+        }
+    }
+
+    template<>
+    void CtrModeImpl<AesEncryptor256>::ProcessBlocks(u8 *dst, const u8 *src, size_t num_blocks) {
+        if (!ProcessBlocksAccelerated<x64::GetAesRoundCount(AesEncryptor256::KeySize)>(dst, src, num_blocks, this->counter, this->block_cipher->GetRoundKey())) {
+            while (num_blocks--) {
+                this->ProcessBlock(dst, src, BlockSize);
+                dst += BlockSize;
+                src += BlockSize;
+            }
+        }
+    }
+
+}
+
+#else
+
+/* TODO: Non-EL0 implementation. */
+namespace ams::crypto::impl {
+
+}
+
+#endif
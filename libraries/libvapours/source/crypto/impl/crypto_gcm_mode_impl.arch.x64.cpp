@@ -0,0 +1,558 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vapours.hpp>
+
+#if defined(ATMOSPHERE_IS_STRATOSPHERE)
+#include "crypto_x64_impl.hpp"
+
+namespace ams::crypto::impl {
+
+    namespace {
+
+        constexpr size_t BlockSize = 0x10;
+
+        /* Number of blocks folded into the hash per reduction. */
+        constexpr size_t GhashParallelBlocks = 4;
+
+        /* Index of the byte-reflected powers of H (H^1 ... H^4) within h_mult_blocks. */
+        constexpr size_t ReflectedHashKeyIndex = 1;
+
+        template<typename T>
+        concept IsAesEncryptor = std::same_as<T, AesEncryptor128> || std::same_as<T, AesEncryptor192> || std::same_as<T, AesEncryptor256>;
+
+        constexpr u64 GetMultiplyFactor(u8 value) {
+            constexpr size_t Shift = BITSIZEOF(u8) - 1;
+            constexpr u8     Mask  = (1u << Shift);
+            return (value & Mask) >> Shift;
+        }
+
+        constexpr void GaloisShiftLeft(u64 *block) {
+            /* Shift the block left by one. */
+            block[1] <<= 1;
+            block[1] |= (block[0] & (static_cast<u64>(1) << (BITSIZEOF(u64) - 1))) >> (BITSIZEOF(u64) - 1);
+            block[0] <<= 1;
+        }
+
+        constexpr u8 GaloisShiftRight(u64 *block) {
+            /* Determine the mask to return. */
+            constexpr u8 GaloisFieldMask = 0xE1;
+            const u8 mask = (block[0] & 1) * GaloisFieldMask;
+
+            /* Shift the block right by one. */
+            block[0] >>= 1;
+            block[0] |= (block[1] & 1) << (BITSIZEOF(u64) - 1);
+            block[1] >>= 1;
+
+            /* Return the mask. */
+            return mask;
+        }
+
+        /* Multiply two 128-bit numbers X, Y in the GF(128) Galois Field. */
+        void GaloisFieldMult(void *dst, const void *x, const void *y) {
+            constexpr size_t FieldSize = 128;
+
+            /* Declare work blocks for us to store temporary values. */
+            u8 x_block[BlockSize];
+            u8 y_block[BlockSize];
+            u8 out[BlockSize];
+
+            /* Declare 64-bit pointers for our convenience. */
+            u64 *x_64   = static_cast<u64 *>(static_cast<void *>(x_block));
+            u64 *y_64   = static_cast<u64 *>(static_cast<void *>(y_block));
+            u64 *out_64 = static_cast<u64 *>(static_cast<void *>(out));
+
+            /* Initialize our work blocks. */
+            for (size_t i = 0; i < BlockSize; ++i) {
+                x_block[i] = static_cast<const u8 *>(x)[BlockSize - 1 - i];
+                y_block[i] = static_cast<const u8 *>(y)[BlockSize - 1 - i];
+                out[i]     = 0;
+            }
+
+            /* Perform multiplication on each bit in y. */
+            for (size_t i = 0; i < FieldSize; ++i) {
+                /* Get the multiply factor for this bit. */
+                const auto y_mult = GetMultiplyFactor(y_block[BlockSize - 1]);
+
+                /* Multiply x by the factor. */
+                out_64[0] ^= x_64[0] * y_mult;
+                out_64[1] ^= x_64[1] * y_mult;
+
+                /* Shift left y by one. */
+                GaloisShiftLeft(y_64);
+
+                /* Shift right x by one, and mask appropriately. */
+                const u8 x_mask = GaloisShiftRight(x_64);
+                x_block[BlockSize - 1] ^= x_mask;
+            }
+
+            /* Copy out our result. */
+            for (size_t i = 0; i < BlockSize; ++i) {
+                static_cast<u8 *>(dst)[i] = out[BlockSize - 1 - i];
+            }
+        }
+
+        AMS_CRYPTO_X64_TARGET_CLMUL ALWAYS_INLINE __m128i ReflectBytes(__m128i block) {
+            return _mm_shuffle_epi8(block, _mm_set_epi64x(0x0001020304050607ull, 0x08090A0B0C0D0E0Full));
+        }
+
+        AMS_CRYPTO_X64_TARGET_CLMUL ALWAYS_INLINE void MultiplyUnreduced(__m128i &lo, __m128i &hi, const __m128i a, const __m128i b) {
+            const __m128i t0 = _mm_clmulepi64_si128(a, b, 0x00);
+            const __m128i t1 = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
+            const __m128i t2 = _mm_clmulepi64_si128(a, b, 0x11);
+
+            lo = _mm_xor_si128(lo, _mm_xor_si128(t0, _mm_slli_si128(t1, 8)));
+            hi = _mm_xor_si128(hi, _mm_xor_si128(t2, _mm_srli_si128(t1, 8)));
+        }
+
+        AMS_CRYPTO_X64_TARGET_CLMUL ALWAYS_INLINE __m128i Reduce(__m128i lo, __m128i hi) {
+            /* Shift the 256-bit product left by one, to account for the reflected bit order. */
+            __m128i lo_carry = _mm_srli_epi32(lo, 31);
+            __m128i hi_carry = _mm_srli_epi32(hi, 31);
+            lo = _mm_slli_epi32(lo, 1);
+            hi = _mm_slli_epi32(hi, 1);
+
+            const __m128i cross = _mm_srli_si128(lo_carry, 12);
+            hi_carry = _mm_slli_si128(hi_carry, 4);
+            lo_carry = _mm_slli_si128(lo_carry, 4);
+            lo = _mm_or_si128(lo, lo_carry);
+            hi = _mm_or_si128(_mm_or_si128(hi, hi_carry), cross);
+
+            /* Reduce modulo x^128 + x^7 + x^2 + x + 1. */
+            __m128i t = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30)), _mm_slli_epi32(lo, 25));
+            const __m128i t_hi = _mm_srli_si128(t, 4);
+            lo = _mm_xor_si128(lo, _mm_slli_si128(t, 12));
+
+            __m128i u = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2)), _mm_srli_epi32(lo, 7));
+            u  = _mm_xor_si128(u, t_hi);
+            lo = _mm_xor_si128(lo, u);
+
+            return _mm_xor_si128(hi, lo);
+        }
+
+        AMS_CRYPTO_X64_TARGET_CLMUL void ComputeHashKeyPowersPclmul(void *dst, const void *h) {
+            __m128i *powers = static_cast<__m128i *>(dst);
+
+            const __m128i h1 = ReflectBytes(_mm_loadu_si128(static_cast<const __m128i *>(h)));
+            __m128i cur = h1;
+            for (size_t i = 0; i < GhashParallelBlocks; ++i) {
+                _mm_storeu_si128(powers + i, cur);
+
+                __m128i lo = _mm_setzero_si128(), hi = _mm_setzero_si128();
+                MultiplyUnreduced(lo, hi, cur, h1);
+                cur = Reduce(lo, hi);
+            }
+        }
+
+        AMS_CRYPTO_X64_TARGET_CLMUL void GhashBlocksPclmul(void *x, const u8 *data, size_t num_blocks, const void *h_powers) {
+            const __m128i *powers = static_cast<const __m128i *>(h_powers);
+            const __m128i h1 = _mm_loadu_si128(powers + 0);
+            const __m128i h2 = _mm_loadu_si128(powers + 1);
+            const __m128i h3 = _mm_loadu_si128(powers + 2);
+            const __m128i h4 = _mm_loadu_si128(powers + 3);
+
+            __m128i acc = ReflectBytes(_mm_loadu_si128(static_cast<const __m128i *>(x)));
+
+            /* Aggregate four blocks per reduction: X' = (X ^ D0)H^4 ^ D1H^3 ^ D2H^2 ^ D3H. */
+            while (num_blocks >= GhashParallelBlocks) {
+                const __m128i d0 = ReflectBytes(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0 * BlockSize)));
+                const __m128i d1 = ReflectBytes(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 1 * BlockSize)));
+                const __m128i d2 = ReflectBytes(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 2 * BlockSize)));
+                const __m128i d3 = ReflectBytes(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 3 * BlockSize)));
+
+                __m128i lo = _mm_setzero_si128(), hi = _mm_setzero_si128();
+                MultiplyUnreduced(lo, hi, _mm_xor_si128(acc, d0), h4);
+                MultiplyUnreduced(lo, hi, d1, h3);
+                MultiplyUnreduced(lo, hi, d2, h2);
+                MultiplyUnreduced(lo, hi, d3, h1);
+                acc = Reduce(lo, hi);
+
+                data       += GhashParallelBlocks * BlockSize;
+                num_blocks -= GhashParallelBlocks;
+            }
+
+            while (num_blocks > 0) {
+                const __m128i d = ReflectBytes(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)));
+
+                __m128i lo = _mm_setzero_si128(), hi = _mm_setzero_si128();
+                MultiplyUnreduced(lo, hi, _mm_xor_si128(acc, d), h1);
+                acc = Reduce(lo, hi);
+
+                data += BlockSize;
+                --num_blocks;
+            }
+
+            _mm_storeu_si128(static_cast<__m128i *>(x), ReflectBytes(acc));
+        }
+
+        void GhashBlocksSoftware(void *x, const u8 *data, size_t num_blocks, const void *h) {
+            u8 *x_8 = static_cast<u8 *>(x);
+            while (num_blocks > 0) {
+                for (size_t i = 0; i < BlockSize; ++i) {
+                    x_8[i] ^= data[i];
+                }
+                GaloisFieldMult(x, x, h);
+
+                data += BlockSize;
+                --num_blocks;
+            }
+        }
+
+        ALWAYS_INLINE void IncrementCounter(u32 *counter_block) {
+            util::StoreBigEndian(counter_block + 3, util::LoadBigEndian(counter_block + 3) + 1);
+        }
+
+        template<s32 RoundCount>
+        AMS_CRYPTO_X64_TARGET_AES void GenerateKeyStreamAesNi(u8 *dst, u32 *counter_block, size_t num_blocks, const u8 *round_keys) {
+            constexpr size_t ParallelBlocks = 8;
+
+            __m128i keys[RoundCount + 1];
+            x64::LoadRoundKeys<RoundCount>(keys, round_keys);
+
+            while (num_blocks > 0) {
+                const size_t cur_blocks = std::min(num_blocks, ParallelBlocks);
+
+                __m128i blocks[ParallelBlocks];
+                for (size_t i = 0; i < cur_blocks; ++i) {
+                    IncrementCounter(counter_block);
+                    blocks[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(counter_block));
+                }
+                for (size_t i = cur_blocks; i < ParallelBlocks; ++i) {
+                    blocks[i] = _mm_setzero_si128();
+                }
+
+                x64::EncryptBlocksAesNi<RoundCount, ParallelBlocks>(blocks, keys);
+
+                for (size_t i = 0; i < cur_blocks; ++i) {
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + BlockSize * i), blocks[i]);
+                }
+
+                dst        += BlockSize * cur_blocks;
+                num_blocks -= cur_blocks;
+            }
+        }
+
+    }
+
+    template<class BlockCipher>
+    void GcmModeImpl<BlockCipher>::Initialize(const BlockCipher *block_cipher) {
+        /* Set member variables. */
+        this->block_cipher = block_cipher;
+        this->cipher_func  = std::addressof(GcmModeImpl<BlockCipher>::ProcessBlock);
+
+        /* Pre-calculate values to speed up galois field multiplications later. */
+        this->InitializeHashKey();
+
+        /* Note that we're initialized. */
+        this->state = State_Initialized;
+    }
+
+    template<class BlockCipher>
+    void GcmModeImpl<BlockCipher>::Reset(const void *iv, size_t iv_size) {
+        /* Validate pre-conditions. */
+        AMS_ASSERT(this->state >= State_Initialized);
+
+        /* Reset blocks. */
+        this->block_x.block_128.Clear();
+        this->block_tmp.block_128.Clear();
+
+        /* Clear sizes. */
+        this->aad_size      = 0;
+        this->msg_size      = 0;
+        this->aad_remaining = 0;
+        this->msg_remaining = 0;
+
+        /* Update our state. */
+        this->state = State_ProcessingAad;
+
+        /* Set our iv. */
+        if (iv_size == 12) {
+            /* If our iv is the correct size, simply copy in the iv, and set the magic bit. */
+            std::memcpy(std::addressof(this->block_ek0), iv, iv_size);
+            util::StoreBigEndian(this->block_ek0.block_32 + 3, static_cast<u32>(1));
+        } else {
+            /* Clear our ek0 block. */
+            this->block_ek0.block_128.Clear();
+
+            /* Update using the iv as aad. */
+            this->UpdateAad(iv, iv_size);
+
+            /* Treat the iv as fake msg for the mac that will become our iv. */
+            this->msg_size = this->aad_size;
+            this->aad_size = 0;
+
+            /* Compute a non-final mac. */
+            this->ComputeMac(false);
+
+            /* Set our ek0 block to our calculated mac block. */
+            this->block_ek0 = this->block_x;
+
+            /* Clear our calculated mac block. */
+            this->block_x.block_128.Clear();
+
+            /* Reset our state. */
+            this->msg_size      = 0;
+            this->aad_size      = 0;
+            this->msg_remaining = 0;
+            this->aad_remaining = 0;
+        }
+
+        /* Set the working block to the iv. */
+        this->block_ek = this->block_ek0;
+    }
+
+    template<class BlockCipher>
+    void GcmModeImpl<BlockCipher>::UpdateAad(const void *aad, size_t aad_size) {
+        /* Validate pre-conditions. */
+        AMS_ASSERT(this->state    == State_ProcessingAad);
+        AMS_ASSERT(this->msg_size == 0);
+
+        /* Update our aad size. */
+        this->aad_size += aad_size;
+
+        /* Define a working tracker variable. */
+        const u8 *cur_aad = static_cast<const u8 *>(aad);
+
+        /* Process any leftover aad data from a previous invocation. */
+        if (this->aad_remaining > 0) {
+            while (aad_size > 0 && this->aad_remaining < BlockSize) {
+                this->block_x.block_8[this->aad_remaining++] ^= *(cur_aad++);
+                --aad_size;
+            }
+
+            /* If we have a complete block, process it and move onward. */
+            if (this->aad_remaining == BlockSize) {
+                this->GhashBlocks(nullptr, 0);
+                this->aad_remaining = 0;
+            }
+        }
+
+        /* Process as many blocks as we can. */
+        if (const size_t num_blocks = aad_size / BlockSize; num_blocks > 0) {
+            this->GhashBlocks(cur_aad, num_blocks);
+
+            cur_aad  += num_blocks * BlockSize;
+            aad_size -= num_blocks * BlockSize;
+        }
+
+        /* Update our state with whatever aad is left over. */
+        if (aad_size > 0) {
+            /* Note how much left over data we have. */
+            this->aad_remaining = static_cast<u32>(aad_size);
+
+            /* Xor the data in. */
+            for (size_t i = 0; i < aad_size; ++i) {
+                this->block_x.block_8[i] ^= *(cur_aad++);
+            }
+        }
+    }
+
+    template<class BlockCipher>
+    size_t GcmModeImpl<BlockCipher>::UpdateEncrypt(void *dst, size_t dst_size, const void *src, size_t src_size) {
+        AMS_ASSERT(dst_size >= src_size);
+        AMS_UNUSED(dst_size);
+
+        return this->UpdateMessage<true>(static_cast<u8 *>(dst), static_cast<const u8 *>(src), src_size);
+    }
+
+    template<class BlockCipher>
+    size_t GcmModeImpl<BlockCipher>::UpdateDecrypt(void *dst, size_t dst_size, const void *src, size_t src_size) {
+        AMS_ASSERT(dst_size >= src_size);
+        AMS_UNUSED(dst_size);
+
+        return this->UpdateMessage<false>(static_cast<u8 *>(dst), static_cast<const u8 *>(src), src_size);
+    }
+
+    template<class BlockCipher>
+    template<bool IsEncrypt>
+    size_t GcmModeImpl<BlockCipher>::UpdateMessage(u8 *dst, const u8 *src, size_t src_size) {
+        /* Validate pre-conditions. */
+        constexpr State TargetState = IsEncrypt ? State_Encrypting : State_Decrypting;
+        AMS_ASSERT(this->state == State_ProcessingAad || this->state == TargetState);
+
+        /* If we're transitioning from aad, finish any partial aad block. */
+        if (this->state == State_ProcessingAad) {
+            if (this->aad_remaining > 0) {
+                this->GhashBlocks(nullptr, 0);
+                this->aad_remaining = 0;
+            }
+            this->state = TargetState;
+        }
+
+        this->msg_size += src_size;
+
+        /* Process any leftover keystream from a previous invocation. */
+        size_t remaining = src_size;
+        if (this->msg_remaining > 0) {
+            while (remaining > 0 && this->msg_remaining < BlockSize) {
+                const u8 in  = *(src++);
+                const u8 out = in ^ this->block_tmp.block_8[this->msg_remaining];
+                *(dst++) = out;
+
+                this->block_x.block_8[this->msg_remaining++] ^= IsEncrypt ? out : in;
+                --remaining;
+            }
+
+            if (this->msg_remaining == BlockSize) {
+                this->GhashBlocks(nullptr, 0);
+                this->msg_remaining = 0;
+            }
+        }
+
+        /* Process as many blocks as we can. */
+        if (const size_t num_blocks = remaining / BlockSize; num_blocks > 0) {
+            const size_t size = num_blocks * BlockSize;
+
+            /* NOTE: When decrypting, hash the ciphertext before it can be overwritten by in-place operation. */
+            if constexpr (!IsEncrypt) {
+                this->GhashBlocks(src, num_blocks);
+            }
+
+            this->GenerateKeyStream(dst, num_blocks);
+            for (size_t i = 0; i < size; ++i) {
+                dst[i] ^= src[i];
+            }
+
+            if constexpr (IsEncrypt) {
+                this->GhashBlocks(dst, num_blocks);
+            }
+
+            src       += size;
+            dst       += size;
+            remaining -= size;
+        }
+
+        /* Handle any partial trailing block. */
+        if (remaining > 0) {
+            this->GenerateKeyStream(this->block_tmp.block_8, 1);
+
+            for (size_t i = 0; i < remaining; ++i) {
+                const u8 in  = src[i];
+                const u8 out = in ^ this->block_tmp.block_8[i];
+                dst[i] = out;
+
+                this->block_x.block_8[i] ^= IsEncrypt ? out : in;
+            }
+
+            this->msg_remaining = static_cast<u32>(remaining);
+        }
+
+        return src_size;
+    }
+
+    template<class BlockCipher>
+    void GcmModeImpl<BlockCipher>::GetMac(void *dst, size_t dst_size) {
+        /* Validate pre-conditions. */
+        AMS_ASSERT(State_ProcessingAad <= this->state && this->state <= State_Done);
+        AMS_ASSERT(dst != nullptr);
+        AMS_ASSERT(dst_size >= MacSize);
+        AMS_UNUSED(dst_size);
+
+        /* If we haven't already done so, compute the final mac. */
+        if (this->state != State_Done) {
+            this->ComputeMac(true);
+            this->state = State_Done;
+        }
+
+        static_assert(sizeof(this->block_x) == MacSize);
+        std::memcpy(dst, std::addressof(this->block_x), MacSize);
+    }
+
+    template<class BlockCipher>
+    void GcmModeImpl<BlockCipher>::InitializeHashKey() {
+        /* We want to encrypt an empty block to use for intermediate calculations. */
+        constexpr const Block EmptyBlock = {};
+
+        this->ProcessBlock(std::addressof(this->h_mult_blocks[0]), std::addressof(EmptyBlock), this->block_cipher);
+
+        /* If we can use carry-less multiplication, precompute reflected powers of H for aggregated reduction. */
+        static_assert(ReflectedHashKeyIndex + GhashParallelBlocks <= sizeof(this->h_mult_blocks) / sizeof(this->h_mult_blocks[0]));
+        if (x64::IsPclmulAvailable()) {
+            ComputeHashKeyPowersPclmul(std::addressof(this->h_mult_blocks[ReflectedHashKeyIndex]), std::addressof(this->h_mult_blocks[0]));
+        }
+    }
+
+    template<class BlockCipher>
+    void GcmModeImpl<BlockCipher>::GhashBlocks(const u8 *data, size_t num_blocks) {
+        /* NOTE: A null data pointer means "multiply the accumulator by H", which completes a partially xored block. */
+        constexpr const Block EmptyBlock = {};
+        if (data == nullptr) {
+            data       = EmptyBlock.block_8;
+            num_blocks = 1;
+        }
+
+        if (x64::IsPclmulAvailable()) {
+            GhashBlocksPclmul(std::addressof(this->block_x), data, num_blocks, std::addressof(this->h_mult_blocks[ReflectedHashKeyIndex]));
+        } else {
+            GhashBlocksSoftware(std::addressof(this->block_x), data, num_blocks, std::addressof(this->h_mult_blocks[0]));
+        }
+    }
+
+    template<class BlockCipher>
+    void GcmModeImpl<BlockCipher>::GenerateKeyStream(u8 *dst, size_t num_blocks) {
+        if constexpr (IsAesEncryptor<BlockCipher>) {
+            if (x64::IsAesNiAvailable()) {
+                GenerateKeyStreamAesNi<x64::GetAesRoundCount(BlockCipher::KeySize)>(dst, this->block_ek.block_32, num_blocks, this->block_cipher->GetRoundKey());
+                return;
+            }
+        }
+
+        while (num_blocks > 0) {
+            IncrementCounter(this->block_ek.block_32);
+            this->cipher_func(dst, std::addressof(this->block_ek), this->block_cipher);
+
+            dst += BlockSize;
+            --num_blocks;
+        }
+    }
+
+    template<class BlockCipher>
+    void GcmModeImpl<BlockCipher>::ComputeMac(bool encrypt) {
+        /* If we have leftover data, process it. */
+        if (this->aad_remaining > 0 || this->msg_remaining > 0) {
+            this->GhashBlocks(nullptr, 0);
+        }
+
+        /* Setup the last block, containing the bit lengths of the aad and message. */
+        Block last_block;
+        util::StoreBigEndian(reinterpret_cast<u64 *>(last_block.block_8 + 0), static_cast<u64>(this->aad_size) * BITSIZEOF(u8));
+        util::StoreBigEndian(reinterpret_cast<u64 *>(last_block.block_8 + 8), static_cast<u64>(this->msg_size) * BITSIZEOF(u8));
+
+        /* Hash the last block. */
+        this->GhashBlocks(last_block.block_8, 1);
+
+        /* If we need to do an encryption, do so. */
+        if (encrypt) {
+            /* Encrypt the iv. */
+            u8 enc_result[BlockSize];
+            this->ProcessBlock(enc_result, std::addressof(this->block_ek0), this->block_cipher);
+
+            /* Xor the iv in. */
+            for (size_t i = 0; i < BlockSize; ++i) {
+                this->block_x.block_8[i] ^= enc_result[i];
+            }
+        }
+    }
+
+    /* Explicitly instantiate the valid template classes. */
+    template class GcmModeImpl<AesEncryptor128>;
+
+}
+
+#else
+
+/* EL1+ implementations do not target x64. */
+
+#endif
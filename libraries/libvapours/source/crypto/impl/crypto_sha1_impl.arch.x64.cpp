@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vapours.hpp>
+
+#ifdef ATMOSPHERE_IS_STRATOSPHERE
+#include "crypto_x64_impl.hpp"
+
+namespace ams::crypto::impl {
+
+    namespace {
+
+        constexpr size_t BlockSize = Sha1Impl::BlockSize;
+
+        constexpr const u32 InitialHash[Sha1Impl::HashSize / sizeof(u32)] = {
+            0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0,
+        };
+
+        constexpr ALWAYS_INLINE u32 RotateLeft(u32 v, u32 n) {
+            return (v << n) | (v >> (BITSIZEOF(u32) - n));
+        }
+
+        void ProcessBlocksSoftware(u32 *hash, const u8 *data, size_t num_blocks) {
+            while (num_blocks--) {
+                u32 w[80];
+                for (size_t i = 0; i < 16; ++i) {
+                    w[i] = util::LoadBigEndian(reinterpret_cast<const u32 *>(data + sizeof(u32) * i));
+                }
+                for (size_t i = 16; i < 80; ++i) {
+                    w[i] = RotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+                }
+
+                u32 a = hash[0], b = hash[1], c = hash[2], d = hash[3], e = hash[4];
+                for (size_t i = 0; i < 80; ++i) {
+                    u32 f, k;
+                    if (i < 20) {
+                        f = (b & c) | (~b & d);
+                        k = 0x5A827999;
+                    } else if (i < 40) {
+                        f = b ^ c ^ d;
+                        k = 0x6ED9EBA1;
+                    } else if (i < 60) {
+                        f = (b & c) | (b & d) | (c & d);
+                        k = 0x8F1BBCDC;
+                    } else {
+                        f = b ^ c ^ d;
+                        k = 0xCA62C1D6;
+                    }
+
+                    const u32 tmp = RotateLeft(a, 5) + f + e + k + w[i];
+                    e = d;
+                    d = c;
+                    c = RotateLeft(b, 30);
+                    b = a;
+                    a = tmp;
+                }
+
+                hash[0] += a; hash[1] += b; hash[2] += c; hash[3] += d; hash[4] += e;
+
+                data += BlockSize;
+            }
+        }
+
+        template<size_t Group>
+        AMS_CRYPTO_X64_TARGET_SHA ALWAYS_INLINE void ProcessRoundGroupShaNi(__m128i &abcd, __m128i *e, __m128i *msgs, const u8 *data, const __m128i shuffle_mask) {
+            /* Each group performs four rounds; msgs[Group % 4] holds the schedule words for this group. */
+            /* The E values alternate between the two registers in e[] from group to group. */
+            __m128i &cur    = msgs[Group % 4];
+            __m128i &e_cur  = e[(Group + 0) % 2];
+            __m128i &e_next = e[(Group + 1) % 2];
+
+            if constexpr (Group < 4) {
+                cur = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x10 * Group)), shuffle_mask);
+            }
+
+            if constexpr (Group == 0) {
+                e_cur = _mm_add_epi32(e_cur, cur);
+            } else {
+                e_cur = _mm_sha1nexte_epu32(e_cur, cur);
+            }
+            e_next = abcd;
+
+            /* Finish computing the schedule words for the next group. */
+            if constexpr (3 <= Group && Group <= 18) {
+                msgs[(Group + 1) % 4] = _mm_sha1msg2_epu32(msgs[(Group + 1) % 4], cur);
+            }
+
+            abcd = _mm_sha1rnds4_epu32(abcd, e_cur, Group / 5);
+
+            /* Continue computing the schedule words for future groups. */
+            if constexpr (1 <= Group && Group <= 16) {
+                msgs[(Group + 3) % 4] = _mm_sha1msg1_epu32(msgs[(Group + 3) % 4], cur);
+            }
+            if constexpr (2 <= Group && Group <= 17) {
+                msgs[(Group + 2) % 4] = _mm_xor_si128(msgs[(Group + 2) % 4], cur);
+            }
+        }
+
+        template<size_t... Groups>
+        AMS_CRYPTO_X64_TARGET_SHA ALWAYS_INLINE void ProcessRoundGroupsShaNi(__m128i &abcd, __m128i *e, const u8 *data, const __m128i shuffle_mask, std::index_sequence<Groups...>) {
+            __m128i msgs[4];
+            (ProcessRoundGroupShaNi<Groups>(abcd, e, msgs, data, shuffle_mask), ...);
+        }
+
+        AMS_CRYPTO_X64_TARGET_SHA void ProcessBlocksShaNi(u32 *hash, const u8 *data, size_t num_blocks) {
+            const __m128i shuffle_mask = _mm_set_epi64x(0x0001020304050607ull, 0x08090A0B0C0D0E0Full);
+
+            __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hash)), 0x1B);
+            __m128i e[2] = { _mm_set_epi32(static_cast<s32>(hash[4]), 0, 0, 0), _mm_setzero_si128() };
+
+            while (num_blocks--) {
+                const __m128i saved_abcd = abcd;
+                const __m128i saved_e    = e[0];
+
+                ProcessRoundGroupsShaNi(abcd, e, data, shuffle_mask, std::make_index_sequence<20>());
+
+                /* NOTE: The final group (an odd group) leaves the pre-round abcd in e[0]. */
+                e[0] = _mm_sha1nexte_epu32(e[0], saved_e);
+                abcd = _mm_add_epi32(abcd, saved_abcd);
+
+                data += BlockSize;
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(hash), _mm_shuffle_epi32(abcd, 0x1B));
+            hash[4] = static_cast<u32>(_mm_extract_epi32(e[0], 3));
+        }
+
+        ALWAYS_INLINE void ProcessBlocks(u32 *hash, const u8 *data, size_t num_blocks) {
+            if (x64::IsShaNiAvailable()) {
+                ProcessBlocksShaNi(hash, data, num_blocks);
+            } else {
+                ProcessBlocksSoftware(hash, data, num_blocks);
+            }
+        }
+
+    }
+
+    void Sha1Impl::Initialize() {
+        std::memcpy(this->state.intermediate_hash, InitialHash, sizeof(this->state.intermediate_hash));
+        this->state.bits_consumed = 0;
+        this->state.num_buffered  = 0;
+        this->state.finalized     = false;
+    }
+
+    void Sha1Impl::Update(const void *data, size_t size) {
+        AMS_ASSERT(!this->state.finalized);
+
+        const u8 *cur = static_cast<const u8 *>(data);
+        this->state.bits_consumed += BITSIZEOF(u8) * size;
+
+        /* Complete any partially buffered block. */
+        if (this->state.num_buffered > 0) {
+            const size_t partial = std::min(BlockSize - this->state.num_buffered, size);
+            std::memcpy(this->state.buffer + this->state.num_buffered, cur, partial);
+
+            this->state.num_buffered += partial;
+            cur  += partial;
+            size -= partial;
+
+            if (this->state.num_buffered == BlockSize) {
+                ProcessBlocks(this->state.intermediate_hash, this->state.buffer, 1);
+                this->state.num_buffered = 0;
+            }
+        }
+
+        /* Process as many whole blocks as we can directly from the input. */
+        if (size >= BlockSize) {
+            const size_t num_blocks = size / BlockSize;
+            ProcessBlocks(this->state.intermediate_hash, cur, num_blocks);
+
+            cur  += num_blocks * BlockSize;
+            size -= num_blocks * BlockSize;
+        }
+
+        /* Buffer whatever is left over. */
+        if (size > 0) {
+            std::memcpy(this->state.buffer, cur, size);
+            this->state.num_buffered = size;
+        }
+    }
+
+    void Sha1Impl::GetHash(void *dst, size_t size) {
+        AMS_ASSERT(size >= HashSize);
+        AMS_UNUSED(size);
+
+        if (!this->state.finalized) {
+            /* Append the terminator bit. */
+            this->state.buffer[this->state.num_buffered++] = 0x80;
+
+            /* If there's no room for the length, process the block and start a new one. */
+            if (this->state.num_buffered > BlockSize - sizeof(u64)) {
+                std::memset(this->state.buffer + this->state.num_buffered, 0, BlockSize - this->state.num_buffered);
+                ProcessBlocks(this->state.intermediate_hash, this->state.buffer, 1);
+                this->state.num_buffered = 0;
+            }
+
+            /* Pad, append the length, and process the final block. */
+            std::memset(this->state.buffer + this->state.num_buffered, 0, BlockSize - sizeof(u64) - this->state.num_buffered);
+            util::StoreBigEndian(reinterpret_cast<u64 *>(this->state.buffer + BlockSize - sizeof(u64)), this->state.bits_consumed);
+            ProcessBlocks(this->state.intermediate_hash, this->state.buffer, 1);
+
+            this->state.num_buffered = 0;
+            this->state.finalized    = true;
+        }
+
+        for (size_t i = 0; i < util::size(this->state.intermediate_hash); ++i) {
+            util::StoreBigEndian(static_cast<u32 *>(dst) + i, this->state.intermediate_hash[i]);
+        }
+    }
+
+}
+
+#else
+
+    /* TODO: Non-EL0 implementation. */
+
+#endif
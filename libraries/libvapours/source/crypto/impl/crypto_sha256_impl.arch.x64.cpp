@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vapours.hpp>
+
+#ifdef ATMOSPHERE_IS_STRATOSPHERE
+#include "crypto_x64_impl.hpp"
+
+namespace ams::crypto::impl {
+
+    namespace {
+
+        constexpr size_t BlockSize = Sha256Impl::BlockSize;
+
+        constexpr const u32 InitialHash[Sha256Impl::HashSize / sizeof(u32)] = {
+            0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19,
+        };
+
+        alignas(0x10) constexpr const u32 RoundConstants[64] = {
+            0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+            0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+            0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+            0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+            0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+            0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+            0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+            0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
+        };
+
+        constexpr ALWAYS_INLINE u32 RotateRight(u32 v, u32 n) {
+            return (v >> n) | (v << (BITSIZEOF(u32) - n));
+        }
+
+        void ProcessBlocksSoftware(u32 *hash, const u8 *data, size_t num_blocks) {
+            while (num_blocks--) {
+                u32 w[64];
+                for (size_t i = 0; i < 16; ++i) {
+                    w[i] = util::LoadBigEndian(reinterpret_cast<const u32 *>(data + sizeof(u32) * i));
+                }
+                for (size_t i = 16; i < 64; ++i) {
+                    const u32 s0 = RotateRight(w[i - 15],  7) ^ RotateRight(w[i - 15], 18) ^ (w[i - 15] >>  3);
+                    const u32 s1 = RotateRight(w[i -  2], 17) ^ RotateRight(w[i -  2], 19) ^ (w[i -  2] >> 10);
+                    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+                }
+
+                u32 a = hash[0], b = hash[1], c = hash[2], d = hash[3], e = hash[4], f = hash[5], g = hash[6], h = hash[7];
+                for (size_t i = 0; i < 64; ++i) {
+                    const u32 s1  = RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25);
+                    const u32 ch  = (e & f) ^ (~e & g);
+                    const u32 t1  = h + s1 + ch + RoundConstants[i] + w[i];
+                    const u32 s0  = RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22);
+                    const u32 maj = (a & b) ^ (a & c) ^ (b & c);
+                    const u32 t2  = s0 + maj;
+
+                    h = g;
+                    g = f;
+                    f = e;
+                    e = d + t1;
+                    d = c;
+                    c = b;
+                    b = a;
+                    a = t1 + t2;
+                }
+
+                hash[0] += a; hash[1] += b; hash[2] += c; hash[3] += d;
+                hash[4] += e; hash[5] += f; hash[6] += g; hash[7] += h;
+
+                data += BlockSize;
+            }
+        }
+
+        template<size_t Group>
+        AMS_CRYPTO_X64_TARGET_SHA ALWAYS_INLINE void ProcessRoundGroupShaNi(__m128i &state0, __m128i &state1, __m128i *msgs, const u8 *data, const __m128i shuffle_mask) {
+            /* Each group performs four rounds; msgs[Group % 4] holds the schedule words for this group. */
+            __m128i &cur = msgs[(Group + 0) % 4];
+            if constexpr (Group < 4) {
+                cur = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x10 * Group)), shuffle_mask);
+            }
+
+            __m128i msg = _mm_add_epi32(cur, _mm_load_si128(reinterpret_cast<const __m128i *>(RoundConstants + 4 * Group)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+
+            /* Finish computing the schedule words for the next group. */
+            if constexpr (3 <= Group && Group <= 14) {
+                __m128i &next = msgs[(Group + 1) % 4];
+                next = _mm_add_epi32(next, _mm_alignr_epi8(cur, msgs[(Group + 3) % 4], 4));
+                next = _mm_sha256msg2_epu32(next, cur);
+            }
+
+            msg    = _mm_shuffle_epi32(msg, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+
+            /* Begin computing the schedule words for three groups from now. */
+            if constexpr (1 <= Group && Group <= 12) {
+                __m128i &prev = msgs[(Group + 3) % 4];
+                prev = _mm_sha256msg1_epu32(prev, cur);
+            }
+        }
+
+        template<size_t... Groups>
+        AMS_CRYPTO_X64_TARGET_SHA ALWAYS_INLINE void ProcessRoundGroupsShaNi(__m128i &state0, __m128i &state1, const u8 *data, const __m128i shuffle_mask, std::index_sequence<Groups...>) {
+            __m128i msgs[4];
+            (ProcessRoundGroupShaNi<Groups>(state0, state1, msgs, data, shuffle_mask), ...);
+        }
+
+        AMS_CRYPTO_X64_TARGET_SHA void ProcessBlocksShaNi(u32 *hash, const u8 *data, size_t num_blocks) {
+            const __m128i shuffle_mask = _mm_set_epi64x(0x0C0D0E0F08090A0Bull, 0x0405060700010203ull);
+
+            /* Load the state, and rearrange into the ABEF/CDGH layout expected by sha256rnds2. */
+            __m128i tmp    = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hash + 0)), 0xB1);
+            __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(hash + 4)), 0x1B);
+            __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+                    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+            while (num_blocks--) {
+                const __m128i saved0 = state0;
+                const __m128i saved1 = state1;
+
+                ProcessRoundGroupsShaNi(state0, state1, data, shuffle_mask, std::make_index_sequence<16>());
+
+                state0 = _mm_add_epi32(state0, saved0);
+                state1 = _mm_add_epi32(state1, saved1);
+
+                data += BlockSize;
+            }
+
+            /* Restore the state to its canonical layout. */
+            tmp    = _mm_shuffle_epi32(state0, 0x1B);
+            state1 = _mm_shuffle_epi32(state1, 0xB1);
+            state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+            state1 = _mm_alignr_epi8(state1, tmp, 8);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(hash + 0), state0);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(hash + 4), state1);
+        }
+
+        ALWAYS_INLINE void ProcessBlocks(u32 *hash, const u8 *data, size_t num_blocks) {
+            if (x64::IsShaNiAvailable()) {
+                ProcessBlocksShaNi(hash, data, num_blocks);
+            } else {
+                ProcessBlocksSoftware(hash, data, num_blocks);
+            }
+        }
+
+    }
+
+    void Sha256Impl::Initialize() {
+        std::memcpy(this->state.intermediate_hash, InitialHash, sizeof(this->state.intermediate_hash));
+        this->state.bits_consumed = 0;
+        this->state.num_buffered  = 0;
+        this->state.finalized     = false;
+    }
+
+    void Sha256Impl::Update(const void *data, size_t size) {
+        AMS_ASSERT(!this->state.finalized);
+
+        const u8 *cur = static_cast<const u8 *>(data);
+        this->state.bits_consumed += BITSIZEOF(u8) * size;
+
+        /* Complete any partially buffered block. */
+        if (this->state.num_buffered > 0) {
+            const size_t partial = std::min(BlockSize - this->state.num_buffered, size);
+            std::memcpy(this->state.buffer + this->state.num_buffered, cur, partial);
+
+            this->state.num_buffered += partial;
+            cur  += partial;
+            size -= partial;
+
+            if (this->state.num_buffered == BlockSize) {
+                ProcessBlocks(this->state.intermediate_hash, this->state.buffer, 1);
+                this->state.num_buffered = 0;
+            }
+        }
+
+        /* Process as many whole blocks as we can directly from the input. */
+        if (size >= BlockSize) {
+            const size_t num_blocks = size / BlockSize;
+            ProcessBlocks(this->state.intermediate_hash, cur, num_blocks);
+
+            cur  += num_blocks * BlockSize;
+            size -= num_blocks * BlockSize;
+        }
+
+        /* Buffer whatever is left over. */
+        if (size > 0) {
+            std::memcpy(this->state.buffer, cur, size);
+            this->state.num_buffered = size;
+        }
+    }
+
+    void Sha256Impl::GetHash(void *dst, size_t size) {
+        AMS_ASSERT(size >= HashSize);
+        AMS_UNUSED(size);
+
+        if (!this->state.finalized) {
+            /* Append the terminator bit. */
+            this->state.buffer[this->state.num_buffered++] = 0x80;
+
+            /* If there's no room for the length, process the block and start a new one. */
+            if (this->state.num_buffered > BlockSize - sizeof(u64)) {
+                std::memset(this->state.buffer + this->state.num_buffered, 0, BlockSize - this->state.num_buffered);
+                ProcessBlocks(this->state.intermediate_hash, this->state.buffer, 1);
+                this->state.num_buffered = 0;
+            }
+
+            /* Pad, append the length, and process the final block. */
+            std::memset(this->state.buffer + this->state.num_buffered, 0, BlockSize - sizeof(u64) - this->state.num_buffered);
+            util::StoreBigEndian(reinterpret_cast<u64 *>(this->state.buffer + BlockSize - sizeof(u64)), this->state.bits_consumed);
+            ProcessBlocks(this->state.intermediate_hash, this->state.buffer, 1);
+
+            this->state.num_buffered = 0;
+            this->state.finalized    = true;
+        }
+
+        for (size_t i = 0; i < util::size(this->state.intermediate_hash); ++i) {
+            util::StoreBigEndian(static_cast<u32 *>(dst) + i, this->state.intermediate_hash[i]);
+        }
+    }
+
+    void Sha256Impl::InitializeWithContext(const Sha256Context *context) {
+        /* Copy state in from the context. */
+        std::memcpy(this->state.intermediate_hash, context->intermediate_hash, sizeof(this->state.intermediate_hash));
+        this->state.bits_consumed = context->bits_consumed;
+
+        /* Clear the rest of state. */
+        std::memset(this->state.buffer, 0, sizeof(this->state.buffer));
+        this->state.num_buffered = 0;
+        this->state.finalized = false;
+    }
+
+    size_t Sha256Impl::GetContext(Sha256Context *context) const {
+        std::memcpy(context->intermediate_hash, this->state.intermediate_hash, sizeof(context->intermediate_hash));
+        context->bits_consumed = this->state.bits_consumed;
+
+        return this->state.num_buffered;
+    }
+
+}
+
+#else
+
+    /* TODO: Non-EL0 implementation. */
+
+#endif
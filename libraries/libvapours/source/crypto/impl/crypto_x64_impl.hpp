@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <vapours.hpp>
+#include <immintrin.h>
+
+/* NOTE: Instruction set extensions are enabled per-function, so that the library can be built for a baseline */
+/* x86-64 target and still select accelerated implementations at runtime based on CPUID. */
+#define AMS_CRYPTO_X64_TARGET_AES    __attribute__((target("aes,sse4.1")))
+#define AMS_CRYPTO_X64_TARGET_VAES   __attribute__((target("aes,sse4.1,avx2,vaes")))
+#define AMS_CRYPTO_X64_TARGET_CLMUL  __attribute__((target("aes,sse4.1,pclmul,ssse3")))
+#define AMS_CRYPTO_X64_TARGET_SHA    __attribute__((target("sha,sse4.1,ssse3")))
+
+namespace ams::crypto::impl::x64 {
+
+    enum CpuFeature : u32 {
+        CpuFeature_Aes    = (1u << 0),
+        CpuFeature_Vaes   = (1u << 1),
+        CpuFeature_Pclmul = (1u << 2),
+        CpuFeature_Sha    = (1u << 3),
+
+        CpuFeature_Detected = (1u << 31),
+    };
+
+    inline u32 DetectCpuFeatures() {
+        __builtin_cpu_init();
+
+        const bool has_sse41 = __builtin_cpu_supports("sse4.1");
+        const bool has_ssse3 = __builtin_cpu_supports("ssse3");
+        const bool has_aes   = has_sse41 && __builtin_cpu_supports("aes");
+
+        u32 features = CpuFeature_Detected;
+        if (has_aes) {
+            features |= CpuFeature_Aes;
+        }
+        if (has_aes && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("vaes")) {
+            features |= CpuFeature_Vaes;
+        }
+        if (has_aes && has_ssse3 && __builtin_cpu_supports("pclmul")) {
+            features |= CpuFeature_Pclmul;
+        }
+        if (has_sse41 && has_ssse3 && __builtin_cpu_supports("sha")) {
+            features |= CpuFeature_Sha;
+        }
+        return features;
+    }
+
+    /* NOTE: Zero means the features haven't been detected yet. */
+    inline constinit std::atomic<u32> g_cpu_features = 0;
+
+    ALWAYS_INLINE u32 GetCpuFeatures() {
+        u32 features = g_cpu_features.load(std::memory_order_acquire);
+        if (AMS_UNLIKELY(features == 0)) {
+            /* Only publish what we detected if nobody has beaten us to it, so that an explicit setting always wins. */
+            const u32 detected = DetectCpuFeatures();
+            if (g_cpu_features.compare_exchange_strong(features, detected, std::memory_order_acq_rel)) {
+                features = detected;
+            }
+        }
+        return features;
+    }
+
+    /* Selects between the accelerated and the portable implementations; intended for host tooling which compares the two. */
+    /* NOTE: Contexts initialized before this is changed must not be used afterwards. */
+    inline void SetHardwareAccelerationEnabled(bool enabled) {
+        g_cpu_features.store(enabled ? DetectCpuFeatures() : static_cast<u32>(CpuFeature_Detected), std::memory_order_release);
+    }
+
+    ALWAYS_INLINE bool IsAesNiAvailable()    { return (GetCpuFeatures() & CpuFeature_Aes)    != 0; }
+    ALWAYS_INLINE bool IsVaesAvailable()     { return (GetCpuFeatures() & CpuFeature_Vaes)   != 0; }
+    ALWAYS_INLINE bool IsPclmulAvailable()   { return (GetCpuFeatures() & CpuFeature_Pclmul) != 0; }
+    ALWAYS_INLINE bool IsShaNiAvailable()    { return (GetCpuFeatures() & CpuFeature_Sha)    != 0; }
+
+    /* AES-NI helpers. */
+    /* NOTE: Round keys are stored in FIPS-197 byte order. Decryption round keys are stored for the equivalent */
+    /* inverse cipher (reversed, with InvMixColumns applied to the inner rounds), which is what aesdec expects. */
+    template<s32 RoundCount>
+    AMS_CRYPTO_X64_TARGET_AES ALWAYS_INLINE void LoadRoundKeys(__m128i *dst, const u8 *round_keys) {
+        for (s32 i = 0; i <= RoundCount; ++i) {
+            dst[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(round_keys + 0x10 * i));
+        }
+    }
+
+    template<s32 RoundCount, size_t NumBlocks>
+    AMS_CRYPTO_X64_TARGET_AES ALWAYS_INLINE void EncryptBlocksAesNi(__m128i *blocks, const __m128i *keys) {
+        for (size_t i = 0; i < NumBlocks; ++i) {
+            blocks[i] = _mm_xor_si128(blocks[i], keys[0]);
+        }
+        for (s32 r = 1; r < RoundCount; ++r) {
+            for (size_t i = 0; i < NumBlocks; ++i) {
+                blocks[i] = _mm_aesenc_si128(blocks[i], keys[r]);
+            }
+        }
+        for (size_t i = 0; i < NumBlocks; ++i) {
+            blocks[i] = _mm_aesenclast_si128(blocks[i], keys[RoundCount]);
+        }
+    }
+
+    template<s32 RoundCount, size_t NumBlocks>
+    AMS_CRYPTO_X64_TARGET_AES ALWAYS_INLINE void DecryptBlocksAesNi(__m128i *blocks, const __m128i *keys) {
+        for (size_t i = 0; i < NumBlocks; ++i) {
+            blocks[i] = _mm_xor_si128(blocks[i], keys[0]);
+        }
+        for (s32 r = 1; r < RoundCount; ++r) {
+            for (size_t i = 0; i < NumBlocks; ++i) {
+                blocks[i] = _mm_aesdec_si128(blocks[i], keys[r]);
+            }
+        }
+        for (size_t i = 0; i < NumBlocks; ++i) {
+            blocks[i] = _mm_aesdeclast_si128(blocks[i], keys[RoundCount]);
+        }
+    }
+
+    template<s32 RoundCount>
+    AMS_CRYPTO_X64_TARGET_AES ALWAYS_INLINE __m128i EncryptBlockAesNi(__m128i block, const __m128i *keys) {
+        EncryptBlocksAesNi<RoundCount, 1>(std::addressof(block), keys);
+        return block;
+    }
+
+    template<s32 RoundCount>
+    AMS_CRYPTO_X64_TARGET_AES ALWAYS_INLINE __m128i DecryptBlockAesNi(__m128i block, const __m128i *keys) {
+        DecryptBlocksAesNi<RoundCount, 1>(std::addressof(block), keys);
+        return block;
+    }
+
+    constexpr ALWAYS_INLINE s32 GetAesRoundCount(size_t key_size) {
+        return static_cast<s32>(key_size / 4) + 6;
+    }
+
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vapours.hpp>
+#include "crypto_update_impl.hpp"
+
+#ifdef ATMOSPHERE_IS_STRATOSPHERE
+#include "crypto_x64_impl.hpp"
+
+namespace ams::crypto::impl {
+
+    namespace {
+
+        /* Number of blocks kept in flight, to hide aesenc/aesdec latency. */
+        constexpr size_t ParallelBlocks = 8;
+
+        /* TODO: Support non-Nintendo Endianness */
+
+        AMS_CRYPTO_X64_TARGET_AES ALWAYS_INLINE __m128i MultiplyTweak(const __m128i tweak) {
+            /* Broadcast the carry out of each 64-bit half into the position it must be folded into. */
+            const __m128i carry = _mm_and_si128(_mm_shuffle_epi32(_mm_srai_epi32(tweak, 31), 0x13), _mm_set_epi32(0, 1, 0, 0x87));
+
+            return _mm_xor_si128(_mm_add_epi64(tweak, tweak), carry);
+        }
+
+        template<s32 RoundCount, bool IsEncrypt>
+        AMS_CRYPTO_X64_TARGET_AES void ProcessBlocksAesNi(u8 *dst, const u8 *src, size_t num_blocks, u8 *tweak_storage, const u8 *round_keys) {
+            __m128i keys[RoundCount + 1];
+            x64::LoadRoundKeys<RoundCount>(keys, round_keys);
+
+            __m128i tweak = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tweak_storage));
+
+            while (num_blocks >= ParallelBlocks) {
+                __m128i tweaks[ParallelBlocks];
+                __m128i blocks[ParallelBlocks];
+                for (size_t i = 0; i < ParallelBlocks; ++i) {
+                    tweaks[i] = tweak;
+                    blocks[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + XtsModeImpl::BlockSize * i)), tweak);
+                    tweak     = MultiplyTweak(tweak);
+                }
+
+                if constexpr (IsEncrypt) {
+                    x64::EncryptBlocksAesNi<RoundCount, ParallelBlocks>(blocks, keys);
+                } else {
+                    x64::DecryptBlocksAesNi<RoundCount, ParallelBlocks>(blocks, keys);
+                }
+
+                for (size_t i = 0; i < ParallelBlocks; ++i) {
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + XtsModeImpl::BlockSize * i), _mm_xor_si128(blocks[i], tweaks[i]));
+                }
+
+                src        += XtsModeImpl::BlockSize * ParallelBlocks;
+                dst        += XtsModeImpl::BlockSize * ParallelBlocks;
+                num_blocks -= ParallelBlocks;
+            }
+
+            while (num_blocks > 0) {
+                __m128i block = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)), tweak);
+
+                if constexpr (IsEncrypt) {
+                    block = x64::EncryptBlockAesNi<RoundCount>(block, keys);
+                } else {
+                    block = x64::DecryptBlockAesNi<RoundCount>(block, keys);
+                }
+
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_xor_si128(block, tweak));
+                tweak = MultiplyTweak(tweak);
+
+                src += XtsModeImpl::BlockSize;
+                dst += XtsModeImpl::BlockSize;
+                --num_blocks;
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(tweak_storage), tweak);
+        }
+
+    }
+
+    size_t XtsModeImpl::UpdateGeneric(void *dst, size_t dst_size, const void *src, size_t src_size) {
+        AMS_ASSERT(this->state == State_Initialized || this->state == State_Processing);
+
+        return UpdateImpl<void>(this, dst, dst_size, src, src_size);
+    }
+
+    size_t XtsModeImpl::ProcessBlocksGeneric(u8 *dst, const u8 *src, size_t num_blocks) {
+        size_t processed = BlockSize * (num_blocks - 1);
+
+        if (this->state == State_Processing) {
+            this->ProcessBlock(dst, this->last_block);
+            dst       += BlockSize;
+            processed += BlockSize;
+        }
+
+        while ((--num_blocks) > 0) {
+            this->ProcessBlock(dst, src);
+            dst += BlockSize;
+            src += BlockSize;
+        }
+
+        std::memcpy(this->last_block, src, BlockSize);
+
+        this->state = State_Processing;
+
+        return processed;
+    }
+
+    template<> size_t XtsModeImpl::Update<AesEncryptor128>(void *dst, size_t dst_size, const void *src, size_t src_size) { return UpdateImpl<AesEncryptor128>(this, dst, dst_size, src, src_size); }
+    template<> size_t XtsModeImpl::Update<AesEncryptor192>(void *dst, size_t dst_size, const void *src, size_t src_size) { return UpdateImpl<AesEncryptor192>(this, dst, dst_size, src, src_size); }
+    template<> size_t XtsModeImpl::Update<AesEncryptor256>(void *dst, size_t dst_size, const void *src, size_t src_size) { return UpdateImpl<AesEncryptor256>(this, dst, dst_size, src, src_size); }
+
+    template<> size_t XtsModeImpl::Update<AesDecryptor128>(void *dst, size_t dst_size, const void *src, size_t src_size) { return UpdateImpl<AesDecryptor128>(this, dst, dst_size, src, src_size); }
+    template<> size_t XtsModeImpl::Update<AesDecryptor192>(void *dst, size_t dst_size, const void *src, size_t src_size) { return UpdateImpl<AesDecryptor192>(this, dst, dst_size, src, src_size); }
+    template<> size_t XtsModeImpl::Update<AesDecryptor256>(void *dst, size_t dst_size, const void *src, size_t src_size) { return UpdateImpl<AesDecryptor256>(this, dst, dst_size, src, src_size); }
+
+    #define AMS_CRYPTO_DEFINE_XTS_PROCESS_BLOCKS(_CIPHER_, _IS_ENCRYPT_)                                                                       \
+    template<>                                                                                                                                 \
+    size_t XtsModeImpl::ProcessBlocks<_CIPHER_>(u8 *dst, const u8 *src, size_t num_blocks) {                                                   \
+        /* If we can't accelerate, use the generic implementation. */                                                                          \
+        if (!x64::IsAesNiAvailable()) {                                                                                                        \
+            return this->ProcessBlocksGeneric(dst, src, num_blocks);                                                                           \
+        }                                                                                                                                      \
+                                                                                                                                               \
+        /* Handle last buffered block. */                                                                                                      \
+        size_t processed = (num_blocks - 1) * BlockSize;                                                                                       \
+                                                                                                                                               \
+        if (this->state == State_Processing) {                                                                                                 \
+            this->ProcessBlock(dst, this->last_block);                                                                                         \
+            dst += BlockSize;                                                                                                                  \
+            processed += BlockSize;                                                                                                            \
+        }                                                                                                                                      \
+                                                                                                                                               \
+        /* Process all but the final block, which is held back for ciphertext stealing. */                                                     \
+        const u8 *round_keys = static_cast<const _CIPHER_ *>(this->cipher_ctx)->GetRoundKey();                                                 \
+        ProcessBlocksAesNi<x64::GetAesRoundCount(_CIPHER_::KeySize), _IS_ENCRYPT_>(dst, src, num_blocks - 1, this->tweak, round_keys);         \
+        src += (num_blocks - 1) * BlockSize;                                                                                                   \
+                                                                                                                                               \
+        std::memcpy(this->last_block, src, BlockSize);                                                                                         \
+        this->state = State_Processing;                                                                                                        \
+                                                                                                                                               \
+        return processed;                                                                                                                      \
+    }
+
+    AMS_CRYPTO_DEFINE_XTS_PROCESS_BLOCKS(AesEncryptor128, true)
+    AMS_CRYPTO_DEFINE_XTS_PROCESS_BLOCKS(AesEncryptor192, true)
+    AMS_CRYPTO_DEFINE_XTS_PROCESS_BLOCKS(AesEncryptor256, true)
+
+    AMS_CRYPTO_DEFINE_XTS_PROCESS_BLOCKS(AesDecryptor128, false)
+    AMS_CRYPTO_DEFINE_XTS_PROCESS_BLOCKS(AesDecryptor192, false)
+    AMS_CRYPTO_DEFINE_XTS_PROCESS_BLOCKS(AesDecryptor256, false)
+
+    #undef AMS_CRYPTO_DEFINE_XTS_PROCESS_BLOCKS
+
+}
+
+#else
+
+/* TODO: Non-EL0 implementation. */
+namespace ams::crypto::impl {
+
+}
+
+#endif
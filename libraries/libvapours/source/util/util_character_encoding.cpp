@@ -39,7 +39,7 @@ namespace ams::util {
             4, 4, 4, 4, 4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 7, 8,
         };
 
-        constexpr inline const char * const Utf8NBytesTable = static_cast<const char *>(static_cast<const void *>(Utf8NBytesInnerTable + 1));
+        constexpr inline const int8_t * const Utf8NBytesTable = Utf8NBytesInnerTable + 1;
 
     }
 
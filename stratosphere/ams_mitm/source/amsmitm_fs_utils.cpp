@@ -77,6 +77,12 @@ namespace ams::mitm::fs {
         return DeleteSdFile(fixed_path);
     }
 
+    Result DeleteAtmosphereSdFile(ncm::ProgramId program_id, const char *path) {
+        char fixed_path[ams::fs::EntryNameLengthMax + 1];
+        FormatAtmosphereSdPath(fixed_path, sizeof(fixed_path), program_id, path);
+        return DeleteSdFile(fixed_path);
+    }
+
     Result CreateAtmosphereSdFile(const char *path, s64 size, s32 option) {
         char fixed_path[ams::fs::EntryNameLengthMax + 1];
         FormatAtmosphereSdPath(fixed_path, sizeof(fixed_path), path);
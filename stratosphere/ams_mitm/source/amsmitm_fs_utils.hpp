@@ -23,6 +23,7 @@ namespace ams::mitm::fs {
 
     /* Utilities. */
     Result DeleteAtmosphereSdFile(const char *path);
+    Result DeleteAtmosphereSdFile(ncm::ProgramId program_id, const char *path);
     Result CreateSdFile(const char *path, s64 size, s32 option);
     Result CreateAtmosphereSdFile(const char *path, s64 size, s32 option);
     Result OpenSdFile(FsFile *out, const char *path, u32 mode);
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "dnsmitm_answer_cache.hpp"
+
+namespace ams::mitm::socket::resolver {
+
+    namespace {
+
+        constexpr size_t MaxEntries       = 256;
+        constexpr size_t MaxTotalDataSize = 128_KB;
+        constexpr size_t MaxEntryDataSize = 16_KB;
+
+        /* sfdnsres does not report record TTLs, so answers live for the configured maximum TTL. */
+        /* Failed lookups are retried sooner, as they are often transient (e.g. the network was not yet up). */
+        constexpr TimeSpan NegativeTtlMax = TimeSpan::FromSeconds(10);
+
+        struct CacheEntry : public util::IntrusiveListBaseNode<CacheEntry> {
+            std::string key;
+            std::unique_ptr<u8[]> data;
+            Answer answer;
+            os::Tick expiration_tick;
+            bool negative;
+        };
+
+        using CacheEntryList = util::IntrusiveListBaseTraits<CacheEntry>::ListType;
+
+        constinit os::SdkMutex g_cache_lock;
+        constinit TimeSpan g_positive_ttl = TimeSpan::FromSeconds(0);
+        constinit TimeSpan g_negative_ttl = TimeSpan::FromSeconds(0);
+
+        /* The list is ordered from most to least recently used. */
+        std::unordered_map<std::string_view, std::unique_ptr<CacheEntry>> g_cache_map;
+        CacheEntryList g_cache_lru_list;
+        constinit size_t g_cache_data_size = 0;
+
+        constinit AnswerCacheStatistics g_statistics = {};
+
+        void RemoveEntry(CacheEntry *entry) {
+            /* NOTE: This must be called with g_cache_lock held. */
+            g_cache_lru_list.erase(g_cache_lru_list.iterator_to(*entry));
+            g_cache_data_size -= entry->answer.size;
+
+            /* Erasing from the map frees the entry. */
+            g_cache_map.erase(g_cache_map.find(entry->key));
+        }
+
+        void RemoveLeastRecentlyUsedEntry() {
+            /* NOTE: This must be called with g_cache_lock held. */
+            CacheEntry *entry = std::addressof(g_cache_lru_list.back());
+
+            /* Prefer to count an expired entry as expired rather than evicted. */
+            if (entry->expiration_tick <= os::GetSystemTick()) {
+                ++g_statistics.expirations;
+            } else {
+                ++g_statistics.evictions;
+            }
+
+            RemoveEntry(entry);
+        }
+
+    }
+
+    void InitializeAnswerCache(TimeSpan max_ttl) {
+        std::scoped_lock lk(g_cache_lock);
+
+        g_positive_ttl = max_ttl;
+        g_negative_ttl = std::min(max_ttl, NegativeTtlMax);
+    }
+
+    bool GetCachedAnswer(Answer *out, void *dst, size_t dst_size, const AnswerCacheKey &key, bool *out_negative) {
+        std::scoped_lock lk(g_cache_lock);
+
+        /* Find the entry. */
+        const auto it = g_cache_map.find(key.Get());
+        if (it == g_cache_map.end()) {
+            ++g_statistics.misses;
+            return false;
+        }
+
+        CacheEntry *entry = it->second.get();
+
+        /* If the entry has expired, drop it. */
+        if (entry->expiration_tick <= os::GetSystemTick()) {
+            ++g_statistics.expirations;
+            ++g_statistics.misses;
+            RemoveEntry(entry);
+            return false;
+        }
+
+        /* If the client's buffer can't hold the answer, let sfdnsres produce whatever it would have. */
+        if (entry->answer.size > dst_size) {
+            ++g_statistics.misses;
+            return false;
+        }
+
+        /* Mark the entry as most recently used. */
+        g_cache_lru_list.erase(g_cache_lru_list.iterator_to(*entry));
+        g_cache_lru_list.push_front(*entry);
+
+        /* Copy out the answer. */
+        std::memcpy(dst, entry->data.get(), entry->answer.size);
+        *out          = entry->answer;
+        *out_negative = entry->negative;
+
+        ++(entry->negative ? g_statistics.negative_hits : g_statistics.hits);
+        return true;
+    }
+
+    void CacheAnswer(const AnswerCacheKey &key, const Answer &answer, const void *data, bool negative) {
+        std::scoped_lock lk(g_cache_lock);
+
+        /* Check that we should cache the answer. */
+        const TimeSpan ttl = negative ? g_negative_ttl : g_positive_ttl;
+        if (ttl.GetNanoSeconds() <= 0 || answer.size > MaxEntryDataSize) {
+            return;
+        }
+
+        /* Remove any existing answer, which another thread may have cached while we were forwarding. */
+        if (const auto it = g_cache_map.find(key.Get()); it != g_cache_map.end()) {
+            RemoveEntry(it->second.get());
+        }
+
+        /* Make room for the answer. */
+        while (!g_cache_lru_list.empty() && (g_cache_map.size() >= MaxEntries || g_cache_data_size + answer.size > MaxTotalDataSize)) {
+            RemoveLeastRecentlyUsedEntry();
+        }
+
+        /* Create the entry. */
+        auto entry = std::make_unique<CacheEntry>();
+        entry->key             = key.Get();
+        entry->data            = std::make_unique<u8[]>(answer.size);
+        entry->answer          = answer;
+        entry->expiration_tick = os::GetSystemTick() + os::ConvertToTick(ttl);
+        entry->negative        = negative;
+        std::memcpy(entry->data.get(), data, answer.size);
+
+        /* Insert it. */
+        g_cache_lru_list.push_front(*entry);
+        g_cache_data_size += answer.size;
+
+        const std::string_view entry_key = entry->key;
+        g_cache_map.emplace(entry_key, std::move(entry));
+    }
+
+    void ClearAnswerCache() {
+        std::scoped_lock lk(g_cache_lock);
+
+        g_cache_lru_list.clear();
+        g_cache_map.clear();
+        g_cache_data_size = 0;
+    }
+
+    void GetAnswerCacheStatistics(AnswerCacheStatistics *out) {
+        std::scoped_lock lk(g_cache_lock);
+
+        *out = g_statistics;
+    }
+
+}
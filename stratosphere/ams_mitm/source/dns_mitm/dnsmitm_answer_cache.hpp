@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+
+namespace ams::mitm::socket::resolver {
+
+    enum AnswerType : u8 {
+        AnswerType_HostEnt  = 0,
+        AnswerType_AddrInfo = 1,
+    };
+
+    struct Answer {
+        u32 size;
+        s32 retval;
+        s32 host_error;
+        s32 errno_value;
+    };
+
+    struct AnswerCacheStatistics {
+        u64 hits;
+        u64 negative_hits;
+        u64 misses;
+        u64 evictions;
+        u64 expirations;
+    };
+
+    /* Identifies a request by everything which was forwarded to sfdnsres, other than the client. */
+    class AnswerCacheKey {
+        private:
+            std::string key;
+        public:
+            explicit AnswerCacheKey(AnswerType type) : key(1, static_cast<char>(type)) { /* ... */ }
+
+            void Append(const void *data, size_t size) {
+                const u32 size32 = static_cast<u32>(size);
+                this->key.append(reinterpret_cast<const char *>(std::addressof(size32)), sizeof(size32));
+                if (data != nullptr) {
+                    this->key.append(static_cast<const char *>(data), size);
+                }
+            }
+
+            template<typename T> requires std::is_trivially_copyable<T>::value
+            void Append(const T &value) {
+                this->Append(std::addressof(value), sizeof(value));
+            }
+
+            std::string_view Get() const { return this->key; }
+    };
+
+    void InitializeAnswerCache(TimeSpan max_ttl);
+
+    bool GetCachedAnswer(Answer *out, void *dst, size_t dst_size, const AnswerCacheKey &key, bool *out_negative);
+    void CacheAnswer(const AnswerCacheKey &key, const Answer &answer, const void *data, bool negative);
+    void ClearAnswerCache();
+
+    void GetAnswerCacheStatistics(AnswerCacheStatistics *out);
+
+}
@@ -23,7 +23,7 @@ namespace ams::mitm::socket::resolver {
 
     namespace {
 
-        /* https://github.com/clibs/wildcardcmp */
+        /* Based on https://github.com/clibs/wildcardcmp, with backtracking to the last `*` on mismatch. */
         constexpr int wildcardcmp(const char *pattern, const char *string) {
             const char *w = nullptr; /* last `*` */
             const char *s = nullptr; /* last checked char */
@@ -32,223 +32,455 @@ namespace ams::mitm::socket::resolver {
             if (!pattern || !string) return 0;
 
             /* loop 1 char at a time */
-            while (1) {
-                if (!*string) {
-                    if (!*pattern) return 1;
-                    if ('*' == *pattern) return 1;
-                    if (!*s) return 0;
-                    string = s++;
+            while (*string) {
+                if ('*' == *pattern) {
+                    w = ++pattern;
+                    s = string;
+                } else if (*pattern == *string) {
+                    pattern++;
+                    string++;
+                } else if (w) {
+                    /* "*ooba*" -> "foobar" */
                     pattern = w;
-                    continue;
+                    string  = ++s;
                 } else {
-                    if (*pattern != *string) {
-                        if ('*' == *pattern) {
-                            w = ++pattern;
-                            s = string;
-                            /* "*" -> "foobar" */
-                            if (*pattern) continue;
-                            return 1;
-                        } else if (w) {
-                            string++;
-                            /* "*ooba*" -> "foobar" */
-                            continue;
-                        }
-                        return 0;
-                    }
+                    return 0;
                 }
+            }
 
-                string++;
+            /* trailing `*` match the empty string */
+            while ('*' == *pattern) {
                 pattern++;
             }
 
-            return 1;
+            return !*pattern;
         }
 
+        static_assert(wildcardcmp("*", "foobar"));
+        static_assert(wildcardcmp("*ooba*", "foobar"));
+        static_assert(wildcardcmp("*.nintendo.net", "a.b.nintendo.net"));
+        static_assert(!wildcardcmp("*.nintendo.net", "nintendo.network"));
+        static_assert(!wildcardcmp("*.nintendo.net", "nintendo.net"));
+
+        /* Hosts files are read and parsed in pieces, so that a large file never needs to be resident all at once. */
+        constexpr size_t HostsFileReadSize = 16_KB;
+
         constexpr const char DefaultHostsFile[] =
             "# Nintendo telemetry servers\n"
             "127.0.0.1 receive-%.dg.srv.nintendo.net receive-%.er.srv.nintendo.net\n";
 
-        constinit os::SdkMutex g_redirection_lock;
-        std::vector<std::pair<std::string, ams::socket::InAddrT>> g_redirection_list;
+        /* Compiled set of redirections. Later redirections take precedence over earlier ones. */
+        /* Hostnames are kept in a block arena, and indexed by a single array of entries sorted by kind: */
+        /* plain hostnames and "*.suffix" wildcards are sorted by name and found by binary search, and */
+        /* any other wildcard patterns are matched with wildcardcmp, in order of precedence. */
+        class RedirectionTable {
+            NON_COPYABLE(RedirectionTable);
+            NON_MOVEABLE(RedirectionTable);
+            public:
+                struct Statistics {
+                    size_t num_exact;
+                    size_t num_suffix;
+                    size_t num_pattern;
+                    size_t name_arena_size;
+                    std::atomic<u64> num_lookups;
+                    std::atomic<u64> num_redirected;
+                    std::atomic<s64> lookup_ticks;
+                };
+            private:
+                static constexpr size_t NameBlockSize = 32_KB;
+
+                enum class EntryKind : u8 {
+                    Exact,
+                    Suffix,
+                    Pattern,
+                };
+
+                struct Entry {
+                    const char *name;
+                    u32 name_length;
+                    u32 priority;
+                    ams::socket::InAddrT address;
+                    EntryKind kind;
+
+                    /* Suffix wildcards are keyed by what follows their "*.". */
+                    std::string_view GetKey() const {
+                        const std::string_view name_view(this->name, this->name_length);
+                        return this->kind == EntryKind::Suffix ? name_view.substr(2) : name_view;
+                    }
+                };
+            private:
+                std::vector<std::unique_ptr<char[]>> name_blocks;
+                size_t name_block_used;
+                std::vector<Entry> entries;
+                size_t exact_end;
+                size_t suffix_end;
+                u32 next_priority;
+                Statistics statistics;
+            public:
+                RedirectionTable() : name_blocks(), name_block_used(NameBlockSize), entries(), exact_end(0), suffix_end(0), next_priority(0), statistics() { /* ... */ }
+
+                void Add(const char *hostname, ams::socket::InAddrT address) {
+                    /* Copy the hostname into our arena; patterns are matched by wildcardcmp, and so are kept null-terminated. */
+                    const size_t length = std::strlen(hostname);
+                    char *name = this->AllocateName(length + 1);
+                    std::memcpy(name, hostname, length + 1);
+
+                    const std::string_view host(name, length);
+
+                    EntryKind kind;
+                    if (host.find('*') == std::string_view::npos) {
+                        kind = EntryKind::Exact;
+                    } else if (host.starts_with("*.") && host.find('*', 1) == std::string_view::npos) {
+                        kind = EntryKind::Suffix;
+                    } else {
+                        kind = EntryKind::Pattern;
+                    }
 
-        void RemoveRedirection(const char *hostname) {
-            for (auto it = g_redirection_list.begin(); it != g_redirection_list.end(); ++it) {
-                if (std::strcmp(it->first.c_str(), hostname) == 0) {
-                    g_redirection_list.erase(it);
-                    break;
+                    this->entries.push_back(Entry{ .name = name, .name_length = static_cast<u32>(length), .priority = this->next_priority++, .address = address, .kind = kind });
                 }
-            }
-        }
 
-        void AddRedirection(const char *hostname, ams::socket::InAddrT addr) {
-            RemoveRedirection(hostname);
-            g_redirection_list.emplace(g_redirection_list.begin(), std::string(hostname), addr);
-        }
-
-        constinit char g_specific_emummc_hosts_path[0x40] = {};
-
-        void ParseHostsFile(const char *file_data) {
-            /* Get the environment identifier from settings. */
-            const auto env     = ams::nsd::impl::device::GetEnvironmentIdentifierFromSettings();
-            const auto env_len = std::strlen(env.value);
-
-            /* Parse the file. */
-            enum class State {
-                IgnoredLine,
-                BeginLine,
-                Ip1,
-                IpDot1,
-                Ip2,
-                IpDot2,
-                Ip3,
-                IpDot3,
-                Ip4,
-                WhiteSpace,
-                HostName,
-            };
-
-            ams::socket::InAddrT current_address;
-            char current_hostname[0x200];
-            u32 work;
-
-            State state = State::BeginLine;
-            for (const char *cur = file_data; *cur != '\x00'; ++cur) {
-                const char c = *cur;
-                switch (state) {
-                    case State::IgnoredLine:
-                        if (c == '\n') {
-                            state = State::BeginLine;
-                        }
-                        break;
-                    case State::BeginLine:
-                        if (std::isdigit(static_cast<unsigned char>(c))) {
-                            current_address = 0;
-                            work            = static_cast<u32>(c - '0');
-                            state           = State::Ip1;
-                        } else if (c == '\n') {
-                            state = State::BeginLine;
-                        } else {
-                            state = State::IgnoredLine;
+                void Finalize() {
+                    /* Sort entries by kind; names by key, with later duplicates last, and patterns in order of precedence. */
+                    std::sort(this->entries.begin(), this->entries.end(), [](const Entry &lhs, const Entry &rhs) {
+                        if (lhs.kind != rhs.kind) {
+                            return lhs.kind < rhs.kind;
                         }
-                        break;
-                    case State::Ip1:
-                        if (std::isdigit(static_cast<unsigned char>(c))) {
-                            work *= 10;
-                            work += static_cast<u32>(c - '0');
-                        } else if (c == '.') {
-                            current_address |= (work & 0xFF) << 0;
-                            work = 0;
-                            state = State::IpDot1;
-                        } else {
-                            state = State::IgnoredLine;
-                        }
-                        break;
-                    case State::IpDot1:
-                        if (std::isdigit(static_cast<unsigned char>(c))) {
-                            work            = static_cast<u32>(c - '0');
-                            state           = State::Ip2;
-                        } else {
-                            state = State::IgnoredLine;
-                        }
-                        break;
-                    case State::Ip2:
-                        if (std::isdigit(static_cast<unsigned char>(c))) {
-                            work *= 10;
-                            work += static_cast<u32>(c - '0');
-                        } else if (c == '.') {
-                            current_address |= (work & 0xFF) << 8;
-                            work = 0;
-                            state = State::IpDot2;
-                        } else {
-                            state = State::IgnoredLine;
+
+                        if (lhs.kind == EntryKind::Pattern) {
+                            return lhs.priority > rhs.priority;
                         }
-                        break;
-                    case State::IpDot2:
-                        if (std::isdigit(static_cast<unsigned char>(c))) {
-                            work            = static_cast<u32>(c - '0');
-                            state           = State::Ip3;
-                        } else {
-                            state = State::IgnoredLine;
+
+                        if (const int cmp = lhs.GetKey().compare(rhs.GetKey()); cmp != 0) {
+                            return cmp < 0;
                         }
-                        break;
-                    case State::Ip3:
-                        if (std::isdigit(static_cast<unsigned char>(c))) {
-                            work *= 10;
-                            work += static_cast<u32>(c - '0');
-                        } else if (c == '.') {
-                            current_address |= (work & 0xFF) << 16;
-                            work = 0;
-                            state = State::IpDot3;
-                        } else {
-                            state = State::IgnoredLine;
+                        return lhs.priority < rhs.priority;
+                    });
+
+                    /* Only the latest of several redirections for the same name can ever be used. */
+                    size_t count = 0;
+                    for (size_t i = 0; i < this->entries.size(); ++i) {
+                        const Entry &entry = this->entries[i];
+                        if (entry.kind != EntryKind::Pattern && i + 1 < this->entries.size()) {
+                            const Entry &next = this->entries[i + 1];
+                            if (next.kind == entry.kind && next.GetKey() == entry.GetKey()) {
+                                continue;
+                            }
                         }
-                        break;
-                    case State::IpDot3:
-                        if (std::isdigit(static_cast<unsigned char>(c))) {
-                            work            = static_cast<u32>(c - '0');
-                            state           = State::Ip4;
-                        } else {
-                            state = State::IgnoredLine;
+
+                        this->entries[count++] = entry;
+                    }
+                    this->entries.resize(count);
+                    this->entries.shrink_to_fit();
+
+                    /* Find where each kind begins. */
+                    this->exact_end  = std::partition_point(this->entries.begin(), this->entries.end(), [](const Entry &entry) { return entry.kind == EntryKind::Exact; }) - this->entries.begin();
+                    this->suffix_end = std::partition_point(this->entries.begin(), this->entries.end(), [](const Entry &entry) { return entry.kind != EntryKind::Pattern; }) - this->entries.begin();
+
+                    this->statistics.num_exact       = this->exact_end;
+                    this->statistics.num_suffix      = this->suffix_end - this->exact_end;
+                    this->statistics.num_pattern     = this->entries.size() - this->suffix_end;
+                    this->statistics.name_arena_size = this->name_blocks.size() * NameBlockSize;
+                }
+
+                bool Find(ams::socket::InAddrT *out, const char *hostname) const {
+                    const std::string_view host(hostname);
+                    const Entry *best = nullptr;
+
+                    auto Consider = [&](const Entry *entry) {
+                        if (entry != nullptr && (best == nullptr || entry->priority > best->priority)) {
+                            best = entry;
                         }
-                        break;
-                    case State::Ip4:
-                        if (std::isdigit(static_cast<unsigned char>(c))) {
-                            work *= 10;
-                            work += static_cast<u32>(c - '0');
-                        } else if (c == ' ' || c == '\t') {
-                            current_address |= (work & 0xFF) << 24;
-                            work = 0;
-                            state = State::WhiteSpace;
-                        } else {
-                            state = State::IgnoredLine;
+                    };
+
+                    /* Check for an exact match. */
+                    Consider(this->FindByKey(0, this->exact_end, host));
+
+                    /* Check for suffix wildcards. */
+                    /* A wildcard matches if at least one label (possibly empty) remains before its suffix. */
+                    for (size_t dot = host.find('.'); dot != std::string_view::npos; dot = host.find('.', dot + 1)) {
+                        Consider(this->FindByKey(this->exact_end, this->suffix_end, host.substr(dot + 1)));
+                    }
+
+                    /* Check general patterns, until none could take precedence over what we've found. */
+                    for (size_t i = this->suffix_end; i < this->entries.size(); ++i) {
+                        const Entry &pattern = this->entries[i];
+                        if (best != nullptr && pattern.priority < best->priority) {
+                            break;
                         }
-                        break;
-                    case State::WhiteSpace:
-                        if (c == '\n') {
-                            state = State::BeginLine;
-                        } else if (c != ' ' && c != '\r' && c != '\t') {
-                            if (c == '%') {
-                                std::memcpy(current_hostname, env.value, env_len);
-                                work = env_len;
-                            } else {
-                                current_hostname[0] = c;
-                                work = 1;
-                            }
-                            state = State::HostName;
+
+                        if (wildcardcmp(pattern.name, hostname)) {
+                            Consider(std::addressof(pattern));
+                            break;
                         }
-                        break;
-                    case State::HostName:
-                        if (c == ' ' || c == '\r' || c == '\n' || c == '\t') {
-                            AMS_ABORT_UNLESS(work < sizeof(current_hostname));
-                            current_hostname[work] = '\x00';
-
-                            AddRedirection(current_hostname, current_address);
-                            work = 0;
-
-                            if (c == '\n') {
-                                state = State::BeginLine;
-                            } else {
-                                state = State::WhiteSpace;
-                            }
-                        } else if (c == '%') {
-                            AMS_ABORT_UNLESS(work < sizeof(current_hostname) - env_len);
-                            std::memcpy(current_hostname + work, env.value, env_len);
-                            work += env_len;
-                        } else {
-                            AMS_ABORT_UNLESS(work < sizeof(current_hostname) - 1);
-                            current_hostname[work++] = c;
+                    }
+
+                    if (best != nullptr) {
+                        *out = best->address;
+                        return true;
+                    } else {
+                        return false;
+                    }
+                }
+
+                Statistics &GetStatistics() { return this->statistics; }
+                const Statistics &GetStatistics() const { return this->statistics; }
+            private:
+                char *AllocateName(size_t size) {
+                    AMS_ABORT_UNLESS(size <= NameBlockSize);
+
+                    if (this->name_block_used + size > NameBlockSize) {
+                        this->name_blocks.emplace_back(std::make_unique<char[]>(NameBlockSize));
+                        AMS_ABORT_UNLESS(this->name_blocks.back() != nullptr);
+                        this->name_block_used = 0;
+                    }
+
+                    char *name = this->name_blocks.back().get() + this->name_block_used;
+                    this->name_block_used += size;
+                    return name;
+                }
+
+                const Entry *FindByKey(size_t begin, size_t end, std::string_view key) const {
+                    const auto first = this->entries.begin() + begin;
+                    const auto last  = this->entries.begin() + end;
+
+                    const auto it = std::lower_bound(first, last, key, [](const Entry &entry, std::string_view key) { return entry.GetKey() < key; });
+                    return (it != last && it->GetKey() == key) ? std::addressof(*it) : nullptr;
+                }
+        };
+
+        /* The current table is published by pointer, so that lookups never take a lock. */
+        /* Lookups register with the reader count for the current epoch; replacing the table advances the epoch, */
+        /* and waits for readers of the previous epoch to finish before freeing the old table. */
+        constinit os::SdkMutex g_redirection_lock;
+        constinit std::atomic<RedirectionTable *> g_redirection_table = nullptr;
+        constinit std::atomic<u32> g_redirection_epoch = 0;
+        constinit std::atomic<u32> g_redirection_readers[2] = {};
+
+        class ScopedRedirectionTableReader {
+            NON_COPYABLE(ScopedRedirectionTableReader);
+            NON_MOVEABLE(ScopedRedirectionTableReader);
+            private:
+                u32 epoch;
+            public:
+                ScopedRedirectionTableReader() {
+                    while (true) {
+                        this->epoch = g_redirection_epoch.load();
+                        g_redirection_readers[this->epoch % 2]++;
+                        if (g_redirection_epoch.load() == this->epoch) {
+                            break;
                         }
+                        g_redirection_readers[this->epoch % 2]--;
+                    }
                 }
-            }
 
-            if (state == State::HostName) {
-                AMS_ABORT_UNLESS(work < sizeof(current_hostname));
-                current_hostname[work] = '\x00';
+                ~ScopedRedirectionTableReader() {
+                    g_redirection_readers[this->epoch % 2]--;
+                }
+
+                RedirectionTable *Get() const {
+                    return g_redirection_table.load();
+                }
+        };
+
+        std::unique_ptr<RedirectionTable> PublishRedirectionTable(std::unique_ptr<RedirectionTable> table) {
+            /* NOTE: This must be called with g_redirection_lock held. */
+            std::unique_ptr<RedirectionTable> old_table(g_redirection_table.exchange(table.release()));
 
-                AddRedirection(current_hostname, current_address);
+            /* Wait for any lookups which may still be using the old table. */
+            const u32 epoch = g_redirection_epoch++;
+            while (g_redirection_readers[epoch % 2].load() != 0) {
+                os::SleepThread(TimeSpan::FromMicroSeconds(100));
             }
+
+            return old_table;
         }
 
+        constinit char g_specific_emummc_hosts_path[0x40] = {};
+
+        /* Parses a hosts file into a table, a piece at a time. */
+        class HostsFileParser {
+            NON_COPYABLE(HostsFileParser);
+            NON_MOVEABLE(HostsFileParser);
+            private:
+                enum class State {
+                    IgnoredLine,
+                    BeginLine,
+                    Ip1,
+                    IpDot1,
+                    Ip2,
+                    IpDot2,
+                    Ip3,
+                    IpDot3,
+                    Ip4,
+                    WhiteSpace,
+                    HostName,
+                    End,
+                };
+            private:
+                RedirectionTable &table;
+                const ams::nsd::EnvironmentIdentifier &env;
+                size_t env_len;
+                State state;
+                ams::socket::InAddrT current_address;
+                u32 work;
+                char current_hostname[0x200];
+            public:
+                explicit HostsFileParser(RedirectionTable &t) : table(t), env(ams::nsd::impl::device::GetEnvironmentIdentifierFromSettings()), state(State::BeginLine), current_address(0), work(0) {
+                    this->env_len = std::strlen(this->env.value);
+                }
+
+                void Parse(const char *data, size_t size) {
+                    for (size_t i = 0; i < size && this->state != State::End; ++i) {
+                        const char c = data[i];
+
+                        /* As with a string, the file ends at its first null character. */
+                        if (c == '\x00') {
+                            this->Finish();
+                            break;
+                        }
+
+                        switch (this->state) {
+                            case State::IgnoredLine:
+                                if (c == '\n') {
+                                    this->state = State::BeginLine;
+                                }
+                                break;
+                            case State::BeginLine:
+                                if (std::isdigit(static_cast<unsigned char>(c))) {
+                                    this->current_address = 0;
+                                    this->work            = static_cast<u32>(c - '0');
+                                    this->state           = State::Ip1;
+                                } else if (c == '\n') {
+                                    this->state = State::BeginLine;
+                                } else {
+                                    this->state = State::IgnoredLine;
+                                }
+                                break;
+                            case State::Ip1:
+                                if (std::isdigit(static_cast<unsigned char>(c))) {
+                                    this->work *= 10;
+                                    this->work += static_cast<u32>(c - '0');
+                                } else if (c == '.') {
+                                    this->current_address |= (this->work & 0xFF) << 0;
+                                    this->work = 0;
+                                    this->state = State::IpDot1;
+                                } else {
+                                    this->state = State::IgnoredLine;
+                                }
+                                break;
+                            case State::IpDot1:
+                                if (std::isdigit(static_cast<unsigned char>(c))) {
+                                    this->work            = static_cast<u32>(c - '0');
+                                    this->state           = State::Ip2;
+                                } else {
+                                    this->state = State::IgnoredLine;
+                                }
+                                break;
+                            case State::Ip2:
+                                if (std::isdigit(static_cast<unsigned char>(c))) {
+                                    this->work *= 10;
+                                    this->work += static_cast<u32>(c - '0');
+                                } else if (c == '.') {
+                                    this->current_address |= (this->work & 0xFF) << 8;
+                                    this->work = 0;
+                                    this->state = State::IpDot2;
+                                } else {
+                                    this->state = State::IgnoredLine;
+                                }
+                                break;
+                            case State::IpDot2:
+                                if (std::isdigit(static_cast<unsigned char>(c))) {
+                                    this->work            = static_cast<u32>(c - '0');
+                                    this->state           = State::Ip3;
+                                } else {
+                                    this->state = State::IgnoredLine;
+                                }
+                                break;
+                            case State::Ip3:
+                                if (std::isdigit(static_cast<unsigned char>(c))) {
+                                    this->work *= 10;
+                                    this->work += static_cast<u32>(c - '0');
+                                } else if (c == '.') {
+                                    this->current_address |= (this->work & 0xFF) << 16;
+                                    this->work = 0;
+                                    this->state = State::IpDot3;
+                                } else {
+                                    this->state = State::IgnoredLine;
+                                }
+                                break;
+                            case State::IpDot3:
+                                if (std::isdigit(static_cast<unsigned char>(c))) {
+                                    this->work            = static_cast<u32>(c - '0');
+                                    this->state           = State::Ip4;
+                                } else {
+                                    this->state = State::IgnoredLine;
+                                }
+                                break;
+                            case State::Ip4:
+                                if (std::isdigit(static_cast<unsigned char>(c))) {
+                                    this->work *= 10;
+                                    this->work += static_cast<u32>(c - '0');
+                                } else if (c == ' ' || c == '\t') {
+                                    this->current_address |= (this->work & 0xFF) << 24;
+                                    this->work = 0;
+                                    this->state = State::WhiteSpace;
+                                } else {
+                                    this->state = State::IgnoredLine;
+                                }
+                                break;
+                            case State::WhiteSpace:
+                                if (c == '\n') {
+                                    this->state = State::BeginLine;
+                                } else if (c != ' ' && c != '\r' && c != '\t') {
+                                    if (c == '%') {
+                                        std::memcpy(this->current_hostname, this->env.value, this->env_len);
+                                        this->work = this->env_len;
+                                    } else {
+                                        this->current_hostname[0] = c;
+                                        this->work = 1;
+                                    }
+                                    this->state = State::HostName;
+                                }
+                                break;
+                            case State::HostName:
+                                if (c == ' ' || c == '\r' || c == '\n' || c == '\t') {
+                                    AMS_ABORT_UNLESS(this->work < sizeof(this->current_hostname));
+                                    this->current_hostname[this->work] = '\x00';
+
+                                    this->table.Add(this->current_hostname, this->current_address);
+                                    this->work = 0;
+
+                                    if (c == '\n') {
+                                        this->state = State::BeginLine;
+                                    } else {
+                                        this->state = State::WhiteSpace;
+                                    }
+                                } else if (c == '%') {
+                                    AMS_ABORT_UNLESS(this->work < sizeof(this->current_hostname) - this->env_len);
+                                    std::memcpy(this->current_hostname + this->work, this->env.value, this->env_len);
+                                    this->work += this->env_len;
+                                } else {
+                                    AMS_ABORT_UNLESS(this->work < sizeof(this->current_hostname) - 1);
+                                    this->current_hostname[this->work++] = c;
+                                }
+                                break;
+                            AMS_UNREACHABLE_DEFAULT_CASE();
+                        }
+                    }
+                }
+
+                void Finish() {
+                    if (this->state == State::HostName) {
+                        AMS_ABORT_UNLESS(this->work < sizeof(this->current_hostname));
+                        this->current_hostname[this->work] = '\x00';
+
+                        this->table.Add(this->current_hostname, this->current_address);
+                    }
+
+                    this->state = State::End;
+                }
+        };
+
         void Log(::FsFile &f, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
         void Log(::FsFile &f, const char *fmt, ...) {
             char log_buf[0x100];
@@ -305,11 +537,11 @@ namespace ams::mitm::socket::resolver {
         /* Get whether we should add defaults. */
         const bool add_defaults = ShouldAddDefaultResolverRedirections();
 
-        /* Acquire exclusive access to the map. */
+        /* Serialize reloads. */
         std::scoped_lock lk(g_redirection_lock);
 
-        /* Clear the redirections map. */
-        g_redirection_list.clear();
+        /* Build a new table, while lookups continue to use the current one. */
+        auto table = std::make_unique<RedirectionTable>();
 
         /* Open log file. */
         ::FsFile log_file;
@@ -337,7 +569,9 @@ namespace ams::mitm::socket::resolver {
         /* If we should, add the defaults. */
         if (add_defaults) {
             Log(log_file, "Adding defaults to redirection list.\n");
-            ParseHostsFile(DefaultHostsFile);
+            HostsFileParser parser(*table);
+            parser.Parse(DefaultHostsFile, sizeof(DefaultHostsFile) - 1);
+            parser.Finish();
         }
 
         /* Select the hosts file. */
@@ -346,54 +580,68 @@ namespace ams::mitm::socket::resolver {
 
         /* Load the hosts file. */
         {
-            char *hosts_file_data = nullptr;
-            ON_SCOPE_EXIT { if (hosts_file_data != nullptr) { ams::Free(hosts_file_data); } };
+            const auto start_tick = os::GetSystemTick();
             {
                 ::FsFile hosts_file;
                 R_ABORT_UNLESS(mitm::fs::OpenAtmosphereSdFile(std::addressof(hosts_file), hosts_path, ams::fs::OpenMode_Read));
                 ON_SCOPE_EXIT { ::fsFileClose(std::addressof(hosts_file)); };
 
                 /* Get the hosts file size. */
-                s64 hosts_size;
-                R_ABORT_UNLESS(::fsFileGetSize(std::addressof(hosts_file), std::addressof(hosts_size)));
+                s64 file_size;
+                R_ABORT_UNLESS(::fsFileGetSize(std::addressof(hosts_file), std::addressof(file_size)));
+                AMS_ABORT_UNLESS(0 <= file_size);
 
-                /* Validate we can read the file. */
-                AMS_ABORT_UNLESS(0 <= hosts_size && hosts_size < 0x8000);
+                /* Parse the file as we read it. */
+                auto read_buffer = std::make_unique<char[]>(HostsFileReadSize);
+                AMS_ABORT_UNLESS(read_buffer != nullptr);
 
-                /* Read the data. */
-                hosts_file_data = static_cast<char *>(ams::Malloc(0x8000));
-                AMS_ABORT_UNLESS(hosts_file_data != nullptr);
+                HostsFileParser parser(*table);
+                for (s64 offset = 0; offset < file_size; /* ... */) {
+                    const size_t read_size = static_cast<size_t>(std::min<s64>(file_size - offset, HostsFileReadSize));
 
-                u64 br;
-                R_ABORT_UNLESS(::fsFileRead(std::addressof(hosts_file), 0, hosts_file_data, hosts_size, ::FsReadOption_None, std::addressof(br)));
-                AMS_ABORT_UNLESS(br == static_cast<u64>(hosts_size));
+                    u64 br;
+                    R_ABORT_UNLESS(::fsFileRead(std::addressof(hosts_file), offset, read_buffer.get(), read_size, ::FsReadOption_None, std::addressof(br)));
+                    AMS_ABORT_UNLESS(br == read_size);
 
-                /* Null-terminate. */
-                hosts_file_data[hosts_size] = '\x00';
+                    parser.Parse(read_buffer.get(), read_size);
+                    offset += read_size;
+                }
+                parser.Finish();
             }
+            table->Finalize();
+            const auto end_tick = os::GetSystemTick();
 
-            /* Parse the hosts file. */
-            ParseHostsFile(hosts_file_data);
+            /* Note what we loaded; the redirections themselves are not listed, as a large hosts file would take a great many log writes. */
+            const auto &stats = table->GetStatistics();
+            Log(log_file, "Loaded hosts file in %" PRId64 " us (%zu exact, %zu suffix wildcard, %zu pattern, %zu KB of hostnames).\n", (end_tick - start_tick).ToTimeSpan().GetMicroSeconds(), stats.num_exact, stats.num_suffix, stats.num_pattern, stats.name_arena_size / 1_KB);
         }
 
-        /* Print the redirections. */
-        Log(log_file, "Redirections:\n");
-        for (const auto &[host, address] : g_redirection_list) {
-            Log(log_file, "    `%s` -> %u.%u.%u.%u\n", host.c_str(), (address >> 0) & 0xFF, (address >> 8) & 0xFF, (address >> 16) & 0xFF, (address >> 24) & 0xFF);
+        /* Replace the current table. */
+        if (auto old_table = PublishRedirectionTable(std::move(table)); old_table != nullptr) {
+            const auto &stats = old_table->GetStatistics();
+            const u64 num_lookups = stats.num_lookups;
+            Log(log_file, "Previous hosts table served %" PRIu64 " lookups (%" PRIu64 " redirected), averaging %" PRId64 " ns.\n", num_lookups, stats.num_redirected.load(), num_lookups > 0 ? os::Tick(stats.lookup_ticks.load() / num_lookups).ToTimeSpan().GetNanoSeconds() : 0);
         }
     }
 
     bool GetRedirectedHostByName(ams::socket::InAddrT *out, const char *hostname) {
-        std::scoped_lock lk(g_redirection_lock);
+        ScopedRedirectionTableReader reader;
 
-        for (const auto &[host, address] : g_redirection_list) {
-            if (wildcardcmp(host.c_str(), hostname)) {
-                *out = address;
-                return true;
-            }
+        RedirectionTable *table = reader.Get();
+        if (table == nullptr) {
+            return false;
         }
 
-        return false;
+        const auto start_tick = os::GetSystemTick();
+        const bool redirected = table->Find(out, hostname);
+        const auto end_tick = os::GetSystemTick();
+
+        auto &stats = table->GetStatistics();
+        stats.num_lookups++;
+        stats.num_redirected += redirected ? 1 : 0;
+        stats.lookup_ticks   += (end_tick - start_tick).GetInt64Value();
+
+        return redirected;
     }
 
 }
@@ -19,6 +19,7 @@
 #include "dnsmitm_debug.hpp"
 #include "dnsmitm_resolver_impl.hpp"
 #include "dnsmitm_host_redirection.hpp"
+#include "dnsmitm_answer_cache.hpp"
 
 namespace ams::mitm::socket::resolver {
 
@@ -112,6 +113,14 @@ namespace ams::mitm::socket::resolver {
             return false;
         }
 
+        TimeSpan GetAnswerCacheMaxTtl() {
+            u32 seconds = 0;
+            if (settings::fwdbg::GetSettingsItemValue(std::addressof(seconds), sizeof(seconds), "atmosphere", "dns_mitm_cache_max_ttl") == sizeof(seconds)) {
+                return TimeSpan::FromSeconds(seconds);
+            }
+            return TimeSpan::FromSeconds(0);
+        }
+
     }
 
     void MitmModule::ThreadFunction(void *arg) {
@@ -132,6 +141,9 @@ namespace ams::mitm::socket::resolver {
         /* Initialize redirection map. */
         resolver::InitializeResolverRedirections();
 
+        /* Initialize the answer cache. */
+        resolver::InitializeAnswerCache(GetAnswerCacheMaxTtl());
+
         /* Create mitm servers. */
         R_ABORT_UNLESS((g_server_manager.RegisterMitmServer<ResolverImpl>(PortIndex_Mitm, DnsMitmServiceName)));
 
@@ -15,6 +15,7 @@
  */
 #include <stratosphere.hpp>
 #include "dnsmitm_resolver_impl.hpp"
+#include "dnsmitm_answer_cache.hpp"
 #include "dnsmitm_debug.hpp"
 #include "dnsmitm_host_redirection.hpp"
 #include "serializer/serializer.hpp"
@@ -84,6 +85,13 @@ namespace ams::mitm::socket::resolver {
         return result;
     }
 
+    void LogAnswerCacheLookup(ncm::ProgramId program_id, const char *hostname, bool hit, bool negative) {
+        AnswerCacheStatistics stats;
+        GetAnswerCacheStatistics(std::addressof(stats));
+
+        LogDebug("[%016lx]: Answer cache %s for %s (hits=%lu, negative hits=%lu, misses=%lu, evictions=%lu, expirations=%lu)\n", program_id.value, hit ? (negative ? "negative hit" : "hit") : "miss", hostname, stats.hits, stats.negative_hits, stats.misses, stats.evictions, stats.expirations);
+    }
+
     Result ResolverImpl::GetHostByNameRequest(u32 cancel_handle, const sf::ClientProcessId &client_pid, bool use_nsd_resolve, const sf::InBuffer &name, sf::Out<u32> out_host_error, sf::Out<u32> out_errno, const sf::OutBuffer &out_hostent, sf::Out<u32> out_size) {
         const char *hostname = reinterpret_cast<const char *>(name.GetPointer());
 
@@ -143,7 +151,34 @@ namespace ams::mitm::socket::resolver {
         LogDebug("[%016lx]: GetHostByNameRequestWithOptions(%s)\n", this->client_info.program_id.value, hostname);
 
         ams::socket::InAddrT redirect_addr = {};
-        R_UNLESS(GetRedirectedHostByName(std::addressof(redirect_addr), hostname), sm::mitm::ResultShouldForwardToSession());
+        if (!GetRedirectedHostByName(std::addressof(redirect_addr), hostname)) {
+            AnswerCacheKey key(AnswerType_HostEnt);
+            key.Append(name.GetPointer(), name.GetSize());
+            key.Append(options_version);
+            key.Append(num_options);
+            key.Append(options.GetPointer(), options.GetSize());
+
+            /* Try to answer from the cache, and otherwise ask sfdnsres. */
+            Answer answer = {};
+            bool negative = false;
+            const bool hit = GetCachedAnswer(std::addressof(answer), out_hostent.GetPointer(), out_hostent.GetSize(), key, std::addressof(negative));
+            if (!hit) {
+                R_TRY(sfdnsresGetHostByNameRequestWithOptionsFwd(this->forward_service.get(), client_pid.GetValue().value, name.GetPointer(), name.GetSize(), out_hostent.GetPointer(), out_hostent.GetSize(), std::addressof(answer.size), options_version, options.GetPointer(), options.GetSize(), num_options, std::addressof(answer.host_error), std::addressof(answer.errno_value)));
+
+                /* Cache successful lookups, and lookups of hosts which don't exist. */
+                if (answer.host_error == 0 || answer.host_error == HOST_NOT_FOUND) {
+                    CacheAnswer(key, answer, out_hostent.GetPointer(), answer.host_error != 0);
+                }
+            }
+
+            LogAnswerCacheLookup(this->client_info.program_id, hostname, hit, negative);
+
+            *out_host_error = answer.host_error;
+            *out_errno      = answer.errno_value;
+            *out_size       = answer.size;
+
+            return ResultSuccess();
+        }
 
         LogDebug("[%016lx]: Redirecting %s to %u.%u.%u.%u\n", this->client_info.program_id.value, hostname, (redirect_addr >> 0) & 0xFF, (redirect_addr >> 8) & 0xFF, (redirect_addr >> 16) & 0xFF, (redirect_addr >> 24) & 0xFF);
         const auto size = SerializeRedirectedHostEnt(out_hostent.GetPointer(), out_hostent.GetSize(), hostname, redirect_addr);
@@ -161,7 +196,37 @@ namespace ams::mitm::socket::resolver {
         LogDebug("[%016lx]: GetAddrInfoRequestWithOptions(%s, %s)\n", this->client_info.program_id.value, hostname, reinterpret_cast<const char *>(srv.GetPointer()));
 
         ams::socket::InAddrT redirect_addr = {};
-        R_UNLESS(GetRedirectedHostByName(std::addressof(redirect_addr), hostname), sm::mitm::ResultShouldForwardToSession());
+        if (!GetRedirectedHostByName(std::addressof(redirect_addr), hostname)) {
+            AnswerCacheKey key(AnswerType_AddrInfo);
+            key.Append(node.GetPointer(), node.GetSize());
+            key.Append(srv.GetPointer(), srv.GetSize());
+            key.Append(serialized_hint.GetPointer(), serialized_hint.GetSize());
+            key.Append(options_version);
+            key.Append(num_options);
+            key.Append(options.GetPointer(), options.GetSize());
+
+            /* Try to answer from the cache, and otherwise ask sfdnsres. */
+            Answer answer = {};
+            bool negative = false;
+            const bool hit = GetCachedAnswer(std::addressof(answer), out_addrinfo.GetPointer(), out_addrinfo.GetSize(), key, std::addressof(negative));
+            if (!hit) {
+                R_TRY(sfdnsresGetAddrInfoRequestWithOptionsFwd(this->forward_service.get(), client_pid.GetValue().value, node.GetPointer(), node.GetSize(), srv.GetPointer(), srv.GetSize(), serialized_hint.GetPointer(), serialized_hint.GetSize(), out_addrinfo.GetPointer(), out_addrinfo.GetSize(), std::addressof(answer.size), std::addressof(answer.retval), options_version, options.GetPointer(), options.GetSize(), num_options, std::addressof(answer.host_error), std::addressof(answer.errno_value)));
+
+                /* Cache successful lookups, and lookups of hosts which don't exist. */
+                if (answer.retval == 0 || answer.retval == EAI_NONAME) {
+                    CacheAnswer(key, answer, out_addrinfo.GetPointer(), answer.retval != 0);
+                }
+            }
+
+            LogAnswerCacheLookup(this->client_info.program_id, hostname, hit, negative);
+
+            *out_retval     = answer.retval;
+            *out_host_error = answer.host_error;
+            *out_errno      = answer.errno_value;
+            *out_size       = answer.size;
+
+            return ResultSuccess();
+        }
 
         u16 port = 0;
         if (srv.GetPointer() != nullptr) {
@@ -194,6 +259,9 @@ namespace ams::mitm::socket::resolver {
     Result ResolverImpl::AtmosphereReloadHostsFile() {
         /* Perform a hosts file reload. */
         InitializeResolverRedirections();
+
+        /* Drop any cached answers, so that the next lookups see the current network state. */
+        ClearAnswerCache();
         return ResultSuccess();
     }
 
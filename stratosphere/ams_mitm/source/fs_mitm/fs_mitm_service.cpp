@@ -410,4 +410,12 @@ namespace ams::mitm::fs {
         return ResultSuccess();
     }
 
+    void FsMitmService::AtmosphereGetLooseFileCacheStatistics(sf::Out<LooseFileCacheStatistics> out) {
+        GetLooseFileCacheStatistics(out.GetPointer());
+    }
+
+    void FsMitmService::AtmosphereGetRomfsBuildStatistics(sf::Out<RomfsBuildStatistics> out) {
+        GetRomfsBuildStatistics(out.GetPointer());
+    }
+
 }
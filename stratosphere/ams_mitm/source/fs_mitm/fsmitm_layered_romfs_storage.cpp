@@ -17,52 +17,198 @@
 #include "../amsmitm_initialization.hpp"
 #include "../amsmitm_fs_utils.hpp"
 #include "fsmitm_layered_romfs_storage.hpp"
+#include "fsmitm_romfs_build_cache.hpp"
 
 namespace ams::mitm::fs {
 
     namespace {
 
+        /* Builds all share ams.mitm's single fs session and its heap, so they run one at a time on a single thread. */
+        /* Requests are queued, so that a title being launched does not wait for the builds of other titles to start. */
+        constexpr size_t RomfsInitializerThreadStackSize = 0x8000;
+        constexpr size_t RomfsInitializeRequestCount     = 0x10;
+
         os::Mutex g_mq_lock(false);
         bool g_started_req_thread;
-        uintptr_t g_mq_storage[2];
-        os::MessageQueue g_req_mq(g_mq_storage + 0, 1);
-        os::MessageQueue g_ack_mq(g_mq_storage + 1, 1);
+        uintptr_t g_mq_storage[RomfsInitializeRequestCount];
+        os::MessageQueue g_req_mq(g_mq_storage, RomfsInitializeRequestCount);
+
+        os::ThreadType g_romfs_initializer_thread;
+        alignas(os::ThreadStackAlignment) u8 g_romfs_initializer_thread_stack[RomfsInitializerThreadStackSize];
 
         void RomfsInitializerThreadFunction(void *arg) {
             while (true) {
-                uintptr_t storage_uptr = 0;
-                g_req_mq.Receive(&storage_uptr);
-                std::shared_ptr<LayeredRomfsStorage> layered_storage = reinterpret_cast<LayeredRomfsStorage *>(storage_uptr)->GetShared();
-                g_ack_mq.Send(storage_uptr);
+                /* The request holds a reference to the storage, which we take ownership of. */
+                uintptr_t request_uptr = 0;
+                g_req_mq.Receive(&request_uptr);
+                std::unique_ptr<std::shared_ptr<LayeredRomfsStorage>> request(reinterpret_cast<std::shared_ptr<LayeredRomfsStorage> *>(request_uptr));
+
+                std::shared_ptr<LayeredRomfsStorage> layered_storage = std::move(*request);
+                request.reset();
+
                 layered_storage->InitializeImpl();
             }
         }
 
-        constexpr size_t RomfsInitializerThreadStackSize = 0x8000;
-        os::ThreadType g_romfs_initializer_thread;
-        alignas(os::ThreadStackAlignment) u8 g_romfs_initializer_thread_stack[RomfsInitializerThreadStackSize];
-
-        void RequestInitializeStorage(uintptr_t storage_uptr) {
-            std::scoped_lock lk(g_mq_lock);
+        void RequestInitializeStorage(std::shared_ptr<LayeredRomfsStorage> storage) {
+            {
+                std::scoped_lock lk(g_mq_lock);
 
-            if (AMS_UNLIKELY(!g_started_req_thread)) {
-                R_ABORT_UNLESS(os::CreateThread(std::addressof(g_romfs_initializer_thread), RomfsInitializerThreadFunction, nullptr, g_romfs_initializer_thread_stack, sizeof(g_romfs_initializer_thread_stack), AMS_GET_SYSTEM_THREAD_PRIORITY(mitm_fs, RomFileSystemInitializeThread)));
-                os::SetThreadNamePointer(std::addressof(g_romfs_initializer_thread), AMS_GET_SYSTEM_THREAD_NAME(mitm_fs, RomFileSystemInitializeThread));
-                os::StartThread(std::addressof(g_romfs_initializer_thread));
-                g_started_req_thread = true;
+                if (AMS_UNLIKELY(!g_started_req_thread)) {
+                    R_ABORT_UNLESS(os::CreateThread(std::addressof(g_romfs_initializer_thread), RomfsInitializerThreadFunction, nullptr, g_romfs_initializer_thread_stack, sizeof(g_romfs_initializer_thread_stack), AMS_GET_SYSTEM_THREAD_PRIORITY(mitm_fs, RomFileSystemInitializeThread)));
+                    os::SetThreadNamePointer(std::addressof(g_romfs_initializer_thread), AMS_GET_SYSTEM_THREAD_NAME(mitm_fs, RomFileSystemInitializeThread));
+                    os::StartThread(std::addressof(g_romfs_initializer_thread));
+                    g_started_req_thread = true;
+                }
             }
 
-            g_req_mq.Send(storage_uptr);
-            uintptr_t ack = 0;
-            g_ack_mq.Receive(&ack);
-            AMS_ABORT_UNLESS(ack == storage_uptr);
+            /* Hand a reference to the initializer, so that the storage outlives its build. */
+            auto *request = new std::shared_ptr<LayeredRomfsStorage>(std::move(storage));
+            AMS_ABORT_UNLESS(request != nullptr);
+            g_req_mq.Send(reinterpret_cast<uintptr_t>(request));
+        }
+
+        os::Mutex g_build_statistics_lock(false);
+        constinit RomfsBuildStatistics g_build_statistics = {};
+
+        void RecordBuild(TimeSpan build_time) {
+            std::scoped_lock lk(g_build_statistics_lock);
+            g_build_statistics.cache_miss_count++;
+            g_build_statistics.total_build_time += build_time;
+        }
+
+        void RecordCacheHit(TimeSpan load_time, TimeSpan cached_build_time) {
+            std::scoped_lock lk(g_build_statistics_lock);
+            g_build_statistics.cache_hit_count++;
+            g_build_statistics.total_load_time += load_time;
+            if (cached_build_time > load_time) {
+                g_build_statistics.total_saved_time += cached_build_time - load_time;
+            }
         }
 
+        constinit std::atomic<u64> g_loose_file_open_count          = 0;
+        constinit std::atomic<u64> g_loose_file_open_avoided_count  = 0;
+        constinit std::atomic<u64> g_loose_file_eviction_count      = 0;
+
+    }
+
+    void GetRomfsBuildStatistics(RomfsBuildStatistics *out) {
+        std::scoped_lock lk(g_build_statistics_lock);
+        *out = g_build_statistics;
+    }
+
+    void GetLooseFileCacheStatistics(LooseFileCacheStatistics *out) {
+        *out = {
+            .open_count         = g_loose_file_open_count,
+            .open_avoided_count = g_loose_file_open_avoided_count,
+            .eviction_count     = g_loose_file_eviction_count,
+        };
     }
 
     using namespace ams::fs;
 
-    LayeredRomfsStorage::LayeredRomfsStorage(std::unique_ptr<IStorage> s_r, std::unique_ptr<IStorage> f_r, ncm::ProgramId pr_id) : storage_romfs(std::move(s_r)), file_romfs(std::move(f_r)), initialize_event(os::EventClearMode_ManualClear), program_id(std::move(pr_id)), is_initialized(false), started_initialize(false) {
+    LooseFileCache::LooseFileCache(ncm::ProgramId pr_id, size_t cap) : lock(false), entries(), capacity(cap), program_id(pr_id), use_counter(0) {
+        if (this->capacity > 0) {
+            this->entries = std::make_unique<Entry[]>(this->capacity);
+            AMS_ABORT_UNLESS(this->entries != nullptr);
+        }
+    }
+
+    LooseFileCache::~LooseFileCache() {
+        for (size_t i = 0; i < this->capacity; i++) {
+            auto &entry = this->entries[i];
+            if (entry.path != nullptr) {
+                AMS_ABORT_UNLESS(entry.reference_count == 0);
+                fsFileClose(&entry.file);
+            }
+        }
+    }
+
+    LooseFileCache::Entry *LooseFileCache::Acquire(const char *path) {
+        Entry *victim = nullptr;
+        ::FsFile evicted_file;
+        bool evicted = false;
+        {
+            std::scoped_lock lk(this->lock);
+
+            /* Look for an open file, while tracking the least recently used idle entry. */
+            for (size_t i = 0; i < this->capacity; i++) {
+                auto &entry = this->entries[i];
+                if (entry.path == path) {
+                    /* If another thread is still opening the file, the caller must open the file itself. */
+                    if (entry.reserved) {
+                        return nullptr;
+                    }
+
+                    entry.reference_count++;
+                    entry.last_used = ++this->use_counter;
+                    g_loose_file_open_avoided_count++;
+                    return &entry;
+                }
+
+                if (entry.reference_count == 0 && (victim == nullptr || entry.last_used < victim->last_used)) {
+                    victim = &entry;
+                }
+            }
+
+            /* If every entry is in use, the caller must open the file itself. */
+            if (victim == nullptr) {
+                return nullptr;
+            }
+
+            /* Reserve the victim, so that files can be closed and opened without holding our lock. */
+            if (victim->path != nullptr) {
+                evicted_file = victim->file;
+                evicted      = true;
+            }
+
+            victim->path            = path;
+            victim->reserved        = true;
+            victim->reference_count = 1;
+            victim->last_used       = ++this->use_counter;
+        }
+
+        /* Evict the victim's file, and open the file in its place. */
+        if (evicted) {
+            fsFileClose(&evicted_file);
+            g_loose_file_eviction_count++;
+        }
+
+        R_ABORT_UNLESS(mitm::fs::OpenAtmosphereSdRomfsFile(&victim->file, this->program_id, path, OpenMode_Read));
+        g_loose_file_open_count++;
+
+        {
+            std::scoped_lock lk(this->lock);
+            victim->reserved = false;
+        }
+
+        return victim;
+    }
+
+    void LooseFileCache::Release(Entry *entry) {
+        std::scoped_lock lk(this->lock);
+        AMS_ABORT_UNLESS(entry->reference_count > 0);
+        entry->reference_count--;
+    }
+
+    void LooseFileCache::Read(const char *path, s64 offset, void *buffer, size_t size) {
+        u64 out_read = 0;
+        if (Entry *entry = this->Acquire(path); entry != nullptr) {
+            ON_SCOPE_EXIT { this->Release(entry); };
+            R_ABORT_UNLESS(fsFileRead(&entry->file, offset, buffer, size, FsReadOption_None, &out_read));
+        } else {
+            FsFile file;
+            R_ABORT_UNLESS(mitm::fs::OpenAtmosphereSdRomfsFile(&file, this->program_id, path, OpenMode_Read));
+            ON_SCOPE_EXIT { fsFileClose(&file); };
+
+            g_loose_file_open_count++;
+
+            R_ABORT_UNLESS(fsFileRead(&file, offset, buffer, size, FsReadOption_None, &out_read));
+        }
+        AMS_ABORT_UNLESS(out_read == size);
+    }
+
+    LayeredRomfsStorage::LayeredRomfsStorage(std::unique_ptr<IStorage> s_r, std::unique_ptr<IStorage> f_r, ncm::ProgramId pr_id, size_t loose_file_cache_capacity) : storage_romfs(std::move(s_r)), file_romfs(std::move(f_r)), loose_file_cache(pr_id, loose_file_cache_capacity), initialize_event(os::EventClearMode_ManualClear), program_id(std::move(pr_id)), is_initialized(false), started_initialize(false) {
         /* ... */
     }
 
@@ -74,25 +220,46 @@ namespace ams::mitm::fs {
 
     void LayeredRomfsStorage::BeginInitialize() {
         AMS_ABORT_UNLESS(!this->started_initialize);
-        RequestInitializeStorage(reinterpret_cast<uintptr_t>(this));
+        RequestInitializeStorage(this->GetShared());
         this->started_initialize = true;
     }
 
     void LayeredRomfsStorage::InitializeImpl() {
-        /* Build new virtual romfs. */
-        romfs::Builder builder(this->program_id);
+        const os::Tick start_tick = os::GetSystemTick();
+        const bool add_sd_files = mitm::IsInitialized();
+
+        /* Try to reuse the result of a previous build with the same inputs. */
+        romfs::BuildFingerprint fingerprint;
+        romfs::CalculateBuildFingerprint(std::addressof(fingerprint), this->program_id, add_sd_files, this->file_romfs.get(), this->storage_romfs.get());
+
+        if (TimeSpan cached_build_time; romfs::LoadBuildCache(&this->source_infos, std::addressof(cached_build_time), this->program_id, fingerprint)) {
+            RecordCacheHit((os::GetSystemTick() - start_tick).ToTimeSpan(), cached_build_time);
+        } else {
+            /* Building rewrites the metadata file that the cache refers to. */
+            romfs::InvalidateBuildCache(this->program_id);
+
+            /* Build new virtual romfs. */
+            const os::Tick build_start_tick = os::GetSystemTick();
+            {
+                romfs::Builder builder(this->program_id);
+
+                if (add_sd_files) {
+                    builder.AddSdFiles();
+                }
+                if (this->file_romfs) {
+                    builder.AddStorageFiles(this->file_romfs.get(), romfs::DataSourceType::File);
+                }
+                if (this->storage_romfs) {
+                    builder.AddStorageFiles(this->storage_romfs.get(), romfs::DataSourceType::Storage);
+                }
 
-        if (mitm::IsInitialized()) {
-            builder.AddSdFiles();
-        }
-        if (this->file_romfs) {
-            builder.AddStorageFiles(this->file_romfs.get(), romfs::DataSourceType::File);
-        }
-        if (this->storage_romfs) {
-            builder.AddStorageFiles(this->storage_romfs.get(), romfs::DataSourceType::Storage);
-        }
+                builder.Build(&this->source_infos);
+            }
+            const TimeSpan build_time = (os::GetSystemTick() - build_start_tick).ToTimeSpan();
 
-        builder.Build(&this->source_infos);
+            romfs::SaveBuildCache(this->program_id, fingerprint, this->source_infos, build_time);
+            RecordBuild(build_time);
+        }
 
         this->is_initialized = true;
         this->initialize_event.Signal();
@@ -139,15 +306,7 @@ namespace ams::mitm::fs {
                         R_ABORT_UNLESS(this->file_romfs->Read(cur_source.file_source_info.offset + offset_within_source, cur_dst, cur_read_size));
                         break;
                     case romfs::DataSourceType::LooseSdFile:
-                        {
-                            FsFile file;
-                            R_ABORT_UNLESS(mitm::fs::OpenAtmosphereSdRomfsFile(&file, this->program_id, cur_source.loose_source_info.path, OpenMode_Read));
-                            ON_SCOPE_EXIT { fsFileClose(&file); };
-
-                            u64 out_read = 0;
-                            R_ABORT_UNLESS(fsFileRead(&file, offset_within_source, cur_dst, cur_read_size, FsReadOption_None, &out_read));
-                            AMS_ABORT_UNLESS(out_read == cur_read_size);
-                        }
+                        this->loose_file_cache.Read(cur_source.loose_source_info.path, offset_within_source, cur_dst, cur_read_size);
                         break;
                     case romfs::DataSourceType::Memory:
                         std::memcpy(cur_dst, cur_source.memory_source_info.data + offset_within_source, cur_read_size);
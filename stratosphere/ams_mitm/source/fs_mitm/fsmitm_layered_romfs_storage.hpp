@@ -20,11 +20,65 @@
 
 namespace ams::mitm::fs {
 
+    struct RomfsBuildStatistics {
+        u64 cache_hit_count;
+        u64 cache_miss_count;
+        TimeSpanType total_build_time;
+        TimeSpanType total_load_time;
+        TimeSpanType total_saved_time;
+    };
+    static_assert(util::is_pod<RomfsBuildStatistics>::value);
+
+    /* Gets the statistics of every layered romfs build since boot. */
+    void GetRomfsBuildStatistics(RomfsBuildStatistics *out);
+
+    struct LooseFileCacheStatistics {
+        u64 open_count;
+        u64 open_avoided_count;
+        u64 eviction_count;
+    };
+    static_assert(util::is_pod<LooseFileCacheStatistics>::value);
+
+    /* Gets the statistics of every loose file cache since boot. */
+    void GetLooseFileCacheStatistics(LooseFileCacheStatistics *out);
+
+    /* Keeps loose sd files open between reads, evicting the least recently used file when full. */
+    class LooseFileCache {
+        NON_COPYABLE(LooseFileCache);
+        NON_MOVEABLE(LooseFileCache);
+        public:
+            static constexpr size_t DefaultCapacity = 8;
+        private:
+            struct Entry {
+                const char *path;
+                ::FsFile file;
+                u64 last_used;
+                u32 reference_count;
+                bool reserved;
+            };
+        private:
+            os::Mutex lock;
+            std::unique_ptr<Entry[]> entries;
+            size_t capacity;
+            ncm::ProgramId program_id;
+            u64 use_counter;
+        private:
+            Entry *Acquire(const char *path);
+            void Release(Entry *entry);
+        public:
+            LooseFileCache(ncm::ProgramId pr_id, size_t cap);
+            ~LooseFileCache();
+
+            /* Paths are identified by address, as each loose source info owns its path. */
+            void Read(const char *path, s64 offset, void *buffer, size_t size);
+    };
+
     class LayeredRomfsStorage : public std::enable_shared_from_this<LayeredRomfsStorage>, public ams::fs::IStorage {
         private:
             std::vector<romfs::SourceInfo> source_infos;
             std::unique_ptr<ams::fs::IStorage> storage_romfs;
             std::unique_ptr<ams::fs::IStorage> file_romfs;
+            LooseFileCache loose_file_cache;
             os::Event initialize_event;
             ncm::ProgramId program_id;
             bool is_initialized;
@@ -35,7 +89,7 @@ namespace ams::mitm::fs {
                 return back.virtual_offset + back.size;
             }
         public:
-            LayeredRomfsStorage(std::unique_ptr<ams::fs::IStorage> s_r, std::unique_ptr<ams::fs::IStorage> f_r, ncm::ProgramId pr_id);
+            LayeredRomfsStorage(std::unique_ptr<ams::fs::IStorage> s_r, std::unique_ptr<ams::fs::IStorage> f_r, ncm::ProgramId pr_id, size_t loose_file_cache_capacity = LooseFileCache::DefaultCapacity);
             virtual ~LayeredRomfsStorage();
 
             void BeginInitialize();
@@ -28,20 +28,6 @@ namespace ams::mitm::fs {
             constexpr u32 EmptyEntry = 0xFFFFFFFF;
             constexpr size_t FilePartitionOffset = 0x200;
 
-            struct Header {
-                s64 header_size;
-                s64 dir_hash_table_ofs;
-                s64 dir_hash_table_size;
-                s64 dir_table_ofs;
-                s64 dir_table_size;
-                s64 file_hash_table_ofs;
-                s64 file_hash_table_size;
-                s64 file_table_ofs;
-                s64 file_table_size;
-                s64 file_partition_ofs;
-            };
-            static_assert(util::is_pod<Header>::value && sizeof(Header) == 0x50);
-
             struct DirectoryEntry {
                 u32 parent;
                 u32 sibling;
@@ -457,7 +443,7 @@ namespace ams::mitm::fs {
             /* Open metadata file. */
             const size_t metadata_size = this->dir_hash_table_size + this->dir_table_size + this->file_hash_table_size + this->file_table_size;
             FsFile metadata_file;
-            R_ABORT_UNLESS(mitm::fs::CreateAndOpenAtmosphereSdFile(&metadata_file, this->program_id, "romfs_metadata.bin", metadata_size));
+            R_ABORT_UNLESS(mitm::fs::CreateAndOpenAtmosphereSdFile(&metadata_file, this->program_id, MetadataFileName, metadata_size));
 
             /* Ensure later hash tables will have correct defaults. */
             static_assert(EmptyEntry == 0xFFFFFFFF);
@@ -19,6 +19,22 @@
 
 namespace ams::mitm::fs::romfs {
 
+    constexpr inline const char MetadataFileName[] = "romfs_metadata.bin";
+
+    struct Header {
+        s64 header_size;
+        s64 dir_hash_table_ofs;
+        s64 dir_hash_table_size;
+        s64 dir_table_ofs;
+        s64 dir_table_size;
+        s64 file_hash_table_ofs;
+        s64 file_hash_table_size;
+        s64 file_table_ofs;
+        s64 file_table_size;
+        s64 file_partition_ofs;
+    };
+    static_assert(util::is_pod<Header>::value && sizeof(Header) == 0x50);
+
     enum class DataSourceType {
         Storage,
         File,
@@ -0,0 +1,477 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "../amsmitm_fs_utils.hpp"
+#include "fsmitm_romfs_build_cache.hpp"
+
+namespace ams::mitm::fs::romfs {
+
+    using namespace ams::fs;
+
+    namespace {
+
+        constexpr u32 BuildCacheMagic   = util::FourCC<'R','F','B','C'>::Code;
+        constexpr u32 BuildCacheVersion = 1;
+
+        constexpr const char BuildCacheFileName[] = "romfs_metadata_cache.bin";
+
+        constexpr size_t DirectoryReadCount  = 0x20;
+        constexpr size_t TableReadBufferSize = 16_KB;
+
+        struct BuildCacheHeader {
+            u32 magic;
+            u32 version;
+            BuildFingerprint fingerprint;
+            u8 body_hash[crypto::Sha256Generator::HashSize];
+            s64 build_time;
+            s64 metadata_size;
+            u32 num_source_infos;
+            u32 data_size;
+        };
+        static_assert(util::is_pod<BuildCacheHeader>::value && sizeof(BuildCacheHeader) == 0x60);
+
+        struct BuildCacheSourceInfo {
+            s64 virtual_offset;
+            s64 size;
+            s64 value;
+            u32 source_type;
+            u32 data_size;
+        };
+        static_assert(util::is_pod<BuildCacheSourceInfo>::value && sizeof(BuildCacheSourceInfo) == 0x20);
+
+        enum FingerprintSection : u8 {
+            FingerprintSection_SdFiles      = 0,
+            FingerprintSection_FileRomfs    = 1,
+            FingerprintSection_StorageRomfs = 2,
+            FingerprintSection_File         = 3,
+            FingerprintSection_Directory    = 4,
+            FingerprintSection_DirectoryEnd = 5,
+            FingerprintSection_TimeStamp    = 6,
+        };
+
+        void UpdateWithSection(crypto::Sha256Generator *generator, FingerprintSection section) {
+            generator->Update(std::addressof(section), sizeof(section));
+        }
+
+        class SdTreeHasher {
+            NON_COPYABLE(SdTreeHasher);
+            NON_MOVEABLE(SdTreeHasher);
+            private:
+                crypto::Sha256Generator *generator;
+                FsFileSystem *fs;
+                ncm::ProgramId program_id;
+                char path[EntryNameLengthMax + 1];
+                DirectoryEntry entries[DirectoryReadCount];
+            public:
+                SdTreeHasher(crypto::Sha256Generator *g, FsFileSystem *f, ncm::ProgramId p) : generator(g), fs(f), program_id(p) {
+                    this->path[0] = '\x00';
+                }
+
+                void HashDirectory(size_t path_len) {
+                    /* Hash the name and size of every file in the directory. */
+                    {
+                        FsDir dir;
+                        R_ABORT_UNLESS(mitm::fs::OpenAtmosphereRomfsDirectory(&dir, this->program_id, this->path, OpenDirectoryMode_File, this->fs));
+                        ON_SCOPE_EXIT { fsDirClose(&dir); };
+
+                        while (true) {
+                            s64 read_entries = 0;
+                            R_ABORT_UNLESS(fsDirRead(&dir, &read_entries, DirectoryReadCount, this->entries));
+                            if (read_entries == 0) {
+                                break;
+                            }
+
+                            for (s64 i = 0; i < read_entries; i++) {
+                                const auto &entry = this->entries[i];
+                                UpdateWithSection(this->generator, FingerprintSection_File);
+                                this->generator->Update(entry.name, std::strlen(entry.name) + 1);
+                                this->generator->Update(std::addressof(entry.file_size), sizeof(entry.file_size));
+                            }
+                        }
+                    }
+
+                    /* Collect the names of child directories, so that we don't hold directories open while recursing. */
+                    constexpr size_t NameSize = sizeof(DirectoryEntry::name);
+                    s64 num_child_dirs = 0;
+                    std::unique_ptr<char[]> child_names;
+                    {
+                        FsDir dir;
+                        R_ABORT_UNLESS(mitm::fs::OpenAtmosphereRomfsDirectory(&dir, this->program_id, this->path, OpenDirectoryMode_Directory, this->fs));
+                        ON_SCOPE_EXIT { fsDirClose(&dir); };
+
+                        R_ABORT_UNLESS(fsDirGetEntryCount(&dir, &num_child_dirs));
+                        AMS_ABORT_UNLESS(num_child_dirs >= 0);
+                        child_names = std::make_unique<char[]>(NameSize * num_child_dirs);
+
+                        s64 cur_child_dir_ind = 0;
+                        while (true) {
+                            s64 read_entries = 0;
+                            R_ABORT_UNLESS(fsDirRead(&dir, &read_entries, DirectoryReadCount, this->entries));
+                            if (read_entries == 0) {
+                                break;
+                            }
+
+                            AMS_ABORT_UNLESS(cur_child_dir_ind + read_entries <= num_child_dirs);
+                            for (s64 i = 0; i < read_entries; i++) {
+                                std::memcpy(child_names.get() + NameSize * cur_child_dir_ind++, this->entries[i].name, NameSize);
+                            }
+                        }
+                        AMS_ABORT_UNLESS(cur_child_dir_ind == num_child_dirs);
+                    }
+
+                    /* Hash each child directory. */
+                    for (s64 i = 0; i < num_child_dirs; i++) {
+                        const char *name = child_names.get() + NameSize * i;
+                        const size_t name_len = std::strlen(name);
+
+                        UpdateWithSection(this->generator, FingerprintSection_Directory);
+                        this->generator->Update(name, name_len + 1);
+
+                        AMS_ABORT_UNLESS(path_len + 1 + name_len < sizeof(this->path));
+                        this->path[path_len] = '/';
+                        std::memcpy(this->path + path_len + 1, name, name_len);
+                        this->path[path_len + 1 + name_len] = '\x00';
+
+                        this->HashDirectory(path_len + 1 + name_len);
+
+                        this->path[path_len] = '\x00';
+                        UpdateWithSection(this->generator, FingerprintSection_DirectoryEnd);
+                    }
+                }
+        };
+
+        void UpdateWithSdFiles(crypto::Sha256Generator *generator, ncm::ProgramId program_id) {
+            /* Open Sd Card filesystem. */
+            FsFileSystem sd_filesystem;
+            R_ABORT_UNLESS(fsOpenSdCardFileSystem(&sd_filesystem));
+            ON_SCOPE_EXIT { fsFsClose(&sd_filesystem); };
+
+            /* If there is no romfs folder on the SD, there are no files to hash. */
+            {
+                FsDir dir;
+                if (R_FAILED(mitm::fs::OpenAtmosphereRomfsDirectory(&dir, program_id, "", OpenDirectoryMode_Directory, &sd_filesystem))) {
+                    return;
+                }
+                fsDirClose(&dir);
+            }
+
+            /* Walking the whole tree takes about as long as building, so the romfs folder's timestamps stand in for its contents. */
+            /* NOTE: Replacing the folder changes them, but overwriting files within it may not; deleting the cache file forces a rebuild. */
+            {
+                char path[EntryNameLengthMax + 1];
+                mitm::fs::FormatAtmosphereSdPath(path, sizeof(path), program_id, "romfs");
+
+                FsTimeStampRaw time_stamp;
+                if (R_SUCCEEDED(fsFsGetFileTimeStampRaw(&sd_filesystem, path, &time_stamp)) && time_stamp.is_valid) {
+                    UpdateWithSection(generator, FingerprintSection_TimeStamp);
+                    generator->Update(std::addressof(time_stamp.created), sizeof(time_stamp.created));
+                    generator->Update(std::addressof(time_stamp.modified), sizeof(time_stamp.modified));
+                    return;
+                }
+            }
+
+            /* If the sd card can't give us timestamps, hash the tree. */
+            auto hasher = std::make_unique<SdTreeHasher>(generator, &sd_filesystem, program_id);
+            hasher->HashDirectory(0);
+        }
+
+        void UpdateWithStorage(crypto::Sha256Generator *generator, IStorage *storage, u8 *buffer, s64 offset, s64 size) {
+            while (size > 0) {
+                const size_t cur_size = static_cast<size_t>(std::min<s64>(size, TableReadBufferSize));
+                R_ABORT_UNLESS(storage->Read(offset, buffer, cur_size));
+                generator->Update(buffer, cur_size);
+
+                offset += cur_size;
+                size   -= cur_size;
+            }
+        }
+
+        void UpdateWithRomfsTables(crypto::Sha256Generator *generator, IStorage *storage) {
+            /* Only the header and the entry tables affect the build, as file data is referenced by offset. */
+            Header header;
+            R_ABORT_UNLESS(storage->Read(0, &header, sizeof(Header)));
+            AMS_ABORT_UNLESS(header.header_size == sizeof(Header));
+            generator->Update(std::addressof(header), sizeof(header));
+
+            auto buffer = std::make_unique<u8[]>(TableReadBufferSize);
+            UpdateWithStorage(generator, storage, buffer.get(), header.dir_table_ofs, header.dir_table_size);
+            UpdateWithStorage(generator, storage, buffer.get(), header.file_table_ofs, header.file_table_size);
+        }
+
+    }
+
+    void CalculateBuildFingerprint(BuildFingerprint *out, ncm::ProgramId program_id, bool add_sd_files, IStorage *file_romfs, IStorage *storage_romfs) {
+        crypto::Sha256Generator generator;
+        generator.Initialize();
+
+        /* Include the cache version, so that changes to the build process invalidate existing caches. */
+        const u32 version = BuildCacheVersion;
+        generator.Update(std::addressof(version), sizeof(version));
+
+        /* Hash the sources in the order the builder adds them, as earlier sources take priority. */
+        if (add_sd_files) {
+            UpdateWithSection(std::addressof(generator), FingerprintSection_SdFiles);
+            UpdateWithSdFiles(std::addressof(generator), program_id);
+        }
+        if (file_romfs != nullptr) {
+            UpdateWithSection(std::addressof(generator), FingerprintSection_FileRomfs);
+            UpdateWithRomfsTables(std::addressof(generator), file_romfs);
+        }
+        if (storage_romfs != nullptr) {
+            UpdateWithSection(std::addressof(generator), FingerprintSection_StorageRomfs);
+            UpdateWithRomfsTables(std::addressof(generator), storage_romfs);
+        }
+
+        generator.GetHash(out->hash, sizeof(out->hash));
+    }
+
+    bool LoadBuildCache(std::vector<SourceInfo> *out_infos, TimeSpan *out_build_time, ncm::ProgramId program_id, const BuildFingerprint &fingerprint) {
+        /* Open the cache file. */
+        FsFile file;
+        if (R_FAILED(mitm::fs::OpenAtmosphereSdFile(&file, program_id, BuildCacheFileName, OpenMode_Read))) {
+            return false;
+        }
+        ON_SCOPE_EXIT { fsFileClose(&file); };
+
+        /* Read and validate the header. */
+        BuildCacheHeader header;
+        u64 read_size = 0;
+        if (R_FAILED(fsFileRead(&file, 0, &header, sizeof(header), FsReadOption_None, &read_size)) || read_size != sizeof(header)) {
+            return false;
+        }
+        if (header.magic != BuildCacheMagic || header.version != BuildCacheVersion || header.num_source_infos == 0) {
+            return false;
+        }
+        if (std::memcmp(std::addressof(header.fingerprint), std::addressof(fingerprint), sizeof(fingerprint)) != 0) {
+            return false;
+        }
+
+        /* Read and validate the body. */
+        const size_t body_size = sizeof(BuildCacheSourceInfo) * header.num_source_infos + header.data_size;
+        s64 file_size = 0;
+        if (R_FAILED(fsFileGetSize(&file, &file_size)) || static_cast<u64>(file_size) != sizeof(header) + body_size) {
+            return false;
+        }
+
+        u8 *body = static_cast<u8 *>(std::malloc(body_size));
+        if (body == nullptr) {
+            return false;
+        }
+        ON_SCOPE_EXIT { std::free(body); };
+
+        if (R_FAILED(fsFileRead(&file, sizeof(header), body, body_size, FsReadOption_None, &read_size)) || read_size != body_size) {
+            return false;
+        }
+
+        u8 body_hash[crypto::Sha256Generator::HashSize];
+        crypto::GenerateSha256Hash(body_hash, sizeof(body_hash), body, body_size);
+        if (std::memcmp(body_hash, header.body_hash, sizeof(body_hash)) != 0) {
+            return false;
+        }
+
+        /* Open the metadata file that the cache refers to. */
+        FsFile metadata_file;
+        if (R_FAILED(mitm::fs::OpenAtmosphereSdFile(&metadata_file, program_id, MetadataFileName, OpenMode_Read))) {
+            return false;
+        }
+        auto metadata_guard = SCOPE_GUARD { fsFileClose(&metadata_file); };
+
+        s64 metadata_size = 0;
+        if (R_FAILED(fsFileGetSize(&metadata_file, &metadata_size)) || metadata_size != header.metadata_size) {
+            return false;
+        }
+
+        /* Reconstruct the source infos. */
+        const BuildCacheSourceInfo *cache_infos = reinterpret_cast<const BuildCacheSourceInfo *>(body);
+        const u8 *data = reinterpret_cast<const u8 *>(cache_infos + header.num_source_infos);
+
+        out_infos->clear();
+        auto infos_guard = SCOPE_GUARD {
+            for (auto &info : *out_infos) {
+                info.Cleanup();
+            }
+            out_infos->clear();
+        };
+
+        bool has_metadata = false;
+        for (u32 i = 0; i < header.num_source_infos; i++) {
+            const auto &cache_info = cache_infos[i];
+
+            /* Validate the info. */
+            if (i > 0 && cache_info.virtual_offset < cache_infos[i - 1].virtual_offset) {
+                return false;
+            }
+            if (cache_info.data_size > 0 && (cache_info.value < 0 || static_cast<u64>(cache_info.value) + cache_info.data_size > header.data_size)) {
+                return false;
+            }
+
+            const auto source_type = static_cast<DataSourceType>(cache_info.source_type);
+            switch (source_type) {
+                case DataSourceType::Storage:
+                case DataSourceType::File:
+                    out_infos->emplace_back(cache_info.virtual_offset, cache_info.size, source_type, cache_info.value);
+                    break;
+                case DataSourceType::LooseSdFile:
+                    {
+                        if (cache_info.data_size == 0 || data[cache_info.value + cache_info.data_size - 1] != '\x00') {
+                            return false;
+                        }
+
+                        char *path = new char[cache_info.data_size];
+                        std::memcpy(path, data + cache_info.value, cache_info.data_size);
+                        out_infos->emplace_back(cache_info.virtual_offset, cache_info.size, source_type, path);
+                    }
+                    break;
+                case DataSourceType::Memory:
+                    {
+                        if (cache_info.size != static_cast<s64>(cache_info.data_size)) {
+                            return false;
+                        }
+
+                        void *memory = std::malloc(cache_info.data_size);
+                        if (memory == nullptr) {
+                            return false;
+                        }
+                        std::memcpy(memory, data + cache_info.value, cache_info.data_size);
+                        out_infos->emplace_back(cache_info.virtual_offset, cache_info.size, source_type, memory);
+                    }
+                    break;
+                case DataSourceType::Metadata:
+                    {
+                        if (has_metadata || cache_info.size != metadata_size) {
+                            return false;
+                        }
+
+                        metadata_guard.Cancel();
+                        out_infos->emplace_back(cache_info.virtual_offset, cache_info.size, source_type, new RemoteFile(metadata_file));
+                        has_metadata = true;
+                    }
+                    break;
+                default:
+                    return false;
+            }
+        }
+
+        if (!has_metadata) {
+            return false;
+        }
+
+        infos_guard.Cancel();
+        *out_build_time = TimeSpan::FromNanoSeconds(header.build_time);
+        return true;
+    }
+
+    void SaveBuildCache(ncm::ProgramId program_id, const BuildFingerprint &fingerprint, const std::vector<SourceInfo> &infos, TimeSpan build_time) {
+        /* Determine how much data we need to save alongside the infos. */
+        size_t data_size = 0;
+        s64 metadata_size = -1;
+        for (const auto &info : infos) {
+            switch (info.source_type) {
+                case DataSourceType::Storage:
+                case DataSourceType::File:
+                    break;
+                case DataSourceType::LooseSdFile:
+                    data_size += std::strlen(info.loose_source_info.path) + 1;
+                    break;
+                case DataSourceType::Memory:
+                    data_size += info.size;
+                    break;
+                case DataSourceType::Metadata:
+                    /* The only metadata source is the metadata file written by the builder. */
+                    AMS_ABORT_UNLESS(metadata_size < 0);
+                    metadata_size = info.size;
+                    break;
+                AMS_UNREACHABLE_DEFAULT_CASE();
+            }
+        }
+
+        if (metadata_size < 0 || data_size > std::numeric_limits<u32>::max() || infos.size() > std::numeric_limits<u32>::max()) {
+            return;
+        }
+
+        /* Allocate a buffer for the cache file. */
+        const size_t body_size = sizeof(BuildCacheSourceInfo) * infos.size() + data_size;
+        const size_t file_size = sizeof(BuildCacheHeader) + body_size;
+        u8 *buffer = static_cast<u8 *>(std::malloc(file_size));
+        if (buffer == nullptr) {
+            return;
+        }
+        ON_SCOPE_EXIT { std::free(buffer); };
+
+        /* Serialize the infos. */
+        BuildCacheHeader *header = reinterpret_cast<BuildCacheHeader *>(buffer);
+        BuildCacheSourceInfo *cache_infos = reinterpret_cast<BuildCacheSourceInfo *>(header + 1);
+        u8 *data = reinterpret_cast<u8 *>(cache_infos + infos.size());
+
+        size_t data_offset = 0;
+        for (size_t i = 0; i < infos.size(); i++) {
+            const auto &info = infos[i];
+            auto &cache_info = cache_infos[i];
+
+            cache_info.virtual_offset = info.virtual_offset;
+            cache_info.size           = info.size;
+            cache_info.value          = 0;
+            cache_info.source_type    = static_cast<u32>(info.source_type);
+            cache_info.data_size      = 0;
+
+            switch (info.source_type) {
+                case DataSourceType::Storage:
+                    cache_info.value = info.storage_source_info.offset;
+                    break;
+                case DataSourceType::File:
+                    cache_info.value = info.file_source_info.offset;
+                    break;
+                case DataSourceType::LooseSdFile:
+                    cache_info.value     = data_offset;
+                    cache_info.data_size = std::strlen(info.loose_source_info.path) + 1;
+                    std::memcpy(data + data_offset, info.loose_source_info.path, cache_info.data_size);
+                    break;
+                case DataSourceType::Memory:
+                    cache_info.value     = data_offset;
+                    cache_info.data_size = info.size;
+                    std::memcpy(data + data_offset, info.memory_source_info.data, cache_info.data_size);
+                    break;
+                case DataSourceType::Metadata:
+                    break;
+                AMS_UNREACHABLE_DEFAULT_CASE();
+            }
+
+            data_offset += cache_info.data_size;
+        }
+
+        /* Set the header. */
+        header->magic            = BuildCacheMagic;
+        header->version          = BuildCacheVersion;
+        header->fingerprint      = fingerprint;
+        header->build_time       = build_time.GetNanoSeconds();
+        header->metadata_size    = metadata_size;
+        header->num_source_infos = static_cast<u32>(infos.size());
+        header->data_size        = static_cast<u32>(data_size);
+        crypto::GenerateSha256Hash(header->body_hash, sizeof(header->body_hash), cache_infos, body_size);
+
+        /* Save the cache. Failure here only means that the next boot will have to build again. */
+        FsFile file;
+        if (R_SUCCEEDED(mitm::fs::SaveAtmosphereSdFile(&file, program_id, BuildCacheFileName, buffer, file_size))) {
+            fsFileClose(&file);
+        }
+    }
+
+    void InvalidateBuildCache(ncm::ProgramId program_id) {
+        /* Don't check the result, as the cache may not exist. */
+        mitm::fs::DeleteAtmosphereSdFile(program_id, BuildCacheFileName);
+    }
+
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <stratosphere.hpp>
+#include "fsmitm_romfs.hpp"
+
+namespace ams::mitm::fs::romfs {
+
+    /* Identifies the inputs to a romfs build: the sd romfs folder's timestamps, and the tables of any base romfs images. */
+    struct BuildFingerprint {
+        u8 hash[crypto::Sha256Generator::HashSize];
+    };
+
+    void CalculateBuildFingerprint(BuildFingerprint *out, ncm::ProgramId program_id, bool add_sd_files, ams::fs::IStorage *file_romfs, ams::fs::IStorage *storage_romfs);
+
+    /* The build cache refers to the metadata file written by Builder::Build, and must be invalidated before that file is rewritten. */
+    bool LoadBuildCache(std::vector<SourceInfo> *out_infos, TimeSpan *out_build_time, ncm::ProgramId program_id, const BuildFingerprint &fingerprint);
+    void SaveBuildCache(ncm::ProgramId program_id, const BuildFingerprint &fingerprint, const std::vector<SourceInfo> &infos, TimeSpan build_time);
+    void InvalidateBuildCache(ncm::ProgramId program_id);
+
+}
@@ -365,6 +365,10 @@ namespace ams::settings::fwdbg {
             /* 0 = Disabled, 1 = Enabled */
             R_ABORT_UNLESS(ParseSettingsItemValue("atmosphere", "enable_dns_mitm_debug_log", "u8!0x0"));
 
+            /* Controls the maximum time, in seconds, for which dns.mitm caches answers from the real resolver. */
+            /* 0 = Disabled, Other = Maximum TTL in seconds */
+            R_ABORT_UNLESS(ParseSettingsItemValue("atmosphere", "dns_mitm_cache_max_ttl", "u32!0x3C"));
+
             /* Controls whether htc is enabled. */
             /* TODO: Change this to default 1 when tma2 is ready for inclusion in atmosphere releases. */
             /* 0 = Disabled, 1 = Enabled */
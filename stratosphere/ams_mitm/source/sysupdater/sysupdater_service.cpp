@@ -469,6 +469,23 @@ namespace ams::mitm::sysupdater {
         return ResultSuccess();
     }
 
+    Result SystemUpdateService::GetPrepareUpdatePipelineThroughput(sf::Out<SystemUpdatePipelineThroughput> out) {
+        /* Ensure the update is setup. */
+        R_UNLESS(this->setup_update, ns::ResultCardUpdateNotSetup());
+
+        /* Get the throughput of each stage. */
+        const auto throughput = this->update_task->GetPipelineThroughput();
+        out.SetValue({
+            .read_size  = throughput.read.installed,
+            .write_size = throughput.write.installed,
+            .hash_size  = throughput.hash.installed,
+            .read_time  = throughput.read.elapsed_time,
+            .write_time = throughput.write.elapsed_time,
+            .hash_time  = throughput.hash.elapsed_time,
+        });
+        return ResultSuccess();
+    }
+
     Result SystemUpdateService::SetupUpdateImpl(os::ManagedHandle transfer_memory, u64 transfer_memory_size, const ncm::Path &path, bool exfat, ncm::FirmwareVariationId firmware_variation_id) {
         /* Ensure we don't already have an update set up. */
         R_UNLESS(!this->setup_update, ns::ResultCardUpdateAlreadySetup());
@@ -515,6 +532,10 @@ namespace ams::mitm::sysupdater {
         this->update_task.emplace();
         R_TRY(this->update_task->Initialize(package_root.str, context_path, tmem_buffer, tmem_buffer_size, exfat, firmware_variation_id));
 
+        /* Overlap reading the package from the sd card with writing (and hashing) its contents. */
+        this->update_task->SetPipelinedInstallEnabled(true);
+        this->update_task->SetMaxParallelContentCount(2);
+
         /* We successfully setup the update. */
         tmem_guard.Cancel();
 
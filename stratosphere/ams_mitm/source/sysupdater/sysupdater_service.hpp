@@ -38,17 +38,29 @@ namespace ams::mitm::sysupdater {
         s64 total_size;
     };
 
+    /* Bytes handled by each stage of the update's install pipeline, and the time each stage spent working. */
+    struct SystemUpdatePipelineThroughput {
+        s64 read_size;
+        s64 write_size;
+        s64 hash_size;
+        TimeSpanType read_time;
+        TimeSpanType write_time;
+        TimeSpanType hash_time;
+    };
+    static_assert(util::is_pod<SystemUpdatePipelineThroughput>::value);
+
 }
 
-#define AMS_SYSUPDATER_SYSTEM_UPDATE_INTERFACE_INFO(C, H)                                                                                                                                                                                                                                                                  \
-    AMS_SF_METHOD_INFO(C, H, 0, Result, GetUpdateInformation,     (sf::Out<mitm::sysupdater::UpdateInformation> out, const ncm::Path &path),                                                                                                  (out, path))                                                                 \
-    AMS_SF_METHOD_INFO(C, H, 1, Result, ValidateUpdate,           (sf::Out<Result> out_validate_result, sf::Out<Result> out_validate_exfat_result, sf::Out<mitm::sysupdater::UpdateValidationInfo> out_validate_info, const ncm::Path &path), (out_validate_result, out_validate_exfat_result, out_validate_info, path))   \
-    AMS_SF_METHOD_INFO(C, H, 2, Result, SetupUpdate,              (sf::CopyHandle transfer_memory, u64 transfer_memory_size, const ncm::Path &path, bool exfat),                                                                              (transfer_memory, transfer_memory_size, path, exfat))                        \
-    AMS_SF_METHOD_INFO(C, H, 3, Result, SetupUpdateWithVariation, (sf::CopyHandle transfer_memory, u64 transfer_memory_size, const ncm::Path &path, bool exfat, ncm::FirmwareVariationId firmware_variation_id),                              (transfer_memory, transfer_memory_size, path, exfat, firmware_variation_id)) \
-    AMS_SF_METHOD_INFO(C, H, 4, Result, RequestPrepareUpdate,     (sf::OutCopyHandle out_event_handle, sf::Out<sf::SharedPointer<ns::impl::IAsyncResult>> out_async),                                                                         (out_event_handle, out_async))                                               \
-    AMS_SF_METHOD_INFO(C, H, 5, Result, GetPrepareUpdateProgress, (sf::Out<mitm::sysupdater::SystemUpdateProgress> out),                                                                                                                      (out))                                                                       \
-    AMS_SF_METHOD_INFO(C, H, 6, Result, HasPreparedUpdate,        (sf::Out<bool> out),                                                                                                                                                        (out))                                                                       \
-    AMS_SF_METHOD_INFO(C, H, 7, Result, ApplyPreparedUpdate,      (),                                                                                                                                                                         ())
+#define AMS_SYSUPDATER_SYSTEM_UPDATE_INTERFACE_INFO(C, H)                                                                                                                                                                                                                                                                               \
+    AMS_SF_METHOD_INFO(C, H, 0, Result, GetUpdateInformation,               (sf::Out<mitm::sysupdater::UpdateInformation> out, const ncm::Path &path),                                                                                                  (out, path))                                                                 \
+    AMS_SF_METHOD_INFO(C, H, 1, Result, ValidateUpdate,                     (sf::Out<Result> out_validate_result, sf::Out<Result> out_validate_exfat_result, sf::Out<mitm::sysupdater::UpdateValidationInfo> out_validate_info, const ncm::Path &path), (out_validate_result, out_validate_exfat_result, out_validate_info, path))   \
+    AMS_SF_METHOD_INFO(C, H, 2, Result, SetupUpdate,                        (sf::CopyHandle transfer_memory, u64 transfer_memory_size, const ncm::Path &path, bool exfat),                                                                              (transfer_memory, transfer_memory_size, path, exfat))                        \
+    AMS_SF_METHOD_INFO(C, H, 3, Result, SetupUpdateWithVariation,           (sf::CopyHandle transfer_memory, u64 transfer_memory_size, const ncm::Path &path, bool exfat, ncm::FirmwareVariationId firmware_variation_id),                              (transfer_memory, transfer_memory_size, path, exfat, firmware_variation_id)) \
+    AMS_SF_METHOD_INFO(C, H, 4, Result, RequestPrepareUpdate,               (sf::OutCopyHandle out_event_handle, sf::Out<sf::SharedPointer<ns::impl::IAsyncResult>> out_async),                                                                         (out_event_handle, out_async))                                               \
+    AMS_SF_METHOD_INFO(C, H, 5, Result, GetPrepareUpdateProgress,           (sf::Out<mitm::sysupdater::SystemUpdateProgress> out),                                                                                                                      (out))                                                                       \
+    AMS_SF_METHOD_INFO(C, H, 6, Result, HasPreparedUpdate,                  (sf::Out<bool> out),                                                                                                                                                        (out))                                                                       \
+    AMS_SF_METHOD_INFO(C, H, 7, Result, ApplyPreparedUpdate,                (),                                                                                                                                                                         ())                                                                          \
+    AMS_SF_METHOD_INFO(C, H, 8, Result, GetPrepareUpdatePipelineThroughput, (sf::Out<mitm::sysupdater::SystemUpdatePipelineThroughput> out),                                                                                                            (out))
 
 AMS_SF_DEFINE_INTERFACE(ams::mitm::sysupdater::impl, ISystemUpdateInterface, AMS_SYSUPDATER_SYSTEM_UPDATE_INTERFACE_INFO)
 
@@ -75,6 +87,7 @@ namespace ams::mitm::sysupdater {
             Result GetPrepareUpdateProgress(sf::Out<SystemUpdateProgress> out);
             Result HasPreparedUpdate(sf::Out<bool> out);
             Result ApplyPreparedUpdate();
+            Result GetPrepareUpdatePipelineThroughput(sf::Out<SystemUpdatePipelineThroughput> out);
     };
     static_assert(impl::IsISystemUpdateInterface<SystemUpdateService>);
 
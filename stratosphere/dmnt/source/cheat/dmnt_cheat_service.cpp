@@ -48,6 +48,14 @@ namespace ams::dmnt::cheat {
         return dmnt::cheat::impl::ResumeCheatProcess();
     }
 
+    Result CheatService::GetCheatVmSchedule(sf::Out<u32> out_executions_per_second, sf::Out<u32> out_mode) {
+        return dmnt::cheat::impl::GetCheatVmSchedule(out_executions_per_second.GetPointer(), out_mode.GetPointer());
+    }
+
+    Result CheatService::SetCheatVmSchedule(u32 executions_per_second, u32 mode) {
+        return dmnt::cheat::impl::SetCheatVmSchedule(executions_per_second, mode);
+    }
+
     /* ========================================================================================= */
     /* ===================================  Memory Commands  =================================== */
     /* ========================================================================================= */
@@ -145,4 +153,42 @@ namespace ams::dmnt::cheat {
         return dmnt::cheat::impl::DisableFrozenAddress(address);
     }
 
+    Result CheatService::GetFrozenAddressWriteStatistics(sf::Out<FrozenAddressWriteStatistics> out_statistics) {
+        return dmnt::cheat::impl::GetFrozenAddressWriteStatistics(out_statistics.GetPointer());
+    }
+
+    /* ========================================================================================= */
+    /* ===================================  Search Commands  =================================== */
+    /* ========================================================================================= */
+
+    Result CheatService::StartCheatSearch(sf::Out<u64> out_count, const CheatSearchParameters &params) {
+        return dmnt::cheat::impl::StartCheatSearch(out_count.GetPointer(), params);
+    }
+
+    Result CheatService::ContinueCheatSearch(sf::Out<u64> out_count, const CheatSearchParameters &params) {
+        return dmnt::cheat::impl::ContinueCheatSearch(out_count.GetPointer(), params);
+    }
+
+    Result CheatService::GetCheatSearchStatus(sf::Out<CheatSearchStatus> out_status) {
+        return dmnt::cheat::impl::GetCheatSearchStatus(out_status.GetPointer());
+    }
+
+    Result CheatService::GetCheatSearchResults(const sf::OutArray<CheatSearchResult> &results, sf::Out<u64> out_count, u64 offset) {
+        R_UNLESS(results.GetPointer() != nullptr, ResultCheatNullBuffer());
+        return dmnt::cheat::impl::GetCheatSearchResults(results.GetPointer(), results.GetSize(), out_count.GetPointer(), offset);
+    }
+
+    Result CheatService::ResetCheatSearch() {
+        return dmnt::cheat::impl::ResetCheatSearch();
+    }
+
+    Result CheatService::StartCheatPointerSearch(sf::Out<u64> out_count, const CheatPointerSearchParameters &params) {
+        return dmnt::cheat::impl::StartCheatPointerSearch(out_count.GetPointer(), params);
+    }
+
+    Result CheatService::GetCheatPointerSearchResults(const sf::OutArray<CheatPointerPath> &paths, sf::Out<u64> out_count, u64 offset) {
+        R_UNLESS(paths.GetPointer() != nullptr, ResultCheatNullBuffer());
+        return dmnt::cheat::impl::GetCheatPointerSearchResults(paths.GetPointer(), paths.GetSize(), out_count.GetPointer(), offset);
+    }
+
 }
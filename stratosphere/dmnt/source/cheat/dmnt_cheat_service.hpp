@@ -24,6 +24,8 @@
     AMS_SF_METHOD_INFO(C, H, 65003, Result, ForceOpenCheatProcess,       (),                                                                                                   ())                             \
     AMS_SF_METHOD_INFO(C, H, 65004, Result, PauseCheatProcess,           (),                                                                                                   ())                             \
     AMS_SF_METHOD_INFO(C, H, 65005, Result, ResumeCheatProcess,          (),                                                                                                   ())                             \
+    AMS_SF_METHOD_INFO(C, H, 65006, Result, GetCheatVmSchedule,          (sf::Out<u32> out_executions_per_second, sf::Out<u32> out_mode),                                      (out_executions_per_second, out_mode)) \
+    AMS_SF_METHOD_INFO(C, H, 65007, Result, SetCheatVmSchedule,          (u32 executions_per_second, u32 mode),                                                                (executions_per_second, mode))  \
     AMS_SF_METHOD_INFO(C, H, 65100, Result, GetCheatProcessMappingCount, (sf::Out<u64> out_count),                                                                             (out_count))                    \
     AMS_SF_METHOD_INFO(C, H, 65101, Result, GetCheatProcessMappings,     (const sf::OutArray<MemoryInfo> &mappings, sf::Out<u64> out_count, u64 offset),                       (mappings, out_count, offset))  \
     AMS_SF_METHOD_INFO(C, H, 65102, Result, ReadCheatProcessMemory,      (const sf::OutBuffer &buffer, u64 address, u64 out_size),                                             (buffer, address, out_size))    \
@@ -42,7 +44,15 @@
     AMS_SF_METHOD_INFO(C, H, 65301, Result, GetFrozenAddresses,          (const sf::OutArray<dmnt::cheat::FrozenAddressEntry> &addresses, sf::Out<u64> out_count, u64 offset), (addresses, out_count, offset)) \
     AMS_SF_METHOD_INFO(C, H, 65302, Result, GetFrozenAddress,            (sf::Out<dmnt::cheat::FrozenAddressEntry> entry, u64 address),                                        (entry, address))               \
     AMS_SF_METHOD_INFO(C, H, 65303, Result, EnableFrozenAddress,         (sf::Out<u64> out_value, u64 address, u64 width),                                                     (out_value, address, width))    \
-    AMS_SF_METHOD_INFO(C, H, 65304, Result, DisableFrozenAddress,        (u64 address),                                                                                        (address))
+    AMS_SF_METHOD_INFO(C, H, 65304, Result, DisableFrozenAddress,        (u64 address),                                                                                        (address))                      \
+    AMS_SF_METHOD_INFO(C, H, 65305, Result, GetFrozenAddressWriteStatistics, (sf::Out<dmnt::cheat::FrozenAddressWriteStatistics> out_statistics),                           (out_statistics))               \
+    AMS_SF_METHOD_INFO(C, H, 65400, Result, StartCheatSearch,            (sf::Out<u64> out_count, const dmnt::cheat::CheatSearchParameters &params),                           (out_count, params))            \
+    AMS_SF_METHOD_INFO(C, H, 65401, Result, ContinueCheatSearch,         (sf::Out<u64> out_count, const dmnt::cheat::CheatSearchParameters &params),                           (out_count, params))            \
+    AMS_SF_METHOD_INFO(C, H, 65402, Result, GetCheatSearchStatus,        (sf::Out<dmnt::cheat::CheatSearchStatus> out_status),                                                 (out_status))                   \
+    AMS_SF_METHOD_INFO(C, H, 65403, Result, GetCheatSearchResults,       (const sf::OutArray<dmnt::cheat::CheatSearchResult> &results, sf::Out<u64> out_count, u64 offset),    (results, out_count, offset))   \
+    AMS_SF_METHOD_INFO(C, H, 65404, Result, ResetCheatSearch,            (),                                                                                                   ())                             \
+    AMS_SF_METHOD_INFO(C, H, 65405, Result, StartCheatPointerSearch,     (sf::Out<u64> out_count, const dmnt::cheat::CheatPointerSearchParameters &params),                    (out_count, params))            \
+    AMS_SF_METHOD_INFO(C, H, 65406, Result, GetCheatPointerSearchResults, (const sf::OutArray<dmnt::cheat::CheatPointerPath> &paths, sf::Out<u64> out_count, u64 offset),      (paths, out_count, offset))
 
 AMS_SF_DEFINE_INTERFACE(ams::dmnt::cheat::impl, ICheatInterface, AMS_DMNT_I_CHEAT_INTERFACE_INTERFACE_INFO)
 
@@ -56,6 +66,8 @@ namespace ams::dmnt::cheat {
             Result ForceOpenCheatProcess();
             Result PauseCheatProcess();
             Result ResumeCheatProcess();
+            Result GetCheatVmSchedule(sf::Out<u32> out_executions_per_second, sf::Out<u32> out_mode);
+            Result SetCheatVmSchedule(u32 executions_per_second, u32 mode);
 
             Result GetCheatProcessMappingCount(sf::Out<u64> out_count);
             Result GetCheatProcessMappings(const sf::OutArray<MemoryInfo> &mappings, sf::Out<u64> out_count, u64 offset);
@@ -78,6 +90,15 @@ namespace ams::dmnt::cheat {
             Result GetFrozenAddress(sf::Out<FrozenAddressEntry> entry, u64 address);
             Result EnableFrozenAddress(sf::Out<u64> out_value, u64 address, u64 width);
             Result DisableFrozenAddress(u64 address);
+            Result GetFrozenAddressWriteStatistics(sf::Out<FrozenAddressWriteStatistics> out_statistics);
+
+            Result StartCheatSearch(sf::Out<u64> out_count, const CheatSearchParameters &params);
+            Result ContinueCheatSearch(sf::Out<u64> out_count, const CheatSearchParameters &params);
+            Result GetCheatSearchStatus(sf::Out<CheatSearchStatus> out_status);
+            Result GetCheatSearchResults(const sf::OutArray<CheatSearchResult> &results, sf::Out<u64> out_count, u64 offset);
+            Result ResetCheatSearch();
+            Result StartCheatPointerSearch(sf::Out<u64> out_count, const CheatPointerSearchParameters &params);
+            Result GetCheatPointerSearchResults(const sf::OutArray<CheatPointerPath> &paths, sf::Out<u64> out_count, u64 offset);
     };
     static_assert(impl::IsICheatInterface<CheatService>);
 
@@ -16,6 +16,7 @@
 #include <stratosphere.hpp>
 #include "dmnt_cheat_api.hpp"
 #include "dmnt_cheat_vm.hpp"
+#include "dmnt_cheat_search.hpp"
 #include "dmnt_cheat_debug_events_manager.hpp"
 
 namespace ams::dmnt::cheat::impl {
@@ -78,10 +79,84 @@ namespace ams::dmnt::cheat::impl {
 
         using FrozenAddressMap = typename util::IntrusiveRedBlackTreeBaseTraits<FrozenAddressMapEntry>::TreeType<FrozenAddressMapEntry>;
 
+        /* Plan for writing all frozen addresses, with contiguous values within a page coalesced into a single write. */
+        class FrozenAddressWritePlan {
+            private:
+                struct Range {
+                    u64 address;
+                    u32 offset;
+                    u32 size;
+                };
+            private:
+                Range ranges[MaxFrozenAddressCount] = {};
+                u8 data[MaxFrozenAddressCount * sizeof(FrozenAddressValue::value)] = {};
+                size_t num_ranges = 0;
+                size_t num_entries = 0;
+                bool valid = false;
+            public:
+                constexpr FrozenAddressWritePlan() = default;
+
+                void Invalidate() { this->valid = false; }
+                bool IsValid() const { return this->valid; }
+
+                size_t GetEntryCount() const { return this->num_entries; }
+                size_t GetWriteCount() const { return this->num_ranges; }
+
+                void Build(const FrozenAddressMap &map) {
+                    this->num_ranges  = 0;
+                    this->num_entries = 0;
+
+                    size_t data_size = 0;
+                    for (const auto &entry : map) {
+                        const u64 address = entry.GetAddress();
+                        const auto &value = entry.GetValue();
+                        const size_t width = std::min<size_t>(value.width, sizeof(value.value));
+
+                        this->num_entries++;
+                        if (width == 0) {
+                            continue;
+                        }
+
+                        /* The map is ordered, so we can only ever extend the last range. */
+                        const u64 page = util::AlignDown(address, os::MemoryPageSize);
+                        Range *range = this->num_ranges > 0 ? std::addressof(this->ranges[this->num_ranges - 1]) : nullptr;
+                        if (range != nullptr && address <= range->address + range->size && util::AlignDown(range->address, os::MemoryPageSize) == page && util::AlignDown(address + width - 1, os::MemoryPageSize) == page) {
+                            /* Later values overwrite earlier ones where they overlap, as writing them in order would. */
+                            const size_t range_offset = address - range->address;
+                            std::memcpy(this->data + range->offset + range_offset, &value.value, width);
+
+                            range->size = std::max<size_t>(range->size, range_offset + width);
+                            data_size   = range->offset + range->size;
+                        } else {
+                            range = std::addressof(this->ranges[this->num_ranges++]);
+                            range->address = address;
+                            range->offset  = data_size;
+                            range->size    = width;
+                            std::memcpy(this->data + data_size, &value.value, width);
+
+                            data_size += width;
+                        }
+                    }
+
+                    this->valid = true;
+                }
+
+                void Write(Handle debug_handle) const {
+                    for (size_t i = 0; i < this->num_ranges; i++) {
+                        const auto &range = this->ranges[i];
+                        svcWriteDebugProcessMemory(debug_handle, this->data + range.offset, range.address, range.size);
+                    }
+                }
+        };
+
         /* Manager class. */
         class CheatProcessManager {
             private:
                 static constexpr size_t ThreadStackSize = 0x4000;
+
+                static constexpr u32 FramesPerSecond              = 60;
+                static constexpr u32 DefaultVmExecutionsPerSecond = 12;
+                static constexpr u32 MaxVmExecutionsPerSecond     = FramesPerSecond;
             private:
                 os::Mutex cheat_lock;
                 os::Event unsafe_break_event;
@@ -92,15 +167,28 @@ namespace ams::dmnt::cheat::impl {
                 CheatProcessMetadata cheat_process_metadata = {};
 
                 os::ThreadType vm_thread;
-                bool broken_unsafe = false;
+                std::atomic<bool> broken_unsafe = false;
                 bool needs_reload_vm = false;
+                u32 vm_executions_per_second = DefaultVmExecutionsPerSecond;
+                CheatVmScheduleMode vm_schedule_mode = CheatVmScheduleMode_Periodic;
+                os::Event vm_wake_event; /* Autoclear. */
+
+                /* NOTE: Lock ordering is cheat_lock -> search_lock -> vm_lock -> frozen_address_lock. */
+                /* The vm thread executes holding only vm_lock, so that it never stalls ipc on cheat_lock. */
+                /* Searches likewise run holding only search_lock. */
+                os::SdkMutex vm_lock;
                 CheatVirtualMachine cheat_vm;
+                os::SdkMutex frozen_address_lock;
+                os::SdkMutex search_lock;
+                CheatSearchEngine search_engine;
 
                 bool enable_cheats_by_default = true;
                 bool always_save_cheat_toggles = false;
                 bool should_save_cheat_toggles = false;
                 CheatEntry cheat_entries[MaxCheatCount] = {};
                 FrozenAddressMap frozen_addresses_map = {};
+                FrozenAddressWritePlan frozen_address_write_plan = {};
+                FrozenAddressWriteStatistics frozen_address_write_statistics = {};
 
                 alignas(os::MemoryPageSize) u8 detect_thread_stack[ThreadStackSize] = {};
                 alignas(os::MemoryPageSize) u8 debug_events_thread_stack[ThreadStackSize] = {};
@@ -124,8 +212,12 @@ namespace ams::dmnt::cheat::impl {
 
                 void SetNeedsReloadVm(bool reload) {
                     this->needs_reload_vm = reload;
-                }
 
+                    /* Wake the vm, so that changes take effect immediately. */
+                    if (reload) {
+                        this->vm_wake_event.Signal();
+                    }
+                }
 
                 void ResetCheatEntry(size_t i) {
                     if (i < MaxCheatCount) {
@@ -141,6 +233,7 @@ namespace ams::dmnt::cheat::impl {
                         this->ResetCheatEntry(i);
                     }
 
+                    std::scoped_lock vm_lk(this->vm_lock);
                     this->cheat_vm.ResetStaticRegisters();
                 }
 
@@ -183,9 +276,16 @@ namespace ams::dmnt::cheat::impl {
                         /* Knock out the debug events thread. */
                         os::CancelThreadSynchronization(std::addressof(this->debug_events_thread));
 
-                        /* Close resources. */
-                        R_ABORT_UNLESS(svc::CloseHandle(this->cheat_process_debug_handle));
-                        this->cheat_process_debug_handle = svc::InvalidHandle;
+                        /* Close resources, once the vm and any search are no longer using them. */
+                        {
+                            std::scoped_lock search_lk(this->search_lock);
+                            std::scoped_lock vm_lk(this->vm_lock);
+                            R_ABORT_UNLESS(svc::CloseHandle(this->cheat_process_debug_handle));
+                            this->cheat_process_debug_handle = svc::InvalidHandle;
+
+                            /* Search results are meaningless without the process. */
+                            this->search_engine.Reset();
+                        }
 
                         /* Save cheat toggles. */
                         if (this->always_save_cheat_toggles || this->should_save_cheat_toggles) {
@@ -200,14 +300,23 @@ namespace ams::dmnt::cheat::impl {
                         /* Clear cheat list. */
                         this->ResetAllCheatEntries();
 
+                        /* Reset the vm schedule. */
+                        this->vm_executions_per_second = DefaultVmExecutionsPerSecond;
+                        this->vm_schedule_mode         = CheatVmScheduleMode_Periodic;
+
                         /* Clear frozen addresses. */
                         {
+                            std::scoped_lock frz_lk(this->frozen_address_lock);
+
                             auto it = this->frozen_addresses_map.begin();
                             while (it != this->frozen_addresses_map.end()) {
                                 FrozenAddressMapEntry *entry = std::addressof(*it);
                                 it = this->frozen_addresses_map.erase(it);
                                 DeallocateFrozenAddress(entry);
                             }
+
+                            this->frozen_address_write_plan.Invalidate();
+                            this->frozen_address_write_statistics = {};
                         }
 
                         /* Signal to our fans. */
@@ -235,6 +344,12 @@ namespace ams::dmnt::cheat::impl {
                     return ResultSuccess();
                 }
 
+                Result EnsureCheatProcessForSearch() {
+                    /* Searches can take a while, so they only hold the cheat lock long enough to check the process. */
+                    std::scoped_lock lk(this->cheat_lock);
+                    return this->EnsureCheatProcess();
+                }
+
                 Handle GetCheatProcessHandle() const {
                     return this->cheat_process_debug_handle;
                 }
@@ -249,8 +364,31 @@ namespace ams::dmnt::cheat::impl {
                     R_ABORT_UNLESS(pm::dmnt::StartProcess(process_id));
                 }
 
+                void ApplyFrozenAddresses() {
+                    std::scoped_lock frz_lk(this->frozen_address_lock);
+
+                    /* Rebuild our plan, if the frozen addresses have changed. */
+                    if (!this->frozen_address_write_plan.IsValid()) {
+                        this->frozen_address_write_plan.Build(this->frozen_addresses_map);
+                    }
+
+                    /* Use Write SVC directly, to avoid the usual frozen address update logic. */
+                    const os::Tick start_tick = os::GetSystemTick();
+                    this->frozen_address_write_plan.Write(this->GetCheatProcessHandle());
+                    const os::Tick end_tick = os::GetSystemTick();
+
+                    /* Update statistics. */
+                    this->frozen_address_write_statistics.entry_count   = this->frozen_address_write_plan.GetEntryCount();
+                    this->frozen_address_write_statistics.write_count   = this->frozen_address_write_plan.GetWriteCount();
+                    this->frozen_address_write_statistics.write_time_ns = (end_tick - start_tick).ToTimeSpan().GetNanoSeconds();
+                    this->frozen_address_write_statistics.tick_count++;
+                }
+
+                os::Tick GetVmExecutionInterval(u32 executions_per_second) const {
+                    return os::Tick(os::GetSystemTickFrequency() / executions_per_second);
+                }
             public:
-                CheatProcessManager() : cheat_lock(false), unsafe_break_event(os::EventClearMode_ManualClear), debug_events_event(os::EventClearMode_AutoClear), cheat_process_event(os::EventClearMode_AutoClear, true) {
+                CheatProcessManager() : cheat_lock(false), unsafe_break_event(os::EventClearMode_ManualClear), debug_events_event(os::EventClearMode_AutoClear), cheat_process_event(os::EventClearMode_AutoClear, true), vm_wake_event(os::EventClearMode_AutoClear) {
                     /* Learn whether we should enable cheats by default. */
                     {
                         u8 en = 0;
@@ -308,6 +446,7 @@ namespace ams::dmnt::cheat::impl {
                 Result WriteCheatProcessMemoryUnsafe(u64 proc_addr, const void *data, size_t size) {
                     R_TRY(svcWriteDebugProcessMemory(this->GetCheatProcessHandle(), data, proc_addr, size));
 
+                    std::scoped_lock frz_lk(this->frozen_address_lock);
                     for (auto &entry : this->frozen_addresses_map) {
                         /* Get address/value. */
                         const u64 address = entry.GetAddress();
@@ -323,6 +462,7 @@ namespace ams::dmnt::cheat::impl {
                             const size_t offset = (address - proc_addr);
                             const size_t copy_size = std::min(sizeof(value.value), size - offset);
                             std::memcpy(&value.value, reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(data) + offset), copy_size);
+                            this->frozen_address_write_plan.Invalidate();
                         }
                     }
 
@@ -436,6 +576,31 @@ namespace ams::dmnt::cheat::impl {
                     return this->ResumeCheatProcessUnsafe();
                 }
 
+                Result GetCheatVmSchedule(u32 *out_executions_per_second, u32 *out_mode) {
+                    std::scoped_lock lk(this->cheat_lock);
+
+                    R_TRY(this->EnsureCheatProcess());
+
+                    *out_executions_per_second = this->vm_executions_per_second;
+                    *out_mode                  = this->vm_schedule_mode;
+                    return ResultSuccess();
+                }
+
+                Result SetCheatVmSchedule(u32 executions_per_second, u32 mode) {
+                    std::scoped_lock lk(this->cheat_lock);
+
+                    R_TRY(this->EnsureCheatProcess());
+                    R_UNLESS(0 < executions_per_second && executions_per_second <= MaxVmExecutionsPerSecond, ResultCheatInvalid());
+                    R_UNLESS(mode == CheatVmScheduleMode_Periodic || mode == CheatVmScheduleMode_FrameSynchronized, ResultCheatInvalid());
+
+                    this->vm_executions_per_second = executions_per_second;
+                    this->vm_schedule_mode         = static_cast<CheatVmScheduleMode>(mode);
+
+                    /* Wake the vm, so that it picks up the new schedule. */
+                    this->vm_wake_event.Signal();
+                    return ResultSuccess();
+                }
+
                 Result GetCheatCount(u64 *out_count) {
                     std::scoped_lock lk(this->cheat_lock);
 
@@ -543,6 +708,7 @@ namespace ams::dmnt::cheat::impl {
                     R_TRY(this->EnsureCheatProcess());
                     R_UNLESS(which < CheatVirtualMachine::NumStaticRegisters, ResultCheatInvalid());
 
+                    std::scoped_lock vm_lk(this->vm_lock);
                     *out = this->cheat_vm.GetStaticRegister(which);
                     return ResultSuccess();
                 }
@@ -553,6 +719,7 @@ namespace ams::dmnt::cheat::impl {
                     R_TRY(this->EnsureCheatProcess());
                     R_UNLESS(which < CheatVirtualMachine::NumStaticRegisters, ResultCheatInvalid());
 
+                    std::scoped_lock vm_lk(this->vm_lock);
                     this->cheat_vm.SetStaticRegister(which, value);
                     return ResultSuccess();
                 }
@@ -562,6 +729,7 @@ namespace ams::dmnt::cheat::impl {
 
                     R_TRY(this->EnsureCheatProcess());
 
+                    std::scoped_lock vm_lk(this->vm_lock);
                     this->cheat_vm.ResetStaticRegisters();
                     return ResultSuccess();
                 }
@@ -571,6 +739,7 @@ namespace ams::dmnt::cheat::impl {
 
                     R_TRY(this->EnsureCheatProcess());
 
+                    std::scoped_lock frz_lk(this->frozen_address_lock);
                     *out_count = std::distance(this->frozen_addresses_map.begin(), this->frozen_addresses_map.end());
                     return ResultSuccess();
                 }
@@ -580,6 +749,8 @@ namespace ams::dmnt::cheat::impl {
 
                     R_TRY(this->EnsureCheatProcess());
 
+                    std::scoped_lock frz_lk(this->frozen_address_lock);
+
                     u64 total_count = 0, written_count = 0;
                     for (const auto &entry : this->frozen_addresses_map) {
                         if (written_count >= max_count) {
@@ -603,6 +774,8 @@ namespace ams::dmnt::cheat::impl {
 
                     R_TRY(this->EnsureCheatProcess());
 
+                    std::scoped_lock frz_lk(this->frozen_address_lock);
+
                     const auto it = this->frozen_addresses_map.find_key(address);
                     R_UNLESS(it != this->frozen_addresses_map.end(), ResultFrozenAddressNotFound());
 
@@ -616,6 +789,8 @@ namespace ams::dmnt::cheat::impl {
 
                     R_TRY(this->EnsureCheatProcess());
 
+                    std::scoped_lock frz_lk(this->frozen_address_lock);
+
                     const auto it = this->frozen_addresses_map.find_key(address);
                     R_UNLESS(it == this->frozen_addresses_map.end(), ResultFrozenAddressAlreadyExists());
 
@@ -627,6 +802,7 @@ namespace ams::dmnt::cheat::impl {
                     R_UNLESS(entry != nullptr, ResultFrozenAddressOutOfResource());
 
                     this->frozen_addresses_map.insert(*entry);
+                    this->frozen_address_write_plan.Invalidate();
                     *out_value = value.value;
                     return ResultSuccess();
                 }
@@ -636,13 +812,96 @@ namespace ams::dmnt::cheat::impl {
 
                     R_TRY(this->EnsureCheatProcess());
 
+                    std::scoped_lock frz_lk(this->frozen_address_lock);
+
                     const auto it = this->frozen_addresses_map.find_key(address);
                     R_UNLESS(it != this->frozen_addresses_map.end(), ResultFrozenAddressNotFound());
 
                     FrozenAddressMapEntry *entry = std::addressof(*it);
                     this->frozen_addresses_map.erase(it);
                     DeallocateFrozenAddress(entry);
+                    this->frozen_address_write_plan.Invalidate();
+
+                    return ResultSuccess();
+                }
+
+                Result GetFrozenAddressWriteStatistics(FrozenAddressWriteStatistics *out) {
+                    std::scoped_lock lk(this->cheat_lock);
+
+                    R_TRY(this->EnsureCheatProcess());
+
+                    std::scoped_lock frz_lk(this->frozen_address_lock);
 
+                    *out = this->frozen_address_write_statistics;
+                    return ResultSuccess();
+                }
+
+                Result StartCheatSearch(u64 *out_count, const CheatSearchParameters &params) {
+                    R_TRY(this->EnsureCheatProcessForSearch());
+
+                    std::scoped_lock search_lk(this->search_lock);
+                    R_UNLESS(this->GetCheatProcessHandle() != svc::InvalidHandle, ResultCheatNotAttached());
+
+                    return this->search_engine.StartSearch(out_count, this->GetCheatProcessHandle(), params);
+                }
+
+                Result ContinueCheatSearch(u64 *out_count, const CheatSearchParameters &params) {
+                    R_TRY(this->EnsureCheatProcessForSearch());
+
+                    std::scoped_lock search_lk(this->search_lock);
+                    R_UNLESS(this->GetCheatProcessHandle() != svc::InvalidHandle, ResultCheatNotAttached());
+
+                    return this->search_engine.ContinueSearch(out_count, this->GetCheatProcessHandle(), params);
+                }
+
+                Result GetCheatSearchStatus(CheatSearchStatus *out) {
+                    R_TRY(this->EnsureCheatProcessForSearch());
+
+                    std::scoped_lock search_lk(this->search_lock);
+
+                    this->search_engine.GetStatus(out);
+                    return ResultSuccess();
+                }
+
+                Result GetCheatSearchResults(CheatSearchResult *results, size_t max_count, u64 *out_count, u64 offset) {
+                    R_TRY(this->EnsureCheatProcessForSearch());
+
+                    std::scoped_lock search_lk(this->search_lock);
+
+                    return this->search_engine.GetResults(results, max_count, out_count, offset);
+                }
+
+                Result ResetCheatSearch() {
+                    R_TRY(this->EnsureCheatProcessForSearch());
+
+                    std::scoped_lock search_lk(this->search_lock);
+
+                    this->search_engine.Reset();
+                    return ResultSuccess();
+                }
+
+                Result StartCheatPointerSearch(u64 *out_count, const CheatPointerSearchParameters &params) {
+                    CheatProcessMetadata metadata;
+                    {
+                        std::scoped_lock lk(this->cheat_lock);
+
+                        R_TRY(this->EnsureCheatProcess());
+
+                        metadata = this->cheat_process_metadata;
+                    }
+
+                    std::scoped_lock search_lk(this->search_lock);
+                    R_UNLESS(this->GetCheatProcessHandle() != svc::InvalidHandle, ResultCheatNotAttached());
+
+                    return this->search_engine.StartPointerSearch(out_count, this->GetCheatProcessHandle(), metadata, params);
+                }
+
+                Result GetCheatPointerSearchResults(CheatPointerPath *paths, size_t max_count, u64 *out_count, u64 offset) {
+                    R_TRY(this->EnsureCheatProcessForSearch());
+
+                    std::scoped_lock search_lk(this->search_lock);
+
+                    this->search_engine.GetPointerSearchResults(paths, max_count, out_count, offset);
                     return ResultSuccess();
                 }
 
@@ -709,38 +968,61 @@ namespace ams::dmnt::cheat::impl {
 
         void CheatProcessManager::VirtualMachineThread(void *_this) {
             CheatProcessManager *this_ptr = reinterpret_cast<CheatProcessManager *>(_this);
+            os::Tick scheduled_execution_tick = os::GetSystemTick();
             while (true) {
+                u32 executions_per_second = DefaultVmExecutionsPerSecond;
+                CheatVmScheduleMode mode  = CheatVmScheduleMode_Periodic;
+
                 /* Apply cheats. */
                 {
-                    std::scoped_lock lk(this_ptr->cheat_lock);
+                    std::unique_lock lk(this_ptr->cheat_lock);
 
                     if (this_ptr->HasActiveCheatProcess()) {
-                        /* Execute VM. */
-                        if (!this_ptr->GetNeedsReloadVm() || this_ptr->cheat_vm.LoadProgram(this_ptr->cheat_entries, util::size(this_ptr->cheat_entries))) {
-                            this_ptr->SetNeedsReloadVm(false);
+                        executions_per_second = this_ptr->vm_executions_per_second;
+                        mode                  = this_ptr->vm_schedule_mode;
+
+                        /* Take the vm, and hand it a snapshot of the cheats if they've changed. */
+                        std::scoped_lock vm_lk(this_ptr->vm_lock);
 
-                            /* Execute program only if it has opcodes. */
-                            if (this_ptr->cheat_vm.GetProgramSize()) {
-                                this_ptr->cheat_vm.Execute(&this_ptr->cheat_process_metadata);
+                        bool can_execute = true;
+                        if (this_ptr->GetNeedsReloadVm()) {
+                            can_execute = this_ptr->cheat_vm.LoadProgram(this_ptr->cheat_entries, util::size(this_ptr->cheat_entries));
+                            if (can_execute) {
+                                this_ptr->needs_reload_vm = false;
                             }
                         }
 
-                        /* Apply frozen addresses. */
-                        for (const auto &entry : this_ptr->frozen_addresses_map) {
-                            const auto address = entry.GetAddress();
-                            const auto &value  = entry.GetValue();
+                        const CheatProcessMetadata metadata = this_ptr->cheat_process_metadata;
+
+                        /* We no longer need the cheat lock, so let ipc proceed while we execute. */
+                        lk.unlock();
 
-                            /* Use Write SVC directly, to avoid the usual frozen address update logic. */
-                            svcWriteDebugProcessMemory(this_ptr->GetCheatProcessHandle(), &value.value, address, value.width);
+                        /* Execute program only if it has opcodes. */
+                        if (can_execute && this_ptr->cheat_vm.GetProgramSize()) {
+                            this_ptr->cheat_vm.Execute(&metadata);
                         }
+
+                        /* Apply frozen addresses. */
+                        this_ptr->ApplyFrozenAddresses();
                     }
                 }
 
-                /* Sleep until next potential execution. */
-                constexpr u64 ONE_SECOND = 1'000'000'000ul;
-                constexpr u64 TIMES_PER_SECOND = 12;
-                constexpr u64 DELAY_TIME = ONE_SECOND / TIMES_PER_SECOND;
-                svcSleepThread(DELAY_TIME);
+                /* Determine when we should next execute, without bursting if we've fallen behind. */
+                const os::Tick now = os::GetSystemTick();
+                scheduled_execution_tick = std::max(scheduled_execution_tick + this_ptr->GetVmExecutionInterval(executions_per_second), now);
+
+                /* When synchronizing to frames, execute on the first frame boundary after our scheduled time. */
+                /* Executions stay scheduled on the exact interval, so that this rounding doesn't change the average rate. */
+                os::Tick next_execution_tick = scheduled_execution_tick;
+                if (mode == CheatVmScheduleMode_FrameSynchronized) {
+                    const s64 frame_ticks = os::GetSystemTickFrequency() / FramesPerSecond;
+                    next_execution_tick = os::Tick(util::DivideUp(next_execution_tick.GetInt64Value(), frame_ticks) * frame_ticks);
+                }
+
+                /* Sleep until next potential execution, unless we're woken early. */
+                if (this_ptr->vm_wake_event.TimedWait((next_execution_tick - now).ToTimeSpan())) {
+                    scheduled_execution_tick = os::GetSystemTick();
+                }
             }
         }
 
@@ -1187,6 +1469,14 @@ namespace ams::dmnt::cheat::impl {
         return GetReference(g_cheat_process_manager).ResumeCheatProcess();
     }
 
+    Result GetCheatVmSchedule(u32 *out_executions_per_second, u32 *out_mode) {
+        return GetReference(g_cheat_process_manager).GetCheatVmSchedule(out_executions_per_second, out_mode);
+    }
+
+    Result SetCheatVmSchedule(u32 executions_per_second, u32 mode) {
+        return GetReference(g_cheat_process_manager).SetCheatVmSchedule(executions_per_second, mode);
+    }
+
     Result ReadCheatProcessMemoryUnsafe(u64 process_addr, void *out_data, size_t size) {
         return GetReference(g_cheat_process_manager).ReadCheatProcessMemoryUnsafe(process_addr, out_data, size);
     }
@@ -1279,4 +1569,36 @@ namespace ams::dmnt::cheat::impl {
         return GetReference(g_cheat_process_manager).DisableFrozenAddress(address);
     }
 
+    Result GetFrozenAddressWriteStatistics(FrozenAddressWriteStatistics *out) {
+        return GetReference(g_cheat_process_manager).GetFrozenAddressWriteStatistics(out);
+    }
+
+    Result StartCheatSearch(u64 *out_count, const CheatSearchParameters &params) {
+        return GetReference(g_cheat_process_manager).StartCheatSearch(out_count, params);
+    }
+
+    Result ContinueCheatSearch(u64 *out_count, const CheatSearchParameters &params) {
+        return GetReference(g_cheat_process_manager).ContinueCheatSearch(out_count, params);
+    }
+
+    Result GetCheatSearchStatus(CheatSearchStatus *out) {
+        return GetReference(g_cheat_process_manager).GetCheatSearchStatus(out);
+    }
+
+    Result GetCheatSearchResults(CheatSearchResult *results, size_t max_count, u64 *out_count, u64 offset) {
+        return GetReference(g_cheat_process_manager).GetCheatSearchResults(results, max_count, out_count, offset);
+    }
+
+    Result ResetCheatSearch() {
+        return GetReference(g_cheat_process_manager).ResetCheatSearch();
+    }
+
+    Result StartCheatPointerSearch(u64 *out_count, const CheatPointerSearchParameters &params) {
+        return GetReference(g_cheat_process_manager).StartCheatPointerSearch(out_count, params);
+    }
+
+    Result GetCheatPointerSearchResults(CheatPointerPath *paths, size_t max_count, u64 *out_count, u64 offset) {
+        return GetReference(g_cheat_process_manager).GetCheatPointerSearchResults(paths, max_count, out_count, offset);
+    }
+
 }
@@ -26,6 +26,8 @@ namespace ams::dmnt::cheat::impl {
     Result ForceOpenCheatProcess();
     Result PauseCheatProcess();
     Result ResumeCheatProcess();
+    Result GetCheatVmSchedule(u32 *out_executions_per_second, u32 *out_mode);
+    Result SetCheatVmSchedule(u32 executions_per_second, u32 mode);
 
     Result ReadCheatProcessMemoryUnsafe(u64 process_addr, void *out_data, size_t size);
     Result WriteCheatProcessMemoryUnsafe(u64 process_addr, void *data, size_t size);
@@ -54,5 +56,14 @@ namespace ams::dmnt::cheat::impl {
     Result GetFrozenAddress(FrozenAddressEntry *frz_addr, u64 address);
     Result EnableFrozenAddress(u64 *out_value, u64 address, u64 width);
     Result DisableFrozenAddress(u64 address);
+    Result GetFrozenAddressWriteStatistics(FrozenAddressWriteStatistics *out);
+
+    Result StartCheatSearch(u64 *out_count, const CheatSearchParameters &params);
+    Result ContinueCheatSearch(u64 *out_count, const CheatSearchParameters &params);
+    Result GetCheatSearchStatus(CheatSearchStatus *out);
+    Result GetCheatSearchResults(CheatSearchResult *results, size_t max_count, u64 *out_count, u64 offset);
+    Result ResetCheatSearch();
+    Result StartCheatPointerSearch(u64 *out_count, const CheatPointerSearchParameters &params);
+    Result GetCheatPointerSearchResults(CheatPointerPath *paths, size_t max_count, u64 *out_count, u64 offset);
 
 }
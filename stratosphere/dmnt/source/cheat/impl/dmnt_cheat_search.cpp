@@ -0,0 +1,499 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "dmnt_cheat_search.hpp"
+
+namespace ams::dmnt::cheat::impl {
+
+    namespace {
+
+        constexpr u32 InvalidPointerNodeIndex = std::numeric_limits<u32>::max();
+
+        constexpr size_t VarIntSizeMax = (BITSIZEOF(u64) + 6) / 7;
+
+        template<typename T>
+        struct ScanVectorTraits {
+            typedef T Type __attribute__((vector_size(16)));
+        };
+
+        template<typename T>
+        ALWAYS_INLINE T FromBits(u64 bits) {
+            T value;
+            std::memcpy(std::addressof(value), std::addressof(bits), sizeof(value));
+            return value;
+        }
+
+        template<typename T>
+        ALWAYS_INLINE u64 ToBits(T value) {
+            u64 bits = 0;
+            std::memcpy(std::addressof(bits), std::addressof(value), sizeof(value));
+            return bits;
+        }
+
+        /* Finds all values in [lower, upper], a vector at a time, invoking f(offset, value) for each. Stops early if f returns false. */
+        template<typename T, typename F>
+        bool ScanForRange(const u8 *data, size_t size, T lower, T upper, F f) {
+            using Vector = typename ScanVectorTraits<T>::Type;
+            constexpr size_t NumLanes = sizeof(Vector) / sizeof(T);
+
+            const Vector lower_v = Vector{} + lower;
+            const Vector upper_v = Vector{} + upper;
+
+            size_t offset = 0;
+            for (/* ... */; offset + sizeof(Vector) <= size; offset += sizeof(Vector)) {
+                Vector v;
+                std::memcpy(std::addressof(v), data + offset, sizeof(v));
+
+                /* Most vectors contain no matches, so check all lanes at once before looking at any individually. */
+                const auto mask = (v >= lower_v) & (v <= upper_v);
+
+                u64 mask_bits[2];
+                static_assert(sizeof(mask) == sizeof(mask_bits));
+                std::memcpy(mask_bits, std::addressof(mask), sizeof(mask_bits));
+
+                if ((mask_bits[0] | mask_bits[1]) != 0) {
+                    for (size_t i = 0; i < NumLanes; i++) {
+                        if (mask[i] && !f(offset + i * sizeof(T), v[i])) {
+                            return false;
+                        }
+                    }
+                }
+            }
+
+            for (/* ... */; offset + sizeof(T) <= size; offset += sizeof(T)) {
+                T value;
+                std::memcpy(std::addressof(value), data + offset, sizeof(value));
+
+                if (lower <= value && value <= upper && !f(offset, value)) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        template<typename T>
+        bool IsConditionMet(u32 condition, T value, T previous, T lower, T upper) {
+            switch (condition) {
+                case CheatSearchCondition_Equal:     return value == lower;
+                case CheatSearchCondition_Range:     return lower <= value && value <= upper;
+                case CheatSearchCondition_Changed:   return value != previous;
+                case CheatSearchCondition_Unchanged: return value == previous;
+                case CheatSearchCondition_Increased: return value > previous;
+                case CheatSearchCondition_Decreased: return value < previous;
+                AMS_UNREACHABLE_DEFAULT_CASE();
+            }
+        }
+
+        constexpr bool IsValidCondition(u32 condition) {
+            return condition <= CheatSearchCondition_Decreased;
+        }
+
+        constexpr bool IsValidValueType(u32 value_type) {
+            return value_type <= CheatSearchValueType_F64;
+        }
+
+        constexpr bool IsValidFirstCondition(u32 condition) {
+            return condition == CheatSearchCondition_Equal || condition == CheatSearchCondition_Range;
+        }
+
+        #define R_TRY_FOR_VALUE_TYPE(value_type, FUNCTION, ...)                                     \
+            switch (value_type) {                                                                  \
+                case CheatSearchValueType_U8:  R_TRY(FUNCTION<u8>(__VA_ARGS__));     break;        \
+                case CheatSearchValueType_U16: R_TRY(FUNCTION<u16>(__VA_ARGS__));    break;        \
+                case CheatSearchValueType_U32: R_TRY(FUNCTION<u32>(__VA_ARGS__));    break;        \
+                case CheatSearchValueType_U64: R_TRY(FUNCTION<u64>(__VA_ARGS__));    break;        \
+                case CheatSearchValueType_S8:  R_TRY(FUNCTION<s8>(__VA_ARGS__));     break;        \
+                case CheatSearchValueType_S16: R_TRY(FUNCTION<s16>(__VA_ARGS__));    break;        \
+                case CheatSearchValueType_S32: R_TRY(FUNCTION<s32>(__VA_ARGS__));    break;        \
+                case CheatSearchValueType_S64: R_TRY(FUNCTION<s64>(__VA_ARGS__));    break;        \
+                case CheatSearchValueType_F32: R_TRY(FUNCTION<float>(__VA_ARGS__));  break;        \
+                case CheatSearchValueType_F64: R_TRY(FUNCTION<double>(__VA_ARGS__)); break;        \
+                default:                       return ResultSearchInvalidValueType();              \
+            }
+
+        constexpr size_t GetValueWidth(u32 value_type) {
+            switch (value_type) {
+                case CheatSearchValueType_U8:
+                case CheatSearchValueType_S8:
+                    return sizeof(u8);
+                case CheatSearchValueType_U16:
+                case CheatSearchValueType_S16:
+                    return sizeof(u16);
+                case CheatSearchValueType_U32:
+                case CheatSearchValueType_S32:
+                case CheatSearchValueType_F32:
+                    return sizeof(u32);
+                case CheatSearchValueType_U64:
+                case CheatSearchValueType_S64:
+                case CheatSearchValueType_F64:
+                default:
+                    return sizeof(u64);
+            }
+        }
+
+    }
+
+    void CheatSearchEngine::Reset() {
+        this->started           = false;
+        this->value_type        = CheatSearchValueType_U32;
+        this->scan_count        = 0;
+        this->num_pointer_paths = 0;
+        this->current_set       = 0;
+        this->result_sets[0]    = {};
+        this->result_sets[1]    = {};
+        this->result_cursor     = {};
+
+        this->FreeBuffers();
+    }
+
+    Result CheatSearchEngine::EnsureBuffers() {
+        /* dmnt has no other use for its heap, so the buffers can occupy it until the search is reset. */
+        if (this->buffers == nullptr) {
+            void *address;
+            R_UNLESS(R_SUCCEEDED(svcSetHeapSize(std::addressof(address), util::AlignUp(sizeof(Buffers), svc::HeapSizeAlignment))), ResultSearchOutOfMemory());
+            this->buffers = static_cast<Buffers *>(address);
+        }
+
+        return ResultSuccess();
+    }
+
+    void CheatSearchEngine::FreeBuffers() {
+        if (this->buffers != nullptr) {
+            void *address;
+            R_ABORT_UNLESS(svcSetHeapSize(std::addressof(address), 0));
+            this->buffers = nullptr;
+        }
+    }
+
+    void CheatSearchEngine::ResetResultSet(size_t index, bool has_values, u64 uniform_value) {
+        this->result_sets[index] = {
+            .data          = this->buffers->result_buffers[index],
+            .size          = 0,
+            .count         = 0,
+            .last_address  = 0,
+            .uniform_value = uniform_value,
+            .has_values    = has_values,
+            .truncated     = false,
+        };
+
+        if (index == this->current_set) {
+            this->result_cursor = {};
+        }
+    }
+
+    bool CheatSearchEngine::AppendResult(ResultSet &set, u64 address, u64 value, size_t width) {
+        /* Check that we have space for the result. */
+        if (set.size + VarIntSizeMax + width > ResultBufferSize) {
+            set.truncated = true;
+            return false;
+        }
+
+        /* Write the address delta. */
+        u64 delta = (address - set.last_address) / width;
+        do {
+            const u8 byte = delta & 0x7F;
+            delta >>= 7;
+            set.data[set.size++] = byte | (delta != 0 ? 0x80 : 0x00);
+        } while (delta != 0);
+
+        /* Write the value. */
+        if (set.has_values) {
+            std::memcpy(set.data + set.size, std::addressof(value), width);
+            set.size += width;
+        }
+
+        set.last_address = address;
+        set.count++;
+        return true;
+    }
+
+    bool CheatSearchEngine::ReadNextResult(const ResultSet &set, ResultSetReader &reader, u64 *out_address, u64 *out_value, size_t width) const {
+        if (reader.index >= set.count) {
+            return false;
+        }
+
+        /* Read the address delta. */
+        u64 delta = 0;
+        for (size_t shift = 0; true; shift += 7) {
+            const u8 byte = set.data[reader.position++];
+            delta |= static_cast<u64>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                break;
+            }
+        }
+        reader.address += delta * width;
+
+        /* Read the value. */
+        u64 value = set.uniform_value;
+        if (set.has_values) {
+            value = 0;
+            std::memcpy(std::addressof(value), set.data + reader.position, width);
+            reader.position += width;
+        }
+
+        reader.index++;
+        *out_address = reader.address;
+        *out_value   = value;
+        return true;
+    }
+
+    template<typename F>
+    void CheatSearchEngine::ForEachScanChunk(Handle debug_handle, F f) {
+        u64 address = 0;
+        do {
+            MemoryInfo mem_info;
+            u32 tmp;
+            if (R_FAILED(svcQueryDebugProcessMemory(&mem_info, &tmp, debug_handle, address))) {
+                break;
+            }
+
+            /* Only search memory the process can write. */
+            if ((mem_info.perm & Perm_Rw) == Perm_Rw && mem_info.type != MemType_Io) {
+                for (u64 chunk_address = mem_info.addr; chunk_address < mem_info.addr + mem_info.size; chunk_address += ScanBufferSize) {
+                    const size_t chunk_size = std::min<u64>(ScanBufferSize, mem_info.addr + mem_info.size - chunk_address);
+                    if (R_FAILED(svcReadDebugProcessMemory(this->buffers->scan_buffer, debug_handle, chunk_address, chunk_size))) {
+                        continue;
+                    }
+
+                    if (!f(chunk_address, this->buffers->scan_buffer, chunk_size)) {
+                        return;
+                    }
+                }
+            }
+
+            address = mem_info.addr + mem_info.size;
+        } while (address != 0);
+    }
+
+    template<typename T>
+    Result CheatSearchEngine::StartSearchImpl(Handle debug_handle, const CheatSearchParameters &params) {
+        const T lower = FromBits<T>(params.value);
+        const T upper = params.condition == CheatSearchCondition_Equal ? lower : FromBits<T>(params.upper_value);
+
+        /* Exact searches produce results which all share the searched value, so we needn't store it. */
+        this->current_set = 0;
+        this->ResetResultSet(0, params.condition != CheatSearchCondition_Equal, ToBits(lower));
+
+        ResultSet &set = this->result_sets[0];
+        this->ForEachScanChunk(debug_handle, [&](u64 chunk_address, const u8 *data, size_t size) {
+            return ScanForRange<T>(data, size, lower, upper, [&](size_t offset, T value) {
+                return this->AppendResult(set, chunk_address + offset, ToBits(value), sizeof(T));
+            });
+        });
+
+        return ResultSuccess();
+    }
+
+    template<typename T>
+    Result CheatSearchEngine::ContinueSearchImpl(Handle debug_handle, const CheatSearchParameters &params) {
+        const T lower = FromBits<T>(params.value);
+        const T upper = FromBits<T>(params.upper_value);
+
+        const size_t src_index = this->current_set;
+        const size_t dst_index = src_index ^ 1;
+        this->ResetResultSet(dst_index, params.condition != CheatSearchCondition_Equal, ToBits(lower));
+
+        const ResultSet &src = this->result_sets[src_index];
+        ResultSet &dst = this->result_sets[dst_index];
+
+        /* Read memory in windows, so that nearby results share a single read. */
+        u64 window_address = 0;
+        size_t window_size = 0;
+        u64 failed_page = std::numeric_limits<u64>::max();
+
+        ResultSetReader reader = {};
+        u64 address, previous_bits;
+        while (this->ReadNextResult(src, reader, std::addressof(address), std::addressof(previous_bits), sizeof(T))) {
+            const u64 page = util::AlignDown(address, os::MemoryPageSize);
+            if (page == failed_page) {
+                continue;
+            }
+
+            if (!(window_address <= address && address + sizeof(T) <= window_address + window_size)) {
+                /* Try to read a whole window, falling back to just the page if the window isn't entirely mapped. */
+                window_address = page;
+                window_size    = ScanBufferSize;
+                if (R_FAILED(svcReadDebugProcessMemory(this->buffers->scan_buffer, debug_handle, window_address, window_size))) {
+                    window_size = os::MemoryPageSize;
+                    if (R_FAILED(svcReadDebugProcessMemory(this->buffers->scan_buffer, debug_handle, window_address, window_size))) {
+                        /* The memory is gone, so the result is too. */
+                        window_size = 0;
+                        failed_page = page;
+                        continue;
+                    }
+                }
+            }
+
+            T value;
+            std::memcpy(std::addressof(value), this->buffers->scan_buffer + (address - window_address), sizeof(value));
+
+            if (IsConditionMet<T>(params.condition, value, FromBits<T>(previous_bits), lower, upper)) {
+                if (!this->AppendResult(dst, address, ToBits(value), sizeof(T))) {
+                    break;
+                }
+            }
+        }
+
+        /* The new results are now current. */
+        this->current_set   = dst_index;
+        this->result_cursor = {};
+        return ResultSuccess();
+    }
+
+    Result CheatSearchEngine::StartSearch(u64 *out_count, Handle debug_handle, const CheatSearchParameters &params) {
+        /* Validate parameters. */
+        R_UNLESS(IsValidValueType(params.value_type),     ResultSearchInvalidValueType());
+        R_UNLESS(IsValidFirstCondition(params.condition), ResultSearchInvalidCondition());
+
+        /* Perform the search. */
+        R_TRY(this->EnsureBuffers());
+        R_TRY_FOR_VALUE_TYPE(params.value_type, this->StartSearchImpl, debug_handle, params);
+
+        this->started    = true;
+        this->value_type = params.value_type;
+        this->scan_count = 1;
+
+        *out_count = this->result_sets[this->current_set].count;
+        return ResultSuccess();
+    }
+
+    Result CheatSearchEngine::ContinueSearch(u64 *out_count, Handle debug_handle, const CheatSearchParameters &params) {
+        /* Validate parameters. */
+        R_UNLESS(this->started,                          ResultSearchNotStarted());
+        R_UNLESS(params.value_type == this->value_type,  ResultSearchValueTypeMismatch());
+        R_UNLESS(IsValidCondition(params.condition),     ResultSearchInvalidCondition());
+
+        /* Perform the search. */
+        R_TRY_FOR_VALUE_TYPE(params.value_type, this->ContinueSearchImpl, debug_handle, params);
+
+        this->scan_count++;
+
+        *out_count = this->result_sets[this->current_set].count;
+        return ResultSuccess();
+    }
+
+    void CheatSearchEngine::GetStatus(CheatSearchStatus *out) const {
+        const ResultSet &set = this->result_sets[this->current_set];
+
+        *out = {};
+        out->result_count = this->started ? set.count : 0;
+        out->value_type   = this->value_type;
+        out->scan_count   = this->scan_count;
+        out->truncated    = this->started && set.truncated;
+    }
+
+    Result CheatSearchEngine::GetResults(CheatSearchResult *out_results, size_t max_count, u64 *out_count, u64 offset) {
+        R_UNLESS(this->started, ResultSearchNotStarted());
+
+        const ResultSet &set = this->result_sets[this->current_set];
+        const size_t width = GetValueWidth(this->value_type);
+
+        /* Results are usually retrieved in order, so continue from where we left off if we can. */
+        if (this->result_cursor.index > offset) {
+            this->result_cursor = {};
+        }
+
+        u64 address, value;
+        while (this->result_cursor.index < offset && this->ReadNextResult(set, this->result_cursor, std::addressof(address), std::addressof(value), width)) {
+            /* ... */
+        }
+
+        size_t count = 0;
+        while (count < max_count && this->ReadNextResult(set, this->result_cursor, std::addressof(address), std::addressof(value), width)) {
+            out_results[count++] = { .address = address, .value = value };
+        }
+
+        *out_count = count;
+        return ResultSuccess();
+    }
+
+    Result CheatSearchEngine::StartPointerSearch(u64 *out_count, Handle debug_handle, const CheatProcessMetadata &metadata, const CheatPointerSearchParameters &params) {
+        /* Validate parameters. */
+        R_UNLESS(0 < params.max_depth && params.max_depth <= CheatPointerPathDepthMax, ResultSearchInvalidPointerDepth());
+
+        R_TRY(this->EnsureBuffers());
+
+        const u64 main_start = metadata.main_nso_extents.base;
+        const u64 main_end   = metadata.main_nso_extents.base + metadata.main_nso_extents.size;
+
+        /* We search backwards from the target, one level at a time. Each level finds pointers to within max_offset below */
+        /* any address found by the previous level. Pointers from within the main module end a path, rather than continuing it. */
+        this->buffers->pointer_nodes[0] = { .address = params.address, .offset = 0, .parent = InvalidPointerNodeIndex };
+        this->num_pointer_paths = 0;
+
+        size_t num_nodes = 1;
+        size_t level_start = 0, level_end = 1;
+        for (u32 depth = 1; depth <= params.max_depth && level_start < level_end && this->num_pointer_paths < PointerPathCountMax; depth++) {
+            PointerNode * const level_begin = this->buffers->pointer_nodes + level_start;
+            PointerNode * const level_last  = this->buffers->pointer_nodes + level_end;
+
+            /* Sort the level, so that we can find the nodes a pointer may refer to by binary search. */
+            std::sort(level_begin, level_last, [](const PointerNode &lhs, const PointerNode &rhs) { return lhs.address < rhs.address; });
+
+            const u64 lower = level_begin->address - std::min<u64>(level_begin->address, params.max_offset);
+            const u64 upper = (level_last - 1)->address;
+
+            this->ForEachScanChunk(debug_handle, [&](u64 chunk_address, const u8 *data, size_t size) {
+                return ScanForRange<u64>(data, size, lower, upper, [&](size_t offset, u64 value) {
+                    const u64 pointer_address = chunk_address + offset;
+
+                    auto it = std::lower_bound(level_begin, level_last, value, [](const PointerNode &node, u64 address) { return node.address < address; });
+                    for (/* ... */; it != level_last && it->address - value <= params.max_offset; ++it) {
+                        const u32 node_index = static_cast<u32>(it - this->buffers->pointer_nodes);
+                        const u64 node_offset = it->address - value;
+
+                        if (main_start <= pointer_address && pointer_address < main_end) {
+                            /* We found a complete path; record it. */
+                            auto &path = this->buffers->pointer_paths[this->num_pointer_paths++];
+                            path = {};
+                            path.base_offset = pointer_address - main_start;
+                            path.offsets[path.depth++] = node_offset;
+                            for (u32 i = node_index; this->buffers->pointer_nodes[i].parent != InvalidPointerNodeIndex; i = this->buffers->pointer_nodes[i].parent) {
+                                path.offsets[path.depth++] = this->buffers->pointer_nodes[i].offset;
+                            }
+
+                            if (this->num_pointer_paths >= PointerPathCountMax) {
+                                return false;
+                            }
+                        } else if (depth < params.max_depth && num_nodes < PointerNodeCountMax) {
+                            /* Continue searching from this pointer at the next level. */
+                            this->buffers->pointer_nodes[num_nodes++] = { .address = pointer_address, .offset = node_offset, .parent = node_index };
+                        }
+                    }
+
+                    return true;
+                });
+            });
+
+            level_start = level_end;
+            level_end   = num_nodes;
+        }
+
+        *out_count = this->num_pointer_paths;
+        return ResultSuccess();
+    }
+
+    void CheatSearchEngine::GetPointerSearchResults(CheatPointerPath *out_paths, size_t max_count, u64 *out_count, u64 offset) const {
+        size_t count = 0;
+        for (size_t i = offset; i < this->num_pointer_paths && count < max_count; i++) {
+            out_paths[count++] = this->buffers->pointer_paths[i];
+        }
+
+        *out_count = count;
+    }
+
+}
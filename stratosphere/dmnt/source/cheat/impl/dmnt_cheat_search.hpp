@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+
+namespace ams::dmnt::cheat::impl {
+
+    class CheatSearchEngine {
+        NON_COPYABLE(CheatSearchEngine);
+        NON_MOVEABLE(CheatSearchEngine);
+        public:
+            static constexpr size_t ScanBufferSize      = 64_KB;
+            static constexpr size_t ResultBufferSize    = 256_KB;
+            static constexpr size_t PointerNodeCountMax = 0x800;
+            static constexpr size_t PointerPathCountMax = 0x100;
+        private:
+            /* Results are stored as varint-encoded address deltas (in units of the value width), each followed by the value */
+            /* unless every result shares the same value, as is the case after searching for an exact value. */
+            struct ResultSet {
+                u8 *data;
+                size_t size;
+                size_t count;
+                u64 last_address;
+                u64 uniform_value;
+                bool has_values;
+                bool truncated;
+            };
+
+            struct ResultSetReader {
+                size_t position;
+                size_t index;
+                u64 address;
+            };
+
+            struct PointerNode {
+                u64 address;
+                u64 offset;
+                u32 parent;
+            };
+
+            /* Searches are rare, so their buffers are only mapped while a search is in progress. */
+            struct Buffers {
+                alignas(16) u8 scan_buffer[ScanBufferSize];
+                u8 result_buffers[2][ResultBufferSize];
+                PointerNode pointer_nodes[PointerNodeCountMax];
+                CheatPointerPath pointer_paths[PointerPathCountMax];
+            };
+        private:
+            Buffers *buffers;
+            ResultSet result_sets[2];
+            size_t current_set;
+            ResultSetReader result_cursor;
+            bool started;
+            u32 value_type;
+            u32 scan_count;
+            size_t num_pointer_paths;
+        public:
+            CheatSearchEngine() : buffers(nullptr) { this->Reset(); }
+
+            void Reset();
+
+            Result StartSearch(u64 *out_count, Handle debug_handle, const CheatSearchParameters &params);
+            Result ContinueSearch(u64 *out_count, Handle debug_handle, const CheatSearchParameters &params);
+            void GetStatus(CheatSearchStatus *out) const;
+            Result GetResults(CheatSearchResult *out_results, size_t max_count, u64 *out_count, u64 offset);
+
+            Result StartPointerSearch(u64 *out_count, Handle debug_handle, const CheatProcessMetadata &metadata, const CheatPointerSearchParameters &params);
+            void GetPointerSearchResults(CheatPointerPath *out_paths, size_t max_count, u64 *out_count, u64 offset) const;
+        private:
+            Result EnsureBuffers();
+            void FreeBuffers();
+
+            void ResetResultSet(size_t index, bool has_values, u64 uniform_value);
+            bool AppendResult(ResultSet &set, u64 address, u64 value, size_t width);
+            bool ReadNextResult(const ResultSet &set, ResultSetReader &reader, u64 *out_address, u64 *out_value, size_t width) const;
+
+            template<typename T>
+            Result StartSearchImpl(Handle debug_handle, const CheatSearchParameters &params);
+            template<typename T>
+            Result ContinueSearchImpl(Handle debug_handle, const CheatSearchParameters &params);
+
+            template<typename F>
+            void ForEachScanChunk(Handle debug_handle, F f);
+    };
+
+}
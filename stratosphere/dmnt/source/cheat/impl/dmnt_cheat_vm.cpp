@@ -668,26 +668,49 @@ namespace ams::dmnt::cheat::impl {
         return valid;
     }
 
-    void CheatVirtualMachine::SkipConditionalBlock() {
-        if (this->condition_depth > 0) {
-            /* We want to continue until we're out of the current block. */
-            const size_t desired_depth = this->condition_depth - 1;
-
-            CheatVmOpcode skip_opcode;
-            while (this->condition_depth > desired_depth && this->DecodeNextOpcode(&skip_opcode)) {
-                /* Decode instructions until we see end of the current conditional block. */
-                /* NOTE: This is broken in gateway's implementation. */
-                /* Gateway currently checks for "0x2" instead of "0x20000000" */
-                /* In addition, they do a linear scan instead of correctly decoding opcodes. */
-                /* This causes issues if "0x2" appears as an immediate in the conditional block... */
-
-                /* We also support nesting of conditional blocks, and Gateway does not. */
-                if (skip_opcode.begin_conditional_block) {
-                    this->condition_depth++;
-                } else if (skip_opcode.opcode == CheatVmOpcodeType_EndConditionalBlock) {
-                    this->condition_depth--;
+    void CheatVirtualMachine::CompileProgram() {
+        /* Decode the program up front, stopping at the first instruction we can't decode. */
+        this->num_instructions = 0;
+        this->instruction_ptr  = 0;
+        this->decode_success   = true;
+
+        /* While compiling, the skip targets of open conditional blocks link to the enclosing open block. */
+        constexpr u32 NoOpenBlock = std::numeric_limits<u32>::max();
+        u32 open_block = NoOpenBlock;
+
+        while (this->num_instructions < MaximumProgramOpcodeCount && this->DecodeNextOpcode(&this->instructions[this->num_instructions].opcode)) {
+            auto &instruction = this->instructions[this->num_instructions];
+            const u32 index = static_cast<u32>(this->num_instructions++);
+
+            /* Resolve the end of each conditional block, supporting nesting. */
+            /* NOTE: This is broken in gateway's implementation. */
+            /* Gateway does a linear scan for "0x2" at runtime instead of correctly decoding opcodes. */
+            if (instruction.opcode.begin_conditional_block) {
+                instruction.skip_target = open_block;
+                open_block = index;
+            } else if (instruction.opcode.opcode == CheatVmOpcodeType_EndConditionalBlock) {
+                /* We will assume, graciously, that mismatched conditional block ends are a nop. */
+                if (open_block != NoOpenBlock) {
+                    const u32 enclosing_block = this->instructions[open_block].skip_target;
+                    this->instructions[open_block].skip_target = index + 1;
+                    open_block = enclosing_block;
                 }
             }
+        }
+
+        /* Skipping a block which is never closed skips the rest of the program. */
+        while (open_block != NoOpenBlock) {
+            const u32 enclosing_block = this->instructions[open_block].skip_target;
+            this->instructions[open_block].skip_target = static_cast<u32>(this->num_instructions);
+            open_block = enclosing_block;
+        }
+    }
+
+    void CheatVirtualMachine::SkipConditionalBlock(const CheatVmInstruction &instruction) {
+        if (this->condition_depth > 0) {
+            /* Continue after the end of the current conditional block. */
+            this->instruction_ptr = instruction.skip_target;
+            this->condition_depth--;
         } else {
             /* Skipping, but this->condition_depth = 0. */
             /* This is an error condition. */
@@ -698,6 +721,90 @@ namespace ams::dmnt::cheat::impl {
         }
     }
 
+    void CheatVirtualMachine::ReadProcessMemory(u64 address, void *out_data, size_t size) {
+        /* Reads must observe any writes we've deferred. */
+        if (this->write_buffer_start != this->write_buffer_end) {
+            const u64 write_start = this->write_buffer_address + this->write_buffer_start;
+            const u64 write_end   = this->write_buffer_address + this->write_buffer_end;
+            if (address < write_end && write_start < address + size) {
+                this->FlushProcessMemoryWrites();
+            }
+        }
+
+        /* Reads which straddle a page boundary are performed directly. */
+        const u64 page_address = util::AlignDown(address, MemoryAccessPageSize);
+        if (page_address != util::AlignDown(address + size - 1, MemoryAccessPageSize)) {
+            dmnt::cheat::impl::ReadCheatProcessMemoryUnsafe(address, out_data, size);
+            return;
+        }
+
+        /* Read the whole page, if we don't already have it. */
+        if (!this->read_cache_valid || this->read_cache_address != page_address) {
+            this->read_cache_valid = R_SUCCEEDED(dmnt::cheat::impl::ReadCheatProcessMemoryUnsafe(page_address, this->read_cache, sizeof(this->read_cache)));
+            this->read_cache_address = page_address;
+
+            /* If we can't, fall back to reading only what we were asked for. */
+            if (!this->read_cache_valid) {
+                dmnt::cheat::impl::ReadCheatProcessMemoryUnsafe(address, out_data, size);
+                return;
+            }
+        }
+
+        std::memcpy(out_data, this->read_cache + (address - page_address), size);
+    }
+
+    void CheatVirtualMachine::WriteProcessMemory(u64 address, const void *data, size_t size) {
+        const u64 page_address = util::AlignDown(address, MemoryAccessPageSize);
+
+        /* Any cached copy of the page is now stale. */
+        if (this->read_cache_valid && this->read_cache_address == page_address) {
+            this->read_cache_valid = false;
+        }
+
+        /* Writes which straddle a page boundary are performed directly, in order. */
+        if (page_address != util::AlignDown(address + size - 1, MemoryAccessPageSize)) {
+            this->FlushProcessMemoryWrites();
+            if (this->read_cache_valid && this->read_cache_address == util::AlignDown(address + size - 1, MemoryAccessPageSize)) {
+                this->read_cache_valid = false;
+            }
+            dmnt::cheat::impl::WriteCheatProcessMemoryUnsafe(address, const_cast<void *>(data), size);
+            return;
+        }
+
+        /* Extend the pending write if this one is adjacent to or overlaps it, otherwise start a new one. */
+        const size_t start = address - page_address;
+        const size_t end   = start + size;
+        if (this->write_buffer_start != this->write_buffer_end && this->write_buffer_address == page_address && start <= this->write_buffer_end && this->write_buffer_start <= end) {
+            this->write_buffer_start = std::min(this->write_buffer_start, start);
+            this->write_buffer_end   = std::max(this->write_buffer_end, end);
+        } else {
+            this->FlushProcessMemoryWrites();
+            this->write_buffer_address = page_address;
+            this->write_buffer_start   = start;
+            this->write_buffer_end     = end;
+        }
+
+        std::memcpy(this->write_buffer + start, data, size);
+    }
+
+    void CheatVirtualMachine::FlushProcessMemoryWrites() {
+        if (this->write_buffer_start != this->write_buffer_end) {
+            dmnt::cheat::impl::WriteCheatProcessMemoryUnsafe(this->write_buffer_address + this->write_buffer_start, this->write_buffer + this->write_buffer_start, this->write_buffer_end - this->write_buffer_start);
+            this->write_buffer_start = 0;
+            this->write_buffer_end   = 0;
+
+            /* Re-read the page if we need it again, rather than assuming the write succeeded. */
+            if (this->read_cache_valid && this->read_cache_address == this->write_buffer_address) {
+                this->read_cache_valid = false;
+            }
+        }
+    }
+
+    void CheatVirtualMachine::InvalidateProcessMemoryCache() {
+        this->FlushProcessMemoryWrites();
+        this->read_cache_valid = false;
+    }
+
     u64 CheatVirtualMachine::GetVmInt(VmInt value, u32 bit_width) {
         switch (bit_width) {
             case 1:
@@ -743,7 +850,8 @@ namespace ams::dmnt::cheat::impl {
             if (cheats[i].enabled) {
                 /* Bounds check. */
                 if (cheats[i].definition.num_opcodes + this->num_opcodes > MaximumProgramOpcodeCount) {
-                    this->num_opcodes = 0;
+                    this->num_opcodes      = 0;
+                    this->num_instructions = 0;
                     return false;
                 }
 
@@ -753,11 +861,13 @@ namespace ams::dmnt::cheat::impl {
             }
         }
 
+        /* Compile the program, so that we don't need to decode it every execution. */
+        this->CompileProgram();
+
         return true;
     }
 
     void CheatVirtualMachine::Execute(const CheatProcessMetadata *metadata) {
-        CheatVmOpcode cur_opcode;
         u64 kHeld = 0;
 
         /* Get Keys held. */
@@ -774,10 +884,17 @@ namespace ams::dmnt::cheat::impl {
         /* Clear VM state. */
         this->ResetState();
 
+        /* Memory is only cached for the duration of a single execution. */
+        this->InvalidateProcessMemoryCache();
+        ON_SCOPE_EXIT { this->InvalidateProcessMemoryCache(); };
+
         /* Loop until program finishes. */
-        while (this->DecodeNextOpcode(&cur_opcode)) {
+        while (this->instruction_ptr < this->num_instructions) {
             this->LogToDebugFile("Instruction Ptr: %04x\n", (u32)this->instruction_ptr);
 
+            const CheatVmInstruction &cur_instruction = this->instructions[this->instruction_ptr++];
+            const CheatVmOpcode &cur_opcode = cur_instruction.opcode;
+
             for (size_t i = 0; i < NumRegisters; i++) {
                 this->LogToDebugFile("Registers[%02x]: %016lx\n", i, this->registers[i]);
             }
@@ -803,7 +920,7 @@ namespace ams::dmnt::cheat::impl {
                             case 2:
                             case 4:
                             case 8:
-                                dmnt::cheat::impl::WriteCheatProcessMemoryUnsafe(dst_address, &dst_value, cur_opcode.store_static.bit_width);
+                                this->WriteProcessMemory(dst_address, &dst_value, cur_opcode.store_static.bit_width);
                                 break;
                         }
                     }
@@ -818,7 +935,7 @@ namespace ams::dmnt::cheat::impl {
                             case 2:
                             case 4:
                             case 8:
-                                dmnt::cheat::impl::ReadCheatProcessMemoryUnsafe(src_address, &src_value, cur_opcode.begin_cond.bit_width);
+                                this->ReadProcessMemory(src_address, &src_value, cur_opcode.begin_cond.bit_width);
                                 break;
                         }
                         /* Check against condition. */
@@ -846,7 +963,7 @@ namespace ams::dmnt::cheat::impl {
                         }
                         /* Skip conditional block if condition not met. */
                         if (!cond_met) {
-                            this->SkipConditionalBlock();
+                            this->SkipConditionalBlock(cur_instruction);
                         }
                     }
                     break;
@@ -889,7 +1006,7 @@ namespace ams::dmnt::cheat::impl {
                             case 2:
                             case 4:
                             case 8:
-                                dmnt::cheat::impl::ReadCheatProcessMemoryUnsafe(src_address, &this->registers[cur_opcode.ldr_memory.reg_index], cur_opcode.ldr_memory.bit_width);
+                                this->ReadProcessMemory(src_address, &this->registers[cur_opcode.ldr_memory.reg_index], cur_opcode.ldr_memory.bit_width);
                                 break;
                         }
                     }
@@ -908,7 +1025,7 @@ namespace ams::dmnt::cheat::impl {
                             case 2:
                             case 4:
                             case 8:
-                                dmnt::cheat::impl::WriteCheatProcessMemoryUnsafe(dst_address, &dst_value, cur_opcode.str_static.bit_width);
+                                this->WriteProcessMemory(dst_address, &dst_value, cur_opcode.str_static.bit_width);
                                 break;
                         }
                         /* Increment register if relevant. */
@@ -961,7 +1078,7 @@ namespace ams::dmnt::cheat::impl {
                     /* Check for keypress. */
                     if ((cur_opcode.begin_keypress_cond.key_mask & kHeld) != cur_opcode.begin_keypress_cond.key_mask) {
                         /* Keys not pressed. Skip conditional block. */
-                        this->SkipConditionalBlock();
+                        this->SkipConditionalBlock(cur_instruction);
                     }
                     break;
                 case CheatVmOpcodeType_PerformArithmeticRegister:
@@ -1059,7 +1176,7 @@ namespace ams::dmnt::cheat::impl {
                             case 2:
                             case 4:
                             case 8:
-                                dmnt::cheat::impl::WriteCheatProcessMemoryUnsafe(dst_address, &dst_value, cur_opcode.str_register.bit_width);
+                                this->WriteProcessMemory(dst_address, &dst_value, cur_opcode.str_register.bit_width);
                                 break;
                         }
 
@@ -1130,7 +1247,7 @@ namespace ams::dmnt::cheat::impl {
                                 case 2:
                                 case 4:
                                 case 8:
-                                    dmnt::cheat::impl::ReadCheatProcessMemoryUnsafe(cond_address, &cond_value, cur_opcode.begin_reg_cond.bit_width);
+                                    this->ReadProcessMemory(cond_address, &cond_value, cur_opcode.begin_reg_cond.bit_width);
                                     break;
                             }
                         }
@@ -1160,7 +1277,7 @@ namespace ams::dmnt::cheat::impl {
 
                         /* Skip conditional block if condition not met. */
                         if (!cond_met) {
-                            this->SkipConditionalBlock();
+                            this->SkipConditionalBlock(cur_instruction);
                         }
                     }
                     break;
@@ -1225,9 +1342,11 @@ namespace ams::dmnt::cheat::impl {
                     }
                     break;
                 case CheatVmOpcodeType_PauseProcess:
+                    this->InvalidateProcessMemoryCache();
                     dmnt::cheat::impl::PauseCheatProcessUnsafe();
                     break;
                 case CheatVmOpcodeType_ResumeProcess:
+                    this->InvalidateProcessMemoryCache();
                     dmnt::cheat::impl::ResumeCheatProcessUnsafe();
                     break;
                 case CheatVmOpcodeType_DebugLog:
@@ -1272,7 +1391,7 @@ namespace ams::dmnt::cheat::impl {
                                 case 2:
                                 case 4:
                                 case 8:
-                                    dmnt::cheat::impl::ReadCheatProcessMemoryUnsafe(val_address, &log_value, cur_opcode.debug_log.bit_width);
+                                    this->ReadProcessMemory(val_address, &log_value, cur_opcode.debug_log.bit_width);
                                     break;
                             }
                         }
@@ -265,6 +265,12 @@ namespace ams::dmnt::cheat::impl {
         };
     };
 
+    struct CheatVmInstruction {
+        CheatVmOpcode opcode;
+        /* For instructions which begin a conditional block, the index of the instruction following the matching end. */
+        u32 skip_target;
+    };
+
     class CheatVirtualMachine {
         public:
             constexpr static size_t MaximumProgramOpcodeCount = 0x400;
@@ -272,21 +278,39 @@ namespace ams::dmnt::cheat::impl {
             constexpr static size_t NumReadableStaticRegisters = 0x80;
             constexpr static size_t NumWritableStaticRegisters = 0x80;
             constexpr static size_t NumStaticRegisters = NumReadableStaticRegisters + NumWritableStaticRegisters;
+            constexpr static size_t MemoryAccessPageSize = 0x1000;
         private:
             size_t num_opcodes = 0;
+            size_t num_instructions = 0;
             size_t instruction_ptr = 0;
             size_t condition_depth = 0;
             bool decode_success = false;
             u32 program[MaximumProgramOpcodeCount] = {0};
+            CheatVmInstruction instructions[MaximumProgramOpcodeCount] = {};
             u64 registers[NumRegisters] = {0};
             u64 saved_values[NumRegisters] = {0};
             u64 static_registers[NumStaticRegisters] = {0};
             size_t loop_tops[NumRegisters] = {0};
+
+            /* Process memory accessed during a single execution, batched a page at a time. */
+            u8 read_cache[MemoryAccessPageSize] = {0};
+            u64 read_cache_address = 0;
+            bool read_cache_valid = false;
+            u8 write_buffer[MemoryAccessPageSize] = {0};
+            u64 write_buffer_address = 0;
+            size_t write_buffer_start = 0;
+            size_t write_buffer_end = 0;
         private:
             bool DecodeNextOpcode(CheatVmOpcode *out);
-            void SkipConditionalBlock();
+            void CompileProgram();
+            void SkipConditionalBlock(const CheatVmInstruction &instruction);
             void ResetState();
 
+            void ReadProcessMemory(u64 address, void *out_data, size_t size);
+            void WriteProcessMemory(u64 address, const void *data, size_t size);
+            void FlushProcessMemoryWrites();
+            void InvalidateProcessMemoryCache();
+
             /* For implementing the DebugLog opcode. */
             void DebugLog(u32 log_id, u64 value);
 
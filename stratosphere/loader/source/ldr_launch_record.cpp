@@ -31,6 +31,22 @@ namespace ams::ldr {
 
         constinit bool g_boot_programs_done = false;
 
+        struct LaunchPhaseRecord {
+            ncm::ProgramId program_id;
+            LaunchPhaseTimes times;
+        };
+
+        static constexpr size_t MaxLaunchPhaseRecords = 8;
+        constinit std::array<LaunchPhaseRecord, MaxLaunchPhaseRecords> g_launch_phase_records = [] {
+            std::array<LaunchPhaseRecord, MaxLaunchPhaseRecords> arr = {};
+            for (size_t i = 0; i < MaxLaunchPhaseRecords; ++i) {
+                arr[i].program_id = ncm::InvalidProgramId;
+            }
+            return arr;
+        }();
+
+        constinit size_t g_next_launch_phase_record = 0;
+
         bool HasLaunchedBootProgramImpl(ncm::ProgramId program_id) {
             for (const auto &launched : g_launched_boot_programs) {
                 if (launched == program_id) {
@@ -66,6 +82,27 @@ namespace ams::ldr {
         }
     }
 
+    bool GetLaunchPhaseTimes(LaunchPhaseTimes *out, ncm::ProgramId program_id) {
+        /* Search from the most recent launch backwards. */
+        for (size_t i = 1; i <= MaxLaunchPhaseRecords; ++i) {
+            const auto &record = g_launch_phase_records[(g_next_launch_phase_record + MaxLaunchPhaseRecords - i) % MaxLaunchPhaseRecords];
+            if (record.program_id == program_id) {
+                *out = record.times;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void SetLaunchPhaseTimes(ncm::ProgramId program_id, const LaunchPhaseTimes &times) {
+        /* Overwrite the oldest record. */
+        auto &record = g_launch_phase_records[g_next_launch_phase_record];
+        record.program_id = program_id;
+        record.times      = times;
+
+        g_next_launch_phase_record = (g_next_launch_phase_record + 1) % MaxLaunchPhaseRecords;
+    }
+
 }
 
 /* Loader wants to override this libstratosphere function, which is weakly linked. */
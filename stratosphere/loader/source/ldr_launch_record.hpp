@@ -22,4 +22,8 @@ namespace ams::ldr {
     bool HasLaunchedBootProgram(ncm::ProgramId program_id);
     void SetLaunchedBootProgram(ncm::ProgramId program_id);
 
+    /* Only the most recent launches are kept. */
+    bool GetLaunchPhaseTimes(LaunchPhaseTimes *out, ncm::ProgramId program_id);
+    void SetLaunchPhaseTimes(ncm::ProgramId program_id, const LaunchPhaseTimes &times);
+
 }
\ No newline at end of file
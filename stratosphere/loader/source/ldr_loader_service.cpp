@@ -119,6 +119,15 @@ namespace ams::ldr {
         out.SetValue(ldr::HasLaunchedBootProgram(program_id));
     }
 
+    void LoaderService::AtmosphereGetLaunchPhaseTimes(sf::Out<bool> out_found, sf::Out<LaunchPhaseTimes> out, ncm::ProgramId program_id) {
+        *out = {};
+        out_found.SetValue(ldr::GetLaunchPhaseTimes(out.GetPointer(), program_id));
+    }
+
+    void LoaderService::AtmosphereInvalidatePatchIndex() {
+        ams::patcher::InvalidatePatchIndex();
+    }
+
     Result LoaderService::AtmosphereGetProgramInfo(sf::Out<ProgramInfo> out_program_info, sf::Out<cfg::OverrideStatus> out_status, const ncm::ProgramLocation &loc) {
         return GetProgramInfoImpl(out_program_info.GetPointer(), out_status.GetPointer(), loc);
     }
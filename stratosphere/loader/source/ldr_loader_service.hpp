@@ -35,6 +35,8 @@ namespace ams::ldr {
             Result AtmosphereRegisterExternalCode(sf::OutMoveHandle out, ncm::ProgramId program_id);
             void   AtmosphereUnregisterExternalCode(ncm::ProgramId program_id);
             void   AtmosphereHasLaunchedBootProgram(sf::Out<bool> out, ncm::ProgramId program_id);
+            void   AtmosphereGetLaunchPhaseTimes(sf::Out<bool> out_found, sf::Out<LaunchPhaseTimes> out, ncm::ProgramId program_id);
+            void   AtmosphereInvalidatePatchIndex();
             Result AtmosphereGetProgramInfo(sf::Out<ProgramInfo> out_program_info, sf::Out<cfg::OverrideStatus> out_status, const ncm::ProgramLocation &loc);
             Result AtmospherePinProgram(sf::Out<PinId> out_id, const ncm::ProgramLocation &loc, const cfg::OverrideStatus &override_status);
     };
@@ -16,6 +16,7 @@
 #include <stratosphere.hpp>
 #include "ldr_development_manager.hpp"
 #include "ldr_loader_service.hpp"
+#include "ldr_worker_pool.hpp"
 
 extern "C" {
     extern u32 __start__;
@@ -210,6 +211,9 @@ int main(int argc, char **argv)
     ldr::SetDevelopmentForAntiDowngradeCheck(spl::IsDevelopment());
     ldr::SetDevelopmentForAcidSignatureCheck(spl::IsDevelopment());
 
+    /* Start the workers used to load NSOs. */
+    ldr::InitializeWorkerPool();
+
     /* Register the loader services. */
     ldr::RegisterServiceSessions();
 
@@ -21,6 +21,7 @@
 #include "ldr_patcher.hpp"
 #include "ldr_process_creation.hpp"
 #include "ldr_ro_manager.hpp"
+#include "ldr_worker_pool.hpp"
 
 namespace ams::ldr {
 
@@ -76,10 +77,37 @@ namespace ams::ldr {
             size_t    nso_size[Nso_Count];
         };
 
+        struct SegmentHashTask : public WorkerTask {
+            const void *data;
+            size_t size;
+            const u8 *expected_hash;
+            Result result;
+            TimeSpanType hash_time;
+
+            virtual void Run() override;
+        };
+
+        struct NsoLoadTask : public WorkerTask {
+            fs::FileHandle file;
+            const NsoHeader *nso_header;
+            uintptr_t map_address;
+            size_t nso_size;
+            SegmentHashTask hash_tasks[NsoHeader::Segment_Count];
+            Result result;
+            TimeSpanType read_time;
+            TimeSpanType decompress_time;
+            TimeSpanType hash_time;
+
+            virtual void Run() override;
+        };
+
         /* Global NSO header cache. */
         bool g_has_nso[Nso_Count];
         NsoHeader g_nso_headers[Nso_Count];
 
+        /* Global NSO load tasks. */
+        NsoLoadTask g_nso_load_tasks[Nso_Count];
+
         /* Anti-downgrade. */
         #include "ldr_anti_downgrade_tables.inc"
 
@@ -478,7 +506,42 @@ namespace ams::ldr {
             return ResultSuccess();
         }
 
-        Result LoadNsoSegment(fs::FileHandle file, const NsoHeader::SegmentInfo *segment, size_t file_size, const u8 *file_hash, bool is_compressed, bool check_hash, uintptr_t map_base, uintptr_t map_end) {
+        /* Uncompressed segments are read in parts of this size, so that each part is still in cache when it is hashed. */
+        constexpr size_t SegmentReadSize = 256_KB;
+
+        /* Adds the time since the current phase started to a phase's time, and starts the next phase. */
+        void EndLaunchPhase(TimeSpanType *out, os::Tick *phase_start_tick) {
+            const os::Tick cur_tick = os::GetSystemTick();
+            *out += (cur_tick - *phase_start_tick).ToTimeSpan();
+            *phase_start_tick = cur_tick;
+        }
+
+        Result VerifySegmentHash(const void *data, size_t size, const u8 *expected_hash) {
+            u8 hash[crypto::Sha256Generator::HashSize];
+            crypto::GenerateSha256Hash(hash, sizeof(hash), data, size);
+
+            R_UNLESS(std::memcmp(hash, expected_hash, sizeof(hash)) == 0, ResultInvalidNso());
+            return ResultSuccess();
+        }
+
+        void SegmentHashTask::Run() {
+            os::Tick start_tick = os::GetSystemTick();
+            this->result = VerifySegmentHash(this->data, this->size, this->expected_hash);
+            EndLaunchPhase(std::addressof(this->hash_time), std::addressof(start_tick));
+        }
+
+        Result ReadNsoSegmentData(NsoLoadTask *task, s64 offset, uintptr_t address, size_t size) {
+            os::Tick start_tick = os::GetSystemTick();
+            ON_SCOPE_EXIT { EndLaunchPhase(std::addressof(task->read_time), std::addressof(start_tick)); };
+
+            size_t read_size;
+            R_TRY(fs::ReadFile(std::addressof(read_size), task->file, offset, reinterpret_cast<void *>(address), size));
+            R_UNLESS(read_size == size, ResultInvalidNso());
+
+            return ResultSuccess();
+        }
+
+        Result LoadNsoSegment(NsoLoadTask *task, SegmentHashTask *hash_task, const NsoHeader::SegmentInfo *segment, size_t file_size, const u8 *file_hash, bool is_compressed, bool check_hash, bool defer_hash, uintptr_t map_base, uintptr_t map_end) {
             /* Select read size based on compression. */
             if (!is_compressed) {
                 file_size = segment->size;
@@ -488,60 +551,122 @@ namespace ams::ldr {
             R_UNLESS(file_size <= segment->size,                       ResultInvalidNso());
             R_UNLESS(segment->size <= std::numeric_limits<s32>::max(), ResultInvalidNso());
 
-            /* Load data from file. */
-            uintptr_t load_address = is_compressed ? map_end - file_size : map_base;
-            size_t read_size;
-            R_TRY(fs::ReadFile(std::addressof(read_size), file, segment->file_offset, reinterpret_cast<void *>(load_address), file_size));
-            R_UNLESS(read_size == file_size, ResultInvalidNso());
-
-            /* Uncompress if necessary. */
             if (is_compressed) {
-                bool decompressed = (util::DecompressLZ4(reinterpret_cast<void *>(map_base), segment->size, reinterpret_cast<const void *>(load_address), file_size) == static_cast<int>(segment->size));
-                R_UNLESS(decompressed, ResultInvalidNso());
-            }
+                /* Load compressed data to the end of the mapping. */
+                const uintptr_t load_address = map_end - file_size;
+                R_TRY(ReadNsoSegmentData(task, segment->file_offset, load_address, file_size));
+
+                /* Uncompress it into place. */
+                {
+                    os::Tick start_tick = os::GetSystemTick();
+                    const bool decompressed = (util::DecompressLZ4(reinterpret_cast<void *>(map_base), segment->size, reinterpret_cast<const void *>(load_address), file_size) == static_cast<int>(segment->size));
+                    EndLaunchPhase(std::addressof(task->decompress_time), std::addressof(start_tick));
+
+                    R_UNLESS(decompressed, ResultInvalidNso());
+                }
+
+                /* Check hash if necessary. */
+                /* LZ4 doesn't give us its output as it goes, so hash the whole segment, on another thread while we load the next one if we can. */
+                if (check_hash) {
+                    hash_task->data          = reinterpret_cast<const void *>(map_base);
+                    hash_task->size          = segment->size;
+                    hash_task->expected_hash = file_hash;
+
+                    if (defer_hash) {
+                        SubmitWorkerTask(hash_task);
+                    } else {
+                        hash_task->Run();
+                        R_TRY(hash_task->result);
+                    }
+                }
+            } else {
+                /* Load data in place, hashing each part as it arrives if necessary. */
+                crypto::Sha256Generator generator;
+                if (check_hash) {
+                    generator.Initialize();
+                }
+
+                for (size_t offset = 0; offset < segment->size; offset += SegmentReadSize) {
+                    const size_t cur_size = std::min(SegmentReadSize, segment->size - offset);
+                    R_TRY(ReadNsoSegmentData(task, segment->file_offset + offset, map_base + offset, cur_size));
+
+                    if (check_hash) {
+                        os::Tick start_tick = os::GetSystemTick();
+                        generator.Update(reinterpret_cast<const void *>(map_base + offset), cur_size);
+                        EndLaunchPhase(std::addressof(task->hash_time), std::addressof(start_tick));
+                    }
+                }
 
-            /* Check hash if necessary. */
-            if (check_hash) {
-                u8 hash[crypto::Sha256Generator::HashSize];
-                crypto::GenerateSha256Hash(hash, sizeof(hash), reinterpret_cast<void *>(map_base), segment->size);
+                /* Check hash if necessary. */
+                if (check_hash) {
+                    u8 hash[crypto::Sha256Generator::HashSize];
+                    generator.GetHash(hash, sizeof(hash));
 
-                R_UNLESS(std::memcmp(hash, file_hash, sizeof(hash)) == 0, ResultInvalidNso());
+                    R_UNLESS(std::memcmp(hash, file_hash, sizeof(hash)) == 0, ResultInvalidNso());
+                }
             }
 
             return ResultSuccess();
         }
 
-        Result LoadNsoIntoProcessMemory(Handle process_handle, fs::FileHandle file, uintptr_t map_address, const NsoHeader *nso_header, uintptr_t nso_address, size_t nso_size) {
-            /* Map and read data from file. */
-            {
-                map::AutoCloseMap mapper(map_address, process_handle, nso_address, nso_size);
-                R_TRY(mapper.GetResult());
-
-                /* Load NSO segments. */
-                R_TRY(LoadNsoSegment(file, &nso_header->segments[NsoHeader::Segment_Text], nso_header->text_compressed_size, nso_header->text_hash, (nso_header->flags & NsoHeader::Flag_CompressedText) != 0,
-                                           (nso_header->flags & NsoHeader::Flag_CheckHashText) != 0, map_address + nso_header->text_dst_offset, map_address + nso_size));
-                R_TRY(LoadNsoSegment(file, &nso_header->segments[NsoHeader::Segment_Ro], nso_header->ro_compressed_size, nso_header->ro_hash, (nso_header->flags & NsoHeader::Flag_CompressedRo) != 0,
-                                           (nso_header->flags & NsoHeader::Flag_CheckHashRo) != 0, map_address + nso_header->ro_dst_offset, map_address + nso_size));
-                R_TRY(LoadNsoSegment(file, &nso_header->segments[NsoHeader::Segment_Rw], nso_header->rw_compressed_size, nso_header->rw_hash, (nso_header->flags & NsoHeader::Flag_CompressedRw) != 0,
-                                           (nso_header->flags & NsoHeader::Flag_CheckHashRw) != 0, map_address + nso_header->rw_dst_offset, map_address + nso_size));
-
-                /* Clear unused space to zero. */
-                const size_t text_end = nso_header->text_dst_offset + nso_header->text_size;
-                const size_t ro_end   = nso_header->ro_dst_offset   + nso_header->ro_size;
-                const size_t rw_end   = nso_header->rw_dst_offset   + nso_header->rw_size;
-                std::memset(reinterpret_cast<void *>(map_address),            0, nso_header->text_dst_offset);
-                std::memset(reinterpret_cast<void *>(map_address + text_end), 0, nso_header->ro_dst_offset - text_end);
-                std::memset(reinterpret_cast<void *>(map_address + ro_end),   0, nso_header->rw_dst_offset - ro_end);
-                std::memset(reinterpret_cast<void *>(map_address + rw_end), 0, nso_header->bss_size);
-
-                /* Apply embedded patches. */
-                ApplyEmbeddedPatchesToModule(nso_header->build_id, map_address, nso_size);
-
-                /* Apply IPS patches. */
-                LocateAndApplyIpsPatchesToModule(nso_header->build_id, map_address, nso_size);
-            }
-
-            /* Set permissions. */
+        Result LoadNsoSegments(NsoLoadTask *task) {
+            const NsoHeader *nso_header = task->nso_header;
+            const uintptr_t map_address = task->map_address;
+            const uintptr_t map_end     = task->map_address + task->nso_size;
+
+            /* Compressed data is loaded to the end of the mapping, which only stays clear of earlier segments if the segments are in order. */
+            /* If they are, a segment can be hashed while the next one loads. */
+            const size_t text_end = nso_header->text_dst_offset + nso_header->text_size;
+            const size_t ro_end   = nso_header->ro_dst_offset   + nso_header->ro_size;
+            const bool defer_hash = text_end <= nso_header->ro_dst_offset && ro_end <= nso_header->rw_dst_offset;
+
+            R_TRY(LoadNsoSegment(task, &task->hash_tasks[NsoHeader::Segment_Text], &nso_header->segments[NsoHeader::Segment_Text], nso_header->text_compressed_size, nso_header->text_hash, (nso_header->flags & NsoHeader::Flag_CompressedText) != 0,
+                                       (nso_header->flags & NsoHeader::Flag_CheckHashText) != 0, defer_hash, map_address + nso_header->text_dst_offset, map_end));
+            R_TRY(LoadNsoSegment(task, &task->hash_tasks[NsoHeader::Segment_Ro], &nso_header->segments[NsoHeader::Segment_Ro], nso_header->ro_compressed_size, nso_header->ro_hash, (nso_header->flags & NsoHeader::Flag_CompressedRo) != 0,
+                                       (nso_header->flags & NsoHeader::Flag_CheckHashRo) != 0, defer_hash, map_address + nso_header->ro_dst_offset, map_end));
+            R_TRY(LoadNsoSegment(task, &task->hash_tasks[NsoHeader::Segment_Rw], &nso_header->segments[NsoHeader::Segment_Rw], nso_header->rw_compressed_size, nso_header->rw_hash, (nso_header->flags & NsoHeader::Flag_CompressedRw) != 0,
+                                       (nso_header->flags & NsoHeader::Flag_CheckHashRw) != 0, defer_hash, map_address + nso_header->rw_dst_offset, map_end));
+
+            return ResultSuccess();
+        }
+
+        void NsoLoadTask::Run() {
+            this->result = LoadNsoSegments(this);
+        }
+
+        void InitializeNsoLoadTask(NsoLoadTask *task, const NsoHeader *nso_header, uintptr_t map_address, size_t nso_size) {
+            task->nso_header      = nso_header;
+            task->map_address     = map_address;
+            task->nso_size        = nso_size;
+            task->result          = ResultSuccess();
+            task->read_time       = {};
+            task->decompress_time = {};
+            task->hash_time       = {};
+
+            for (auto &hash_task : task->hash_tasks) {
+                hash_task.result    = ResultSuccess();
+                hash_task.hash_time = {};
+            }
+        }
+
+        void PatchNsoInProcessMemory(const NsoHeader *nso_header, uintptr_t map_address, size_t nso_size) {
+            /* Clear unused space to zero. */
+            const size_t text_end = nso_header->text_dst_offset + nso_header->text_size;
+            const size_t ro_end   = nso_header->ro_dst_offset   + nso_header->ro_size;
+            const size_t rw_end   = nso_header->rw_dst_offset   + nso_header->rw_size;
+            std::memset(reinterpret_cast<void *>(map_address),            0, nso_header->text_dst_offset);
+            std::memset(reinterpret_cast<void *>(map_address + text_end), 0, nso_header->ro_dst_offset - text_end);
+            std::memset(reinterpret_cast<void *>(map_address + ro_end),   0, nso_header->rw_dst_offset - ro_end);
+            std::memset(reinterpret_cast<void *>(map_address + rw_end), 0, nso_header->bss_size);
+
+            /* Apply embedded patches. */
+            ApplyEmbeddedPatchesToModule(nso_header->build_id, map_address, nso_size);
+
+            /* Apply IPS patches. */
+            LocateAndApplyIpsPatchesToModule(nso_header->build_id, map_address, nso_size);
+        }
+
+        Result SetNsoMemoryPermissions(Handle process_handle, const NsoHeader *nso_header, uintptr_t nso_address) {
             const size_t text_size = (static_cast<size_t>(nso_header->text_size) + size_t(0xFFFul)) & ~size_t(0xFFFul);
             const size_t ro_size = (static_cast<size_t>(nso_header->ro_size)   + size_t(0xFFFul)) & ~size_t(0xFFFul);
             const size_t rw_size = (static_cast<size_t>(nso_header->rw_size + nso_header->bss_size) + size_t(0xFFFul)) & ~size_t(0xFFFul);
@@ -558,20 +683,89 @@ namespace ams::ldr {
             return ResultSuccess();
         }
 
-        Result LoadNsosIntoProcessMemory(const ProcessInfo *process_info, const NsoHeader *nso_headers, const bool *has_nso, const args::ArgumentInfo *arg_info) {
+        Result LoadNsosIntoProcessMemory(LaunchPhaseTimes *out_times, const ProcessInfo *process_info, const NsoHeader *nso_headers, const bool *has_nso, const args::ArgumentInfo *arg_info) {
             const Handle process_handle = process_info->process_handle.Get();
 
-            /* Load each NSO. */
+            /* Use global storage for NSO load tasks. */
+            NsoLoadTask *tasks = g_nso_load_tasks;
+
+            /* Open and map every NSO, so that they can all be loaded at once. */
+            /* NOTE: Nothing may fail between submitting tasks and waiting for them, as they use these files and mappings. */
+            bool is_open[Nso_Count] = {};
+            std::optional<map::AutoCloseMap> mappers[Nso_Count];
+            ON_SCOPE_EXIT {
+                for (size_t i = 0; i < Nso_Count; i++) {
+                    if (is_open[i]) {
+                        fs::CloseFile(tasks[i].file);
+                    }
+                }
+            };
+
             for (size_t i = 0; i < Nso_Count; i++) {
                 if (has_nso[i]) {
-                    fs::FileHandle file;
-                    R_TRY(fs::OpenFile(std::addressof(file), GetNsoPath(i), fs::OpenMode_Read));
-                    ON_SCOPE_EXIT { fs::CloseFile(file); };
+                    R_TRY(fs::OpenFile(std::addressof(tasks[i].file), GetNsoPath(i), fs::OpenMode_Read));
+                    is_open[i] = true;
 
                     uintptr_t map_address = 0;
                     R_TRY(map::LocateMappableSpace(&map_address, process_info->nso_size[i]));
 
-                    R_TRY(LoadNsoIntoProcessMemory(process_handle, file, map_address, nso_headers + i, process_info->nso_address[i], process_info->nso_size[i]));
+                    mappers[i].emplace(map_address, process_handle, process_info->nso_address[i], process_info->nso_size[i]);
+                    R_TRY(mappers[i]->GetResult());
+
+                    InitializeNsoLoadTask(tasks + i, nso_headers + i, map_address, process_info->nso_size[i]);
+                }
+            }
+
+            /* Load NSO segments on the worker pool, largest NSO first so that the work is spread evenly. */
+            {
+                bool is_submitted[Nso_Count] = {};
+                while (true) {
+                    size_t largest = Nso_Count;
+                    for (size_t i = 0; i < Nso_Count; i++) {
+                        if (has_nso[i] && !is_submitted[i] && (largest == Nso_Count || process_info->nso_size[i] > process_info->nso_size[largest])) {
+                            largest = i;
+                        }
+                    }
+
+                    if (largest == Nso_Count) {
+                        break;
+                    }
+
+                    SubmitWorkerTask(tasks + largest);
+                    is_submitted[largest] = true;
+                }
+
+                WaitWorkerTasks();
+            }
+
+            /* Check that every segment loaded, and note how long it took. */
+            for (size_t i = 0; i < Nso_Count; i++) {
+                if (has_nso[i]) {
+                    R_TRY(tasks[i].result);
+                    out_times->read_segments       += tasks[i].read_time;
+                    out_times->decompress_segments += tasks[i].decompress_time;
+                    out_times->hash_segments       += tasks[i].hash_time;
+
+                    for (const auto &hash_task : tasks[i].hash_tasks) {
+                        R_TRY(hash_task.result);
+                        out_times->hash_segments += hash_task.hash_time;
+                    }
+                }
+            }
+
+            /* Finish each NSO. */
+            for (size_t i = 0; i < Nso_Count; i++) {
+                if (has_nso[i]) {
+                    /* Clear and patch, then unmap. */
+                    {
+                        os::Tick start_tick = os::GetSystemTick();
+                        PatchNsoInProcessMemory(nso_headers + i, tasks[i].map_address, process_info->nso_size[i]);
+                        EndLaunchPhase(std::addressof(out_times->patch_nsos), std::addressof(start_tick));
+                    }
+                    mappers[i].reset();
+
+                    /* Set permissions. */
+                    R_TRY(SetNsoMemoryPermissions(process_handle, nso_headers + i, process_info->nso_address[i]));
                 }
             }
 
@@ -608,6 +802,11 @@ namespace ams::ldr {
         bool *has_nso = g_has_nso;
         const auto arg_info = args::Get(loc.program_id);
 
+        /* Time each phase, for the launch record. */
+        LaunchPhaseTimes times = {};
+        const os::Tick start_tick = os::GetSystemTick();
+        os::Tick phase_start_tick = start_tick;
+
         {
             /* Mount code. */
             ScopedCodeMount mount(loc, override_status);
@@ -619,17 +818,21 @@ namespace ams::ldr {
 
             /* Validate meta. */
             R_TRY(ValidateMeta(&meta, loc, mount.GetCodeVerificationData()));
+            EndLaunchPhase(std::addressof(times.load_meta), std::addressof(phase_start_tick));
 
             /* Load, validate NSOs. */
             R_TRY(LoadNsoHeaders(nso_headers, has_nso));
             R_TRY(ValidateNsoHeaders(nso_headers, has_nso));
+            EndLaunchPhase(std::addressof(times.load_nso_headers), std::addressof(phase_start_tick));
 
             /* Actually create process. */
             ProcessInfo info;
             R_TRY(CreateProcessImpl(&info, &meta, nso_headers, has_nso, arg_info, flags, reslimit_h));
+            EndLaunchPhase(std::addressof(times.create_process), std::addressof(phase_start_tick));
 
             /* Load NSOs into process memory. */
-            R_TRY(LoadNsosIntoProcessMemory(&info, nso_headers, has_nso, arg_info));
+            R_TRY(LoadNsosIntoProcessMemory(std::addressof(times), &info, nso_headers, has_nso, arg_info));
+            EndLaunchPhase(std::addressof(times.load_nsos), std::addressof(phase_start_tick));
 
             /* Register NSOs with ro manager. */
             {
@@ -659,6 +862,9 @@ namespace ams::ldr {
             /* Note that we've created the program. */
             SetLaunchedBootProgram(loc.program_id);
 
+            times.total = (os::GetSystemTick() - start_tick).ToTimeSpan();
+            SetLaunchPhaseTimes(loc.program_id, times);
+
             /* Move the process handle to output. */
             *out = info.process_handle.Move();
         }
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "ldr_worker_pool.hpp"
+
+namespace ams::ldr {
+
+    namespace {
+
+        /* Convenience defines. */
+        constexpr s32    WorkerCountMax        = 2;
+        constexpr size_t WorkerThreadStackSize = 16_KB;
+
+        /* Loader's heap is tiny, so worker stacks are static. */
+        alignas(os::ThreadStackAlignment) constinit u8 g_worker_thread_stacks[WorkerCountMax][WorkerThreadStackSize];
+        constinit os::ThreadType g_worker_threads[WorkerCountMax];
+        constinit s32 g_worker_thread_count = 0;
+
+        /* NOTE: This guards the task queue and the pending task count. */
+        constinit os::SdkMutex g_task_mutex;
+        constinit os::SdkConditionVariable g_task_queue_cv;
+        constinit os::SdkConditionVariable g_task_done_cv;
+        constinit s32 g_pending_task_count = 0;
+
+        WorkerTaskList g_task_queue;
+
+        WorkerTask *DequeueTask() {
+            /* NOTE: This must be called with g_task_mutex held. */
+            WorkerTask *task = std::addressof(g_task_queue.front());
+            g_task_queue.pop_front();
+            return task;
+        }
+
+        void CompleteTask() {
+            /* NOTE: This must be called with g_task_mutex held. */
+            if ((--g_pending_task_count) == 0) {
+                g_task_done_cv.Broadcast();
+            }
+        }
+
+        void WorkerThreadFunction(void *arg) {
+            AMS_UNUSED(arg);
+
+            while (true) {
+                /* Take the oldest task. */
+                WorkerTask *task;
+                {
+                    std::scoped_lock lk(g_task_mutex);
+
+                    while (g_task_queue.empty()) {
+                        g_task_queue_cv.Wait(g_task_mutex);
+                    }
+
+                    task = DequeueTask();
+                }
+
+                /* Run it. */
+                task->Run();
+
+                {
+                    std::scoped_lock lk(g_task_mutex);
+                    CompleteTask();
+                }
+            }
+        }
+
+        bool CreateWorkerThread(s32 core) {
+            os::ThreadType *thread = std::addressof(g_worker_threads[g_worker_thread_count]);
+            void *stack = g_worker_thread_stacks[g_worker_thread_count];
+            const s32 priority = AMS_GET_SYSTEM_THREAD_PRIORITY(ldr, LoadWorker);
+
+            /* A negative core means the process's default core. */
+            const Result create_result = (core >= 0) ? os::CreateThread(thread, WorkerThreadFunction, nullptr, stack, WorkerThreadStackSize, priority, core)
+                                                     : os::CreateThread(thread, WorkerThreadFunction, nullptr, stack, WorkerThreadStackSize, priority);
+            if (R_FAILED(create_result)) {
+                return false;
+            }
+
+            os::SetThreadNamePointer(thread, AMS_GET_SYSTEM_THREAD_NAME(ldr, LoadWorker));
+            os::StartThread(thread);
+
+            ++g_worker_thread_count;
+            return true;
+        }
+
+    }
+
+    /* Worker Pool API. */
+    void InitializeWorkerPool() {
+        /* Prefer to place workers on the other cores we may use, so they can run alongside the main thread. */
+        const s32 current_core = os::GetCurrentCoreNumber();
+        const u64 core_mask    = os::GetThreadAvailableCoreMask();
+
+        for (s32 core = 0; core < static_cast<s32>(BITSIZEOF(core_mask)) && g_worker_thread_count < WorkerCountMax; ++core) {
+            if (core == current_core || (core_mask & (static_cast<u64>(1) << core)) == 0) {
+                continue;
+            }
+
+            /* If we can't create a worker, make do with the ones we have. */
+            if (!CreateWorkerThread(core)) {
+                break;
+            }
+        }
+
+        /* If we're limited to our own core, a single worker still lets file reads overlap with decompression and hashing. */
+        if (g_worker_thread_count == 0) {
+            CreateWorkerThread(-1);
+        }
+    }
+
+    void SubmitWorkerTask(WorkerTask *task) {
+        std::scoped_lock lk(g_task_mutex);
+
+        ++g_pending_task_count;
+        g_task_queue.push_back(*task);
+        g_task_queue_cv.Signal();
+
+        /* Tasks may be submitted by other tasks, so wake any waiter to help run it. */
+        g_task_done_cv.Broadcast();
+    }
+
+    void WaitWorkerTasks() {
+        std::unique_lock lk(g_task_mutex);
+
+        while (g_pending_task_count > 0) {
+            /* Run any tasks which the workers haven't gotten to. */
+            if (!g_task_queue.empty()) {
+                WorkerTask *task = DequeueTask();
+
+                lk.unlock();
+                task->Run();
+                lk.lock();
+
+                CompleteTask();
+            } else {
+                g_task_done_cv.Wait(g_task_mutex);
+            }
+        }
+    }
+
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+
+namespace ams::ldr {
+
+    /* A unit of work which may be run on one of the loader's worker threads. */
+    /* Tasks may submit further tasks while they run. */
+    class WorkerTask : public util::IntrusiveListBaseNode<WorkerTask> {
+        public:
+            virtual void Run() = 0;
+    };
+
+    using WorkerTaskList = util::IntrusiveListBaseTraits<WorkerTask>::ListType;
+
+    /* Worker Pool API. */
+    void InitializeWorkerPool();
+
+    void SubmitWorkerTask(WorkerTask *task);
+
+    /* Runs queued tasks on the calling thread until every submitted task has completed. */
+    void WaitWorkerTasks();
+
+}
@@ -24,4 +24,8 @@ namespace ams::ro {
         return impl::GetProcessModuleInfo(out_count.GetPointer(), out_infos.GetPointer(), out_infos.GetSize(), process_id);
     }
 
+    void DebugMonitorService::AtmosphereInvalidatePatchIndex() {
+        ams::patcher::InvalidatePatchIndex();
+    }
+
 }
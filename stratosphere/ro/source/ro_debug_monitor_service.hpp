@@ -21,6 +21,9 @@ namespace ams::ro {
     class DebugMonitorService {
         public:
             Result GetProcessModuleInfo(sf::Out<u32> out_count, const sf::OutArray<LoaderModuleInfo> &out_infos, os::ProcessId process_id);
+
+            /* Atmosphere commands. */
+            void AtmosphereInvalidatePatchIndex();
     };
     static_assert(ro::impl::IsIDebugMonitorInterface<DebugMonitorService>);
 
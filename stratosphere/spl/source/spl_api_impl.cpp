@@ -16,6 +16,7 @@
 #include <stratosphere.hpp>
 #include "spl_api_impl.hpp"
 #include "spl_ctr_drbg.hpp"
+#include "spl_device_address_space_map_cache.hpp"
 #include "spl_key_slot_cache.hpp"
 
 namespace ams::spl::impl {
@@ -28,6 +29,9 @@ namespace ams::spl::impl {
         constexpr u32 ComputeAesInMapBase  = 0x90000000u;
         constexpr u32 ComputeAesOutMapBase = 0xC0000000u;
         constexpr size_t ComputeAesSizeMax = static_cast<size_t>(ComputeAesOutMapBase - ComputeAesInMapBase);
+        constexpr u64 ComputeAesMapEnd     = UINT64_C(1) << 32;
+
+        constexpr size_t ComputeCtrBatchRegionCountMax = 0x40;
 
         constexpr size_t RsaPrivateKeySize = 0x100;
         constexpr size_t DeviceUniqueDataMetaSize = 0x30;
@@ -220,22 +224,6 @@ namespace ams::spl::impl {
             SeLinkedListEntry out;
         };
 
-        class DeviceAddressSpaceMapHelper {
-            private:
-                Handle das_hnd;
-                u64 dst_addr;
-                u64 src_addr;
-                size_t size;
-                u32 perm;
-            public:
-                DeviceAddressSpaceMapHelper(Handle h, u64 dst, u64 src, size_t sz, u32 p) : das_hnd(h), dst_addr(dst), src_addr(src), size(sz), perm(p) {
-                    R_ABORT_UNLESS(svcMapDeviceAddressSpaceAligned(this->das_hnd, dd::GetCurrentProcessHandle(), this->src_addr, this->size, this->dst_addr, this->perm));
-                }
-                ~DeviceAddressSpaceMapHelper() {
-                    R_ABORT_UNLESS(svcUnmapDeviceAddressSpace(this->das_hnd, dd::GetCurrentProcessHandle(), this->src_addr, this->size, this->dst_addr));
-                }
-        };
-
         /* Global variables. */
         CtrDrbg g_drbg;
         os::InterruptEventType g_se_event;
@@ -245,6 +233,10 @@ namespace ams::spl::impl {
         u32 g_se_mapped_work_buffer_addr;
         alignas(os::MemoryPageSize) u8 g_work_buffer[2 * WorkBufferSizeMax];
 
+        /* NOTE: ComputeCtr's buffers are IPC buffers, which the kernel can only unmap once we've unmapped them from the SE. */
+        /* Thus, cached mappings are only reused within a single request, and everything is invalidated before replying. */
+        DeviceAddressSpaceMapCache g_se_map_cache;
+
         os::Mutex g_async_op_lock(false);
 
         BootReasonValue g_boot_reason;
@@ -289,6 +281,9 @@ namespace ams::spl::impl {
 
             /* Map the work buffer for the SE. */
             R_ABORT_UNLESS(svcMapDeviceAddressSpaceAligned(g_se_das_hnd, dd::GetCurrentProcessHandle(), work_buffer_addr, sizeof(g_work_buffer), g_se_mapped_work_buffer_addr, 3));
+
+            /* Buffers for ComputeCtr are mapped above the work buffer. */
+            g_se_map_cache.Initialize(g_se_das_hnd, ComputeAesInMapBase, ComputeAesMapEnd);
         }
 
         /* Internal RNG functionality. */
@@ -498,6 +493,73 @@ namespace ams::spl::impl {
             return ResultSuccess();
         }
 
+        class DeviceAddressSpaceMapHelper {
+            private:
+                DeviceAddressSpaceMapCacheEntry *entry;
+            public:
+                DeviceAddressSpaceMapHelper(u64 addr, size_t sz, u32 p) : entry(g_se_map_cache.Acquire(dd::GetCurrentProcessHandle(), addr, sz, p)) { /* ... */ }
+                ~DeviceAddressSpaceMapHelper() {
+                    g_se_map_cache.Release(this->entry);
+                }
+
+                u32 GetDeviceAddress(u64 addr) const {
+                    return this->entry->GetDeviceAddress(addr);
+                }
+        };
+
+        Result ComputeCtrImpl(void *dst, size_t dst_size, s32 keyslot, const void *src, size_t src_size, const IvCtr &iv_ctr) {
+            /* Validate sizes. */
+            R_UNLESS(src_size <= dst_size,                      spl::ResultInvalidSize());
+            R_UNLESS(util::IsAligned(src_size, AES_BLOCK_SIZE), spl::ResultInvalidSize());
+
+            /* We can only map 0x400000 aligned buffers for the SE. With that in mind, we have some math to do. */
+            const uintptr_t src_addr = reinterpret_cast<uintptr_t>(src);
+            const uintptr_t dst_addr = reinterpret_cast<uintptr_t>(dst);
+            const size_t src_size_page_aligned = util::AlignUp(src_addr + src_size, os::MemoryPageSize) - util::AlignDown(src_addr, os::MemoryPageSize);
+            const size_t dst_size_page_aligned = util::AlignUp(dst_addr + dst_size, os::MemoryPageSize) - util::AlignDown(dst_addr, os::MemoryPageSize);
+
+            /* Validate aligned sizes. */
+            R_UNLESS(src_size_page_aligned <= ComputeAesSizeMax, spl::ResultInvalidSize());
+            R_UNLESS(dst_size_page_aligned <= ComputeAesSizeMax, spl::ResultInvalidSize());
+
+            /* Helpers for mapping/unmapping. */
+            DeviceAddressSpaceMapHelper in_mapper(src_addr,  src_size, 1);
+            DeviceAddressSpaceMapHelper out_mapper(dst_addr, dst_size, 2);
+            const u32 src_se_addr = in_mapper.GetDeviceAddress(src_addr);
+            const u32 dst_se_addr = out_mapper.GetDeviceAddress(dst_addr);
+
+            /* Setup SE linked list entries. */
+            SeCryptContext *crypt_ctx = reinterpret_cast<SeCryptContext *>(g_work_buffer);
+            crypt_ctx->in.num_entries = 0;
+            crypt_ctx->in.address = src_se_addr;
+            crypt_ctx->in.size = src_size;
+            crypt_ctx->out.num_entries = 0;
+            crypt_ctx->out.address = dst_se_addr;
+            crypt_ctx->out.size = dst_size;
+
+            armDCacheFlush(crypt_ctx, sizeof(*crypt_ctx));
+            armDCacheFlush(const_cast<void *>(src), src_size);
+            armDCacheFlush(dst, dst_size);
+            {
+                std::scoped_lock lk(g_async_op_lock);
+                smc::AsyncOperationKey op_key;
+                const u32 mode = smc::GetComputeAesMode(smc::CipherMode::Ctr, GetPhysicalKeySlot(keyslot, true));
+                const u32 dst_ll_addr = g_se_mapped_work_buffer_addr + offsetof(SeCryptContext, out);
+                const u32 src_ll_addr = g_se_mapped_work_buffer_addr + offsetof(SeCryptContext, in);
+
+                smc::Result res = smc::ComputeAes(&op_key, mode, iv_ctr, dst_ll_addr, src_ll_addr, src_size);
+                if (res != smc::Result::Success) {
+                    return smc::ConvertResult(res);
+                }
+
+                if ((res = WaitCheckStatus(op_key)) != smc::Result::Success) {
+                    return smc::ConvertResult(res);
+                }
+            }
+            armDCacheFlush(dst, dst_size);
+
+            return ResultSuccess();
+        }
 
     }
 
@@ -665,63 +727,58 @@ namespace ams::spl::impl {
             return ResultSuccess();
         }
 
-        /* Validate sizes. */
-        R_UNLESS(src_size <= dst_size,                      spl::ResultInvalidSize());
-        R_UNLESS(util::IsAligned(src_size, AES_BLOCK_SIZE), spl::ResultInvalidSize());
-
-        /* We can only map 0x400000 aligned buffers for the SE. With that in mind, we have some math to do. */
-        const uintptr_t src_addr = reinterpret_cast<uintptr_t>(src);
-        const uintptr_t dst_addr = reinterpret_cast<uintptr_t>(dst);
-        const uintptr_t src_addr_page_aligned = util::AlignDown(src_addr, os::MemoryPageSize);
-        const uintptr_t dst_addr_page_aligned = util::AlignDown(dst_addr, os::MemoryPageSize);
-        const size_t src_size_page_aligned = util::AlignUp(src_addr + src_size, os::MemoryPageSize) - src_addr_page_aligned;
-        const size_t dst_size_page_aligned = util::AlignUp(dst_addr + dst_size, os::MemoryPageSize) - dst_addr_page_aligned;
-        const u32 src_se_map_addr = ComputeAesInMapBase + (src_addr_page_aligned % DeviceAddressSpaceAlign);
-        const u32 dst_se_map_addr = ComputeAesOutMapBase + (dst_addr_page_aligned % DeviceAddressSpaceAlign);
-        const u32 src_se_addr = ComputeAesInMapBase + (src_addr % DeviceAddressSpaceAlign);
-        const u32 dst_se_addr = ComputeAesOutMapBase + (dst_addr % DeviceAddressSpaceAlign);
-
-        /* Validate aligned sizes. */
+        /* Our buffers are about to be unmapped, so drop any SE mappings of them. */
+        ON_SCOPE_EXIT { g_se_map_cache.InvalidateAll(); };
+
+        return ComputeCtrImpl(dst, dst_size, keyslot, src, src_size, iv_ctr);
+    }
+
+    Result ComputeCtrBatch(void *dst, size_t dst_size, s32 keyslot, const void *owner, const void *src, size_t src_size, const ComputeCtrRegion *regions, size_t num_regions) {
+        R_TRY(ValidateAesKeySlot(keyslot, owner));
+
+        /* Validate every region before crypting any of them. */
+        R_UNLESS(num_regions <= ComputeCtrBatchRegionCountMax, spl::ResultInvalidSize());
+        R_UNLESS(src_size <= dst_size,                         spl::ResultInvalidSize());
+        for (size_t i = 0; i < num_regions; i++) {
+            R_UNLESS(regions[i].offset <= src_size,                      spl::ResultInvalidSize());
+            R_UNLESS(regions[i].size <= src_size - regions[i].offset,    spl::ResultInvalidSize());
+            R_UNLESS(util::IsAligned(regions[i].size, AES_BLOCK_SIZE),   spl::ResultInvalidSize());
+        }
+
+        /* Succeed immediately if there's nothing to crypt. */
+        if (src_size == 0) {
+            return ResultSuccess();
+        }
+
+        /* Our buffers are about to be unmapped, so drop any SE mappings of them. */
+        ON_SCOPE_EXIT { g_se_map_cache.InvalidateAll(); };
+
+        /* Map both buffers whole up front, so that every region reuses the same two mappings. */
+        const size_t src_size_page_aligned = util::AlignUp(reinterpret_cast<uintptr_t>(src) + src_size, os::MemoryPageSize) - util::AlignDown(reinterpret_cast<uintptr_t>(src), os::MemoryPageSize);
+        const size_t dst_size_page_aligned = util::AlignUp(reinterpret_cast<uintptr_t>(dst) + dst_size, os::MemoryPageSize) - util::AlignDown(reinterpret_cast<uintptr_t>(dst), os::MemoryPageSize);
         R_UNLESS(src_size_page_aligned <= ComputeAesSizeMax, spl::ResultInvalidSize());
         R_UNLESS(dst_size_page_aligned <= ComputeAesSizeMax, spl::ResultInvalidSize());
 
-        /* Helpers for mapping/unmapping. */
-        DeviceAddressSpaceMapHelper in_mapper(g_se_das_hnd,  src_se_map_addr, src_addr_page_aligned, src_size_page_aligned, 1);
-        DeviceAddressSpaceMapHelper out_mapper(g_se_das_hnd, dst_se_map_addr, dst_addr_page_aligned, dst_size_page_aligned, 2);
-
-        /* Setup SE linked list entries. */
-        SeCryptContext *crypt_ctx = reinterpret_cast<SeCryptContext *>(g_work_buffer);
-        crypt_ctx->in.num_entries = 0;
-        crypt_ctx->in.address = src_se_addr;
-        crypt_ctx->in.size = src_size;
-        crypt_ctx->out.num_entries = 0;
-        crypt_ctx->out.address = dst_se_addr;
-        crypt_ctx->out.size = dst_size;
-
-        armDCacheFlush(crypt_ctx, sizeof(*crypt_ctx));
-        armDCacheFlush(const_cast<void *>(src), src_size);
-        armDCacheFlush(dst, dst_size);
-        {
-            std::scoped_lock lk(g_async_op_lock);
-            smc::AsyncOperationKey op_key;
-            const u32 mode = smc::GetComputeAesMode(smc::CipherMode::Ctr, GetPhysicalKeySlot(keyslot, true));
-            const u32 dst_ll_addr = g_se_mapped_work_buffer_addr + offsetof(SeCryptContext, out);
-            const u32 src_ll_addr = g_se_mapped_work_buffer_addr + offsetof(SeCryptContext, in);
+        DeviceAddressSpaceMapHelper in_mapper(reinterpret_cast<uintptr_t>(src),  src_size, 1);
+        DeviceAddressSpaceMapHelper out_mapper(reinterpret_cast<uintptr_t>(dst), dst_size, 2);
 
-            smc::Result res = smc::ComputeAes(&op_key, mode, iv_ctr, dst_ll_addr, src_ll_addr, src_size);
-            if (res != smc::Result::Success) {
-                return smc::ConvertResult(res);
+        /* Crypt each region to the same offset in the output. */
+        for (size_t i = 0; i < num_regions; i++) {
+            if (regions[i].size == 0) {
+                continue;
             }
 
-            if ((res = WaitCheckStatus(op_key)) != smc::Result::Success) {
-                return smc::ConvertResult(res);
-            }
+            const size_t offset = regions[i].offset;
+            R_TRY(ComputeCtrImpl(static_cast<u8 *>(dst) + offset, regions[i].size, keyslot, static_cast<const u8 *>(src) + offset, regions[i].size, regions[i].iv_ctr));
         }
-        armDCacheFlush(dst, dst_size);
 
         return ResultSuccess();
     }
 
+    void GetComputeCtrMappingCounters(u64 *out_created, u64 *out_reused) {
+        g_se_map_cache.GetCounters(out_created, out_reused);
+    }
+
     Result ComputeCmac(Cmac *out_cmac, s32 keyslot, const void *owner, const void *data, size_t size) {
         R_TRY(ValidateAesKeySlot(keyslot, owner));
 
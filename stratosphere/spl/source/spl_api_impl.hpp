@@ -36,6 +36,8 @@ namespace ams::spl::impl {
     Result GenerateAesKey(AesKey *out_key, const AccessKey &access_key, const KeySource &key_source);
     Result DecryptAesKey(AesKey *out_key, const KeySource &key_source, u32 generation, u32 option);
     Result ComputeCtr(void *dst, size_t dst_size, s32 keyslot, const void *owner, const void *src, size_t src_size, const IvCtr &iv_ctr);
+    Result ComputeCtrBatch(void *dst, size_t dst_size, s32 keyslot, const void *owner, const void *src, size_t src_size, const ComputeCtrRegion *regions, size_t num_regions);
+    void GetComputeCtrMappingCounters(u64 *out_created, u64 *out_reused);
     Result ComputeCmac(Cmac *out_cmac, s32 keyslot, const void *owner, const void *data, size_t size);
     Result AllocateAesKeySlot(s32 *out_keyslot, const void *owner);
     Result DeallocateAesKeySlot(s32 keyslot, const void *owner);
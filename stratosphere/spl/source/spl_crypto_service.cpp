@@ -61,4 +61,13 @@ namespace ams::spl {
         return ResultSuccess();
     }
 
+    Result CryptoService::AtmosphereComputeCtrBatch(const sf::OutNonSecureBuffer &out_buf, s32 keyslot, const sf::InNonSecureBuffer &in_buf, const sf::InArray<ComputeCtrRegion> &regions) {
+        return impl::ComputeCtrBatch(out_buf.GetPointer(), out_buf.GetSize(), keyslot, this, in_buf.GetPointer(), in_buf.GetSize(), regions.GetPointer(), regions.GetSize());
+    }
+
+    Result CryptoService::AtmosphereGetComputeCtrMappingCounters(sf::Out<u64> out_created, sf::Out<u64> out_reused) {
+        impl::GetComputeCtrMappingCounters(out_created.GetPointer(), out_reused.GetPointer());
+        return ResultSuccess();
+    }
+
 }
@@ -32,6 +32,10 @@ namespace ams::spl {
             Result AllocateAesKeySlot(sf::Out<s32> out_keyslot);
             Result DeallocateAesKeySlot(s32 keyslot);
             Result GetAesKeySlotAvailableEvent(sf::OutCopyHandle out_hnd);
+
+            /* Atmosphere extension commands. */
+            Result AtmosphereComputeCtrBatch(const sf::OutNonSecureBuffer &out_buf, s32 keyslot, const sf::InNonSecureBuffer &in_buf, const sf::InArray<ComputeCtrRegion> &regions);
+            Result AtmosphereGetComputeCtrMappingCounters(sf::Out<u64> out_created, sf::Out<u64> out_reused);
     };
     static_assert(spl::impl::IsICryptoInterface<CryptoService>);
 
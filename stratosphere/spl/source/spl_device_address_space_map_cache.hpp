@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+
+namespace ams::spl {
+
+    class DeviceAddressSpaceMapCacheEntry : public util::IntrusiveListBaseNode<DeviceAddressSpaceMapCacheEntry> {
+        NON_COPYABLE(DeviceAddressSpaceMapCacheEntry);
+        NON_MOVEABLE(DeviceAddressSpaceMapCacheEntry);
+        private:
+            friend class DeviceAddressSpaceMapCache;
+        private:
+            Handle process_handle;
+            u64 process_address;
+            size_t size;
+            u64 device_address;
+            u32 perm;
+            s32 ref_count;
+        public:
+            constexpr DeviceAddressSpaceMapCacheEntry() : process_handle(INVALID_HANDLE), process_address(0), size(0), device_address(0), perm(0), ref_count(0) { /* ... */ }
+
+            bool IsMapped() const { return this->size != 0; }
+
+            bool Contains(Handle process_handle, u64 address, size_t size, u32 perm) const {
+                return this->IsMapped() && this->process_handle == process_handle && (this->perm & perm) == perm &&
+                       this->process_address <= address && address + size <= this->process_address + this->size;
+            }
+
+            bool Overlaps(u64 device_address, size_t size) const {
+                return this->IsMapped() && device_address < this->device_address + this->size && this->device_address < device_address + size;
+            }
+
+            u32 GetDeviceAddress(u64 address) const {
+                AMS_ASSERT(this->process_address <= address && address < this->process_address + this->size);
+                return static_cast<u32>(this->device_address + (address - this->process_address));
+            }
+    };
+
+    /* Keeps recently used device address space mappings around, so that mapping a range which is already mapped is free. */
+    /* Entries in use are reference counted; the least recently used unreferenced entry is evicted when a new one is needed. */
+    class DeviceAddressSpaceMapCache {
+        NON_COPYABLE(DeviceAddressSpaceMapCache);
+        NON_MOVEABLE(DeviceAddressSpaceMapCache);
+        public:
+            static constexpr size_t EntryCountMax           = 8;
+            static constexpr size_t DeviceAddressSpaceAlign = 0x400000;
+        private:
+            using DeviceAddressSpaceMapCacheEntryList = util::IntrusiveListBaseTraits<DeviceAddressSpaceMapCacheEntry>::ListType;
+        private:
+            DeviceAddressSpaceMapCacheEntry entries[EntryCountMax];
+            DeviceAddressSpaceMapCacheEntryList mru_list;
+            Handle das_handle;
+            u64 window_begin;
+            u64 window_end;
+            u64 created_count;
+            u64 reused_count;
+        public:
+            constexpr DeviceAddressSpaceMapCache() : entries(), mru_list(), das_handle(INVALID_HANDLE), window_begin(0), window_end(0), created_count(0), reused_count(0) { /* ... */ }
+
+            void Initialize(Handle das_handle, u64 window_begin, u64 window_end) {
+                AMS_ASSERT(util::IsAligned(window_begin, DeviceAddressSpaceAlign));
+
+                this->das_handle   = das_handle;
+                this->window_begin = window_begin;
+                this->window_end   = window_end;
+
+                for (auto &entry : this->entries) {
+                    this->mru_list.push_back(entry);
+                }
+            }
+
+            DeviceAddressSpaceMapCacheEntry *Acquire(Handle process_handle, u64 address, size_t size, u32 perm) {
+                const u64 map_address = util::AlignDown(address, os::MemoryPageSize);
+                const size_t map_size = util::AlignUp(address + size, os::MemoryPageSize) - map_address;
+
+                /* If the range is already mapped, use the existing mapping. */
+                for (auto it = this->mru_list.begin(); it != this->mru_list.end(); ++it) {
+                    if (it->Contains(process_handle, map_address, map_size, perm)) {
+                        ++it->ref_count;
+                        ++this->reused_count;
+
+                        this->UpdateMru(it);
+                        return std::addressof(*it);
+                    }
+                }
+
+                /* Otherwise, take the least recently used entry that isn't in use. */
+                auto it = this->mru_list.rbegin();
+                while (it != this->mru_list.rend() && it->ref_count > 0) {
+                    ++it;
+                }
+                AMS_ABORT_UNLESS(it != this->mru_list.rend());
+
+                DeviceAddressSpaceMapCacheEntry *entry = std::addressof(*it);
+                this->Unmap(entry);
+
+                /* Find somewhere to map it, evicting everything not in use if we have to. */
+                u64 device_address;
+                if (!this->FindDeviceAddress(std::addressof(device_address), map_address, map_size)) {
+                    this->InvalidateAll();
+                    AMS_ABORT_UNLESS(this->FindDeviceAddress(std::addressof(device_address), map_address, map_size));
+                }
+
+                R_ABORT_UNLESS(svcMapDeviceAddressSpaceAligned(this->das_handle, process_handle, map_address, map_size, device_address, perm));
+
+                entry->process_handle  = process_handle;
+                entry->process_address = map_address;
+                entry->size            = map_size;
+                entry->device_address  = device_address;
+                entry->perm            = perm;
+                entry->ref_count       = 1;
+                ++this->created_count;
+
+                this->mru_list.erase(this->mru_list.iterator_to(*entry));
+                this->mru_list.push_front(*entry);
+                return entry;
+            }
+
+            void Release(DeviceAddressSpaceMapCacheEntry *entry) {
+                AMS_ASSERT(entry->ref_count > 0);
+                --entry->ref_count;
+            }
+
+            /* Unmaps every entry not in use, e.g. because the memory they map is about to go away. */
+            void InvalidateAll() {
+                for (auto &entry : this->entries) {
+                    if (entry.ref_count == 0) {
+                        this->Unmap(std::addressof(entry));
+                    }
+                }
+            }
+
+            void GetCounters(u64 *out_created, u64 *out_reused) const {
+                *out_created = this->created_count;
+                *out_reused  = this->reused_count;
+            }
+        private:
+            bool FindDeviceAddress(u64 *out, u64 map_address, size_t map_size) const {
+                /* Device addresses must share the process address's offset into a DeviceAddressSpaceAlign-sized region. */
+                for (u64 device_address = this->window_begin + (map_address % DeviceAddressSpaceAlign); device_address + map_size <= this->window_end; device_address += DeviceAddressSpaceAlign) {
+                    bool overlaps = false;
+                    for (const auto &entry : this->entries) {
+                        if (entry.Overlaps(device_address, map_size)) {
+                            overlaps = true;
+                            break;
+                        }
+                    }
+
+                    if (!overlaps) {
+                        *out = device_address;
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            void Unmap(DeviceAddressSpaceMapCacheEntry *entry) {
+                if (entry->IsMapped()) {
+                    R_ABORT_UNLESS(svcUnmapDeviceAddressSpace(this->das_handle, entry->process_handle, entry->process_address, entry->size, entry->device_address));
+                    entry->size = 0;
+                }
+            }
+
+            void UpdateMru(DeviceAddressSpaceMapCacheEntryList::iterator it) {
+                auto *entry = std::addressof(*it);
+                this->mru_list.erase(it);
+                this->mru_list.push_front(*entry);
+            }
+    };
+
+}
@@ -0,0 +1,470 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vapours.hpp>
+#include <vector>
+#include "crypto_x64_impl.hpp"
+
+namespace ams::diag {
+
+    void AbortImpl(const char *file, int line, const char *func, const char *expr, u64 value, const char *format, ...) {
+        std::fprintf(stderr, "Abort: %s:%d %s (%s, 0x%" PRIx64 ")\n", file, line, func, expr, value);
+        AMS_UNUSED(format);
+        std::abort();
+    }
+
+    void AbortImpl(const char *file, int line, const char *func, const char *expr, u64 value) {
+        AbortImpl(file, line, func, expr, value, "");
+    }
+
+    void AbortImpl() {
+        std::abort();
+    }
+
+}
+
+namespace ams::test {
+
+    namespace {
+
+        using Bytes = std::vector<u8>;
+
+        constinit int g_check_count   = 0;
+        constinit int g_failure_count = 0;
+        constinit const char *g_mode_name = "";
+
+        Bytes ParseHex(const char *str) {
+            auto ParseNybble = [](char c) -> u8 {
+                if ('0' <= c && c <= '9') {
+                    return c - '0';
+                } else if ('a' <= c && c <= 'f') {
+                    return c - 'a' + 0xA;
+                } else {
+                    AMS_ABORT_UNLESS('A' <= c && c <= 'F');
+                    return c - 'A' + 0xA;
+                }
+            };
+
+            const size_t len = std::strlen(str);
+            AMS_ABORT_UNLESS(util::IsAligned(len, 2));
+
+            Bytes bytes(len / 2);
+            for (size_t i = 0; i < bytes.size(); ++i) {
+                bytes[i] = (ParseNybble(str[2 * i]) << 4) | ParseNybble(str[2 * i + 1]);
+            }
+            return bytes;
+        }
+
+        void Check(bool success, const char *name) {
+            ++g_check_count;
+            if (!success) {
+                std::printf("[%s] FAILED: %s\n", g_mode_name, name);
+                ++g_failure_count;
+            }
+        }
+
+        void CheckEqual(const Bytes &actual, const Bytes &expected, const char *name) {
+            Check(actual == expected, name);
+        }
+
+        /* Deterministic random data, so that failures are reproducible. */
+        class Random {
+            private:
+                u64 state;
+            public:
+                constexpr explicit Random(u64 seed) : state(seed) { /* ... */ }
+
+                u64 Next() {
+                    this->state ^= this->state << 13;
+                    this->state ^= this->state >> 7;
+                    this->state ^= this->state << 17;
+                    return this->state;
+                }
+
+                size_t Next(size_t max) {
+                    return static_cast<size_t>(this->Next() % (max + 1));
+                }
+
+                Bytes NextBytes(size_t size) {
+                    Bytes bytes(size);
+                    for (auto &b : bytes) {
+                        b = static_cast<u8>(this->Next());
+                    }
+                    return bytes;
+                }
+        };
+
+        /* AES block cipher, FIPS-197 Appendix C. */
+        template<typename Encryptor, typename Decryptor>
+        void TestAesBlock(const char *key_hex, const char *ct_hex, const char *name) {
+            const auto key = ParseHex(key_hex);
+            const auto pt  = ParseHex("00112233445566778899aabbccddeeff");
+            const auto ct  = ParseHex(ct_hex);
+
+            Encryptor enc;
+            enc.Initialize(key.data(), key.size());
+
+            Bytes out(pt.size());
+            enc.EncryptBlock(out.data(), out.size(), pt.data(), pt.size());
+            CheckEqual(out, ct, name);
+
+            Decryptor dec;
+            dec.Initialize(key.data(), key.size());
+            dec.DecryptBlock(out.data(), out.size(), ct.data(), ct.size());
+            CheckEqual(out, pt, name);
+        }
+
+        void TestAes() {
+            TestAesBlock<crypto::AesEncryptor128, crypto::AesDecryptor128>("000102030405060708090a0b0c0d0e0f",                                 "69c4e0d86a7b0430d8cdb78070b4c55a", "AES-128 block");
+            TestAesBlock<crypto::AesEncryptor192, crypto::AesDecryptor192>("000102030405060708090a0b0c0d0e0f1011121314151617",                 "dda97ca4864cdfe06eaf70a0ec0d7191", "AES-192 block");
+            TestAesBlock<crypto::AesEncryptor256, crypto::AesDecryptor256>("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f", "8ea2b7ca516745bfeafc49904b496089", "AES-256 block");
+        }
+
+        /* AES-CTR, SP 800-38A F.5.1 and F.5.5. */
+        constexpr const char CtrIv[]        = "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+        constexpr const char CtrPlainText[] = "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e5130c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710";
+
+        void TestCtr() {
+            const auto iv = ParseHex(CtrIv);
+            const auto pt = ParseHex(CtrPlainText);
+
+            {
+                const auto key = ParseHex("2b7e151628aed2a6abf7158809cf4f3c");
+                const auto ct  = ParseHex("874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee");
+
+                Bytes out(pt.size());
+                crypto::EncryptAes128Ctr(out.data(), out.size(), key.data(), key.size(), iv.data(), iv.size(), pt.data(), pt.size());
+                CheckEqual(out, ct, "AES-128-CTR encrypt");
+
+                crypto::DecryptAes128Ctr(out.data(), out.size(), key.data(), key.size(), iv.data(), iv.size(), ct.data(), ct.size());
+                CheckEqual(out, pt, "AES-128-CTR decrypt");
+
+                /* Starting partway through the stream must match the tail of the full stream. */
+                Bytes tail(pt.size() - 0x10);
+                crypto::EncryptAes128CtrPartial(tail.data(), tail.size(), key.data(), key.size(), iv.data(), iv.size(), 0x10, pt.data() + 0x10, tail.size());
+                CheckEqual(tail, Bytes(ct.begin() + 0x10, ct.end()), "AES-128-CTR partial");
+            }
+
+            {
+                const auto key = ParseHex("603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4");
+                const auto ct  = ParseHex("601ec313775789a5b7a7f504bbf3d228f443e3ca4d62b59aca84e990cacaf5c52b0930daa23de94ce87017ba2d84988ddfc9c58db67aada613c2dd08457941a6");
+
+                Bytes out(pt.size());
+                crypto::EncryptAes256Ctr(out.data(), out.size(), key.data(), key.size(), iv.data(), iv.size(), pt.data(), pt.size());
+                CheckEqual(out, ct, "AES-256-CTR encrypt");
+            }
+        }
+
+        /* AES-XTS, IEEE 1619 vector 2, plus a ragged length that needs ciphertext stealing. */
+        void TestXtsVector(const char *key1_hex, const char *key2_hex, const char *iv_hex, const char *pt_hex, const char *ct_hex, const char *name) {
+            const auto key1 = ParseHex(key1_hex);
+            const auto key2 = ParseHex(key2_hex);
+            const auto iv   = ParseHex(iv_hex);
+            const auto pt   = ParseHex(pt_hex);
+            const auto ct   = ParseHex(ct_hex);
+
+            Bytes out(pt.size());
+            crypto::EncryptAes128Xts(out.data(), out.size(), key1.data(), key2.data(), key1.size(), iv.data(), iv.size(), pt.data(), pt.size());
+            CheckEqual(out, ct, name);
+
+            crypto::DecryptAes128Xts(out.data(), out.size(), key1.data(), key2.data(), key1.size(), iv.data(), iv.size(), ct.data(), ct.size());
+            CheckEqual(out, pt, name);
+        }
+
+        void TestXts() {
+            TestXtsVector("11111111111111111111111111111111", "22222222222222222222222222222222", "33333333330000000000000000000000",
+                          "4444444444444444444444444444444444444444444444444444444444444444",
+                          "c454185e6a16936e39334038acef838bfb186fff7480adc4289382ecd6d394f0", "AES-128-XTS");
+            TestXtsVector("fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0", "22222222222222222222222222222222", "9a785634120000000000000000000000",
+                          "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f2021222324",
+                          "e4840eace0effab4acf16ef43e1c25c7b18006d827df4c834c9b10bb47feee04654e5290df", "AES-128-XTS ragged");
+        }
+
+        /* AES-GCM, test cases 2, 4 and 6 of the GCM specification. */
+        void TestGcmVector(const char *key_hex, const char *iv_hex, const char *aad_hex, const char *pt_hex, const char *ct_hex, const char *mac_hex, const char *name) {
+            const auto key = ParseHex(key_hex);
+            const auto iv  = ParseHex(iv_hex);
+            const auto aad = ParseHex(aad_hex);
+            const auto pt  = ParseHex(pt_hex);
+            const auto ct  = ParseHex(ct_hex);
+            const auto mac = ParseHex(mac_hex);
+
+            crypto::Aes128GcmEncryptor gcm;
+            gcm.Initialize(key.data(), key.size(), iv.data(), iv.size());
+            if (!aad.empty()) {
+                gcm.UpdateAad(aad.data(), aad.size());
+            }
+
+            Bytes out(pt.size());
+            gcm.Update(out.data(), out.size(), pt.data(), pt.size());
+            CheckEqual(out, ct, name);
+
+            Bytes out_mac(crypto::Aes128GcmEncryptor::MacSize);
+            gcm.GetMac(out_mac.data(), out_mac.size());
+            CheckEqual(out_mac, mac, name);
+        }
+
+        constexpr const char GcmKey[]       = "feffe9928665731c6d6a8f9467308308";
+        constexpr const char GcmAad[]       = "feedfacedeadbeeffeedfacedeadbeefabaddad2";
+        constexpr const char GcmPlainText[] = "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39";
+
+        void TestGcm() {
+            TestGcmVector("00000000000000000000000000000000", "000000000000000000000000", "", "00000000000000000000000000000000",
+                          "0388dace60b6a392f328c2b971b2fe78", "ab6e47d42cec13bdf53a67b21257bddf", "AES-128-GCM case 2");
+            TestGcmVector(GcmKey, "cafebabefacedbaddecaf888", GcmAad, GcmPlainText,
+                          "42831ec2217774244b7221b784d0d49ce3aa212f2c02a4e035c17e2329aca12e21d514b25466931c7d8f6a5aac84aa051ba30b396a0aac973d58e091",
+                          "5bc94fbc3221a5db94fae95ae7121a47", "AES-128-GCM case 4");
+            TestGcmVector(GcmKey, "9313225df88406e555909c5aff5269aa6a7a9538534f7da1e4c303d2a318a728c3c0c95156809539fcf0e2429a6b525416aedbf5a0de6a57a637b39b", GcmAad, GcmPlainText,
+                          "8ce24998625615b603a033aca13fb894be9112a5c3a211a8ba262a3cca7e2ca701e4a9a4fba43c90ccdcb281d48c7c6fd62875d2aca417034c34aee5",
+                          "619cc5aefffe0bfa462af43c1699d050", "AES-128-GCM case 6");
+        }
+
+        /* SHA-1 and SHA-256, FIPS 180 examples. */
+        template<typename Generator>
+        Bytes Hash(const Bytes &data, size_t chunk_size) {
+            Generator generator;
+            generator.Initialize();
+            for (size_t ofs = 0; ofs < data.size(); ofs += chunk_size) {
+                generator.Update(data.data() + ofs, std::min(chunk_size, data.size() - ofs));
+            }
+
+            Bytes hash(Generator::HashSize);
+            generator.GetHash(hash.data(), hash.size());
+            return hash;
+        }
+
+        template<typename Generator>
+        void TestHashVector(const char *message, size_t repeat, const char *hash_hex, const char *name) {
+            Bytes data;
+            for (size_t i = 0; i < repeat; ++i) {
+                data.insert(data.end(), message, message + std::strlen(message));
+            }
+
+            /* Hash in one go, and in chunks that straddle block boundaries. */
+            CheckEqual(Hash<Generator>(data, std::max<size_t>(data.size(), 1)), ParseHex(hash_hex), name);
+            CheckEqual(Hash<Generator>(data, 7), ParseHex(hash_hex), name);
+        }
+
+        constexpr const char HashMessage448[] = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+
+        void TestSha() {
+            TestHashVector<crypto::Sha1Generator>("abc",          1,       "a9993e364706816aba3e25717850c26c9cd0d89d", "SHA-1 abc");
+            TestHashVector<crypto::Sha1Generator>(HashMessage448, 1,       "84983e441c3bd26ebaae4aa1f95129e5e54670f1", "SHA-1 448 bits");
+            TestHashVector<crypto::Sha1Generator>("a",            1000000, "34aa973cd4c4daa4f61eeb2bdbad27316534016f", "SHA-1 million a");
+
+            TestHashVector<crypto::Sha256Generator>("abc",          1,       "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", "SHA-256 abc");
+            TestHashVector<crypto::Sha256Generator>(HashMessage448, 1,       "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1", "SHA-256 448 bits");
+            TestHashVector<crypto::Sha256Generator>("a",            1000000, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0", "SHA-256 million a");
+
+            /* HMAC-SHA256, RFC 4231 test case 2. */
+            const char key[]  = "Jefe";
+            const char data[] = "what do ya want for nothing?";
+            Bytes mac(crypto::Sha256Generator::HashSize);
+            crypto::GenerateHmacSha256Mac(mac.data(), mac.size(), data, std::strlen(data), key, std::strlen(key));
+            CheckEqual(mac, ParseHex("5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843"), "HMAC-SHA256");
+        }
+
+        void TestMemoryCompare() {
+            Random rng(0x5EED0001);
+            for (size_t size = 0; size <= 0x41; ++size) {
+                auto lhs = rng.NextBytes(size);
+                auto rhs = lhs;
+                Check(crypto::IsSameBytes(lhs.data(), rhs.data(), size), "IsSameBytes equal");
+
+                for (size_t i = 0; i < size; ++i) {
+                    rhs[i] ^= 0x01;
+                    Check(!crypto::IsSameBytes(lhs.data(), rhs.data(), size), "IsSameBytes differ");
+                    rhs[i] ^= 0x01;
+                }
+            }
+        }
+
+        /* The x64 bignum primitives, against straightforward references. */
+        void TestBigNum() {
+            using Word = crypto::impl::BigNum::Word;
+            constexpr size_t NumWords = 9;
+
+            Random rng(0x5EED0002);
+            for (size_t i = 0; i < 0x100; ++i) {
+                Word lhs[NumWords], rhs[NumWords], out[NumWords], ref[NumWords];
+                for (size_t w = 0; w < NumWords; ++w) {
+                    /* Bias towards all-ones words, so that carries propagate. */
+                    lhs[w] = (rng.Next(3) == 0) ? std::numeric_limits<Word>::max() : static_cast<Word>(rng.Next());
+                    rhs[w] = (rng.Next(3) == 0) ? std::numeric_limits<Word>::max() : static_cast<Word>(rng.Next());
+                }
+
+                /* Add. */
+                u64 carry = 0;
+                for (size_t w = 0; w < NumWords; ++w) {
+                    const u64 sum = static_cast<u64>(lhs[w]) + rhs[w] + carry;
+                    ref[w] = static_cast<Word>(sum);
+                    carry  = sum >> BITSIZEOF(Word);
+                }
+                Check(crypto::impl::BigNum::Add(out, lhs, rhs, NumWords) == carry && std::memcmp(out, ref, sizeof(ref)) == 0, "BigNum::Add");
+
+                /* Sub. */
+                u64 borrow = 0;
+                for (size_t w = 0; w < NumWords; ++w) {
+                    const u64 diff = static_cast<u64>(lhs[w]) - rhs[w] - borrow;
+                    ref[w] = static_cast<Word>(diff);
+                    borrow = (diff >> BITSIZEOF(Word)) != 0 ? 1 : 0;
+                }
+                Check(crypto::impl::BigNum::Sub(out, lhs, rhs, NumWords) == borrow && std::memcmp(out, ref, sizeof(ref)) == 0, "BigNum::Sub");
+
+                /* MultAdd. */
+                const Word mult = static_cast<Word>(rng.Next());
+                carry = 0;
+                for (size_t w = 0; w < NumWords; ++w) {
+                    const u64 v = static_cast<u64>(lhs[w]) + static_cast<u64>(rhs[w]) * mult + carry;
+                    ref[w] = static_cast<Word>(v);
+                    carry  = v >> BITSIZEOF(Word);
+                }
+                std::memcpy(out, lhs, sizeof(out));
+                Check(crypto::impl::BigNum::MultAdd(out, rhs, NumWords, mult) == carry && std::memcmp(out, ref, sizeof(ref)) == 0, "BigNum::MultAdd");
+            }
+        }
+
+        void RunKnownAnswerTests() {
+            TestAes();
+            TestCtr();
+            TestXts();
+            TestGcm();
+            TestSha();
+            TestMemoryCompare();
+            TestBigNum();
+        }
+
+        /* Outputs of each mode on random inputs, used to compare the accelerated and portable implementations. */
+        struct ModeOutputs {
+            std::vector<Bytes> ctr;
+            std::vector<Bytes> xts;
+            std::vector<Bytes> gcm;
+            std::vector<Bytes> sha1;
+            std::vector<Bytes> sha256;
+        };
+
+        ModeOutputs ComputeModeOutputs() {
+            ModeOutputs outputs;
+            Random rng(0x5EED0003);
+
+            for (size_t i = 0; i < 0x80; ++i) {
+                const auto key1 = rng.NextBytes(0x10);
+                const auto key2 = rng.NextBytes(0x10);
+                const auto iv   = rng.NextBytes(0x10);
+
+                /* CTR, at an arbitrary offset into the stream, updated in uneven pieces. */
+                {
+                    const auto data   = rng.NextBytes(rng.Next(0x400));
+                    const s64  offset = static_cast<s64>(rng.Next(0x100)) * 0x10;
+
+                    crypto::Aes128CtrEncryptor ctr;
+                    ctr.Initialize(key1.data(), key1.size(), iv.data(), iv.size(), offset);
+
+                    Bytes out(data.size());
+                    for (size_t ofs = 0; ofs < data.size(); ) {
+                        const size_t cur = std::min(data.size() - ofs, rng.Next(0x90));
+                        ctr.Update(out.data() + ofs, cur, data.data() + ofs, cur);
+                        ofs += cur;
+                    }
+                    outputs.ctr.push_back(std::move(out));
+                }
+
+                /* XTS. */
+                {
+                    const auto data = rng.NextBytes(0x10 + rng.Next(0x400));
+
+                    Bytes out(data.size());
+                    crypto::EncryptAes128Xts(out.data(), out.size(), key1.data(), key2.data(), key1.size(), iv.data(), iv.size(), data.data(), data.size());
+
+                    Bytes dec(data.size());
+                    crypto::DecryptAes128Xts(dec.data(), dec.size(), key1.data(), key2.data(), key1.size(), iv.data(), iv.size(), out.data(), out.size());
+                    Check(dec == data, "AES-128-XTS round trip");
+
+                    outputs.xts.push_back(std::move(out));
+                }
+
+                /* GCM, with aad and message in uneven pieces. */
+                {
+                    const auto aad  = rng.NextBytes(rng.Next(0x80));
+                    const auto data = rng.NextBytes(rng.Next(0x400));
+
+                    crypto::Aes128GcmEncryptor gcm;
+                    gcm.Initialize(key1.data(), key1.size(), iv.data(), 12);
+
+                    for (size_t ofs = 0; ofs < aad.size(); ) {
+                        const size_t cur = std::min(aad.size() - ofs, 1 + rng.Next(0x30));
+                        gcm.UpdateAad(aad.data() + ofs, cur);
+                        ofs += cur;
+                    }
+
+                    Bytes out(data.size() + crypto::Aes128GcmEncryptor::MacSize);
+                    for (size_t ofs = 0; ofs < data.size(); ) {
+                        const size_t cur = std::min(data.size() - ofs, rng.Next(0x90));
+                        gcm.Update(out.data() + ofs, cur, data.data() + ofs, cur);
+                        ofs += cur;
+                    }
+                    gcm.GetMac(out.data() + data.size(), crypto::Aes128GcmEncryptor::MacSize);
+
+                    outputs.gcm.push_back(std::move(out));
+                }
+
+                /* SHA. */
+                {
+                    const auto data  = rng.NextBytes(rng.Next(0x300));
+                    const auto chunk = 1 + rng.Next(0x100);
+                    outputs.sha1.push_back(Hash<crypto::Sha1Generator>(data, chunk));
+                    outputs.sha256.push_back(Hash<crypto::Sha256Generator>(data, chunk));
+                }
+            }
+
+            return outputs;
+        }
+
+        void RunTests(bool accelerated) {
+            crypto::impl::x64::SetHardwareAccelerationEnabled(accelerated);
+            g_mode_name = accelerated ? "accelerated" : "portable";
+
+            std::printf("[%s] aes-ni: %d, vaes: %d, pclmul: %d, sha-ni: %d\n", g_mode_name,
+                        crypto::impl::x64::IsAesNiAvailable(), crypto::impl::x64::IsVaesAvailable(),
+                        crypto::impl::x64::IsPclmulAvailable(), crypto::impl::x64::IsShaNiAvailable());
+
+            RunKnownAnswerTests();
+        }
+
+    }
+
+}
+
+int main() {
+    using namespace ams;
+
+    /* Check the known answers against whatever this host can accelerate, and against the portable implementations. */
+    test::RunTests(true);
+    const auto accelerated_outputs = test::ComputeModeOutputs();
+
+    test::RunTests(false);
+    const auto portable_outputs = test::ComputeModeOutputs();
+
+    /* Check that the two agree on everything else. */
+    test::g_mode_name = "compare";
+    test::Check(accelerated_outputs.ctr    == portable_outputs.ctr,    "AES-128-CTR accelerated vs portable");
+    test::Check(accelerated_outputs.xts    == portable_outputs.xts,    "AES-128-XTS accelerated vs portable");
+    test::Check(accelerated_outputs.gcm    == portable_outputs.gcm,    "AES-128-GCM accelerated vs portable");
+    test::Check(accelerated_outputs.sha1   == portable_outputs.sha1,   "SHA-1 accelerated vs portable");
+    test::Check(accelerated_outputs.sha256 == portable_outputs.sha256, "SHA-256 accelerated vs portable");
+
+    std::printf("%d/%d checks passed.\n", test::g_check_count - test::g_failure_count, test::g_check_count);
+    return test::g_failure_count == 0 ? 0 : 1;
+}
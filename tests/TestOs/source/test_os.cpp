@@ -0,0 +1,431 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+
+namespace ams::diag {
+
+    void AbortImpl(const char *file, int line, const char *func, const char *expr, u64 value, const char *format, ...) {
+        std::fprintf(stderr, "Abort: %s:%d %s (%s, 0x%" PRIx64 ")\n", file, line, func, expr, value);
+        AMS_UNUSED(format);
+        std::abort();
+    }
+
+    void AbortImpl(const char *file, int line, const char *func, const char *expr, u64 value) {
+        AbortImpl(file, line, func, expr, value, "");
+    }
+
+    void AbortImpl() {
+        std::abort();
+    }
+
+    void AssertionFailureImpl(const char *file, int line, const char *func, const char *expr, u64 value, const char *format, ...) {
+        std::fprintf(stderr, "Assertion failure: %s:%d %s (%s, 0x%" PRIx64 ")\n", file, line, func, expr, value);
+        AMS_UNUSED(format);
+        std::abort();
+    }
+
+    void AssertionFailureImpl(const char *file, int line, const char *func, const char *expr, u64 value) {
+        AssertionFailureImpl(file, line, func, expr, value, "");
+    }
+
+}
+
+namespace ams::os {
+
+    void InitializeForStratosphereInternal();
+
+}
+
+namespace ams::test {
+
+    namespace {
+
+        constexpr size_t ThreadStackSize = 32_KB;
+        constexpr size_t ThreadCount     = 4;
+
+        /* NOTE: These are generous, so that a loaded build machine can't fail the tests. */
+        constexpr TimeSpan ShortTimeout = TimeSpan::FromMilliSeconds(20);
+        constexpr TimeSpan LongTimeout  = TimeSpan::FromSeconds(5);
+
+        alignas(os::ThreadStackAlignment) constinit u8 g_thread_stacks[ThreadCount][ThreadStackSize];
+
+        constinit int g_check_count   = 0;
+        constinit int g_failure_count = 0;
+
+        void Check(bool success, const char *name) {
+            ++g_check_count;
+            if (!success) {
+                std::printf("FAILED: %s\n", name);
+                ++g_failure_count;
+            }
+        }
+
+        /* Runs a function on a new thread, for the duration of a scope. */
+        class ScopedThread {
+            NON_COPYABLE(ScopedThread);
+            NON_MOVEABLE(ScopedThread);
+            private:
+                os::ThreadType thread;
+            public:
+                ScopedThread(os::ThreadFunction function, void *arg, size_t index) {
+                    R_ABORT_UNLESS(os::CreateThread(std::addressof(this->thread), function, arg, g_thread_stacks[index], ThreadStackSize, os::DefaultThreadPriority));
+                    os::StartThread(std::addressof(this->thread));
+                }
+
+                ~ScopedThread() {
+                    os::WaitThread(std::addressof(this->thread));
+                    os::DestroyThread(std::addressof(this->thread));
+                }
+
+                os::ThreadType *Get() {
+                    return std::addressof(this->thread);
+                }
+        };
+
+        void TestThreadsAndMutex() {
+            struct Context {
+                os::Mutex mutex{false};
+                int counter = 0;
+            } ctx;
+
+            constexpr int IncrementsPerThread = 100000;
+
+            {
+                auto increment = [](void *arg) {
+                    auto *ctx = static_cast<Context *>(arg);
+                    for (int i = 0; i < IncrementsPerThread; ++i) {
+                        std::scoped_lock lk(ctx->mutex);
+                        ++ctx->counter;
+                    }
+                };
+
+                ScopedThread threads[ThreadCount] = { {increment, std::addressof(ctx), 0}, {increment, std::addressof(ctx), 1}, {increment, std::addressof(ctx), 2}, {increment, std::addressof(ctx), 3} };
+            }
+
+            Check(ctx.counter == IncrementsPerThread * static_cast<int>(ThreadCount), "Mutex serializes increments from several threads");
+        }
+
+        void TestEvents() {
+            /* Auto clear events are consumed by a wait. */
+            os::Event event(os::EventClearMode_AutoClear);
+            Check(!event.TryWait(), "Event starts unsignaled");
+            Check(!event.TimedWait(ShortTimeout), "Event wait times out while unsignaled");
+
+            {
+                ScopedThread thread([](void *arg) { static_cast<os::Event *>(arg)->Signal(); }, std::addressof(event), 0);
+                Check(event.TimedWait(LongTimeout), "Event wait is woken by a signal from another thread");
+            }
+            Check(!event.TryWait(), "Auto clear event is cleared by a wait");
+
+            /* Manual clear events stay signaled until cleared. */
+            os::Event manual_event(os::EventClearMode_ManualClear);
+            manual_event.Signal();
+            Check(manual_event.TryWait() && manual_event.TryWait(), "Manual clear event stays signaled");
+            manual_event.Clear();
+            Check(!manual_event.TryWait(), "Manual clear event is cleared by Clear");
+
+            /* System events are backed by native handles. */
+            os::SystemEvent system_event(os::EventClearMode_AutoClear, true);
+            {
+                ScopedThread thread([](void *arg) { static_cast<os::SystemEvent *>(arg)->Signal(); }, std::addressof(system_event), 0);
+                Check(system_event.TimedWait(LongTimeout), "System event wait is woken by a signal from another thread");
+            }
+            Check(!system_event.TryWait(), "Auto clear system event is cleared by a wait");
+        }
+
+        void TestConditionVariableAndMessageQueue() {
+            /* Condition variables wake their waiters. */
+            struct Context {
+                os::Mutex mutex{false};
+                os::ConditionVariable cv;
+                bool ready = false;
+            } ctx;
+
+            {
+                ScopedThread thread([](void *arg) {
+                    auto *ctx = static_cast<Context *>(arg);
+                    std::scoped_lock lk(ctx->mutex);
+                    ctx->ready = true;
+                    ctx->cv.Signal();
+                }, std::addressof(ctx), 0);
+
+                std::scoped_lock lk(ctx.mutex);
+                while (!ctx.ready) {
+                    ctx.cv.Wait(ctx.mutex);
+                }
+            }
+            Check(ctx.ready, "Condition variable wait is woken by a signal");
+
+            /* Message queues pass messages between threads in order. */
+            constexpr size_t MessageCount = 64;
+            uintptr_t buffer[4];
+            os::MessageQueue mq(buffer, util::size(buffer));
+
+            bool in_order = true;
+            {
+                ScopedThread thread([](void *arg) {
+                    auto *mq = static_cast<os::MessageQueue *>(arg);
+                    for (size_t i = 0; i < MessageCount; ++i) {
+                        mq->Send(i);
+                    }
+                }, std::addressof(mq), 0);
+
+                for (size_t i = 0; i < MessageCount; ++i) {
+                    uintptr_t message;
+                    mq.Receive(std::addressof(message));
+                    in_order &= message == i;
+                }
+            }
+            Check(in_order, "Message queue delivers messages in order");
+
+            uintptr_t message;
+            Check(!mq.TimedReceive(std::addressof(message), ShortTimeout), "Message queue receive times out while empty");
+
+            /* Semaphores count. */
+            os::Semaphore semaphore(1, 2);
+            Check(semaphore.TryAcquire() && !semaphore.TryAcquire(), "Semaphore can be acquired only as often as its count");
+            semaphore.Release();
+            Check(semaphore.TimedAcquire(ShortTimeout), "Released semaphore can be acquired");
+        }
+
+        void TestWaitableManager() {
+            os::WaitableManagerType manager;
+            os::InitializeWaitableManager(std::addressof(manager));
+
+            os::Event event(os::EventClearMode_ManualClear);
+            os::SystemEvent system_event(os::EventClearMode_ManualClear, true);
+            os::TimerEvent timer_event(os::EventClearMode_ManualClear);
+
+            os::WaitableHolderType event_holder, system_event_holder, timer_event_holder;
+            os::InitializeWaitableHolder(std::addressof(event_holder), event.GetBase());
+            os::InitializeWaitableHolder(std::addressof(system_event_holder), system_event.GetBase());
+            os::InitializeWaitableHolder(std::addressof(timer_event_holder), timer_event.GetBase());
+            os::LinkWaitableHolder(std::addressof(manager), std::addressof(event_holder));
+            os::LinkWaitableHolder(std::addressof(manager), std::addressof(system_event_holder));
+            os::LinkWaitableHolder(std::addressof(manager), std::addressof(timer_event_holder));
+
+            Check(os::TryWaitAny(std::addressof(manager)) == nullptr, "TryWaitAny finds nothing signaled");
+            Check(os::TimedWaitAny(std::addressof(manager), ShortTimeout) == nullptr, "TimedWaitAny times out with nothing signaled");
+
+            /* Handle-less holders are woken from another thread. */
+            {
+                ScopedThread thread([](void *arg) { os::SleepThread(ShortTimeout); static_cast<os::Event *>(arg)->Signal(); }, std::addressof(event), 0);
+                Check(os::WaitAny(std::addressof(manager)) == std::addressof(event_holder), "WaitAny is woken by an event");
+            }
+            event.Clear();
+
+            /* Holders with handles are woken from another thread. */
+            {
+                ScopedThread thread([](void *arg) { os::SleepThread(ShortTimeout); static_cast<os::SystemEvent *>(arg)->Signal(); }, std::addressof(system_event), 0);
+                Check(os::WaitAny(std::addressof(manager)) == std::addressof(system_event_holder), "WaitAny is woken by a system event");
+            }
+            system_event.Clear();
+
+            /* Timers fire by themselves. */
+            timer_event.StartOneShot(ShortTimeout);
+            Check(os::TimedWaitAny(std::addressof(manager), LongTimeout) == std::addressof(timer_event_holder), "TimedWaitAny is woken by a timer event");
+            timer_event.Clear();
+
+            /* Message queue holders are woken by messages. */
+            {
+                uintptr_t buffer[1];
+                os::MessageQueue mq(buffer, util::size(buffer));
+
+                os::WaitableHolderType mq_holder;
+                os::InitializeWaitableHolder(std::addressof(mq_holder), mq.GetBase(), os::MessageQueueWaitType::ForNotEmpty);
+                os::LinkWaitableHolder(std::addressof(manager), std::addressof(mq_holder));
+
+                {
+                    ScopedThread thread([](void *arg) { os::SleepThread(ShortTimeout); static_cast<os::MessageQueue *>(arg)->Send(1); }, std::addressof(mq), 0);
+                    Check(os::WaitAny(std::addressof(manager)) == std::addressof(mq_holder), "WaitAny is woken by a message");
+                }
+
+                os::UnlinkWaitableHolder(std::addressof(mq_holder));
+                os::FinalizeWaitableHolder(std::addressof(mq_holder));
+            }
+
+            /* Linux has no ipc sessions to reply to. */
+            {
+                os::WaitableHolderType *out;
+                const Result result = os::SdkReplyAndReceive(std::addressof(out), system_event.GetReadableHandle(), std::addressof(manager));
+                Check(svc::ResultNotImplemented::Includes(result) && out == nullptr, "SdkReplyAndReceive fails without aborting");
+            }
+
+            os::UnlinkAllWaitableHolder(std::addressof(manager));
+            os::FinalizeWaitableHolder(std::addressof(event_holder));
+            os::FinalizeWaitableHolder(std::addressof(system_event_holder));
+            os::FinalizeWaitableHolder(std::addressof(timer_event_holder));
+            os::FinalizeWaitableManager(std::addressof(manager));
+        }
+
+        void TestWaitableManagerRelays() {
+            constexpr size_t RelayCount = 3;
+            constexpr size_t EventCount = RelayCount * svc::ArgumentHandleCountMax;
+
+            struct Context {
+                os::WaitableManagerType manager;
+                os::WaitableManagerRelayType relays[RelayCount];
+                os::SystemEventType events[EventCount];
+                os::WaitableHolderType holders[EventCount];
+            };
+            auto ctx = std::make_unique<Context>();
+
+            os::InitializeWaitableManager(std::addressof(ctx->manager));
+
+            /* The first relay is waited on directly, and the rest wait on the stacks we give them. */
+            bool attached = R_SUCCEEDED(os::AttachWaitableManagerRelay(std::addressof(ctx->manager), std::addressof(ctx->relays[0]), nullptr, 0, os::DefaultThreadPriority));
+            for (size_t i = 1; i < RelayCount; ++i) {
+                attached &= R_SUCCEEDED(os::AttachWaitableManagerRelay(std::addressof(ctx->manager), std::addressof(ctx->relays[i]), g_thread_stacks[i], ThreadStackSize, os::DefaultThreadPriority));
+            }
+            Check(attached, "Relays can be attached");
+
+            for (size_t i = 0; i < EventCount; ++i) {
+                R_ABORT_UNLESS(os::CreateSystemEvent(std::addressof(ctx->events[i]), os::EventClearMode_ManualClear, true));
+                os::InitializeWaitableHolder(std::addressof(ctx->holders[i]), std::addressof(ctx->events[i]));
+                os::LinkWaitableHolder(std::addressof(ctx->manager), std::addressof(ctx->holders[i]));
+            }
+
+            Check(os::TryWaitAny(std::addressof(ctx->manager)) == nullptr, "TryWaitAny finds nothing signaled across relays");
+            Check(os::TimedWaitAny(std::addressof(ctx->manager), ShortTimeout) == nullptr, "TimedWaitAny times out with nothing signaled across relays");
+
+            /* Each group wakes the manager, whether signaled before or during the wait. */
+            bool woken = true, polled = true;
+            for (const size_t index : { size_t(0), size_t(svc::ArgumentHandleCountMax + 5), EventCount - 1 }) {
+                os::SignalSystemEvent(std::addressof(ctx->events[index]));
+                polled &= os::TryWaitAny(std::addressof(ctx->manager)) == std::addressof(ctx->holders[index]);
+                os::ClearSystemEvent(std::addressof(ctx->events[index]));
+
+                {
+                    ScopedThread thread([](void *arg) { os::SleepThread(ShortTimeout); os::SignalSystemEvent(static_cast<os::SystemEventType *>(arg)); }, std::addressof(ctx->events[index]), 0);
+                    woken &= os::TimedWaitAny(std::addressof(ctx->manager), LongTimeout) == std::addressof(ctx->holders[index]);
+                }
+                os::ClearSystemEvent(std::addressof(ctx->events[index]));
+            }
+            Check(polled, "TryWaitAny finds a signaled handle in any relay");
+            Check(woken,  "TimedWaitAny is woken by a handle in any relay");
+
+            /* Unlinked holders are no longer waited on. */
+            const size_t last = EventCount - 1;
+            os::UnlinkWaitableHolder(std::addressof(ctx->holders[last]));
+            os::SignalSystemEvent(std::addressof(ctx->events[last]));
+            Check(os::TimedWaitAny(std::addressof(ctx->manager), ShortTimeout) == nullptr, "Unlinked holders are not waited on");
+
+            os::UnlinkAllWaitableHolder(std::addressof(ctx->manager));
+            for (size_t i = 0; i < EventCount; ++i) {
+                os::FinalizeWaitableHolder(std::addressof(ctx->holders[i]));
+                os::DestroySystemEvent(std::addressof(ctx->events[i]));
+            }
+            os::FinalizeWaitableManager(std::addressof(ctx->manager));
+        }
+
+        void TestWaitableManagerRelayCapacity() {
+            constexpr size_t EventCount = svc::ArgumentHandleCountMax + 2;
+
+            struct Context {
+                os::WaitableManagerType manager;
+                os::WaitableManagerType waitlist;
+                os::WaitableManagerRelayType relay;
+                os::SystemEventType events[EventCount];
+                os::WaitableHolderType holders[EventCount];
+            };
+            auto ctx = std::make_unique<Context>();
+
+            os::InitializeWaitableManager(std::addressof(ctx->manager));
+            os::InitializeWaitableManager(std::addressof(ctx->waitlist));
+            for (size_t i = 0; i < EventCount; ++i) {
+                R_ABORT_UNLESS(os::CreateSystemEvent(std::addressof(ctx->events[i]), os::EventClearMode_ManualClear, true));
+                os::InitializeWaitableHolder(std::addressof(ctx->holders[i]), std::addressof(ctx->events[i]));
+            }
+
+            /* The first relay takes over the handles linked before it. */
+            os::LinkWaitableHolder(std::addressof(ctx->manager), std::addressof(ctx->holders[0]));
+            os::LinkWaitableHolder(std::addressof(ctx->manager), std::addressof(ctx->holders[1]));
+            Check(R_SUCCEEDED(os::AttachWaitableManagerRelay(std::addressof(ctx->manager), std::addressof(ctx->relay), nullptr, 0, os::DefaultThreadPriority)), "The first relay can be attached after linking");
+
+            os::SignalSystemEvent(std::addressof(ctx->events[1]));
+            Check(os::TryWaitAny(std::addressof(ctx->manager)) == std::addressof(ctx->holders[1]), "The first relay waits on handles linked before it");
+            os::ClearSystemEvent(std::addressof(ctx->events[1]));
+
+            /* Once the relay is full, linking fails instead of aborting. */
+            bool linked = true;
+            for (size_t i = 2; i < svc::ArgumentHandleCountMax; ++i) {
+                linked &= R_SUCCEEDED(os::TryLinkWaitableHolder(std::addressof(ctx->manager), std::addressof(ctx->holders[i])));
+            }
+            Check(linked, "Handles can be linked up to the relay's capacity");
+
+            const size_t first_extra = svc::ArgumentHandleCountMax;
+            Check(os::ResultOutOfResource::Includes(os::TryLinkWaitableHolder(std::addressof(ctx->manager), std::addressof(ctx->holders[first_extra]))), "Linking past every relay's capacity fails");
+
+            /* Moving takes holders in order for as long as there is space, and leaves the rest behind. */
+            os::LinkWaitableHolder(std::addressof(ctx->waitlist), std::addressof(ctx->holders[first_extra]));
+            os::LinkWaitableHolder(std::addressof(ctx->waitlist), std::addressof(ctx->holders[first_extra + 1]));
+            Check(os::ResultOutOfResource::Includes(os::TryMoveAllWaitableHolder(std::addressof(ctx->manager), std::addressof(ctx->waitlist))), "Moving into a full manager fails");
+
+            os::UnlinkWaitableHolder(std::addressof(ctx->holders[0]));
+            const Result partial_move_result = os::TryMoveAllWaitableHolder(std::addressof(ctx->manager), std::addressof(ctx->waitlist));
+            os::SignalSystemEvent(std::addressof(ctx->events[first_extra]));
+            Check(os::ResultOutOfResource::Includes(partial_move_result) && os::TryWaitAny(std::addressof(ctx->manager)) == std::addressof(ctx->holders[first_extra]), "Moving fills the space that is free");
+            os::ClearSystemEvent(std::addressof(ctx->events[first_extra]));
+
+            os::UnlinkWaitableHolder(std::addressof(ctx->holders[1]));
+            Check(R_SUCCEEDED(os::TryMoveAllWaitableHolder(std::addressof(ctx->manager), std::addressof(ctx->waitlist))), "Holders left behind can be moved once there is space");
+
+            os::UnlinkAllWaitableHolder(std::addressof(ctx->manager));
+            for (size_t i = 0; i < EventCount; ++i) {
+                os::FinalizeWaitableHolder(std::addressof(ctx->holders[i]));
+                os::DestroySystemEvent(std::addressof(ctx->events[i]));
+            }
+            os::FinalizeWaitableManager(std::addressof(ctx->waitlist));
+            os::FinalizeWaitableManager(std::addressof(ctx->manager));
+        }
+
+        void TestThreadLocalStorage() {
+            os::TlsSlot slot;
+            R_ABORT_UNLESS(os::AllocateTlsSlot(std::addressof(slot), nullptr));
+
+            os::SetTlsValue(slot, 1);
+            {
+                ScopedThread thread([](void *arg) {
+                    const auto slot = *static_cast<os::TlsSlot *>(arg);
+                    Check(os::GetTlsValue(slot) == 0, "Tls values start cleared on new threads");
+                    os::SetTlsValue(slot, 2);
+                }, std::addressof(slot), 0);
+            }
+            Check(os::GetTlsValue(slot) == 1, "Tls values are per thread");
+
+            os::FreeTlsSlot(slot);
+        }
+
+    }
+
+}
+
+int main() {
+    using namespace ams;
+
+    os::InitializeForStratosphereInternal();
+
+    test::TestThreadsAndMutex();
+    test::TestEvents();
+    test::TestConditionVariableAndMessageQueue();
+    test::TestWaitableManager();
+    test::TestWaitableManagerRelays();
+    test::TestWaitableManagerRelayCapacity();
+    test::TestThreadLocalStorage();
+
+    std::printf("%d/%d checks passed.\n", test::g_check_count - test::g_failure_count, test::g_check_count);
+    return test::g_failure_count == 0 ? 0 : 1;
+}
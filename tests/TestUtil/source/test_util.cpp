@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include <vector>
+
+namespace ams::diag {
+
+    void AbortImpl(const char *file, int line, const char *func, const char *expr, u64 value, const char *format, ...) {
+        std::fprintf(stderr, "Abort: %s:%d %s (%s, 0x%" PRIx64 ")\n", file, line, func, expr, value);
+        AMS_UNUSED(format);
+        std::abort();
+    }
+
+    void AbortImpl(const char *file, int line, const char *func, const char *expr, u64 value) {
+        AbortImpl(file, line, func, expr, value, "");
+    }
+
+    void AbortImpl() {
+        std::abort();
+    }
+
+    void AssertionFailureImpl(const char *file, int line, const char *func, const char *expr, u64 value, const char *format, ...) {
+        std::fprintf(stderr, "Assertion failure: %s:%d %s (%s, 0x%" PRIx64 ")\n", file, line, func, expr, value);
+        AMS_UNUSED(format);
+        std::abort();
+    }
+
+    void AssertionFailureImpl(const char *file, int line, const char *func, const char *expr, u64 value) {
+        AssertionFailureImpl(file, line, func, expr, value, "");
+    }
+
+}
+
+namespace ams::os {
+
+    void InitializeForStratosphereInternal();
+
+}
+
+namespace ams::test {
+
+    namespace {
+
+        using Bytes = std::vector<u8>;
+
+        constexpr size_t BenchmarkDataSize = 32_MB;
+        constexpr int BenchmarkIterations  = 4;
+
+        constexpr size_t FrameHeaderSize     = 0x18;
+        constexpr size_t FrameBlockEntrySize = 0x8;
+
+        constinit int g_check_count   = 0;
+        constinit int g_failure_count = 0;
+
+        void Check(bool success, const char *name) {
+            ++g_check_count;
+            if (!success) {
+                std::printf("FAILED: %s\n", name);
+                ++g_failure_count;
+            }
+        }
+
+        /* Makes data which compresses roughly as well as text does. */
+        Bytes MakeCompressibleData(size_t size) {
+            constexpr const char *Words[] = { "atmosphere ", "stratosphere ", "mesosphere ", "exosphere ", "thermosphere ", "troposphere ", "content ", "meta ", "\n" };
+
+            Bytes data(size);
+            u32 state = 0x12345678;
+            for (size_t i = 0; i < size; /* ... */) {
+                state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+                const char *word = Words[state % util::size(Words)];
+                for (size_t j = 0; word[j] != '\x00' && i < size; ++j) {
+                    data[i++] = static_cast<u8>(word[j]);
+                }
+            }
+            return data;
+        }
+
+        Bytes MakeIncompressibleData(size_t size) {
+            Bytes data(size);
+            u32 state = 0x87654321;
+            for (size_t i = 0; i < size; ++i) {
+                state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+                data[i] = static_cast<u8>(state >> 24);
+            }
+            return data;
+        }
+
+        constexpr size_t GetFrameDataOffset(size_t size, size_t block_size) {
+            return FrameHeaderSize + util::DivideUp(size, block_size) * FrameBlockEntrySize;
+        }
+
+        Bytes CompressFrame(const Bytes &src, size_t block_size, s32 thread_count, size_t dst_size) {
+            Bytes frame(dst_size);
+            size_t frame_size = 0;
+            if (!util::CompressLZ4Frame(std::addressof(frame_size), frame.data(), frame.size(), src.data(), src.size(), block_size, thread_count)) {
+                return Bytes();
+            }
+            frame.resize(frame_size);
+            return frame;
+        }
+
+        Bytes CompressFrame(const Bytes &src, size_t block_size, s32 thread_count) {
+            return CompressFrame(src, block_size, thread_count, util::GetCompressLZ4FrameBound(src.size(), block_size));
+        }
+
+        bool DecompressFrame(Bytes *out, const Bytes &frame, size_t dst_size, s32 thread_count) {
+            out->resize(dst_size);
+            size_t out_size = 0;
+            if (!util::DecompressLZ4Frame(std::addressof(out_size), out->data(), out->size(), frame.data(), frame.size(), thread_count)) {
+                return false;
+            }
+            out->resize(out_size);
+            return true;
+        }
+
+        bool IsRoundTrip(const Bytes &src, const Bytes &frame, s32 thread_count) {
+            Bytes out;
+            return !frame.empty() && DecompressFrame(std::addressof(out), frame, src.size(), thread_count) && out == src;
+        }
+
+        void TestLZ4FrameRoundTrip() {
+            const Bytes compressible   = MakeCompressibleData(1_MB + 123);
+            const Bytes incompressible = MakeIncompressibleData(256_KB + 45);
+
+            for (s32 thread_count = 1; thread_count <= util::LZ4FrameThreadCountMax; thread_count += util::LZ4FrameThreadCountMax - 1) {
+                const Bytes frame = CompressFrame(compressible, util::LZ4FrameBlockSizeDefault, thread_count);
+                Check(IsRoundTrip(compressible, frame, thread_count), "LZ4 frame round trips compressible data");
+                Check(frame.size() < compressible.size() / 2,         "LZ4 frame compresses compressible data");
+
+                /* Blocks which don't shrink are stored as they are. */
+                const Bytes stored = CompressFrame(incompressible, util::LZ4FrameBlockSizeMin, thread_count);
+                Check(IsRoundTrip(incompressible, stored, thread_count), "LZ4 frame round trips incompressible data");
+                Check(stored.size() == GetFrameDataOffset(incompressible.size(), util::LZ4FrameBlockSizeMin) + incompressible.size(), "LZ4 frame stores incompressible blocks uncompressed");
+            }
+
+            /* Empty data makes a frame with no blocks. */
+            {
+                const Bytes empty;
+                const Bytes frame = CompressFrame(empty, util::LZ4FrameBlockSizeDefault, 1);
+                Check(IsRoundTrip(empty, frame, 1), "LZ4 frame round trips empty data");
+            }
+
+            /* Without room for every block's worst case, blocks are packed as they are compressed. */
+            {
+                const Bytes reference = CompressFrame(compressible, util::LZ4FrameBlockSizeDefault, 1);
+                const Bytes packed    = CompressFrame(compressible, util::LZ4FrameBlockSizeDefault, 1, compressible.size());
+                Check(IsRoundTrip(compressible, packed, 1), "LZ4 frame round trips into a small buffer");
+                Check(packed == reference,                  "LZ4 frame is the same when compressed into a small buffer");
+                Check(CompressFrame(incompressible, util::LZ4FrameBlockSizeMin, 1, incompressible.size()).empty(), "LZ4 frame fails to compress into a buffer which is too small");
+            }
+
+            /* Any block can be decompressed on its own. */
+            {
+                const Bytes frame = CompressFrame(compressible, util::LZ4FrameBlockSizeDefault, 1);
+
+                util::LZ4FrameInfo info;
+                Check(util::GetLZ4FrameInfo(std::addressof(info), frame.data(), frame.size()), "LZ4 frame info can be read");
+                Check(info.uncompressed_size == compressible.size() && info.block_size == util::LZ4FrameBlockSizeDefault && info.block_count == static_cast<s32>(util::DivideUp(compressible.size(), util::LZ4FrameBlockSizeDefault)), "LZ4 frame info is correct");
+
+                bool blocks_correct = true;
+                Bytes block(info.block_size);
+                for (s32 i = 0; i < info.block_count; ++i) {
+                    size_t block_size = 0;
+                    const size_t offset = i * info.block_size;
+                    blocks_correct &= util::DecompressLZ4FrameBlock(std::addressof(block_size), block.data(), block.size(), frame.data(), frame.size(), i);
+                    blocks_correct &= block_size == std::min(info.block_size, compressible.size() - offset);
+                    blocks_correct &= std::memcmp(block.data(), compressible.data() + offset, block_size) == 0;
+                }
+                Check(blocks_correct, "LZ4 frame blocks decompress on their own");
+
+                size_t block_size = 0;
+                Check(!util::DecompressLZ4FrameBlock(std::addressof(block_size), block.data(), block.size(), frame.data(), frame.size(), info.block_count), "LZ4 frame rejects an out of range block");
+                Check(!util::DecompressLZ4FrameBlock(std::addressof(block_size), block.data(), block.size() - 1, frame.data(), frame.size(), 0), "LZ4 frame rejects a block buffer which is too small");
+            }
+        }
+
+        void TestLZ4FrameCorruption() {
+            const Bytes src   = MakeCompressibleData(256_KB + 7);
+            const Bytes frame = CompressFrame(src, util::LZ4FrameBlockSizeMin, 1);
+
+            const size_t block_count = util::DivideUp(src.size(), util::LZ4FrameBlockSizeMin);
+            const size_t data_offset = GetFrameDataOffset(src.size(), util::LZ4FrameBlockSizeMin);
+
+            auto IsRejected = [&](const Bytes &corrupt) {
+                Bytes out;
+                return !DecompressFrame(std::addressof(out), corrupt, src.size(), 1) && !DecompressFrame(std::addressof(out), corrupt, src.size(), util::LZ4FrameThreadCountMax);
+            };
+
+            auto Corrupt = [&](size_t offset, u32 value) {
+                Bytes corrupt = frame;
+                std::memcpy(corrupt.data() + offset, std::addressof(value), sizeof(value));
+                return corrupt;
+            };
+
+            Check(IsRejected(Bytes(frame.begin(), frame.begin() + FrameHeaderSize - 1)), "LZ4 frame rejects a truncated header");
+            Check(IsRejected(Bytes(frame.begin(), frame.begin() + data_offset - 1)),     "LZ4 frame rejects a truncated block index");
+            Check(IsRejected(Bytes(frame.begin(), frame.end() - 1)),                     "LZ4 frame rejects truncated data");
+
+            Check(IsRejected(Corrupt(0x00, 0)),                             "LZ4 frame rejects a bad magic");
+            Check(IsRejected(Corrupt(0x04, util::LZ4FrameBlockSizeMin - 1)), "LZ4 frame rejects a bad block size");
+            Check(IsRejected(Corrupt(0x08, src.size() + 1)),                 "LZ4 frame rejects a size which disagrees with its block count");
+            Check(IsRejected(Corrupt(0x10, block_count + 1)),                "LZ4 frame rejects a bad block count");
+
+            const size_t last_entry = FrameHeaderSize + (block_count - 1) * FrameBlockEntrySize;
+            Check(IsRejected(Corrupt(last_entry + 0, frame.size())),                   "LZ4 frame rejects a block beyond the frame");
+            Check(IsRejected(Corrupt(last_entry + 4, util::LZ4FrameBlockSizeMin + 1)), "LZ4 frame rejects a block larger than the block size");
+
+            /* Corrupt compressed data must be caught by LZ4, rather than read or written out of bounds. */
+            {
+                Bytes corrupt = frame;
+                for (size_t i = data_offset; i < corrupt.size(); i += 7) {
+                    corrupt[i] = 0xFF;
+                }
+                Check(IsRejected(corrupt), "LZ4 frame rejects corrupt compressed data");
+            }
+
+            Bytes out;
+            Check(!DecompressFrame(std::addressof(out), frame, src.size() - 1, 1), "LZ4 frame rejects an output buffer which is too small");
+        }
+
+        /* Abstract types can't have their member offsets found during constant evaluation, so check them at runtime. */
+        class AbstractListEntry {
+            public:
+                u32 value;
+                util::IntrusiveListNode node;
+            public:
+                explicit AbstractListEntry(u32 v) : value(v), node() { /* ... */ }
+                virtual ~AbstractListEntry() { /* ... */ }
+
+                virtual u32 GetValue() const = 0;
+        };
+
+        class ListEntry final : public AbstractListEntry {
+            public:
+                explicit ListEntry(u32 v) : AbstractListEntry(v) { /* ... */ }
+
+                virtual u32 GetValue() const override { return this->value; }
+        };
+
+        void TestParentOfMember() {
+            using ListType = util::IntrusiveListMemberTraits<&AbstractListEntry::node>::ListType;
+
+            ListEntry entries[] = { ListEntry(1), ListEntry(2), ListEntry(3) };
+            ListType list;
+            for (auto &entry : entries) {
+                list.push_back(entry);
+            }
+
+            u32 expected = 1;
+            bool correct = true;
+            for (const auto &entry : list) {
+                correct &= std::addressof(entry) == std::addressof(entries[expected - 1]) && entry.GetValue() == expected;
+                ++expected;
+            }
+            Check(correct && expected == util::size(entries) + 1, "Intrusive list finds the parents of abstract types' member nodes");
+
+            Check(std::addressof(util::GetParentReference<&AbstractListEntry::node>(entries[1].node)) == std::addressof(entries[1]), "GetParentReference finds the parent of an abstract type's member");
+
+            list.clear();
+        }
+
+        void BenchmarkLZ4Frame() {
+            const Bytes src = MakeCompressibleData(BenchmarkDataSize);
+            Bytes frame(util::GetCompressLZ4FrameBound(src.size(), util::LZ4FrameBlockSizeDefault));
+            Bytes dst(src.size());
+
+            auto GetMegaBytesPerSecond = [](size_t size, os::Tick start, os::Tick end) {
+                return static_cast<double>(size * BenchmarkIterations) / static_cast<double>((end - start).ToTimeSpan().GetMicroSeconds());
+            };
+
+            /* The single shot wrappers are the baseline. */
+            {
+                int compressed_size = 0;
+                const auto compress_start = os::GetSystemTick();
+                for (int i = 0; i < BenchmarkIterations; ++i) {
+                    compressed_size = util::CompressLZ4(frame.data(), frame.size(), src.data(), src.size());
+                }
+                const auto compress_end = os::GetSystemTick();
+                for (int i = 0; i < BenchmarkIterations; ++i) {
+                    util::DecompressLZ4(dst.data(), dst.size(), frame.data(), compressed_size);
+                }
+                const auto decompress_end = os::GetSystemTick();
+
+                std::printf("LZ4 single shot:      ratio %.3f, compress %8.1f MB/s, decompress %8.1f MB/s\n", static_cast<double>(compressed_size) / src.size(), GetMegaBytesPerSecond(src.size(), compress_start, compress_end), GetMegaBytesPerSecond(src.size(), compress_end, decompress_end));
+            }
+
+            for (s32 thread_count = 1; thread_count <= util::LZ4FrameThreadCountMax; ++thread_count) {
+                size_t frame_size = 0, out_size = 0;
+                const auto compress_start = os::GetSystemTick();
+                for (int i = 0; i < BenchmarkIterations; ++i) {
+                    util::CompressLZ4Frame(std::addressof(frame_size), frame.data(), frame.size(), src.data(), src.size(), util::LZ4FrameBlockSizeDefault, thread_count);
+                }
+                const auto compress_end = os::GetSystemTick();
+                for (int i = 0; i < BenchmarkIterations; ++i) {
+                    util::DecompressLZ4Frame(std::addressof(out_size), dst.data(), dst.size(), frame.data(), frame_size, thread_count);
+                }
+                const auto decompress_end = os::GetSystemTick();
+
+                std::printf("LZ4 frame, %d thread%s: ratio %.3f, compress %8.1f MB/s, decompress %8.1f MB/s\n", thread_count, thread_count == 1 ? " " : "s", static_cast<double>(frame_size) / src.size(), GetMegaBytesPerSecond(src.size(), compress_start, compress_end), GetMegaBytesPerSecond(src.size(), compress_end, decompress_end));
+            }
+
+            std::printf("(%d cores available)\n", util::PopCount(os::GetThreadAvailableCoreMask()));
+        }
+
+    }
+
+}
+
+int main(int argc, char **argv) {
+    using namespace ams;
+
+    os::InitializeForStratosphereInternal();
+
+    if (argc > 1 && std::strcmp(argv[1], "benchmark") == 0) {
+        test::BenchmarkLZ4Frame();
+        return 0;
+    }
+
+    test::TestLZ4FrameRoundTrip();
+    test::TestLZ4FrameCorruption();
+    test::TestParentOfMember();
+
+    std::printf("%d/%d checks passed.\n", test::g_check_count - test::g_failure_count, test::g_check_count);
+    return test::g_failure_count == 0 ? 0 : 1;
+}
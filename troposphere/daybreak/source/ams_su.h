@@ -34,6 +34,15 @@ typedef struct {
     NcmContentId invalid_content_id;
 } AmsSuUpdateValidationInfo;
 
+typedef struct {
+    s64 read_size;
+    s64 write_size;
+    s64 hash_size;
+    s64 read_time_ns;
+    s64 write_time_ns;
+    s64 hash_time_ns;
+} AmsSuPipelineThroughput;
+
 Result amssuInitialize();
 void   amssuExit();
 Service *amssuGetServiceSession(void);
@@ -46,6 +55,7 @@ Result amssuRequestPrepareUpdate(AsyncResult *a);
 Result amssuGetPrepareUpdateProgress(NsSystemUpdateProgress *out);
 Result amssuHasPreparedUpdate(bool *out);
 Result amssuApplyPreparedUpdate();
+Result amssuGetPrepareUpdatePipelineThroughput(AmsSuPipelineThroughput *out);
 
 #ifdef __cplusplus
 }
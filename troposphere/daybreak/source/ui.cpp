@@ -105,6 +105,14 @@ namespace dbk {
             g_prev_touch_count = current_touch.count;
         }
 
+        float GetThroughputInMegaBytesPerSecond(s64 size, s64 time_ns) {
+            if (time_ns <= 0) {
+                return 0.0f;
+            }
+
+            return (static_cast<float>(size) / (1024.0f * 1024.0f)) / (static_cast<float>(time_ns) / 1'000'000'000.0f);
+        }
+
         void ChangeMenu(std::shared_ptr<Menu> menu) {
             g_current_menu = menu;
         }
@@ -1101,7 +1109,17 @@ namespace dbk {
 
             /* Mark for application if preparation complete. */
             if (prepared) {
-                this->LogText("Update preparation complete.\nApplying update...\n");
+                this->LogText("Update preparation complete.\n");
+
+                /* Log how quickly each stage of the install ran, to help diagnose slow updates. */
+                AmsSuPipelineThroughput throughput = {};
+                if (R_SUCCEEDED(amssuGetPrepareUpdatePipelineThroughput(&throughput)) && throughput.read_size > 0) {
+                    this->LogText("- Read: %.1f MB/s\n",  GetThroughputInMegaBytesPerSecond(throughput.read_size, throughput.read_time_ns));
+                    this->LogText("- Write: %.1f MB/s\n", GetThroughputInMegaBytesPerSecond(throughput.write_size, throughput.write_time_ns));
+                    this->LogText("- Hash: %.1f MB/s\n",  GetThroughputInMegaBytesPerSecond(throughput.hash_size, throughput.hash_time_ns));
+                }
+
+                this->LogText("Applying update...\n");
                 m_install_state = InstallState::NeedsApply;
                 return rc;
             }
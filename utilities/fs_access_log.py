@@ -0,0 +1,174 @@
+#
+# Copyright (c) 2018-2020 Atmosphère-NX
+#
+# This program is free software; you can redistribute it and/or modify it
+# under the terms and conditions of the GNU General Public License,
+# version 2, as published by the Free Software Foundation.
+#
+# This program is distributed in the hope it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+# more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# fs_access_log.py: Decoder for binary fs access logs (see fs::SetLocalBinaryAccessLog).
+# Prints the same FS_ACCESS { ... } text that text access logging would have produced.
+
+import sys, re
+from struct import unpack as up
+
+CHUNK_MAGIC   = b'FSAB'
+CHUNK_VERSION = 1
+CHUNK_HEADER_SIZE = 0x18
+RECORD_SIZE       = 0x80
+
+RECORD_TYPE_ACCESS     = 1
+RECORD_TYPE_DEFINITION = 2
+
+PRIORITY_TYPE_PRIORITY     = 0
+PRIORITY_TYPE_PRIORITY_RAW = 1
+
+INVALID_STRING_ID = 0xFFFF
+
+# Matches fs::impl::IdString::ToString for fs::Priority and fs::PriorityRaw.
+PRIORITY_NAMES     = {0: 'Realtime', 1: 'Normal', 2: 'Low'}
+PRIORITY_RAW_NAMES = {0: 'Realtime', 1: 'Normal', 2: 'Low', 3: 'Realtime'}
+
+# Matches the subset of util::VSNPrintf captured by fs::impl::OutputBinaryAccessLog.
+FORMAT_SPECIFIER = re.compile(r'%([-+ #0]*)([0-9.]*)(hh|h|ll|l|z|j|t)?(.?)')
+
+def to_signed(value, bits):
+    value &= (1 << bits) - 1
+    return value - (1 << bits) if value & (1 << (bits - 1)) else value
+
+def format_pointer(value):
+    return '(nil)' if value == 0 else '0x%x' % value
+
+def ticks_to_ms(tick, frequency):
+    # Matches os::Tick::ToTimeSpan().GetMilliSeconds().
+    sign = -1 if tick < 0 else 1
+    tick = abs(tick)
+    ns = (tick // frequency) * 1000000000 + ((tick % frequency) * 1000000000) // frequency
+    return sign * (ns // 1000000)
+
+def format_arguments(fmt, args, strings):
+    args    = list(args)
+    strings = list(strings)
+    def replace(m):
+        flags, width, length, conv = m.groups()
+        is_64_bit = length in ('l', 'll', 'z', 'j', 't')
+        spec = '%' + flags + width
+        if conv == '%':
+            return '%'
+        elif conv == 's':
+            return (spec + 's') % (strings.pop(0) if strings else '')
+        elif conv == '':
+            return ''
+        value = args.pop(0) if args else 0
+        if conv in 'di':
+            return (spec + 'd') % to_signed(value, 64 if is_64_bit else 32)
+        elif conv == 'u':
+            return (spec + 'd') % (value if is_64_bit else value & 0xFFFFFFFF)
+        elif conv in 'xXo':
+            return (spec + conv) % (value if is_64_bit else value & 0xFFFFFFFF)
+        elif conv == 'b':
+            return format(value if is_64_bit else value & 0xFFFFFFFF, 'b')
+        elif conv == 'c':
+            return chr(value & 0xFF)
+        elif conv == 'p':
+            return format_pointer(value)
+        return m.group(0)
+    return FORMAT_SPECIFIER.sub(replace, fmt)
+
+def parse_access_record(record):
+    _, priority_type, priority, _, result, start_tick, end_tick, handle, name_id, format_id, arg_count, strings_size = up('<BBBBIqqQHHBB2x', record[:0x28])
+    args    = up('<4Q', record[0x28:0x48])[:arg_count]
+    strings = [s.decode('utf-8', 'replace') for s in record[0x48:0x48 + strings_size].split(b'\x00')[:-1]] if strings_size else []
+    return {
+        'priority_type': priority_type,
+        'priority':      priority,
+        'result':        result,
+        'start_tick':    start_tick,
+        'end_tick':      end_tick,
+        'handle':        handle,
+        'name_id':       name_id,
+        'format_id':     format_id,
+        'args':          args,
+        'strings':       strings,
+    }
+
+def format_access(access, definitions, frequency):
+    names = PRIORITY_NAMES if access['priority_type'] == PRIORITY_TYPE_PRIORITY else PRIORITY_RAW_NAMES
+    priority = names.get(access['priority'], '%d' % access['priority'])
+    name = definitions.get(access['name_id'], '<unknown:%d>' % access['name_id'] if access['name_id'] != INVALID_STRING_ID else '<unknown>')
+    fmt  = definitions.get(access['format_id'], '')
+    return 'FS_ACCESS { start: %9d, end: %9d, result: 0x%08X, handle: 0x%s, priority: %s, function: "%s"%s }' % (
+        ticks_to_ms(access['start_tick'], frequency),
+        ticks_to_ms(access['end_tick'], frequency),
+        access['result'],
+        format_pointer(access['handle']),
+        priority,
+        name,
+        format_arguments(fmt, access['args'], access['strings']),
+    )
+
+def decode(data, out):
+    definitions = {}
+    accesses    = []
+    text_lines  = []
+    dropped     = 0
+
+    ofs = 0
+    while ofs < len(data):
+        if data[ofs:ofs + 4] == CHUNK_MAGIC and ofs + CHUNK_HEADER_SIZE <= len(data):
+            _, version, size, dropped_count, frequency = up('<IIIIq', data[ofs:ofs + CHUNK_HEADER_SIZE])
+            if version != CHUNK_VERSION:
+                raise ValueError('Unsupported binary access log version %d at 0x%x' % (version, ofs))
+            ofs += CHUNK_HEADER_SIZE
+            dropped += dropped_count
+            for i in range(size // RECORD_SIZE):
+                record = data[ofs + i * RECORD_SIZE:ofs + (i + 1) * RECORD_SIZE]
+                if len(record) < RECORD_SIZE:
+                    break
+                if record[0] == RECORD_TYPE_DEFINITION:
+                    definitions[up('<H', record[2:4])[0]] = record[4:].split(b'\x00')[0].decode('utf-8', 'replace')
+                elif record[0] == RECORD_TYPE_ACCESS:
+                    access = parse_access_record(record)
+                    access['frequency'] = frequency
+                    accesses.append(access)
+            ofs += size
+        else:
+            # Text output (e.g. the FS_ACCESS start line) up to the next newline or chunk.
+            end = data.find(b'\n', ofs)
+            end = len(data) if end < 0 else end + 1
+            magic = data.find(CHUNK_MAGIC, ofs + 1, end)
+            if magic >= 0:
+                end = magic
+            line = data[ofs:end].decode('utf-8', 'replace').rstrip('\n')
+            if line:
+                text_lines.append(line)
+            ofs = end
+
+    for line in text_lines:
+        out.write(line + '\n')
+
+    # Records are drained per-thread, so restore chronological order.
+    for access in sorted(accesses, key=lambda a: (a['start_tick'], a['end_tick'])):
+        out.write(format_access(access, definitions, access['frequency']) + '\n')
+
+    if dropped:
+        sys.stderr.write('Warning: %d records were dropped by the logger.\n' % dropped)
+
+def main(argc, argv):
+    if argc != 2:
+        print('Usage: %s FsAccessLog.txt' % argv[0])
+        return 1
+    with open(argv[1], 'rb') as f:
+        data = f.read()
+    decode(data, sys.stdout)
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main(len(sys.argv), sys.argv))